@@ -0,0 +1,78 @@
+// lib/filters/cell_subset.dart
+
+import 'dart:typed_data';
+
+import '../utils/mesh_arrays.dart';
+
+/// Cells hidden by the clip and threshold filters, and the faces that bound
+/// the remaining cells.
+///
+/// Each filter hides and shows only the cells whose state it changed; a
+/// cell stays hidden while any filter hides it. Only the faces of those
+/// cells are re-evaluated, so [faceShown] is kept up to date incrementally:
+/// a boundary face is shown when its owner is visible, an internal face
+/// when exactly one of its two cells is (the newly uncovered faces).
+///
+/// The subset is edited in place; [revision] changes on every edit so the
+/// viewer knows to repaint.
+class CellSubset {
+  final MeshArrays mesh;
+  final Uint8List hiddenBy; // Number of filters hiding each cell
+  final Uint8List faceShown;
+  int hiddenCount = 0;
+  int revision = 0;
+
+  CellSubset(this.mesh)
+      : hiddenBy = Uint8List(mesh.nCells),
+        faceShown = Uint8List(mesh.nFaces)
+          ..fillRange(mesh.nInternalFaces, mesh.nFaces, 1);
+
+  /// True when some cell is hidden; otherwise the full mesh is drawn
+  bool get isActive => hiddenCount > 0;
+
+  bool isVisible(int cell) => hiddenBy[cell] == 0;
+
+  /// Cell whose value colours face [f]: the visible side of an internal face
+  int visibleCellOf(int f) {
+    final owner = mesh.owner[f];
+    if (f < mesh.nInternalFaces && hiddenBy[owner] != 0) {
+      return mesh.neighbour[f];
+    }
+    return owner;
+  }
+
+  void hide(Int32List cells) {
+    for (final cell in cells) {
+      if (hiddenBy[cell]++ == 0) {
+        hiddenCount++;
+        _updateFaces(cell);
+      }
+    }
+    if (cells.isNotEmpty) revision++;
+  }
+
+  void show(Int32List cells) {
+    for (final cell in cells) {
+      if (hiddenBy[cell] == 0) continue;
+      if (--hiddenBy[cell] == 0) {
+        hiddenCount--;
+        _updateFaces(cell);
+      }
+    }
+    if (cells.isNotEmpty) revision++;
+  }
+
+  void _updateFaces(int cell) {
+    for (int k = mesh.cellFaceOffsets[cell]; k < mesh.cellFaceOffsets[cell + 1]; k++) {
+      final encoded = mesh.cellFaces[k];
+      final f = encoded >= 0 ? encoded : ~encoded;
+      final ownerVisible = hiddenBy[mesh.owner[f]] == 0;
+      if (f < mesh.nInternalFaces) {
+        final neighbourVisible = hiddenBy[mesh.neighbour[f]] == 0;
+        faceShown[f] = ownerVisible != neighbourVisible ? 1 : 0;
+      } else {
+        faceShown[f] = ownerVisible ? 1 : 0;
+      }
+    }
+  }
+}
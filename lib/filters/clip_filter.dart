@@ -0,0 +1,177 @@
+// lib/filters/clip_filter.dart
+
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/future_cache.dart';
+import '../utils/mesh_geometry.dart';
+import '../utils/sort_utils.dart';
+import '../utils/worker_pool.dart';
+import 'cell_subset.dart';
+
+/// Region removed by a [ClipFilter], tested against cell centres
+sealed class ClipRegion {
+  const ClipRegion();
+
+  bool hides(double x, double y, double z);
+}
+
+/// Hides cells with centre[axis] >= offset (or < offset when inverted)
+class ClipPlane extends ClipRegion {
+  final int axis; // 0, 1, 2 for x, y, z
+  final double offset;
+  final bool invert;
+
+  const ClipPlane(this.axis, this.offset, {this.invert = false});
+
+  @override
+  bool hides(double x, double y, double z) {
+    final d = axis == 0 ? x : (axis == 1 ? y : z);
+    return (d >= offset) != invert;
+  }
+}
+
+/// Hides cells with their centre inside the box (or outside when inverted)
+class ClipBox extends ClipRegion {
+  final Vector3 min;
+  final Vector3 max;
+  final bool invert;
+
+  const ClipBox(this.min, this.max, {this.invert = false});
+
+  @override
+  bool hides(double x, double y, double z) {
+    final inside = x >= min.x &&
+        x <= max.x &&
+        y >= min.y &&
+        y <= max.y &&
+        z >= min.z &&
+        z <= max.z;
+    return inside != invert;
+  }
+}
+
+/// Cell centres and their order along each axis
+class _CentreIndex {
+  final Float64List centres; // x, y, z per cell
+  final List<Int32List> order; // Cells sorted by centre x, y and z
+  final List<Float64List> sorted; // Matching centre coordinates
+
+  _CentreIndex(this.centres, this.order, this.sorted);
+}
+
+/// Cutaway view: hides whole cells by their centres and shows the faces
+/// they uncover, through a shared [CellSubset].
+///
+/// Cell centres come from [MeshGeometry]; their argsort along each axis
+/// is computed once per mesh on a worker. A region change only visits the cells whose state can
+/// change: for a plane moved along the same axis, the cells with centres
+/// between the old and new offsets; for a box, the cells whose centre x
+/// lies within the two boxes' combined x-range. Changing the kind of
+/// region, the axis or the side re-evaluates every cell once.
+class ClipFilter {
+  final PolyMesh mesh;
+  final CellSubset subset;
+  ClipRegion? _region;
+
+  ClipFilter(this.mesh, this.subset);
+
+  ClipRegion? get region => _region;
+
+  static final Expando<Future<_CentreIndex>> _indexes =
+      Expando<Future<_CentreIndex>>();
+
+  Future<_CentreIndex> _index() {
+    return _indexes.putIfAbsentFuture(mesh, () async {
+      final pool = WorkerPool.shared;
+      final geometry = await MeshGeometry.of(mesh);
+      // The geometry is already resident for the locator, gradients and
+      // quality, so the centres are read from it rather than shared again
+      final geometryKey = await pool.shareObject(geometry);
+      final stopwatch = Stopwatch()..start();
+      final (order, sorted) = await pool.run(_buildIndexTask(geometryKey));
+      print('Built clip index in ${stopwatch.elapsedMilliseconds} ms');
+      return _CentreIndex(geometry.cellCentres, order, sorted);
+    });
+  }
+
+  /// Range of cell centres along each axis
+  Future<(Vector3, Vector3)> centreBounds() async {
+    final index = await _index();
+    if (index.centres.isEmpty) return (Vector3(0, 0, 0), Vector3(1, 1, 1));
+    return (
+      Vector3(index.sorted[0].first, index.sorted[1].first, index.sorted[2].first),
+      Vector3(index.sorted[0].last, index.sorted[1].last, index.sorted[2].last),
+    );
+  }
+
+  /// Moves the clip to [region], or removes it when null. Returns the number
+  /// of cells re-evaluated.
+  Future<int> apply(ClipRegion? region) async {
+    final index = await _index();
+    final previous = _region;
+    final centres = index.centres;
+
+    // Positions in one axis order whose cells may change state; all cells
+    // otherwise
+    int axis = -1;
+    int first = 0;
+    int last = centres.length ~/ 3;
+    if (previous is ClipPlane &&
+        region is ClipPlane &&
+        previous.axis == region.axis &&
+        previous.invert == region.invert) {
+      axis = region.axis;
+      final lo = previous.offset < region.offset ? previous.offset : region.offset;
+      final hi = previous.offset < region.offset ? region.offset : previous.offset;
+      first = SortUtils.lowerBound(index.sorted[axis], lo);
+      last = SortUtils.lowerBound(index.sorted[axis], hi, first);
+    } else if (previous is ClipBox &&
+        region is ClipBox &&
+        !previous.invert &&
+        !region.invert) {
+      axis = 0;
+      final lo = previous.min.x < region.min.x ? previous.min.x : region.min.x;
+      final hi = previous.max.x > region.max.x ? previous.max.x : region.max.x;
+      first = SortUtils.lowerBound(index.sorted[0], lo);
+      last = SortUtils.upperBound(index.sorted[0], hi, first);
+    }
+
+    final toHide = <int>[];
+    final toShow = <int>[];
+    for (int i = first; i < last; i++) {
+      final cell = axis >= 0 ? index.order[axis][i] : i;
+      final x = centres[cell * 3], y = centres[cell * 3 + 1], z = centres[cell * 3 + 2];
+      final was = previous?.hides(x, y, z) ?? false;
+      final now = region?.hides(x, y, z) ?? false;
+      if (now && !was) toHide.add(cell);
+      if (was && !now) toShow.add(cell);
+    }
+
+    _region = region;
+    subset.show(Int32List.fromList(toShow));
+    subset.hide(Int32List.fromList(toHide));
+    return last - first;
+  }
+
+  static WorkerTask<(List<Int32List>, List<Float64List>)> _buildIndexTask(
+    int geometryKey,
+  ) =>
+      (store) => _buildIndex((store[geometryKey] as MeshGeometry).cellCentres);
+
+  static (List<Int32List>, List<Float64List>) _buildIndex(Float64List centres) {
+    final nCells = centres.length ~/ 3;
+    final order = <Int32List>[];
+    final sorted = <Float64List>[];
+    final coordinate = Float64List(nCells);
+    for (int axis = 0; axis < 3; axis++) {
+      for (int c = 0; c < nCells; c++) {
+        coordinate[c] = centres[c * 3 + axis];
+      }
+      final (axisOrder, axisSorted) = SortUtils.argsort(coordinate);
+      order.add(axisOrder);
+      sorted.add(axisSorted);
+    }
+    return (order, sorted);
+  }
+}
@@ -0,0 +1,459 @@
+// lib/filters/field_calculator.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/lru_cache.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/worker_pool.dart';
+
+/// A field reference in an expression: `U`, `U.x`, `T@0.5`, `T@prev`
+class FieldRef {
+  final String name;
+  final int component; // 0..2 for .x/.y/.z, -1 for the value (|v| of vectors)
+  final String? time; // Time directory, 'prev', 'next', or null for current
+
+  const FieldRef(this.name, this.component, this.time);
+
+  @override
+  bool operator ==(Object other) =>
+      other is FieldRef &&
+      other.name == name &&
+      other.component == component &&
+      other.time == time;
+
+  @override
+  int get hashCode => Object.hash(name, component, time);
+}
+
+/// Expression tree; plain data so it can be sent to the workers
+sealed class CalcNode {
+  const CalcNode();
+}
+
+class CalcNumber extends CalcNode {
+  final double value;
+  const CalcNumber(this.value);
+}
+
+class CalcField extends CalcNode {
+  final FieldRef ref;
+  const CalcField(this.ref);
+}
+
+class CalcUnary extends CalcNode {
+  final String op; // '-'
+  final CalcNode operand;
+  const CalcUnary(this.op, this.operand);
+}
+
+class CalcBinary extends CalcNode {
+  final String op; // + - * / ^
+  final CalcNode left;
+  final CalcNode right;
+  const CalcBinary(this.op, this.left, this.right);
+}
+
+class CalcCall extends CalcNode {
+  final String function;
+  final List<CalcNode> arguments;
+  const CalcCall(this.function, this.arguments);
+}
+
+/// Derived fields from expressions over loaded fields, e.g.
+/// `p + 0.5*mag(U)^2`, `U.x`, `T - T@0.5` or `T - T@prev`.
+///
+/// An expression is parsed once, then compiled on each worker into one
+/// nest of closures that computes a cell's result from its inputs
+/// directly, so the whole expression is a single fused pass over the cell
+/// arrays with no intermediate fields. Cells are split across
+/// [WorkerPool.shared], each worker sent only its slice of every input,
+/// and the most recent results are cached per expression and time step.
+class FieldCalculator {
+  static const Map<String, int> functions = {
+    'mag': 1, 'abs': 1, 'sqrt': 1, 'exp': 1, 'log': 1, //
+    'sin': 1, 'cos': 1, 'tan': 1, 'min': 2, 'max': 2, 'pow': 2,
+  };
+
+  final PolyMesh mesh;
+  final List<String> timeDirectories;
+
+  /// Loads a field at a time step, e.g. [CaseReader.loadFieldData]
+  final Future<FieldData?> Function(String fieldName, String timeStep) loadField;
+
+  static const int _cacheSize = 8;
+
+  final LruCache<(String, String), Future<FieldData>> _cache = LruCache(_cacheSize);
+
+  FieldCalculator({
+    required this.mesh,
+    required this.timeDirectories,
+    required this.loadField,
+  });
+
+  /// Evaluates [expression] at [timeStep]; [fieldNames] are the fields it
+  /// may refer to. Throws [FormatException] for bad expressions and
+  /// [StateError] for missing inputs.
+  Future<FieldData> evaluate(
+    String expression,
+    String timeStep,
+    Iterable<String> fieldNames,
+  ) {
+    return _cache.putIfAbsentFuture(
+      (expression.trim(), timeStep),
+      () => _evaluate(expression.trim(), timeStep, fieldNames.toSet()),
+    );
+  }
+
+  /// Forgets cached results, e.g. when files on disk changed
+  void clear() => _cache.clear();
+
+  Future<FieldData> _evaluate(
+    String expression,
+    String timeStep,
+    Set<String> fieldNames,
+  ) async {
+    final tree = parse(expression, fieldNames);
+    final pool = WorkerPool.shared;
+    final arrays = MeshArrays.of(mesh);
+
+    final inputs = <FieldRef, Float64List>{};
+    for (final ref in references(tree)) {
+      final time = _resolveTime(ref.time, timeStep);
+      final field = await loadField(ref.name, time);
+      if (field == null) {
+        throw StateError('Field ${ref.name} not found at time $time');
+      }
+      final Float64List data;
+      if (ref.component >= 0) {
+        final vectors = field.vectors;
+        if (vectors == null) {
+          throw StateError('${ref.name} is not a vector field');
+        }
+        data = vectors;
+      } else {
+        data = FieldInterpolation.cellArray(field);
+      }
+      inputs[ref] = data;
+    }
+
+    // Each worker gets its cells' slice of the inputs; uniform ones whole
+    final parts = await pool.forRanges(
+      arrays.nCells,
+      (start, end) => _evaluateTask(tree, {
+        for (final MapEntry(key: ref, value: data) in inputs.entries)
+          ref: _slice(data, ref.component >= 0 ? 3 : 1, start, end),
+      }, end - start),
+      minChunk: 4096,
+    );
+    final values = Float64List(arrays.nCells);
+    int offset = 0;
+    for (final part in parts) {
+      values.setAll(offset, part);
+      offset += part.length;
+    }
+
+    final meshKey = await pool.shareObject(arrays);
+    final pointValues = await pool.run(FieldInterpolation.pointTask(meshKey, values));
+    return FieldData(
+      name: expression,
+      fieldClass: 'volScalarField',
+      internalField: values,
+      boundaryField: {},
+      pointValues: pointValues,
+    );
+  }
+
+  String _resolveTime(String? time, String current) {
+    final index = timeDirectories.indexOf(current);
+    switch (time) {
+      case null:
+        return current;
+      case 'prev':
+        if (index <= 0) throw StateError('No time step before $current');
+        return timeDirectories[index - 1];
+      case 'next':
+        if (index < 0 || index + 1 >= timeDirectories.length) {
+          throw StateError('No time step after $current');
+        }
+        return timeDirectories[index + 1];
+    }
+    // Matched by value so that `@0.5` finds `0.50`
+    final value = double.tryParse(time);
+    for (final directory in timeDirectories) {
+      if (directory == time ||
+          (value != null && double.tryParse(directory) == value)) {
+        return directory;
+      }
+    }
+    throw StateError('No time directory $time');
+  }
+
+  // Cells [start, end) of [data] with [width] values per cell
+  static Float64List _slice(Float64List data, int width, int start, int end) {
+    if (data.length == width) return data; // Uniform
+    return data.sublist(start * width, end * width);
+  }
+
+  static WorkerTask<Float64List> _evaluateTask(
+    CalcNode tree,
+    Map<FieldRef, Float64List> inputs,
+    int count,
+  ) =>
+      (_) => run(tree, inputs, 0, count);
+
+  /// Evaluates [tree] for cells [start]..[end) on this isolate; [inputs]
+  /// holds cell values, or x, y, z triples for component references
+  static Float64List run(
+    CalcNode tree,
+    Map<FieldRef, Float64List> inputs,
+    int start,
+    int end,
+  ) {
+    final kernel = _compile(tree, inputs);
+    final out = Float64List(end - start);
+    for (int c = start; c < end; c++) {
+      out[c - start] = kernel(c);
+    }
+    return out;
+  }
+
+  /// Field references in [tree], without repeats
+  static Set<FieldRef> references(CalcNode tree) {
+    final refs = <FieldRef>{};
+    void visit(CalcNode node) {
+      switch (node) {
+        case CalcNumber():
+          break;
+        case CalcField(:final ref):
+          refs.add(ref);
+        case CalcUnary(:final operand):
+          visit(operand);
+        case CalcBinary(:final left, :final right):
+          visit(left);
+          visit(right);
+        case CalcCall(:final arguments):
+          arguments.forEach(visit);
+      }
+    }
+
+    visit(tree);
+    return refs;
+  }
+
+  // One closure per node; constants are folded
+  static double Function(int) _compile(
+    CalcNode node,
+    Map<FieldRef, Float64List> inputs,
+  ) {
+    switch (node) {
+      case CalcNumber(:final value):
+        return (_) => value;
+
+      case CalcField(:final ref):
+        final data = inputs[ref]!;
+        if (ref.component >= 0) {
+          final k = ref.component;
+          if (data.length == 3) return (_) => data[k]; // Uniform
+          return (c) => data[c * 3 + k];
+        }
+        if (data.length == 1) {
+          final value = data[0];
+          return (_) => value; // Uniform
+        }
+        return (c) => data[c];
+
+      case CalcUnary(:final operand):
+        final a = _compile(operand, inputs);
+        return (c) => -a(c);
+
+      case CalcBinary(:final op, :final left, :final right):
+        final a = _compile(left, inputs);
+        if (op == '^' && right is CalcNumber && right.value == 2) {
+          return (c) {
+            final x = a(c);
+            return x * x;
+          };
+        }
+        final b = _compile(right, inputs);
+        return switch (op) {
+          '+' => (c) => a(c) + b(c),
+          '-' => (c) => a(c) - b(c),
+          '*' => (c) => a(c) * b(c),
+          '/' => (c) => a(c) / b(c),
+          _ => (c) => math.pow(a(c), b(c)).toDouble(),
+        };
+
+      case CalcCall(:final function, :final arguments):
+        // mag of a bare field reference is its value, |v| for vectors
+        final a = _compile(arguments[0], inputs);
+        if (arguments.length == 2) {
+          final b = _compile(arguments[1], inputs);
+          return switch (function) {
+            'min' => (c) => math.min(a(c), b(c)),
+            'max' => (c) => math.max(a(c), b(c)),
+            _ => (c) => math.pow(a(c), b(c)).toDouble(),
+          };
+        }
+        return switch (function) {
+          'mag' || 'abs' => (c) => a(c).abs(),
+          'sqrt' => (c) => math.sqrt(a(c)),
+          'exp' => (c) => math.exp(a(c)),
+          'log' => (c) => math.log(a(c)),
+          'sin' => (c) => math.sin(a(c)),
+          'cos' => (c) => math.cos(a(c)),
+          _ => (c) => math.tan(a(c)),
+        };
+    }
+  }
+
+  /// Parses [expression]; identifiers must be in [fieldNames] (a trailing
+  /// .x, .y or .z selects a vector component unless the whole name is a
+  /// field, as in `alpha.water`)
+  static CalcNode parse(String expression, Set<String> fieldNames) =>
+      _Parser(expression, fieldNames).parse();
+}
+
+class _Parser {
+  final String source;
+  final Set<String> fieldNames;
+  int _pos = 0;
+
+  _Parser(this.source, this.fieldNames);
+
+  FormatException _error(String message) =>
+      FormatException(message, source, _pos);
+
+  void _skipSpace() {
+    while (_pos < source.length && source[_pos].trim().isEmpty) {
+      _pos++;
+    }
+  }
+
+  bool _accept(String symbol) {
+    _skipSpace();
+    if (source.startsWith(symbol, _pos)) {
+      _pos += symbol.length;
+      return true;
+    }
+    return false;
+  }
+
+  void _expect(String symbol) {
+    if (!_accept(symbol)) throw _error("Expected '$symbol'");
+  }
+
+  CalcNode parse() {
+    final node = _sum();
+    _skipSpace();
+    if (_pos < source.length) throw _error('Unexpected ${source[_pos]}');
+    return node;
+  }
+
+  CalcNode _sum() {
+    var node = _product();
+    while (true) {
+      if (_accept('+')) {
+        node = CalcBinary('+', node, _product());
+      } else if (_accept('-')) {
+        node = CalcBinary('-', node, _product());
+      } else {
+        return node;
+      }
+    }
+  }
+
+  CalcNode _product() {
+    var node = _unary();
+    while (true) {
+      if (_accept('*')) {
+        node = CalcBinary('*', node, _unary());
+      } else if (_accept('/')) {
+        node = CalcBinary('/', node, _unary());
+      } else {
+        return node;
+      }
+    }
+  }
+
+  CalcNode _unary() {
+    if (_accept('-')) return CalcUnary('-', _unary());
+    if (_accept('+')) return _unary();
+    return _power();
+  }
+
+  // Right-associative, binding tighter than unary minus: -a^2 is -(a^2)
+  CalcNode _power() {
+    final base = _primary();
+    if (_accept('^')) return CalcBinary('^', base, _unary());
+    return base;
+  }
+
+  static final RegExp _number = RegExp(r'(\d+\.?\d*|\.\d+)([eE][-+]?\d+)?');
+  static final RegExp _identifier = RegExp(r'[A-Za-z_][A-Za-z0-9_.]*');
+  static final RegExp _time = RegExp(r'[A-Za-z]+|[-+]?(\d+\.?\d*|\.\d+)([eE][-+]?\d+)?');
+
+  CalcNode _primary() {
+    _skipSpace();
+    if (_accept('(')) {
+      final node = _sum();
+      _expect(')');
+      return node;
+    }
+
+    final number = _number.matchAsPrefix(source, _pos);
+    if (number != null) {
+      _pos = number.end;
+      return CalcNumber(double.parse(number[0]!));
+    }
+
+    final identifier = _identifier.matchAsPrefix(source, _pos);
+    if (identifier == null) throw _error('Expected a value');
+    final start = _pos;
+    _pos = identifier.end;
+    final word = identifier[0]!;
+
+    if (FieldCalculator.functions.containsKey(word) && _accept('(')) {
+      final arguments = [_sum()];
+      while (_accept(',')) {
+        arguments.add(_sum());
+      }
+      _expect(')');
+      if (arguments.length != FieldCalculator.functions[word]) {
+        _pos = start;
+        throw _error('$word takes ${FieldCalculator.functions[word]} argument(s)');
+      }
+      return CalcCall(word, arguments);
+    }
+
+    var name = word;
+    int component = -1;
+    if (!fieldNames.contains(name)) {
+      final dot = name.lastIndexOf('.');
+      final suffix = dot > 0 ? name.substring(dot + 1) : '';
+      if (suffix.length == 1 && 'xyz'.contains(suffix)) {
+        component = 'xyz'.indexOf(suffix);
+        name = name.substring(0, dot);
+      }
+    }
+    if (!fieldNames.contains(name)) {
+      _pos = start;
+      throw _error('Unknown field $name');
+    }
+
+    String? time;
+    if (_accept('@')) {
+      _skipSpace();
+      final match = _time.matchAsPrefix(source, _pos);
+      if (match == null) throw _error('Expected a time after @');
+      _pos = match.end;
+      time = match[0]!;
+      if (double.tryParse(time) == null && time != 'prev' && time != 'next') {
+        throw _error("Time must be a number, 'prev' or 'next'");
+      }
+    }
+    return CalcField(FieldRef(name, component, time));
+  }
+}
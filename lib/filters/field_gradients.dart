@@ -0,0 +1,326 @@
+// lib/filters/field_gradients.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/lru_cache.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/mesh_geometry.dart';
+import '../utils/tensor_math.dart';
+import '../utils/worker_pool.dart';
+
+/// Cell gradients by the Gauss linear scheme, and the fields derived from
+/// them: `grad(p)`, `vorticity(U)`, `Q(U)`, `lambda2(U)` and `div(U)`.
+///
+/// The gradient of a cell is the sum over its faces of the linearly
+/// interpolated face value times the outward area vector, over the cell
+/// volume; boundary faces take the cell value (zero gradient). Each cell
+/// gathers over its own faces, so cell chunks on [WorkerPool.shared] write
+/// disjoint ranges and need no colouring or reduction. The most recent
+/// gradients are cached per (field, time), derived fields per (name, time).
+class FieldGradients {
+  static const List<String> operations = [
+    'grad',
+    'vorticity',
+    'Q',
+    'lambda2',
+    'div',
+  ];
+
+  static final RegExp _pattern =
+      RegExp(r'^(grad|vorticity|Q|lambda2|div)\(\s*([^()\s]+)\s*\)$');
+
+  final PolyMesh mesh;
+
+  /// Loads a field at a time step, e.g. [CaseReader.loadFieldData]
+  final Future<FieldData?> Function(String fieldName, String timeStep) loadField;
+
+  // A vector gradient is 9 values per cell, so only a few are kept
+  static const int _gradientCacheSize = 4;
+  static const int _cacheSize = 8;
+
+  final LruCache<(String, String), Future<Float64List>> _gradients =
+      LruCache(_gradientCacheSize);
+  final LruCache<(String, String), Future<FieldData>> _cache = LruCache(_cacheSize);
+
+  FieldGradients({required this.mesh, required this.loadField});
+
+  /// The operation and input field of a derived field name such as
+  /// `Q(U)`, or null if [name] is not one
+  static (String, String)? parse(String name) {
+    final match = _pattern.firstMatch(name.trim());
+    if (match == null) return null;
+    return (match[1]!, match[2]!);
+  }
+
+  /// The derived field [name] at [timeStep]. Throws [FormatException] for
+  /// unknown names and [StateError] for missing or mismatched inputs.
+  Future<FieldData> evaluate(String name, String timeStep) {
+    final parsed = parse(name);
+    if (parsed == null) throw FormatException('Not a gradient field', name);
+    final (operation, fieldName) = parsed;
+    return _cache.putIfAbsentFuture(
+      (name.trim(), timeStep),
+      () => _evaluate(name.trim(), operation, fieldName, timeStep),
+    );
+  }
+
+  /// Forgets cached gradients and derived fields
+  void clear() {
+    _gradients.clear();
+    _cache.clear();
+  }
+
+  Future<FieldData> _evaluate(
+    String name,
+    String operation,
+    String fieldName,
+    String timeStep,
+  ) async {
+    final field = await loadField(fieldName, timeStep);
+    if (field == null) {
+      throw StateError('Field $fieldName not found at time $timeStep');
+    }
+    if (field.isTensor) {
+      throw StateError('$operation is not available for tensor fields');
+    }
+    if (operation == 'grad' ? field.isVector : !field.isVector) {
+      throw StateError(
+        operation == 'grad'
+            ? 'grad needs a scalar field; try vorticity($fieldName)'
+            : '$operation needs a vector field',
+      );
+    }
+
+    final pool = WorkerPool.shared;
+    final arrays = MeshArrays.of(mesh);
+    final gradient = await _gradient(field, timeStep);
+    // Each worker gets its cells' slice rather than a share of the whole
+    final width = gradient.length ~/ arrays.nCells;
+    final parts = await pool.forRanges(
+      arrays.nCells,
+      (start, end) => _deriveTask(
+        operation,
+        gradient.sublist(start * width, end * width),
+        end - start,
+      ),
+      minChunk: 65536,
+    );
+
+    final values = Float64List(arrays.nCells);
+    final vectors = parts.first.$2 != null ? Float64List(arrays.nCells * 3) : null;
+    int offset = 0;
+    for (final (partValues, partVectors) in parts) {
+      values.setAll(offset, partValues);
+      if (vectors != null) vectors.setAll(offset * 3, partVectors!);
+      offset += partValues.length;
+    }
+
+    final meshKey = await pool.shareObject(arrays);
+    final pointValues = await pool.run(FieldInterpolation.pointTask(meshKey, values));
+    return FieldData(
+      name: name,
+      fieldClass: vectors != null ? 'volVectorField' : 'volScalarField',
+      internalField: values,
+      boundaryField: {},
+      pointValues: pointValues,
+      vectors: vectors,
+    );
+  }
+
+  // 3 (scalar) or 9 (vector) gradient components per cell
+  Future<Float64List> _gradient(FieldData field, String timeStep) =>
+      _gradients.putIfAbsentFuture(
+        (field.name, timeStep),
+        () => _computeGradient(field),
+      );
+
+  Future<Float64List> _computeGradient(FieldData field) async {
+    final pool = WorkerPool.shared;
+    final arrays = MeshArrays.of(mesh);
+    final geometry = await MeshGeometry.of(mesh);
+    final components = field.isVector ? 3 : 1;
+    final meshKey = await pool.shareObject(arrays);
+    final geometryKey = await pool.shareObject(geometry);
+    final valuesKey = await pool.shareObject(
+      field.vectors ?? FieldInterpolation.cellArray(field),
+    );
+
+    final parts = await pool.forRanges(
+      arrays.nCells,
+      (start, end) => _gradientTask(
+        meshKey,
+        geometryKey,
+        valuesKey,
+        components,
+        start,
+        end,
+      ),
+      minChunk: 65536,
+    );
+    final out = Float64List(arrays.nCells * 3 * components);
+    int offset = 0;
+    for (final part in parts) {
+      out.setAll(offset, part);
+      offset += part.length;
+    }
+    return out;
+  }
+
+  static WorkerTask<Float64List> _gradientTask(
+    int meshKey,
+    int geometryKey,
+    int valuesKey,
+    int components,
+    int start,
+    int end,
+  ) =>
+      (store) => gradient(
+            store[meshKey] as MeshArrays,
+            store[geometryKey] as MeshGeometry,
+            store[valuesKey] as Float64List,
+            components,
+            start,
+            end,
+          );
+
+  static WorkerTask<(Float64List, Float64List?)> _deriveTask(
+    String operation,
+    Float64List gradient,
+    int count,
+  ) =>
+      (_) => derive(operation, gradient, 0, count);
+
+  /// Gauss linear gradients of cells [start]..[end) on this isolate.
+  /// [values] holds [components] (1 or 3) values per cell; the result has
+  /// 3 * [components] per cell, entry `i * components + j` being the
+  /// derivative of component j along axis i.
+  static Float64List gradient(
+    MeshArrays m,
+    MeshGeometry g,
+    Float64List values,
+    int components,
+    int start,
+    int end,
+  ) {
+    final width = 3 * components;
+    final out = Float64List((end - start) * width);
+    final offsets = m.cellFaceOffsets;
+    final cellFaces = m.cellFaces;
+    final cc = g.cellCentres;
+    final fc = g.faceCentres;
+    final sf = g.faceAreas;
+
+    for (int c = start; c < end; c++) {
+      final o = (c - start) * width;
+      for (int k = offsets[c]; k < offsets[c + 1]; k++) {
+        final encoded = cellFaces[k];
+        final owned = encoded >= 0;
+        final f = owned ? encoded : ~encoded;
+        final sign = owned ? 1.0 : -1.0;
+        final sx = sign * sf[f * 3], sy = sign * sf[f * 3 + 1], sz = sign * sf[f * 3 + 2];
+
+        // Linear weight of this cell's value on the face
+        int other = -1;
+        double w = 1;
+        if (f < m.nInternalFaces) {
+          other = owned ? m.neighbour[f] : m.owner[f];
+          final near = (sx * (fc[f * 3] - cc[c * 3]) +
+                  sy * (fc[f * 3 + 1] - cc[c * 3 + 1]) +
+                  sz * (fc[f * 3 + 2] - cc[c * 3 + 2]))
+              .abs();
+          final far = (sx * (cc[other * 3] - fc[f * 3]) +
+                  sy * (cc[other * 3 + 1] - fc[f * 3 + 1]) +
+                  sz * (cc[other * 3 + 2] - fc[f * 3 + 2]))
+              .abs();
+          w = near + far > 0 ? far / (near + far) : 0.5;
+        }
+
+        for (int j = 0; j < components; j++) {
+          final face = other < 0
+              ? values[c * components + j]
+              : w * values[c * components + j] +
+                  (1 - w) * values[other * components + j];
+          out[o + j] += sx * face;
+          out[o + components + j] += sy * face;
+          out[o + 2 * components + j] += sz * face;
+        }
+      }
+
+      final volume = g.cellVolumes[c];
+      if (volume > 0) {
+        for (int i = o; i < o + width; i++) {
+          out[i] /= volume;
+        }
+      }
+    }
+    return out;
+  }
+
+  /// Cell values, and vectors where the result is one, of [operation] for
+  /// cells [start]..[end) from the gradients of the whole field
+  static (Float64List, Float64List?) derive(
+    String operation,
+    Float64List gradient,
+    int start,
+    int end,
+  ) {
+    final values = Float64List(end - start);
+
+    if (operation == 'grad') {
+      final vectors = Float64List.sublistView(gradient, start * 3, end * 3);
+      for (int c = 0; c < end - start; c++) {
+        final x = vectors[c * 3], y = vectors[c * 3 + 1], z = vectors[c * 3 + 2];
+        values[c] = math.sqrt(x * x + y * y + z * z);
+      }
+      return (values, Float64List.fromList(vectors));
+    }
+
+    final vectors = operation == 'vorticity' ? Float64List((end - start) * 3) : null;
+    final m = Float64List(6); // sym(G . G) for lambda2
+    final eigen = Float64List(3);
+
+    for (int c = start; c < end; c++) {
+      final o = c - start;
+      final i = c * 9;
+      // G[a][b] = d u_b / d x_a
+      final g00 = gradient[i], g01 = gradient[i + 1], g02 = gradient[i + 2];
+      final g10 = gradient[i + 3], g11 = gradient[i + 4], g12 = gradient[i + 5];
+      final g20 = gradient[i + 6], g21 = gradient[i + 7], g22 = gradient[i + 8];
+
+      switch (operation) {
+        case 'vorticity':
+          final x = g12 - g21, y = g20 - g02, z = g01 - g10;
+          vectors![o * 3] = x;
+          vectors[o * 3 + 1] = y;
+          vectors[o * 3 + 2] = z;
+          values[o] = math.sqrt(x * x + y * y + z * z);
+        case 'div':
+          values[o] = g00 + g11 + g22;
+        case 'Q':
+          // (|Omega|^2 - |S|^2) / 2 = -tr(G . G) / 2
+          values[o] = -0.5 *
+              (g00 * g00 + g11 * g11 + g22 * g22 +
+                  2 * (g01 * g10 + g02 * g20 + g12 * g21));
+        case 'lambda2':
+          // S^2 + Omega^2 = sym(G . G); its middle eigenvalue
+          m[0] = g00 * g00 + g01 * g10 + g02 * g20;
+          m[1] = 0.5 * (g00 * g01 + g01 * g11 + g02 * g21 +
+              g10 * g00 + g11 * g10 + g12 * g20);
+          m[2] = 0.5 * (g00 * g02 + g01 * g12 + g02 * g22 +
+              g20 * g00 + g21 * g10 + g22 * g20);
+          m[3] = g10 * g01 + g11 * g11 + g12 * g21;
+          m[4] = 0.5 * (g10 * g02 + g11 * g12 + g12 * g22 +
+              g20 * g01 + g21 * g11 + g22 * g21);
+          m[5] = g20 * g02 + g21 * g12 + g22 * g22;
+          TensorMath.symmEigenvalues(m, 0, eigen, 0);
+          values[o] = eigen[1];
+        default:
+          throw ArgumentError.value(operation, 'operation');
+      }
+    }
+    return (values, vectors);
+  }
+}
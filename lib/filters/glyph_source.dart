@@ -0,0 +1,185 @@
+// lib/filters/glyph_source.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/mesh_geometry.dart';
+import '../utils/worker_pool.dart';
+
+/// Candidate positions and vectors for arrow glyphs.
+///
+/// At most [maxCandidates] locations are taken, one per bin of a uniform
+/// grid over the cells (or boundary faces), so the per-frame screen-space
+/// subsampling in `GlyphOverlay` costs the same whatever the mesh size.
+/// Built on a worker.
+class GlyphSource {
+  static const int maxCandidates = 100000;
+
+  final Float64List positions; // x, y, z per candidate
+  final Float64List vectors; // x, y, z per candidate
+  final double maxMagnitude;
+
+  const GlyphSource(this.positions, this.vectors, this.maxMagnitude);
+
+  int get length => positions.length ~/ 3;
+
+  /// Glyphs at cell centres of a vector [field]
+  static Future<GlyphSource> cells(PolyMesh mesh, FieldData field) =>
+      _build(mesh, field, boundary: false);
+
+  /// Glyphs at boundary face centres, with the adjacent cell's vector
+  static Future<GlyphSource> boundary(PolyMesh mesh, FieldData field) =>
+      _build(mesh, field, boundary: true);
+
+  static Future<GlyphSource> _build(
+    PolyMesh mesh,
+    FieldData field, {
+    required bool boundary,
+  }) async {
+    final vectors = field.vectors;
+    if (vectors == null) {
+      throw ArgumentError('${field.name} is not a vector field');
+    }
+    final geometry = await MeshGeometry.of(mesh);
+    final pool = WorkerPool.shared;
+    // The mesh and its geometry stay resident for other kernels; the
+    // vectors are read by this one task only, so they travel with it
+    final meshKey = await pool.shareObject(MeshArrays.of(mesh));
+    final geometryKey = await pool.shareObject(geometry);
+    return pool.run(_buildTask(meshKey, geometryKey, vectors, boundary));
+  }
+
+  static WorkerTask<GlyphSource> _buildTask(
+    int meshKey,
+    int geometryKey,
+    Float64List vectors,
+    bool boundary,
+  ) =>
+      (store) {
+        final geometry = store[geometryKey] as MeshGeometry;
+        return build(
+          store[meshKey] as MeshArrays,
+          vectors,
+          boundary ? geometry.faceCentres : geometry.cellCentres,
+          boundary: boundary,
+        );
+      };
+
+  /// Binned candidates on this isolate; [centres] are the face centres
+  /// for [boundary] glyphs and the cell centres otherwise
+  static GlyphSource build(
+    MeshArrays m,
+    Float64List cellVectors,
+    Float64List centres, {
+    required bool boundary,
+    int limit = maxCandidates,
+  }) {
+    final first = boundary ? m.nInternalFaces : 0;
+    final total = boundary ? m.nFaces - m.nInternalFaces : m.nCells;
+    final items = total <= limit
+        ? Int32List.fromList([for (int n = 0; n < total; n++) first + n])
+        : _binned(centres, first, total, limit);
+
+    final count = items.length;
+    final positions = Float64List(count * 3);
+    final vectors = Float64List(count * 3);
+    double maxMagnitude = 0;
+
+    for (int n = 0; n < count; n++) {
+      final item = items[n];
+      final cell = boundary ? m.owner[item] : item;
+
+      positions[n * 3] = centres[item * 3];
+      positions[n * 3 + 1] = centres[item * 3 + 1];
+      positions[n * 3 + 2] = centres[item * 3 + 2];
+
+      if (cell * 3 + 2 < cellVectors.length) {
+        final vx = cellVectors[cell * 3];
+        final vy = cellVectors[cell * 3 + 1];
+        final vz = cellVectors[cell * 3 + 2];
+        vectors[n * 3] = vx;
+        vectors[n * 3 + 1] = vy;
+        vectors[n * 3 + 2] = vz;
+        final magnitude = math.sqrt(vx * vx + vy * vy + vz * vz);
+        if (magnitude > maxMagnitude) maxMagnitude = magnitude;
+      }
+    }
+    return GlyphSource(positions, vectors, maxMagnitude);
+  }
+
+  /// One item per bin of a uniform grid of at most [limit] bins over the
+  /// bounding box of [centres], the one nearest the bin centre. Striding
+  /// by index instead would alias with the ordering of structured meshes.
+  static Int32List _binned(Float64List centres, int first, int total, int limit) {
+    final lo = Float64List.fromList([double.infinity, double.infinity, double.infinity]);
+    final hi = Float64List.fromList([-double.infinity, -double.infinity, -double.infinity]);
+    for (int item = first; item < first + total; item++) {
+      for (int a = 0; a < 3; a++) {
+        final v = centres[item * 3 + a];
+        if (v < lo[a]) lo[a] = v;
+        if (v > hi[a]) hi[a] = v;
+      }
+    }
+
+    // Cubic bins over the axes longer than one bin; flat axes get one bin
+    final extent = [for (int a = 0; a < 3; a++) hi[a] - lo[a]];
+    final active = [for (int a = 0; a < 3; a++) extent[a] > 0];
+    double size = 0;
+    while (true) {
+      double volume = 1;
+      int axes = 0;
+      for (int a = 0; a < 3; a++) {
+        if (!active[a]) continue;
+        volume *= extent[a];
+        axes++;
+      }
+      if (axes == 0) break;
+      size = math.pow(volume / limit, 1 / axes).toDouble();
+      bool dropped = false;
+      for (int a = 0; a < 3; a++) {
+        if (active[a] && extent[a] < size) {
+          active[a] = false;
+          dropped = true;
+        }
+      }
+      if (!dropped) break;
+    }
+    final dims = [
+      for (int a = 0; a < 3; a++) active[a] ? math.max(1, extent[a] ~/ size) : 1,
+    ];
+    final binSize = [for (int a = 0; a < 3; a++) dims[a] > 1 ? extent[a] / dims[a] : 0.0];
+
+    final bins = dims[0] * dims[1] * dims[2];
+    final best = Int32List(bins)..fillRange(0, bins, -1);
+    final bestDistance = Float64List(bins);
+    for (int item = first; item < first + total; item++) {
+      int bin = 0;
+      double distance = 0;
+      for (int a = 2; a >= 0; a--) {
+        int i = 0;
+        double offset = centres[item * 3 + a] - lo[a];
+        if (dims[a] > 1) {
+          i = math.min(dims[a] - 1, offset ~/ binSize[a]);
+          offset -= (i + 0.5) * binSize[a];
+        } else {
+          offset -= extent[a] * 0.5;
+        }
+        bin = bin * dims[a] + i;
+        distance += offset * offset;
+      }
+      if (best[bin] < 0 || distance < bestDistance[bin]) {
+        best[bin] = item;
+        bestDistance[bin] = distance;
+      }
+    }
+
+    final items = Int32List(bins);
+    int count = 0;
+    for (final item in best) {
+      if (item >= 0) items[count++] = item;
+    }
+    return Int32List.sublistView(items, 0, count);
+  }
+}
@@ -0,0 +1,357 @@
+// lib/filters/iso_surface_filter.dart
+
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/future_cache.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/mesh_geometry.dart';
+import '../utils/sort_utils.dart';
+import '../utils/worker_pool.dart';
+import 'triangle_surface.dart';
+
+/// Value range of every cell, sorted for skipping cells that cannot contain
+/// an iso-value
+class _RangeIndex {
+  static const int blockSize = 256;
+
+  final Int32List order; // Cells sorted by their lowest value
+  final Float64List sortedMin;
+  final Float64List sortedMax; // Highest value of each cell, in [order]
+  final Float64List blockMax; // Highest sortedMax in each block of blockSize
+  final double lowest;
+  final double highest;
+
+  _RangeIndex(
+    this.order,
+    this.sortedMin,
+    this.sortedMax,
+    this.blockMax,
+    this.lowest,
+    this.highest,
+  );
+
+  /// Cells whose range contains [iso]
+  Int32List candidates(double iso) {
+    final end = SortUtils.upperBound(sortedMin, iso);
+    final out = <int>[];
+    for (int block = 0; block * blockSize < end; block++) {
+      if (blockMax[block] < iso) continue;
+      final stop = (block + 1) * blockSize < end ? (block + 1) * blockSize : end;
+      for (int i = block * blockSize; i < stop; i++) {
+        if (sortedMax[i] >= iso) out.add(order[i]);
+      }
+    }
+    return Int32List.fromList(out);
+  }
+}
+
+/// Contour surfaces of a scalar field on the polyhedral mesh.
+///
+/// Each cell is split on the fly into tetrahedra (cell centre, face centre
+/// and one face edge, as in OpenFOAM's cell decomposition, with the centres
+/// from [MeshGeometry]) and marching
+/// tetrahedra is run on them. Values are the cell value at the cell centre,
+/// interpolated point values at the vertices and their face average at the
+/// face centre. A per-field interval index skips cells whose value range
+/// cannot contain the iso-value; the rest are contoured in parallel chunks
+/// on [WorkerPool.shared].
+class IsoSurfaceFilter {
+  final PolyMesh mesh;
+
+  IsoSurfaceFilter(this.mesh);
+
+  static final Expando<Future<_RangeIndex>> _indexes =
+      Expando<Future<_RangeIndex>>();
+
+  Future<_RangeIndex> _indexFor(FieldData field) {
+    return _indexes.putIfAbsentFuture(field, () async {
+      final pool = WorkerPool.shared;
+      final meshKey = await pool.shareObject(MeshArrays.of(mesh));
+      final pointKey = await pool.shareObject(
+        FieldInterpolation.pointArray(field, mesh),
+      );
+      final cellKey = await pool.shareObject(FieldInterpolation.cellArray(field));
+      return pool.run(_buildIndexTask(meshKey, pointKey, cellKey));
+    });
+  }
+
+  /// Lowest and highest value of [field] over cells and points
+  Future<(double, double)> valueRange(FieldData field) async {
+    final index = await _indexFor(field);
+    return (index.lowest, index.highest);
+  }
+
+  /// The iso-surface field == [iso]
+  Future<TriangleSurface> contour(FieldData field, double iso) async {
+    final index = await _indexFor(field);
+    final cells = index.candidates(iso);
+    if (cells.isEmpty) return TriangleSurface.empty;
+
+    final pool = WorkerPool.shared;
+    final meshKey = await pool.shareObject(MeshArrays.of(mesh));
+    final geometryKey = await pool.shareObject(await MeshGeometry.of(mesh));
+    final pointKey = await pool.shareObject(
+      FieldInterpolation.pointArray(field, mesh),
+    );
+    final cellKey = await pool.shareObject(FieldInterpolation.cellArray(field));
+
+    final parts = await pool.forRanges(
+      cells.length,
+      (start, end) => _contourTask(
+        meshKey,
+        geometryKey,
+        pointKey,
+        cellKey,
+        cells.sublist(start, end),
+        iso,
+      ),
+      minChunk: 1024,
+    );
+    return TriangleSurface.concat(parts);
+  }
+
+  static WorkerTask<_RangeIndex> _buildIndexTask(
+    int meshKey,
+    int pointKey,
+    int cellKey,
+  ) =>
+      (store) => _buildIndex(
+            store[meshKey] as MeshArrays,
+            store[pointKey] as Float64List,
+            store[cellKey] as Float64List,
+          );
+
+  static _RangeIndex _buildIndex(
+    MeshArrays m,
+    Float64List pointValues,
+    Float64List cellValues,
+  ) {
+    final nCells = m.nCells;
+    final cellMin = Float64List(nCells);
+    final cellMax = Float64List(nCells);
+    for (int c = 0; c < nCells; c++) {
+      final v = c < cellValues.length ? cellValues[c] : 0.0;
+      cellMin[c] = v;
+      cellMax[c] = v;
+    }
+
+    void include(int cell, double lo, double hi) {
+      if (lo < cellMin[cell]) cellMin[cell] = lo;
+      if (hi > cellMax[cell]) cellMax[cell] = hi;
+    }
+
+    for (int f = 0; f < m.nFaces; f++) {
+      double lo = double.infinity;
+      double hi = double.negativeInfinity;
+      for (int i = m.faceOffsets[f]; i < m.faceOffsets[f + 1]; i++) {
+        final v = pointValues[m.faceVertices[i]];
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+      }
+      if (f < m.owner.length) include(m.owner[f], lo, hi);
+      if (f < m.nInternalFaces) include(m.neighbour[f], lo, hi);
+    }
+
+    final (order, sortedMin) = SortUtils.argsort(cellMin);
+    final sortedMax = Float64List(nCells);
+    double highest = double.negativeInfinity;
+    for (int i = 0; i < nCells; i++) {
+      sortedMax[i] = cellMax[order[i]];
+      if (sortedMax[i] > highest) highest = sortedMax[i];
+    }
+
+    const blockSize = _RangeIndex.blockSize;
+    final nBlocks = (nCells + blockSize - 1) ~/ blockSize;
+    final blockMax = Float64List(nBlocks)
+      ..fillRange(0, nBlocks, double.negativeInfinity);
+    for (int i = 0; i < nCells; i++) {
+      final block = i ~/ blockSize;
+      if (sortedMax[i] > blockMax[block]) blockMax[block] = sortedMax[i];
+    }
+
+    return _RangeIndex(
+      order,
+      sortedMin,
+      sortedMax,
+      blockMax,
+      nCells > 0 ? sortedMin.first : 0,
+      nCells > 0 ? highest : 1,
+    );
+  }
+
+  static WorkerTask<TriangleSurface> _contourTask(
+    int meshKey,
+    int geometryKey,
+    int pointKey,
+    int cellKey,
+    Int32List cells,
+    double iso,
+  ) =>
+      (store) => contourCells(
+            store[meshKey] as MeshArrays,
+            store[geometryKey] as MeshGeometry,
+            cells,
+            store[pointKey] as Float64List,
+            store[cellKey] as Float64List,
+            iso,
+          );
+
+  /// Marching tetrahedra over the decomposed [cells]
+  static TriangleSurface contourCells(
+    MeshArrays m,
+    MeshGeometry geometry,
+    Int32List cells,
+    Float64List pointValues,
+    Float64List cellValues,
+    double iso,
+  ) {
+    final out = TriangleSurfaceBuilder();
+    final marcher = _TetMarcher(out, iso, m.nPoints + m.nFaces + m.nCells);
+    final tet = marcher.tet;
+    final ids = marcher.ids;
+    final points = m.points;
+    final faceCentres = geometry.faceCentres;
+    final cellCentres = geometry.cellCentres;
+
+    for (final cell in cells) {
+      final faceStart = m.cellFaceOffsets[cell];
+      final faceEnd = m.cellFaceOffsets[cell + 1];
+      tet[0] = cellCentres[cell * 3];
+      tet[1] = cellCentres[cell * 3 + 1];
+      tet[2] = cellCentres[cell * 3 + 2];
+      tet[3] = cell < cellValues.length ? cellValues[cell] : double.nan;
+      ids[0] = m.nPoints + m.nFaces + cell;
+
+      for (int k = faceStart; k < faceEnd; k++) {
+        final encoded = m.cellFaces[k];
+        final f = encoded >= 0 ? encoded : ~encoded;
+        final start = m.faceOffsets[f];
+        final end = m.faceOffsets[f + 1];
+        final n = end - start;
+
+        double fv = 0;
+        for (int i = start; i < end; i++) {
+          fv += pointValues[m.faceVertices[i]];
+        }
+        tet[4] = faceCentres[f * 3];
+        tet[5] = faceCentres[f * 3 + 1];
+        tet[6] = faceCentres[f * 3 + 2];
+        tet[7] = fv / n;
+        ids[1] = m.nPoints + f;
+
+        for (int i = start; i < end; i++) {
+          final a = m.faceVertices[i];
+          final b = m.faceVertices[i + 1 < end ? i + 1 : start];
+          tet[8] = points[a * 3];
+          tet[9] = points[a * 3 + 1];
+          tet[10] = points[a * 3 + 2];
+          tet[11] = pointValues[a];
+          tet[12] = points[b * 3];
+          tet[13] = points[b * 3 + 1];
+          tet[14] = points[b * 3 + 2];
+          tet[15] = pointValues[b];
+          ids[2] = a;
+          ids[3] = b;
+          marcher.march();
+        }
+      }
+    }
+    return out.build();
+  }
+}
+
+/// Marching tetrahedra for one chunk of cells.
+///
+/// Tetrahedron corners are mesh points, face centres and cell centres, each
+/// with a node id ([ids]), so a cut edge is identified by its two node ids.
+/// Tetrahedra of a cell (and neighbouring cells in the chunk) share edges;
+/// each cut is emitted once and reused, so the surface shares its vertices
+/// instead of repeating one per triangle corner.
+class _TetMarcher {
+  // Corner pairs (lone corner, then the other three) and, for two corners
+  // on each side, (a, b | c, d) with a, b the corners in the mask
+  static const List<List<int>> _others = [
+    [1, 2, 3],
+    [0, 2, 3],
+    [0, 1, 3],
+    [0, 1, 2],
+  ];
+  static const List<List<int>?> _pairs = [
+    null, null, null, [0, 1, 2, 3],
+    null, [0, 2, 1, 3], [1, 2, 0, 3], null,
+    null, [0, 3, 1, 2], [1, 3, 0, 2], null,
+    [2, 3, 0, 1], null, null, null,
+  ];
+
+  final TriangleSurfaceBuilder out;
+  final double iso;
+  final int nodes; // Node ids are below this
+
+  /// Corners of the current tetrahedron: x, y, z, value for each of four
+  final Float64List tet = Float64List(16);
+
+  /// Node id of each corner
+  final List<int> ids = List<int>.filled(4, 0);
+
+  final Map<int, int> _cuts = {};
+
+  _TetMarcher(this.out, this.iso, this.nodes);
+
+  /// Emits the part of the iso-surface inside the current tetrahedron
+  void march() {
+    int mask = 0;
+    for (int k = 0; k < 4; k++) {
+      if (tet[k * 4 + 3] >= iso) mask |= 1 << k;
+    }
+    if (mask == 0 || mask == 15) return;
+
+    final pair = _pairs[mask];
+    if (pair == null) {
+      // One corner on its own side: a triangle around it
+      final lone = switch (mask) {
+        1 || 14 => 0,
+        2 || 13 => 1,
+        4 || 11 => 2,
+        _ => 3,
+      };
+      final others = _others[lone];
+      out.addTriangle(
+        _cut(lone, others[0]),
+        _cut(lone, others[1]),
+        _cut(lone, others[2]),
+      );
+      return;
+    }
+
+    // Two corners on each side: a quad across the four crossing edges
+    final a = pair[0], b = pair[1], c = pair[2], d = pair[3];
+    final p0 = _cut(a, c);
+    final p1 = _cut(a, d);
+    final p2 = _cut(b, d);
+    final p3 = _cut(b, c);
+    out.addTriangle(p0, p1, p2);
+    out.addTriangle(p0, p2, p3);
+  }
+
+  // Vertex where the surface crosses edge (i, j), emitted on first use
+  int _cut(int i, int j) {
+    final u = ids[i], v = ids[j];
+    final key = u < v ? u * nodes + v : v * nodes + u;
+    final existing = _cuts[key];
+    if (existing != null) return existing;
+
+    final vi = tet[i * 4 + 3];
+    final vj = tet[j * 4 + 3];
+    final t = vj == vi ? 0.5 : (iso - vi) / (vj - vi);
+    final vertex = out.addVertex(
+      tet[i * 4] + (tet[j * 4] - tet[i * 4]) * t,
+      tet[i * 4 + 1] + (tet[j * 4 + 1] - tet[i * 4 + 1]) * t,
+      tet[i * 4 + 2] + (tet[j * 4 + 2] - tet[i * 4 + 2]) * t,
+      iso,
+    );
+    _cuts[key] = vertex;
+    return vertex;
+  }
+}
@@ -0,0 +1,143 @@
+// lib/filters/line_sampler.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/cell_locator.dart';
+import '../utils/mesh_arrays.dart';
+
+/// Plot-over-line: samples a field at evenly spaced points along a segment.
+///
+/// The containing cell of every sample is remembered. When the segment moves,
+/// a sample whose new position is still inside its old cell keeps it; only
+/// the samples that left their cell are located again, in one batch through
+/// [CellLocator.locateAllSync]. A line has at most a few thousand samples and
+/// consecutive ones mostly share or neighbour a cell, which the batch uses as
+/// its walk hint, so this is cheaper than sharing the locator with workers.
+class LineSampler {
+  final PolyMesh mesh;
+
+  CellLocator? _locator;
+  Float64List _xyz = Float64List(0);
+  Int32List _cells = Int32List(0);
+  Float64List _distances = Float64List(0);
+  int _relocated = 0;
+
+  LineSampler(this.mesh);
+
+  /// Sample positions (x, y, z per sample)
+  Float64List get positions => _xyz;
+
+  /// Containing cell per sample, or -1 outside the mesh
+  Int32List get cells => _cells;
+
+  /// Distance of each sample from the start of the line
+  Float64List get distances => _distances;
+
+  /// Samples that needed a full lookup in the last [update]
+  int get relocated => _relocated;
+
+  /// Moves the line to [start]..[end] with [count] samples
+  Future<void> update(Vector3 start, Vector3 end, int count) async {
+    final locator = await CellLocator.of(mesh);
+    final xyz = Float64List(count * 3);
+    final distances = Float64List(count);
+    final length = math.sqrt(
+      math.pow(end.x - start.x, 2) +
+          math.pow(end.y - start.y, 2) +
+          math.pow(end.z - start.z, 2),
+    );
+    for (int i = 0; i < count; i++) {
+      final t = count > 1 ? i / (count - 1) : 0.0;
+      xyz[i * 3] = start.x + (end.x - start.x) * t;
+      xyz[i * 3 + 1] = start.y + (end.y - start.y) * t;
+      xyz[i * 3 + 2] = start.z + (end.z - start.z) * t;
+      distances[i] = length * t;
+    }
+
+    // Keep cells that still contain their sample
+    final cells = Int32List(count)..fillRange(0, count, -1);
+    final stale = <int>[];
+    final sameCount = count == _cells.length;
+    for (int i = 0; i < count; i++) {
+      final previous = sameCount ? _cells[i] : -1;
+      if (previous >= 0 &&
+          locator.contains(previous, xyz[i * 3], xyz[i * 3 + 1], xyz[i * 3 + 2])) {
+        cells[i] = previous;
+      } else {
+        stale.add(i);
+      }
+    }
+
+    if (stale.isNotEmpty) {
+      final batch = Float64List(stale.length * 3);
+      for (int n = 0; n < stale.length; n++) {
+        batch.setRange(n * 3, n * 3 + 3, xyz, stale[n] * 3);
+      }
+      final found = locator.locateAllSync(batch);
+      for (int n = 0; n < stale.length; n++) {
+        cells[stale[n]] = found[n];
+      }
+    }
+
+    _locator = locator;
+    _xyz = xyz;
+    _cells = cells;
+    _distances = distances;
+    _relocated = stale.length;
+  }
+
+  /// Field values at the samples (NaN outside the mesh).
+  ///
+  /// With [pointValues] (see `FieldInterpolation.cellToPoint`) each sample is
+  /// an inverse-distance blend of its cell's vertex values; otherwise it takes
+  /// the cell value.
+  Float64List sample(List<double> cellValues, {List<double>? pointValues}) {
+    final values = Float64List(_cells.length);
+    final arrays = pointValues != null ? MeshArrays.of(mesh) : null;
+    final locator = _locator;
+
+    for (int i = 0; i < _cells.length; i++) {
+      final cell = _cells[i];
+      if (cell < 0 || cell >= cellValues.length) {
+        values[i] = double.nan;
+      } else if (arrays != null && locator != null) {
+        values[i] = _blend(arrays, locator, cell, i, pointValues!);
+      } else {
+        values[i] = cellValues[cell];
+      }
+    }
+    return values;
+  }
+
+  // Inverse-distance weighting over the cell's vertices
+  double _blend(
+    MeshArrays arrays,
+    CellLocator locator,
+    int cell,
+    int sample,
+    List<double> pointValues,
+  ) {
+    final x = _xyz[sample * 3], y = _xyz[sample * 3 + 1], z = _xyz[sample * 3 + 2];
+    final seen = <int>{};
+    double weighted = 0;
+    double weights = 0;
+    for (int k = locator.cellFaceOffsets[cell]; k < locator.cellFaceOffsets[cell + 1]; k++) {
+      final encoded = locator.cellFaces[k];
+      final f = encoded >= 0 ? encoded : ~encoded;
+      for (int i = arrays.faceOffsets[f]; i < arrays.faceOffsets[f + 1]; i++) {
+        final p = arrays.faceVertices[i];
+        if (!seen.add(p) || p >= pointValues.length) continue;
+        final dx = arrays.points[p * 3] - x;
+        final dy = arrays.points[p * 3 + 1] - y;
+        final dz = arrays.points[p * 3 + 2] - z;
+        final d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 == 0) return pointValues[p];
+        weighted += pointValues[p] / d2;
+        weights += 1 / d2;
+      }
+    }
+    return weights > 0 ? weighted / weights : double.nan;
+  }
+}
@@ -0,0 +1,237 @@
+// lib/filters/patch_integrals.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../readers/frame_pipeline.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/mesh_geometry.dart';
+import '../utils/worker_pool.dart';
+
+/// Area-weighted quantities of a field over one boundary patch
+class PatchIntegral {
+  final String name;
+  final double area;
+  final double? integral; // Sum of value * |S|; null for surface fields
+  final double? flux; // Sum of U . S for vectors, of the face values for surface fields
+
+  const PatchIntegral({
+    required this.name,
+    required this.area,
+    this.integral,
+    this.flux,
+  });
+
+  /// Area-weighted average, or null for surface fields
+  double? get average {
+    final integral = this.integral;
+    if (integral == null) return null;
+    return area > 0 ? integral / area : double.nan;
+  }
+}
+
+/// Per-patch area, integral, average and flux of a field, e.g. the mass
+/// flow through an outlet or the mean pressure on a wall.
+///
+/// The field's values at the boundary faces are gathered here first: its
+/// own for surface fields, whose only meaningful sum is the flux; each
+/// patch's boundaryField value otherwise, or the owner cell's where the
+/// patch has none. Chunks on [WorkerPool.shared] are each sent
+/// their slice, walk the face-to-patch mapping with the face area vectors
+/// and return their own per-patch sums, which are added up here.
+class PatchIntegrals {
+  static const int _sums = 3; // Area, integral, flux per patch
+
+  /// Integrals of [field] over every patch of [mesh]
+  static Future<List<PatchIntegral>> compute(PolyMesh mesh, FieldData field) async {
+    final arrays = MeshArrays.of(mesh);
+    final geometry = await MeshGeometry.of(mesh);
+    final pool = WorkerPool.shared;
+    final meshKey = await pool.shareObject(arrays);
+    final geometryKey = await pool.shareObject(geometry);
+    final (values, vectors) = boundaryValues(arrays, field);
+    final onFaces = field.isFaceField;
+
+    final parts = await pool.forRanges(
+      arrays.nFaces - arrays.nInternalFaces,
+      (start, end) => _accumulateTask(
+        meshKey,
+        geometryKey,
+        values.sublist(start, end),
+        vectors?.sublist(start * 3, end * 3),
+        onFaces,
+        start,
+        end,
+      ),
+      minChunk: 65536,
+    );
+    final sums = Float64List(arrays.patchNames.length * _sums);
+    for (final part in parts) {
+      for (int i = 0; i < sums.length; i++) {
+        sums[i] += part[i];
+      }
+    }
+    return results(arrays, sums, onFaces: onFaces, hasFlux: onFaces || vectors != null);
+  }
+
+  static WorkerTask<Float64List> _accumulateTask(
+    int meshKey,
+    int geometryKey,
+    Float64List values,
+    Float64List? vectors,
+    bool onFaces,
+    int start,
+    int end,
+  ) =>
+      (store) => accumulate(
+            store[meshKey] as MeshArrays,
+            (store[geometryKey] as MeshGeometry).faceAreas,
+            values,
+            vectors,
+            onFaces: onFaces,
+            start: start,
+            end: end,
+          );
+
+  /// Values of [field] at every boundary face: the field's own face values
+  /// for surface fields; otherwise each patch's values from its
+  /// boundaryField, or the owner cell's on patches without any
+  /// (zeroGradient and the like), with the vector (x, y, z per face) for
+  /// vector fields
+  static (Float64List, Float64List?) boundaryValues(MeshArrays m, FieldData field) {
+    final nBoundary = m.nFaces - m.nInternalFaces;
+    final values = Float64List(nBoundary);
+    final faceValues = field.faceValues;
+    if (faceValues != null) {
+      for (int b = 0; b < nBoundary && m.nInternalFaces + b < faceValues.length; b++) {
+        values[b] = faceValues[m.nInternalFaces + b];
+      }
+      return (values, null);
+    }
+
+    final cells = FieldInterpolation.cellArray(field);
+    final cellVectors = field.vectors;
+    final vectors = cellVectors != null ? Float64List(nBoundary * 3) : null;
+    for (int b = 0; b < nBoundary; b++) {
+      final cell = m.owner[m.nInternalFaces + b];
+      if (cell < cells.length) values[b] = cells[cell];
+      if (vectors != null && cell * 3 + 2 < cellVectors!.length) {
+        vectors[b * 3] = cellVectors[cell * 3];
+        vectors[b * 3 + 1] = cellVectors[cell * 3 + 1];
+        vectors[b * 3 + 2] = cellVectors[cell * 3 + 2];
+      }
+    }
+
+    // Patch values replace the owner cell's; a uniform one fills the patch
+    final components = vectors != null ? 3 : 1;
+    for (int p = 0; p < m.patchNames.length; p++) {
+      final patch = field.boundaryField[m.patchNames[p]];
+      if (patch is! List<double> || patch.length < components) continue;
+      final tuples = patch.length ~/ components;
+      final first = m.patchStarts[p] - m.nInternalFaces;
+      for (int i = 0; i < m.patchSizes[p] && first + i < nBoundary; i++) {
+        final o = math.min(i, tuples - 1) * components;
+        final b = first + i;
+        if (vectors == null) {
+          values[b] = patch[o];
+          continue;
+        }
+        final x = patch[o], y = patch[o + 1], z = patch[o + 2];
+        vectors[b * 3] = x;
+        vectors[b * 3 + 1] = y;
+        vectors[b * 3 + 2] = z;
+        values[b] = math.sqrt(x * x + y * y + z * z);
+      }
+    }
+    return (values, vectors);
+  }
+
+  /// Per-patch area, integral and flux sums over boundary faces
+  /// [start]..[end) (counted from the first boundary face). [values] and
+  /// [vectors] hold that range of [boundaryValues]; with [onFaces] the
+  /// values are fluxes already and no integral is summed.
+  static Float64List accumulate(
+    MeshArrays m,
+    Float64List faceAreas,
+    Float64List values,
+    Float64List? vectors, {
+    required bool onFaces,
+    required int start,
+    required int end,
+  }) {
+    final sums = Float64List(m.patchNames.length * _sums);
+    final facePatch = m.boundaryFacePatch;
+
+    for (int b = start; b < end; b++) {
+      final patch = facePatch[b];
+      if (patch < 0) continue;
+      final f = m.nInternalFaces + b;
+      final sx = faceAreas[f * 3], sy = faceAreas[f * 3 + 1], sz = faceAreas[f * 3 + 2];
+      final area = math.sqrt(sx * sx + sy * sy + sz * sz);
+      final i = b - start;
+      final value = values[i];
+      final o = patch * _sums;
+      sums[o] += area;
+      if (onFaces) {
+        sums[o + 2] += value; // Surface fields such as phi are fluxes already
+        continue;
+      }
+      sums[o + 1] += value * area;
+      if (vectors != null) {
+        sums[o + 2] += vectors[i * 3] * sx + vectors[i * 3 + 1] * sy + vectors[i * 3 + 2] * sz;
+      }
+    }
+    return sums;
+  }
+
+  /// Rows for the summed [sums] of every patch
+  static List<PatchIntegral> results(
+    MeshArrays m,
+    Float64List sums, {
+    required bool onFaces,
+    required bool hasFlux,
+  }) {
+    return [
+      for (int p = 0; p < m.patchNames.length; p++)
+        PatchIntegral(
+          name: m.patchNames[p],
+          area: sums[p * _sums],
+          integral: onFaces ? null : sums[p * _sums + 1],
+          flux: hasFlux ? sums[p * _sums + 2] : null,
+        ),
+    ];
+  }
+
+  /// Integrals of [fieldName] at every time directory, in order, as a
+  /// background job: fields are decoded [lookAhead] steps ahead on the
+  /// worker pool and each step's rows are emitted as soon as they are
+  /// summed. Cancelling the subscription stops the job.
+  static Stream<(int, List<PatchIntegral>)> overTime({
+    required String casePath,
+    required PolyMesh mesh,
+    required String fieldName,
+    required List<String> timeDirectories,
+    int lookAhead = 4,
+  }) async* {
+    final pipeline = FramePipeline(
+      casePath: casePath,
+      mesh: mesh,
+      fieldName: fieldName,
+      timeDirectories: timeDirectories,
+    );
+    try {
+      for (int index = 0; index < timeDirectories.length; index++) {
+        pipeline.retain([
+          for (int k = index; k < index + lookAhead && k < timeDirectories.length; k++) k,
+        ]);
+        final field = await pipeline.frame(index);
+        if (field == null) continue;
+        yield (index, await compute(mesh, field));
+      }
+    } finally {
+      pipeline.close();
+    }
+  }
+}
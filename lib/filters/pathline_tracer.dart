@@ -0,0 +1,369 @@
+// lib/filters/pathline_tracer.dart
+
+import 'dart:convert';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../parsers/foam_file_parser.dart';
+import '../utils/cell_locator.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/file_utils.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/worker_pool.dart';
+import 'polylines.dart';
+import 'stream_tracer.dart';
+
+/// Point velocities of successive time steps, loaded ahead in the
+/// background and held on the workers, at most [window] at a time.
+///
+/// Files are read on the main isolate (I/O is asynchronous there), parsed
+/// and averaged to the points on a worker, then shared with every worker
+/// under a key of their own. Steps that fall behind the window are released.
+/// A uniform internalField (the usual `0/U`) is expanded to every cell.
+class VelocityStream {
+  static const int window = 3;
+
+  final String casePath;
+  final String fieldName;
+  final List<String> timeDirectories;
+  final int meshKey; // MeshArrays shared on the pool
+  final Map<int, Future<int>> _loaded = {}; // Time index -> pool key
+
+  VelocityStream(this.casePath, this.fieldName, this.timeDirectories, this.meshKey);
+
+  /// Pool key of the point velocities at time index [index]
+  Future<int> keyFor(int index) => _loaded[index] ??= _load(index);
+
+  /// Keeps [first]..[first + window) and starts loading the ones not yet
+  /// requested; everything else is released
+  void advance(int first) {
+    for (final index in _loaded.keys.toList()) {
+      if (index < first || index >= first + window) {
+        final key = _loaded.remove(index)!;
+        key.then(WorkerPool.shared.release, onError: (_) {});
+      }
+    }
+    for (int index = first; index < first + window; index++) {
+      if (index < timeDirectories.length) keyFor(index);
+    }
+  }
+
+  /// Releases every loaded step
+  void close() => advance(timeDirectories.length);
+
+  Future<int> _load(int index) async {
+    final pool = WorkerPool.shared;
+    final raw = await FileUtils.readFileBytes(
+      '$casePath/${timeDirectories[index]}/$fieldName',
+    );
+    final bytes = raw is Uint8List ? raw : Uint8List.fromList(raw);
+    final pointVectors = await pool.run(
+      _parseTask(meshKey, bytes, '${timeDirectories[index]}/$fieldName'),
+    );
+    final key = WorkerPool.newKey();
+    await pool.share(key, pointVectors);
+    return key;
+  }
+
+  static WorkerTask<Float64List> _parseTask(
+    int meshKey,
+    Uint8List bytes,
+    String label,
+  ) =>
+      (store) {
+        final mesh = store[meshKey] as MeshArrays;
+        final content = utf8.decode(bytes, allowMalformed: true);
+        final vectors = FoamFileParser.parseUniformField(content, 3, mesh.nCells) ??
+            FoamFileParser.parseVectorField(content);
+        if (vectors.length != mesh.nCells * 3) {
+          throw FormatException(
+            '$label has ${vectors.length ~/ 3} vectors for ${mesh.nCells} cells',
+          );
+        }
+        return FieldInterpolation.vectorsToPoints(vectors, mesh);
+      };
+}
+
+/// Particles between two time steps: positions (x, y, z), containing cells
+/// (-1 once a particle has left the mesh) and speeds at the end time
+class ParticleState {
+  final Float64List positions;
+  final Int32List cells;
+  final Float64List speeds;
+
+  const ParticleState(this.positions, this.cells, this.speeds);
+}
+
+/// Pathlines: particles advected through the time directories of a case.
+///
+/// Within each interval between two stored steps the velocity is linearly
+/// interpolated in time and particles move with RK4 sub-steps sized to
+/// their cell, walking cell to cell like [StreamTracer]. Only the two
+/// velocity fields of the current interval are held, plus the next one
+/// loading ahead in a [VelocityStream], so runs of any length fit in
+/// memory. Particles are split across [WorkerPool.shared] every interval.
+/// Time directories without the velocity file are skipped, so an interval
+/// can span several stored steps.
+class PathlineTracer {
+  final String casePath;
+  final PolyMesh mesh;
+  final String fieldName;
+  final List<String> timeDirectories; // Ascending
+
+  PathlineTracer({
+    required this.casePath,
+    required this.mesh,
+    required this.fieldName,
+    required this.timeDirectories,
+  });
+
+  static double _timeOf(String directory, int index) =>
+      double.tryParse(directory) ?? index.toDouble();
+
+  /// Releases [seeds] (x, y, z triples) at time index [first] and follows
+  /// them to [last] (default: the final step). One pathline point is kept
+  /// per time step; lines are coloured by speed.
+  Future<Polylines> trace(
+    Float64List seeds, {
+    int first = 0,
+    int? last,
+    double stepFraction = 0.25,
+    void Function(int done, int total)? onProgress,
+    bool Function()? isCancelled,
+  }) async {
+    final end = last ?? timeDirectories.length - 1;
+    final nParticles = seeds.length ~/ 3;
+    final locator = await CellLocator.of(mesh);
+    final pool = WorkerPool.shared;
+    final meshKey = await pool.shareObject(MeshArrays.of(mesh));
+    final locatorKey = await pool.shareObject(locator);
+
+    // Time indices in [first, end] that have the velocity field
+    final present = await Future.wait([
+      for (int i = first; i <= end; i++)
+        FileUtils.fileExists('$casePath/${timeDirectories[i]}/$fieldName'),
+    ]);
+    final steps = [
+      for (int i = first; i <= end; i++)
+        if (present[i - first]) i,
+    ];
+    final stream = VelocityStream(
+      casePath,
+      fieldName,
+      [for (final i in steps) timeDirectories[i]],
+      meshKey,
+    );
+
+    // Trajectory samples per time step
+    final history = <ParticleState>[];
+    final cells = Int32List(nParticles);
+    for (int p = 0; p < nParticles; p++) {
+      cells[p] = locator.locate(seeds[p * 3], seeds[p * 3 + 1], seeds[p * 3 + 2]);
+    }
+    var state = ParticleState(Float64List.fromList(seeds), cells, Float64List(nParticles));
+    history.add(state);
+
+    try {
+      if (steps.length > 1) {
+        stream.advance(0);
+        final speeds = await pool.run(
+          _speedTask(meshKey, locatorKey, await stream.keyFor(0), state),
+        );
+        state.speeds.setAll(0, speeds);
+      }
+      // Stream positions, one per entry of steps
+      for (int step = 0; step + 1 < steps.length; step++) {
+        if (isCancelled?.call() ?? false) break;
+        stream.advance(step);
+        final key0 = await stream.keyFor(step);
+        final key1 = await stream.keyFor(step + 1);
+        final t0 = _timeOf(timeDirectories[steps[step]], steps[step]);
+        final t1 = _timeOf(timeDirectories[steps[step + 1]], steps[step + 1]);
+
+        final current = state;
+        final parts = await pool.forRanges(
+          nParticles,
+          (start, stop) => _advectTask(
+            meshKey,
+            locatorKey,
+            key0,
+            key1,
+            t0,
+            t1,
+            current.positions.sublist(start * 3, stop * 3),
+            current.cells.sublist(start, stop),
+            stepFraction,
+          ),
+          minChunk: 16,
+        );
+        state = _join(parts, nParticles);
+        history.add(state);
+        onProgress?.call(step + 1, steps.length - 1);
+        if (!state.cells.any((cell) => cell >= 0)) break;
+      }
+    } finally {
+      stream.close();
+    }
+
+    return _pathlines(history, nParticles);
+  }
+
+  static ParticleState _join(List<ParticleState> parts, int n) {
+    if (parts.length == 1) return parts.first;
+    final positions = Float64List(n * 3);
+    final cells = Int32List(n);
+    final speeds = Float64List(n);
+    int offset = 0;
+    for (final part in parts) {
+      positions.setAll(offset * 3, part.positions);
+      cells.setAll(offset, part.cells);
+      speeds.setAll(offset, part.speeds);
+      offset += part.cells.length;
+    }
+    return ParticleState(positions, cells, speeds);
+  }
+
+  // One line per particle, up to the last step it was inside the mesh
+  static Polylines _pathlines(List<ParticleState> history, int nParticles) {
+    final out = PolylinesBuilder();
+    for (int p = 0; p < nParticles; p++) {
+      for (final state in history) {
+        if (state.cells[p] < 0) break;
+        out.addPoint(
+          state.positions[p * 3],
+          state.positions[p * 3 + 1],
+          state.positions[p * 3 + 2],
+          state.speeds[p],
+        );
+      }
+      out.endLine();
+    }
+    return out.build();
+  }
+
+  static WorkerTask<Float64List> _speedTask(
+    int meshKey,
+    int locatorKey,
+    int vectorKey,
+    ParticleState state,
+  ) =>
+      (store) {
+        final sampler = FlowSampler(
+          store[meshKey] as MeshArrays,
+          store[locatorKey] as CellLocator,
+        );
+        final vectors = store[vectorKey] as Float64List;
+        final speeds = Float64List(state.cells.length);
+        final u = Float64List(3);
+        for (int p = 0; p < speeds.length; p++) {
+          final cell = state.cells[p];
+          if (cell < 0) continue;
+          final xyz = state.positions;
+          sampler.sample(vectors, cell, xyz[p * 3], xyz[p * 3 + 1], xyz[p * 3 + 2], u);
+          speeds[p] = math.sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        }
+        return speeds;
+      };
+
+  static WorkerTask<ParticleState> _advectTask(
+    int meshKey,
+    int locatorKey,
+    int key0,
+    int key1,
+    double t0,
+    double t1,
+    Float64List positions,
+    Int32List cells,
+    double stepFraction,
+  ) =>
+      (store) => advect(
+            FlowSampler(
+              store[meshKey] as MeshArrays,
+              store[locatorKey] as CellLocator,
+            ),
+            store[key0] as Float64List,
+            store[key1] as Float64List,
+            t0,
+            t1,
+            positions,
+            cells,
+            stepFraction: stepFraction,
+          );
+
+  /// Moves particles from [t0] to [t1] through the velocities [u0] at t0
+  /// and [u1] at t1 (point vectors), blended linearly in time
+  static ParticleState advect(
+    FlowSampler sampler,
+    Float64List u0,
+    Float64List u1,
+    double t0,
+    double t1,
+    Float64List positions,
+    Int32List cells, {
+    double stepFraction = 0.25,
+    int maxSubSteps = 10000,
+  }) {
+    final n = cells.length;
+    final out = Float64List.fromList(positions);
+    final outCells = Int32List.fromList(cells);
+    final speeds = Float64List(n);
+    final span = t1 - t0;
+
+    final a = Float64List(3);
+    final b = Float64List(3);
+    final k1 = Float64List(3);
+    final k2 = Float64List(3);
+    final k3 = Float64List(3);
+    final k4 = Float64List(3);
+
+    // Velocity at time t into k; returns the containing cell, or -1 when
+    // the point is outside the mesh
+    int velocity(int hint, double x, double y, double z, double t, Float64List k) {
+      final cell = sampler.walk(hint, x, y, z);
+      if (cell < 0) return -1;
+      final s = span > 0 ? ((t - t0) / span).clamp(0.0, 1.0) : 0.0;
+      sampler.sample(u0, cell, x, y, z, a);
+      sampler.sample(u1, cell, x, y, z, b);
+      k[0] = a[0] + (b[0] - a[0]) * s;
+      k[1] = a[1] + (b[1] - a[1]) * s;
+      k[2] = a[2] + (b[2] - a[2]) * s;
+      return cell;
+    }
+
+    for (int p = 0; p < n; p++) {
+      int cell = outCells[p];
+      if (cell < 0) continue;
+      double x = out[p * 3], y = out[p * 3 + 1], z = out[p * 3 + 2];
+      double t = t0;
+
+      for (int sub = 0; sub < maxSubSteps && t < t1 && cell >= 0; sub++) {
+        velocity(cell, x, y, z, t, k1);
+        final speed = math.sqrt(k1[0] * k1[0] + k1[1] * k1[1] + k1[2] * k1[2]);
+        if (speed < 1e-30) break;
+        final h = math.min(stepFraction * sampler.cellSize(cell) / speed, t1 - t);
+
+        if (velocity(cell, x + h / 2 * k1[0], y + h / 2 * k1[1], z + h / 2 * k1[2], t + h / 2, k2) < 0 ||
+            velocity(cell, x + h / 2 * k2[0], y + h / 2 * k2[1], z + h / 2 * k2[2], t + h / 2, k3) < 0 ||
+            velocity(cell, x + h * k3[0], y + h * k3[1], z + h * k3[2], t + h, k4) < 0) {
+          cell = -1;
+          break;
+        }
+        x += h / 6 * (k1[0] + 2 * k2[0] + 2 * k3[0] + k4[0]);
+        y += h / 6 * (k1[1] + 2 * k2[1] + 2 * k3[1] + k4[1]);
+        z += h / 6 * (k1[2] + 2 * k2[2] + 2 * k3[2] + k4[2]);
+        cell = sampler.walk(cell, x, y, z);
+        t += h;
+      }
+
+      out[p * 3] = x;
+      out[p * 3 + 1] = y;
+      out[p * 3 + 2] = z;
+      outCells[p] = cell;
+      if (cell >= 0 && velocity(cell, x, y, z, t1, k1) >= 0) {
+        speeds[p] = math.sqrt(k1[0] * k1[0] + k1[1] * k1[1] + k1[2] * k1[2]);
+      }
+    }
+    return ParticleState(out, outCells, speeds);
+  }
+}
@@ -0,0 +1,95 @@
+// lib/filters/polylines.dart
+
+import 'dart:typed_data';
+
+/// Line output of a filter (streamlines, pathlines)
+class Polylines {
+  final Float64List positions; // x, y, z per point
+  final Float64List values; // Value per point, e.g. speed
+  final Int32List offsets; // Line l uses points offsets[l]..offsets[l+1]
+
+  const Polylines(this.positions, this.values, this.offsets);
+
+  static final Polylines empty =
+      Polylines(Float64List(0), Float64List(0), Int32List(1));
+
+  int get lineCount => offsets.length - 1;
+  int get pointCount => values.length;
+  bool get isEmpty => values.isEmpty;
+
+  /// Joins per-chunk results, keeping their order
+  static Polylines concat(List<Polylines> parts) {
+    if (parts.length == 1) return parts.first;
+    int points = 0;
+    int lines = 0;
+    for (final part in parts) {
+      points += part.pointCount;
+      lines += part.lineCount;
+    }
+    final positions = Float64List(points * 3);
+    final values = Float64List(points);
+    final offsets = Int32List(lines + 1);
+    int p = 0;
+    int l = 0;
+    for (final part in parts) {
+      positions.setAll(p * 3, part.positions);
+      values.setAll(p, part.values);
+      for (int i = 1; i <= part.lineCount; i++) {
+        offsets[l + i] = part.offsets[i] + p;
+      }
+      p += part.pointCount;
+      l += part.lineCount;
+    }
+    return Polylines(positions, values, offsets);
+  }
+}
+
+/// Growable buffers for building [Polylines] inside a kernel
+class PolylinesBuilder {
+  Float64List _positions = Float64List(3 * 1024);
+  Float64List _values = Float64List(1024);
+  final List<int> _offsets = [0];
+  int _pointCount = 0;
+
+  int get pointCount => _pointCount;
+
+  void addPoint(double x, double y, double z, double value) {
+    if (_pointCount == _values.length) {
+      _values = Float64List(_values.length * 2)..setAll(0, _values);
+      _positions = Float64List(_positions.length * 2)..setAll(0, _positions);
+    }
+    _positions[_pointCount * 3] = x;
+    _positions[_pointCount * 3 + 1] = y;
+    _positions[_pointCount * 3 + 2] = z;
+    _values[_pointCount++] = value;
+  }
+
+  /// Reverses the order of the points added since [start]
+  void reverseFrom(int start) {
+    for (int i = start, j = _pointCount - 1; i < j; i++, j--) {
+      for (int axis = 0; axis < 3; axis++) {
+        final t = _positions[i * 3 + axis];
+        _positions[i * 3 + axis] = _positions[j * 3 + axis];
+        _positions[j * 3 + axis] = t;
+      }
+      final t = _values[i];
+      _values[i] = _values[j];
+      _values[j] = t;
+    }
+  }
+
+  /// Closes the current line; lines of fewer than two points are dropped
+  void endLine() {
+    if (_pointCount - _offsets.last < 2) {
+      _pointCount = _offsets.last;
+      return;
+    }
+    _offsets.add(_pointCount);
+  }
+
+  Polylines build() => Polylines(
+        _positions.sublist(0, _pointCount * 3),
+        _values.sublist(0, _pointCount),
+        Int32List.fromList(_offsets),
+      );
+}
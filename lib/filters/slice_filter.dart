@@ -0,0 +1,324 @@
+// lib/filters/slice_filter.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/sort_utils.dart';
+import '../utils/worker_pool.dart';
+import 'triangle_surface.dart';
+
+/// Cell extents along one plane normal, sorted for candidate lookup
+class _ExtentIndex {
+  final double nx, ny, nz;
+  final Int32List order; // Cells sorted by their lowest projection
+  final Float64List sortedMin; // n.x minimum of each cell, in [order]
+  final Float64List cellMax; // n.x maximum per cell (by cell id)
+  final double maxSpan; // Largest max - min over all cells
+
+  _ExtentIndex(
+    this.nx,
+    this.ny,
+    this.nz,
+    this.order,
+    this.sortedMin,
+    this.cellMax,
+    this.maxSpan,
+  );
+
+  double get lowest => sortedMin.isEmpty ? 0 : sortedMin.first;
+  double get highest {
+    double highest = double.negativeInfinity;
+    for (final v in cellMax) {
+      if (v > highest) highest = v;
+    }
+    return highest.isFinite ? highest : 0;
+  }
+}
+
+/// Cuts every cell with a plane and returns the coloured polygons.
+///
+/// For a plane normal n, every cell's extent [min, max] of n.x is computed
+/// once and the cells are sorted by min. A cut at offset d can only touch
+/// cells with min in [d - maxSpan, d], found by two binary searches, so
+/// sliding the plane along its normal only visits the cells near it. The
+/// candidates are cut in parallel on [WorkerPool.shared]: each edge that
+/// crosses the plane gives a point, and the points of a cell are ordered
+/// around their centre into a polygon (exact for convex cells).
+class SliceFilter {
+  final PolyMesh mesh;
+  _ExtentIndex? _index;
+
+  SliceFilter(this.mesh);
+
+  static Vector3 _unit(Vector3 n) {
+    final length = math.sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+    if (length == 0) return Vector3(1, 0, 0);
+    return Vector3(n.x / length, n.y / length, n.z / length);
+  }
+
+  Future<_ExtentIndex> _indexFor(Vector3 normal) async {
+    final n = _unit(normal);
+    final existing = _index;
+    if (existing != null &&
+        existing.nx == n.x &&
+        existing.ny == n.y &&
+        existing.nz == n.z) {
+      return existing;
+    }
+
+    final pool = WorkerPool.shared;
+    final meshKey = await pool.shareObject(MeshArrays.of(mesh));
+    final stopwatch = Stopwatch()..start();
+    final index = await pool.run(_buildIndexTask(meshKey, n.x, n.y, n.z));
+    print(
+      'Built slice index for normal (${n.x}, ${n.y}, ${n.z}) in '
+      '${stopwatch.elapsedMilliseconds} ms',
+    );
+    _index = index;
+    return index;
+  }
+
+  /// Range of plane offsets (n.x) that cut the mesh
+  Future<(double, double)> offsetRange(Vector3 normal) async {
+    final index = await _indexFor(normal);
+    return (index.lowest, index.highest);
+  }
+
+  /// Slice by the plane n.x = [offset]. Vertex values are interpolated along
+  /// the cut edges from [pointValues], or taken from [cellValues] per cell.
+  Future<TriangleSurface> cut(
+    Vector3 normal,
+    double offset, {
+    Float64List? pointValues,
+    Float64List? cellValues,
+  }) async {
+    final index = await _indexFor(normal);
+
+    // Cells whose extent contains the offset
+    final first = SortUtils.lowerBound(index.sortedMin, offset - index.maxSpan);
+    final last = SortUtils.upperBound(index.sortedMin, offset, first);
+    final candidates = <int>[];
+    for (int i = first; i < last; i++) {
+      final cell = index.order[i];
+      if (index.cellMax[cell] >= offset) candidates.add(cell);
+    }
+    if (candidates.isEmpty) return TriangleSurface.empty;
+    final cells = Int32List.fromList(candidates);
+
+    final pool = WorkerPool.shared;
+    final meshKey = await pool.shareObject(MeshArrays.of(mesh));
+    final pointKey = pointValues != null ? await pool.shareObject(pointValues) : -1;
+    final cellKey = cellValues != null ? await pool.shareObject(cellValues) : -1;
+
+    final parts = await pool.forRanges(
+      cells.length,
+      (start, end) => _cutTask(
+        meshKey,
+        pointKey,
+        cellKey,
+        cells.sublist(start, end),
+        index.nx,
+        index.ny,
+        index.nz,
+        offset,
+      ),
+      minChunk: 2048,
+    );
+    return TriangleSurface.concat(parts);
+  }
+
+  static WorkerTask<_ExtentIndex> _buildIndexTask(
+    int meshKey,
+    double nx,
+    double ny,
+    double nz,
+  ) =>
+      (store) => _buildIndex(store[meshKey] as MeshArrays, nx, ny, nz);
+
+  static _ExtentIndex _buildIndex(MeshArrays m, double nx, double ny, double nz) {
+    final nCells = m.nCells;
+    final cellMin = Float64List(nCells)..fillRange(0, nCells, double.infinity);
+    final cellMax = Float64List(nCells)
+      ..fillRange(0, nCells, double.negativeInfinity);
+
+    // Every face contributes its vertices to its owner and neighbour
+    for (int f = 0; f < m.nFaces; f++) {
+      double lo = double.infinity;
+      double hi = double.negativeInfinity;
+      for (int i = m.faceOffsets[f]; i < m.faceOffsets[f + 1]; i++) {
+        final p = m.faceVertices[i] * 3;
+        final d = m.points[p] * nx + m.points[p + 1] * ny + m.points[p + 2] * nz;
+        if (d < lo) lo = d;
+        if (d > hi) hi = d;
+      }
+      if (f < m.owner.length) {
+        final c = m.owner[f];
+        if (lo < cellMin[c]) cellMin[c] = lo;
+        if (hi > cellMax[c]) cellMax[c] = hi;
+      }
+      if (f < m.nInternalFaces) {
+        final c = m.neighbour[f];
+        if (lo < cellMin[c]) cellMin[c] = lo;
+        if (hi > cellMax[c]) cellMax[c] = hi;
+      }
+    }
+
+    double maxSpan = 0;
+    for (int c = 0; c < nCells; c++) {
+      final span = cellMax[c] - cellMin[c];
+      if (span > maxSpan) maxSpan = span;
+    }
+
+    final (order, sortedMin) = SortUtils.argsort(cellMin);
+    return _ExtentIndex(nx, ny, nz, order, sortedMin, cellMax, maxSpan);
+  }
+
+  static WorkerTask<TriangleSurface> _cutTask(
+    int meshKey,
+    int pointKey,
+    int cellKey,
+    Int32List cells,
+    double nx,
+    double ny,
+    double nz,
+    double offset,
+  ) =>
+      (store) => cutCells(
+            store[meshKey] as MeshArrays,
+            cells,
+            nx,
+            ny,
+            nz,
+            offset,
+            pointValues: pointKey >= 0 ? store[pointKey] as Float64List : null,
+            cellValues: cellKey >= 0 ? store[cellKey] as Float64List : null,
+          );
+
+  /// Cuts [cells] with the plane n.x = offset (n of unit length)
+  static TriangleSurface cutCells(
+    MeshArrays m,
+    Int32List cells,
+    double nx,
+    double ny,
+    double nz,
+    double offset, {
+    Float64List? pointValues,
+    Float64List? cellValues,
+  }) {
+    final out = TriangleSurfaceBuilder();
+
+    // In-plane axes for ordering the polygon points: u = n x (x or y axis)
+    final ax = nx.abs() < 0.9 ? 1.0 : 0.0;
+    final ay = 1.0 - ax;
+    double ux = -nz * ay;
+    double uy = nz * ax;
+    double uz = nx * ay - ny * ax;
+    final uLength = math.sqrt(ux * ux + uy * uy + uz * uz);
+    ux /= uLength;
+    uy /= uLength;
+    uz /= uLength;
+    final vx = ny * uz - nz * uy;
+    final vy = nz * ux - nx * uz;
+    final vz = nx * uy - ny * ux;
+
+    // Per-cell scratch: crossing points, their edges and angles
+    final edgeA = <int>[];
+    final edgeB = <int>[];
+    final px = <double>[];
+    final py = <double>[];
+    final pz = <double>[];
+    final pv = <double>[];
+    final angle = <double>[];
+    final ring = <int>[];
+
+    for (final cell in cells) {
+      edgeA.clear();
+      edgeB.clear();
+      px.clear();
+      py.clear();
+      pz.clear();
+      pv.clear();
+
+      final cellValue =
+          cellValues != null && cell < cellValues.length ? cellValues[cell] : double.nan;
+
+      for (int k = m.cellFaceOffsets[cell]; k < m.cellFaceOffsets[cell + 1]; k++) {
+        final encoded = m.cellFaces[k];
+        final f = encoded >= 0 ? encoded : ~encoded;
+        final start = m.faceOffsets[f];
+        final end = m.faceOffsets[f + 1];
+        for (int i = start; i < end; i++) {
+          final a = m.faceVertices[i];
+          final b = m.faceVertices[i + 1 < end ? i + 1 : start];
+          final da = m.points[a * 3] * nx +
+              m.points[a * 3 + 1] * ny +
+              m.points[a * 3 + 2] * nz -
+              offset;
+          final db = m.points[b * 3] * nx +
+              m.points[b * 3 + 1] * ny +
+              m.points[b * 3 + 2] * nz -
+              offset;
+          if ((da >= 0) == (db >= 0)) continue;
+
+          // Each edge is shared by two faces of the cell; keep it once
+          final lo = a < b ? a : b;
+          final hi = a < b ? b : a;
+          bool seen = false;
+          for (int e = 0; e < edgeA.length; e++) {
+            if (edgeA[e] == lo && edgeB[e] == hi) {
+              seen = true;
+              break;
+            }
+          }
+          if (seen) continue;
+          edgeA.add(lo);
+          edgeB.add(hi);
+
+          final t = da / (da - db);
+          px.add(m.points[a * 3] + (m.points[b * 3] - m.points[a * 3]) * t);
+          py.add(m.points[a * 3 + 1] + (m.points[b * 3 + 1] - m.points[a * 3 + 1]) * t);
+          pz.add(m.points[a * 3 + 2] + (m.points[b * 3 + 2] - m.points[a * 3 + 2]) * t);
+          if (pointValues != null && a < pointValues.length && b < pointValues.length) {
+            pv.add(pointValues[a] + (pointValues[b] - pointValues[a]) * t);
+          } else {
+            pv.add(cellValue);
+          }
+        }
+      }
+
+      final n = px.length;
+      if (n < 3) continue;
+
+      double cx = 0, cy = 0, cz = 0;
+      for (int i = 0; i < n; i++) {
+        cx += px[i];
+        cy += py[i];
+        cz += pz[i];
+      }
+      cx /= n;
+      cy /= n;
+      cz /= n;
+
+      angle.clear();
+      ring.clear();
+      for (int i = 0; i < n; i++) {
+        final dx = px[i] - cx, dy = py[i] - cy, dz = pz[i] - cz;
+        angle.add(math.atan2(dx * vx + dy * vy + dz * vz, dx * ux + dy * uy + dz * uz));
+        ring.add(i);
+      }
+      ring.sort((i, j) => angle[i].compareTo(angle[j]));
+
+      final base = out.vertexCount;
+      for (final i in ring) {
+        out.addVertex(px[i], py[i], pz[i], pv[i]);
+      }
+      for (int i = 1; i < n - 1; i++) {
+        out.addTriangle(base, base + i, base + i + 1);
+      }
+    }
+
+    return out.build();
+  }
+}
@@ -0,0 +1,305 @@
+// lib/filters/stream_tracer.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/cell_locator.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/worker_pool.dart';
+import 'polylines.dart';
+
+/// Velocity lookup for particle tracing inside one isolate.
+///
+/// Particles are followed from cell to cell: a point that left its cell
+/// moves across the face it is furthest outside of, to the owner or
+/// neighbour on the other side, which is usually one or two hops per step.
+/// Velocity inside a cell is an inverse-distance blend of its vertex
+/// values, which keeps it continuous across faces.
+class FlowSampler {
+  static const int _maxHops = 64;
+
+  final MeshArrays mesh;
+  final CellLocator locator;
+  final Int32List _seen = Int32List(256); // Vertices of the current cell
+
+  FlowSampler(this.mesh, this.locator);
+
+  /// The cell containing the point, walking from [cell]; -1 outside the mesh
+  int walk(int cell, double x, double y, double z) {
+    if (cell < 0) return locator.locate(x, y, z);
+    for (int hop = 0; hop < _maxHops; hop++) {
+      int exit = 0;
+      bool outside = false;
+      double furthest = locator.tolerance;
+      for (int k = locator.cellFaceOffsets[cell]; k < locator.cellFaceOffsets[cell + 1]; k++) {
+        final encoded = locator.cellFaces[k];
+        final f = (encoded >= 0 ? encoded : ~encoded) * 3;
+        double d = (x - locator.faceCentres[f]) * locator.faceNormals[f] +
+            (y - locator.faceCentres[f + 1]) * locator.faceNormals[f + 1] +
+            (z - locator.faceCentres[f + 2]) * locator.faceNormals[f + 2];
+        if (encoded < 0) d = -d;
+        if (d > furthest) {
+          furthest = d;
+          exit = encoded;
+          outside = true;
+        }
+      }
+      if (!outside) return cell;
+
+      final f = exit >= 0 ? exit : ~exit;
+      if (exit >= 0 && f >= mesh.nInternalFaces) {
+        // Through a boundary face: outside, unless the cell is not convex
+        return locator.locate(x, y, z, hint: cell);
+      }
+      cell = exit >= 0 ? mesh.neighbour[f] : mesh.owner[f];
+    }
+    return locator.locate(x, y, z, hint: cell);
+  }
+
+  /// Blends the vertex vectors of [cell] at the point into [out]
+  void sample(
+    Float64List pointVectors,
+    int cell,
+    double x,
+    double y,
+    double z,
+    Float64List out,
+  ) {
+    int nSeen = 0;
+    double wx = 0, wy = 0, wz = 0, weights = 0;
+    for (int k = locator.cellFaceOffsets[cell]; k < locator.cellFaceOffsets[cell + 1]; k++) {
+      final encoded = locator.cellFaces[k];
+      final f = encoded >= 0 ? encoded : ~encoded;
+      for (int i = mesh.faceOffsets[f]; i < mesh.faceOffsets[f + 1]; i++) {
+        final p = mesh.faceVertices[i];
+        bool seen = false;
+        for (int s = 0; s < nSeen; s++) {
+          if (_seen[s] == p) {
+            seen = true;
+            break;
+          }
+        }
+        if (seen) continue;
+        if (nSeen < _seen.length) _seen[nSeen++] = p;
+
+        final dx = mesh.points[p * 3] - x;
+        final dy = mesh.points[p * 3 + 1] - y;
+        final dz = mesh.points[p * 3 + 2] - z;
+        final d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 == 0) {
+          out[0] = pointVectors[p * 3];
+          out[1] = pointVectors[p * 3 + 1];
+          out[2] = pointVectors[p * 3 + 2];
+          return;
+        }
+        final w = 1 / d2;
+        wx += pointVectors[p * 3] * w;
+        wy += pointVectors[p * 3 + 1] * w;
+        wz += pointVectors[p * 3 + 2] * w;
+        weights += w;
+      }
+    }
+    out[0] = weights > 0 ? wx / weights : 0;
+    out[1] = weights > 0 ? wy / weights : 0;
+    out[2] = weights > 0 ? wz / weights : 0;
+  }
+
+  /// Largest bounding-box extent of [cell], the length scale for steps
+  double cellSize(int cell) {
+    final b = cell * 6;
+    final bounds = locator.cellBounds;
+    return math.max(
+      bounds[b + 3] - bounds[b],
+      math.max(bounds[b + 4] - bounds[b + 1], bounds[b + 5] - bounds[b + 2]),
+    );
+  }
+}
+
+/// Streamlines through a cell-centred velocity field.
+///
+/// Seeds are traced forward and backward with fourth-order Runge-Kutta,
+/// each step covering [stepFraction] of the current cell's size, and
+/// walking cell to cell through [FlowSampler]. Seeds are split across
+/// [WorkerPool.shared]; the mesh, locator and point velocities are sent
+/// to each worker once and reused by later traces.
+class StreamTracer {
+  final PolyMesh mesh;
+
+  StreamTracer(this.mesh);
+
+  /// Traces one streamline per seed (x, y, z triples) in [velocity], which
+  /// must be a vector field. Lines are coloured by speed.
+  Future<Polylines> trace(
+    FieldData velocity,
+    Float64List seeds, {
+    int maxSteps = 2000,
+    double stepFraction = 0.25,
+  }) async {
+    final pointVectors = FieldInterpolation.vectorPointArray(velocity, mesh);
+    if (pointVectors == null) {
+      throw ArgumentError('${velocity.name} is not a vector field');
+    }
+    final locator = await CellLocator.of(mesh);
+
+    final pool = WorkerPool.shared;
+    final meshKey = await pool.shareObject(MeshArrays.of(mesh));
+    final locatorKey = await pool.shareObject(locator);
+    final vectorKey = await pool.shareObject(pointVectors);
+
+    final parts = await pool.forRanges(
+      seeds.length ~/ 3,
+      (start, end) => _traceTask(
+        meshKey,
+        locatorKey,
+        vectorKey,
+        seeds.sublist(start * 3, end * 3),
+        maxSteps,
+        stepFraction,
+      ),
+      minChunk: 8,
+    );
+    return Polylines.concat(parts);
+  }
+
+  static WorkerTask<Polylines> _traceTask(
+    int meshKey,
+    int locatorKey,
+    int vectorKey,
+    Float64List seeds,
+    int maxSteps,
+    double stepFraction,
+  ) =>
+      (store) => traceSeeds(
+            FlowSampler(
+              store[meshKey] as MeshArrays,
+              store[locatorKey] as CellLocator,
+            ),
+            store[vectorKey] as Float64List,
+            seeds,
+            maxSteps: maxSteps,
+            stepFraction: stepFraction,
+          );
+
+  /// Traces [seeds] on this isolate
+  static Polylines traceSeeds(
+    FlowSampler sampler,
+    Float64List pointVectors,
+    Float64List seeds, {
+    int maxSteps = 2000,
+    double stepFraction = 0.25,
+  }) {
+    final out = PolylinesBuilder();
+
+    for (int s = 0; s < seeds.length ~/ 3; s++) {
+      final x = seeds[s * 3], y = seeds[s * 3 + 1], z = seeds[s * 3 + 2];
+      final cell = sampler.locator.locate(x, y, z);
+      if (cell < 0) continue;
+
+      // Backward half, reversed to end at the seed, then the forward half
+      final start = out.pointCount;
+      _integrate(sampler, pointVectors, cell, x, y, z, -1, maxSteps, stepFraction, out,
+          addSeed: true);
+      out.reverseFrom(start);
+      _integrate(sampler, pointVectors, cell, x, y, z, 1, maxSteps, stepFraction, out,
+          addSeed: false);
+      out.endLine();
+    }
+    return out.build();
+  }
+
+  // Adds the points of one direction to [out], starting with the seed
+  static void _integrate(
+    FlowSampler sampler,
+    Float64List pointVectors,
+    int cell,
+    double x,
+    double y,
+    double z,
+    double direction,
+    int maxSteps,
+    double stepFraction,
+    PolylinesBuilder out, {
+    required bool addSeed,
+  }) {
+    final k1 = Float64List(3);
+    final k2 = Float64List(3);
+    final k3 = Float64List(3);
+    final k4 = Float64List(3);
+
+    sampler.sample(pointVectors, cell, x, y, z, k1);
+    if (addSeed) out.addPoint(x, y, z, _length(k1));
+
+    for (int step = 0; step < maxSteps; step++) {
+      final speed = _length(k1);
+      if (speed < 1e-30) break;
+      final h = direction * stepFraction * sampler.cellSize(cell) / speed;
+
+      final c2 = sampler.walk(cell, x + h / 2 * k1[0], y + h / 2 * k1[1], z + h / 2 * k1[2]);
+      if (c2 < 0) break;
+      sampler.sample(pointVectors, c2, x + h / 2 * k1[0], y + h / 2 * k1[1], z + h / 2 * k1[2], k2);
+
+      final c3 = sampler.walk(cell, x + h / 2 * k2[0], y + h / 2 * k2[1], z + h / 2 * k2[2]);
+      if (c3 < 0) break;
+      sampler.sample(pointVectors, c3, x + h / 2 * k2[0], y + h / 2 * k2[1], z + h / 2 * k2[2], k3);
+
+      final c4 = sampler.walk(cell, x + h * k3[0], y + h * k3[1], z + h * k3[2]);
+      if (c4 < 0) break;
+      sampler.sample(pointVectors, c4, x + h * k3[0], y + h * k3[1], z + h * k3[2], k4);
+
+      final nx = x + h / 6 * (k1[0] + 2 * k2[0] + 2 * k3[0] + k4[0]);
+      final ny = y + h / 6 * (k1[1] + 2 * k2[1] + 2 * k3[1] + k4[1]);
+      final nz = z + h / 6 * (k1[2] + 2 * k2[2] + 2 * k3[2] + k4[2]);
+      final next = sampler.walk(cell, nx, ny, nz);
+      if (next < 0) break;
+
+      x = nx;
+      y = ny;
+      z = nz;
+      cell = next;
+      sampler.sample(pointVectors, cell, x, y, z, k1);
+      out.addPoint(x, y, z, _length(k1));
+    }
+  }
+
+  static double _length(Float64List v) =>
+      math.sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+/// Seed point layouts for the tracers (x, y, z triples)
+class SeedSources {
+  /// [count] points evenly spaced from [start] to [end]
+  static Float64List line(Vector3 start, Vector3 end, int count) {
+    final seeds = Float64List(count * 3);
+    for (int i = 0; i < count; i++) {
+      final t = count > 1 ? i / (count - 1) : 0.5;
+      seeds[i * 3] = start.x + (end.x - start.x) * t;
+      seeds[i * 3 + 1] = start.y + (end.y - start.y) * t;
+      seeds[i * 3 + 2] = start.z + (end.z - start.z) * t;
+    }
+    return seeds;
+  }
+
+  /// About [count] points on a grid across the box [min]..[max], in the
+  /// plane normal to [axis] through its middle. Points sit at the centres
+  /// of the grid squares, away from the box walls.
+  static Float64List plane(Vector3 min, Vector3 max, int axis, int count) {
+    final side = math.max(1, math.sqrt(count).round());
+    final lo = [min.x, min.y, min.z];
+    final hi = [max.x, max.y, max.z];
+    final u = (axis + 1) % 3;
+    final v = (axis + 2) % 3;
+    final seeds = Float64List(side * side * 3);
+    int n = 0;
+    for (int j = 0; j < side; j++) {
+      for (int i = 0; i < side; i++) {
+        seeds[n * 3 + axis] = (lo[axis] + hi[axis]) / 2;
+        seeds[n * 3 + u] = lo[u] + (hi[u] - lo[u]) * (i + 0.5) / side;
+        seeds[n * 3 + v] = lo[v] + (hi[v] - lo[v]) * (j + 0.5) / side;
+        n++;
+      }
+    }
+    return seeds;
+  }
+}
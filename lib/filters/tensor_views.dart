@@ -0,0 +1,165 @@
+// lib/filters/tensor_views.dart
+
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/lru_cache.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/tensor_math.dart';
+import '../utils/worker_pool.dart';
+
+/// Scalar views of tensor fields, derived on demand: `trace(R)`,
+/// `vonMises(R)` and the principal values `eigMax(R)`, `eigMid(R)` and
+/// `eigMin(R)`. The magnitude is the loaded field itself.
+///
+/// Tensor fields are loaded with their packed components only; a view is
+/// computed in cell chunks on [WorkerPool.shared] the first time it is
+/// asked for, and the most recent are cached per (name, time). The three
+/// principal values come from one eigenvalue pass, cached per (field, time).
+class TensorViews {
+  static const List<String> views = [
+    'trace',
+    'vonMises',
+    'eigMax',
+    'eigMid',
+    'eigMin',
+  ];
+
+  static final RegExp _pattern =
+      RegExp(r'^(trace|vonMises|eigMax|eigMid|eigMin)\(\s*([^()\s]+)\s*\)$');
+
+  final PolyMesh mesh;
+
+  /// Loads a field at a time step, e.g. [CaseReader.loadFieldData]
+  final Future<FieldData?> Function(String fieldName, String timeStep) loadField;
+
+  static const int _eigenvalueCacheSize = 4;
+  static const int _cacheSize = 8;
+
+  final LruCache<(String, String), Future<Float64List>> _eigenvalues =
+      LruCache(_eigenvalueCacheSize);
+  final LruCache<(String, String), Future<FieldData>> _cache = LruCache(_cacheSize);
+
+  TensorViews({required this.mesh, required this.loadField});
+
+  /// The view and input field of a name such as `vonMises(R)`, or null if
+  /// [name] is not one
+  static (String, String)? parse(String name) {
+    final match = _pattern.firstMatch(name.trim());
+    if (match == null) return null;
+    return (match[1]!, match[2]!);
+  }
+
+  /// The view [name] at [timeStep]. Throws [FormatException] for unknown
+  /// names and [StateError] for missing or non-tensor inputs.
+  Future<FieldData> evaluate(String name, String timeStep) {
+    final parsed = parse(name);
+    if (parsed == null) throw FormatException('Not a tensor view', name);
+    final (view, fieldName) = parsed;
+    return _cache.putIfAbsentFuture(
+      (name.trim(), timeStep),
+      () => _evaluate(name.trim(), view, fieldName, timeStep),
+    );
+  }
+
+  /// Forgets cached views and eigenvalues
+  void clear() {
+    _eigenvalues.clear();
+    _cache.clear();
+  }
+
+  Future<FieldData> _evaluate(
+    String name,
+    String view,
+    String fieldName,
+    String timeStep,
+  ) async {
+    final field = await loadField(fieldName, timeStep);
+    if (field == null) {
+      throw StateError('Field $fieldName not found at time $timeStep');
+    }
+    final tensors = field.tensors;
+    if (tensors == null) throw StateError('$view needs a tensor field');
+
+    final pool = WorkerPool.shared;
+    final arrays = MeshArrays.of(mesh);
+    final Float64List values;
+    if (view.startsWith('eig')) {
+      final eigenvalues = await _eigenvaluesOf(field, timeStep);
+      final which = view == 'eigMax' ? 0 : (view == 'eigMid' ? 1 : 2);
+      values = Float64List(eigenvalues.length ~/ 3);
+      for (int c = 0; c < values.length; c++) {
+        values[c] = eigenvalues[c * 3 + which];
+      }
+    } else {
+      values = await _join(
+        field,
+        (tensors, components) => _viewTask(view, tensors, components),
+      );
+    }
+
+    final meshKey = await pool.shareObject(arrays);
+    final pointValues = await pool.run(FieldInterpolation.pointTask(meshKey, values));
+    return FieldData(
+      name: name,
+      fieldClass: 'volScalarField',
+      internalField: values,
+      boundaryField: {},
+      pointValues: pointValues,
+    );
+  }
+
+  // Three principal values per cell, descending
+  Future<Float64List> _eigenvaluesOf(FieldData field, String timeStep) =>
+      _eigenvalues.putIfAbsentFuture(
+        (field.name, timeStep),
+        () => _join(field, _eigenTask),
+      );
+
+  // Runs [taskFor] over cell chunks of [field]'s tensors and joins the
+  // parts. Each cell's result only needs its own tensor, so every chunk is
+  // sent just its slice rather than the whole field shared with each worker.
+  static Future<Float64List> _join(
+    FieldData field,
+    WorkerTask<Float64List> Function(Float64List tensors, int components) taskFor,
+  ) async {
+    final tensors = field.tensors!;
+    final components = field.tensorComponents;
+    final parts = await WorkerPool.shared.forRanges(
+      tensors.length ~/ components,
+      (start, end) => taskFor(
+        tensors.sublist(start * components, end * components),
+        components,
+      ),
+      minChunk: 65536,
+    );
+    final out = Float64List(parts.fold(0, (n, part) => n + part.length));
+    int offset = 0;
+    for (final part in parts) {
+      out.setAll(offset, part);
+      offset += part.length;
+    }
+    return out;
+  }
+
+  static WorkerTask<Float64List> _viewTask(
+    String view,
+    Float64List tensors,
+    int components,
+  ) =>
+      (_) {
+        final n = tensors.length ~/ components;
+        return view == 'trace'
+            ? TensorMath.traces(tensors, components, 0, n)
+            : TensorMath.vonMises(tensors, components, 0, n);
+      };
+
+  static WorkerTask<Float64List> _eigenTask(Float64List tensors, int components) =>
+      (_) => TensorMath.eigenvalues(
+            tensors,
+            components,
+            0,
+            tensors.length ~/ components,
+          );
+}
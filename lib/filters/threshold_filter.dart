@@ -0,0 +1,124 @@
+// lib/filters/threshold_filter.dart
+
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/future_cache.dart';
+import '../utils/sort_utils.dart';
+import '../utils/worker_pool.dart';
+import 'cell_subset.dart';
+
+/// Cell values of one field in ascending order (NaN last)
+class _ValueIndex {
+  final Int32List order;
+  final Float64List sorted;
+
+  _ValueIndex(this.order, this.sorted);
+}
+
+/// Hides the cells whose value lies outside [lower, upper], through a
+/// shared [CellSubset].
+///
+/// Each field's cell values are argsorted once on a worker, so the cells
+/// in range are one contiguous run of that order, found by two binary
+/// searches. Moving the range only hides or shows the cells between the
+/// old and new ends of the run, and the subset only re-evaluates their
+/// faces.
+class ThresholdFilter {
+  final CellSubset subset;
+  FieldData? _field;
+  _ValueIndex? _index;
+  int _first = 0; // Visible run: _index.order[_first.._last)
+  int _last = 0;
+
+  // Applies run one at a time in call order; see [apply]
+  Future<void> _queue = Future.value();
+
+  ThresholdFilter(this.subset);
+
+  static final Expando<Future<_ValueIndex>> _indexes =
+      Expando<Future<_ValueIndex>>();
+
+  static Future<_ValueIndex> _indexFor(FieldData field) {
+    return _indexes.putIfAbsentFuture(field, () async {
+      // Only the worker that sorts the values needs them, so they travel
+      // with the task instead of being shared with every worker
+      final values = FieldInterpolation.cellArray(field);
+      return WorkerPool.shared.run(_buildIndexTask(values));
+    });
+  }
+
+  /// Lowest and highest finite cell value of [field]
+  Future<(double, double)> valueRange(FieldData field) async {
+    final sorted = (await _indexFor(field)).sorted;
+    int end = sorted.length;
+    while (end > 0 && sorted[end - 1].isNaN) {
+      end--;
+    }
+    if (end == 0) return (0.0, 1.0);
+    return (sorted.first, sorted[end - 1]);
+  }
+
+  /// Shows only the cells of [field] with values in [lower, upper], or
+  /// every cell when [field] is null. Returns the number of cells changed.
+  ///
+  /// Calls are queued behind each other, so an apply still waiting for its
+  /// value index cannot run after a later one (such as the `null` that
+  /// removes the threshold) and hide cells again.
+  Future<int> apply(FieldData? field, double lower, double upper) {
+    final result = _queue.then((_) => _apply(field, lower, upper));
+    _queue = result.then<void>((_) {}, onError: (Object _) {});
+    return result;
+  }
+
+  Future<int> _apply(FieldData? field, double lower, double upper) async {
+    final index = field != null ? await _indexFor(field) : null;
+    int changed = 0;
+
+    // A new field has a different order: start again from all visible
+    if (field != _field) {
+      final previous = _index;
+      if (previous != null) {
+        changed += _show(previous, 0, _first);
+        changed += _show(previous, _last, previous.order.length);
+      }
+      _field = field;
+      _index = index;
+      _first = 0;
+      _last = index?.order.length ?? 0;
+    }
+    if (index == null) return changed;
+
+    final first = SortUtils.lowerBound(index.sorted, lower);
+    final last = upper >= lower ? SortUtils.upperBound(index.sorted, upper, first) : first;
+
+    // Leaving the run: its ends beyond the new bounds
+    changed += _hide(index, _first, first < _last ? first : _last);
+    changed += _hide(index, last > _first ? last : _first, _last);
+    // Joining the run: the new bounds beyond its old ends
+    changed += _show(index, first, last < _first ? last : _first);
+    changed += _show(index, first > _last ? first : _last, last);
+
+    _first = first;
+    _last = last;
+    return changed;
+  }
+
+  int _hide(_ValueIndex index, int start, int end) {
+    if (start >= end) return 0;
+    subset.hide(index.order.sublist(start, end));
+    return end - start;
+  }
+
+  int _show(_ValueIndex index, int start, int end) {
+    if (start >= end) return 0;
+    subset.show(index.order.sublist(start, end));
+    return end - start;
+  }
+
+  static WorkerTask<_ValueIndex> _buildIndexTask(Float64List values) => (_) {
+        final (order, sorted) = SortUtils.argsort(values);
+        return _ValueIndex(order, sorted);
+      };
+}
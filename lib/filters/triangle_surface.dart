@@ -0,0 +1,84 @@
+// lib/filters/triangle_surface.dart
+
+import 'dart:typed_data';
+
+/// Indexed triangle output of a filter (slices, iso-surfaces)
+class TriangleSurface {
+  final Float64List positions; // x, y, z per vertex
+  final Float64List values; // Field value per vertex, NaN when unknown
+  final Int32List triangles; // Three vertex indices per triangle
+
+  const TriangleSurface(this.positions, this.values, this.triangles);
+
+  static final TriangleSurface empty =
+      TriangleSurface(Float64List(0), Float64List(0), Int32List(0));
+
+  int get vertexCount => values.length;
+  int get triangleCount => triangles.length ~/ 3;
+  bool get isEmpty => triangles.isEmpty;
+
+  /// Joins per-chunk results into one surface
+  static TriangleSurface concat(List<TriangleSurface> parts) {
+    if (parts.length == 1) return parts.first;
+    int vertices = 0;
+    int indices = 0;
+    for (final part in parts) {
+      vertices += part.vertexCount;
+      indices += part.triangles.length;
+    }
+    final positions = Float64List(vertices * 3);
+    final values = Float64List(vertices);
+    final triangles = Int32List(indices);
+    int v = 0;
+    int t = 0;
+    for (final part in parts) {
+      positions.setAll(v * 3, part.positions);
+      values.setAll(v, part.values);
+      for (int i = 0; i < part.triangles.length; i++) {
+        triangles[t + i] = part.triangles[i] + v;
+      }
+      v += part.vertexCount;
+      t += part.triangles.length;
+    }
+    return TriangleSurface(positions, values, triangles);
+  }
+}
+
+/// Growable buffers for building a [TriangleSurface] inside a kernel
+class TriangleSurfaceBuilder {
+  Float64List _positions = Float64List(3 * 1024);
+  Float64List _values = Float64List(1024);
+  Int32List _triangles = Int32List(3 * 1024);
+  int _vertexCount = 0;
+  int _indexCount = 0;
+
+  int get vertexCount => _vertexCount;
+
+  /// Adds a vertex and returns its index
+  int addVertex(double x, double y, double z, double value) {
+    if (_vertexCount == _values.length) {
+      _values = Float64List(_values.length * 2)..setAll(0, _values);
+      _positions = Float64List(_positions.length * 2)..setAll(0, _positions);
+    }
+    _positions[_vertexCount * 3] = x;
+    _positions[_vertexCount * 3 + 1] = y;
+    _positions[_vertexCount * 3 + 2] = z;
+    _values[_vertexCount] = value;
+    return _vertexCount++;
+  }
+
+  void addTriangle(int a, int b, int c) {
+    if (_indexCount + 3 > _triangles.length) {
+      _triangles = Int32List(_triangles.length * 2)..setAll(0, _triangles);
+    }
+    _triangles[_indexCount++] = a;
+    _triangles[_indexCount++] = b;
+    _triangles[_indexCount++] = c;
+  }
+
+  TriangleSurface build() => TriangleSurface(
+        _positions.sublist(0, _vertexCount * 3),
+        _values.sublist(0, _vertexCount),
+        _triangles.sublist(0, _indexCount),
+      );
+}
@@ -2,9 +2,30 @@
 
 import 'package:flutter/material.dart';
 import 'package:file_picker/file_picker.dart';
+import 'filters/cell_subset.dart';
+import 'filters/field_calculator.dart';
+import 'filters/field_gradients.dart';
+import 'filters/tensor_views.dart';
 import 'readers/case_reader.dart';
 import 'models/openfoam_case.dart';
+import 'utils/mesh_arrays.dart';
+import 'utils/mesh_picker.dart';
+import 'utils/mesh_quality.dart';
+import 'utils/view_transform.dart';
+import 'widgets/calculator_field.dart';
+import 'widgets/clip_controls.dart';
 import 'widgets/foam_viewer.dart';
+import 'widgets/glyph_controls.dart';
+import 'widgets/iso_surface_controls.dart';
+import 'widgets/line_plot_panel.dart';
+import 'widgets/patch_integrals_panel.dart';
+import 'widgets/pathline_controls.dart';
+import 'widgets/playback_controls.dart';
+import 'widgets/probe_panel.dart';
+import 'widgets/scene_overlays.dart';
+import 'widgets/slice_controls.dart';
+import 'widgets/streamline_controls.dart';
+import 'widgets/threshold_controls.dart';
 
 void main() {
   runApp(const MyApp());
@@ -81,12 +102,50 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
   String? _selectedField;
   List<String> _availableFields = [];
   FieldData? _currentFieldData;
+  String? _currentFieldStep; // Step it holds as stored; null for blends
   String? _casePath;
 
+  // Expressions added with the field calculator, listed after the fields
+  FieldCalculator? _calculator;
+  FieldGradients? _gradients;
+  TensorViews? _tensorViews;
+  List<String> _derivedFields = [];
+
   // Visibility controls
   bool _showInternalMesh = true;
   Map<String, bool> _boundaryVisibility = {};
 
+  // Probe picked in the viewer (null when the probe panel is closed)
+  PickResult? _probe;
+
+  // Plot-over-line segment (null when the filter is off)
+  LineOverlay? _sampleLine;
+
+  // Slice filter and its latest output
+  bool _sliceEnabled = false;
+  SceneOverlay? _sliceOverlay;
+
+  // Iso-surface filter and its latest output
+  bool _contourEnabled = false;
+  SceneOverlay? _contourOverlay;
+
+  // Streamlines of the active vector field
+  bool _streamlinesEnabled = false;
+  SceneOverlay? _streamlineOverlay;
+
+  // Arrow glyphs of the active vector field
+  bool _glyphsEnabled = false;
+  SceneOverlay? _glyphOverlay;
+
+  // Pathlines over the time steps
+  bool _pathlinesEnabled = false;
+  SceneOverlay? _pathlineOverlay;
+
+  // Cells hidden by the clip and threshold filters
+  bool _clipEnabled = false;
+  bool _thresholdEnabled = false;
+  CellSubset? _cellSubset;
+
   @override
   void initState() {
     super.initState();
@@ -105,6 +164,11 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
   Future<void> _loadCase() async {
     if (_casePath == null) return;
 
+    // Derived fields of the files as they were; dropped before reading again
+    _calculator?.clear();
+    _gradients?.clear();
+    _tensorViews?.clear();
+
     try {
       setState(() {
         _isLoading = true;
@@ -151,6 +215,35 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
 
       setState(() {
         _foamCase = foamCase;
+        _probe = null;
+        _sampleLine = null;
+        _sliceEnabled = false;
+        _sliceOverlay = null;
+        _contourEnabled = false;
+        _contourOverlay = null;
+        _streamlinesEnabled = false;
+        _streamlineOverlay = null;
+        _glyphsEnabled = false;
+        _glyphOverlay = null;
+        _pathlinesEnabled = false;
+        _pathlineOverlay = null;
+        _clipEnabled = false;
+        _thresholdEnabled = false;
+        _cellSubset = null;
+        _calculator = FieldCalculator(
+          mesh: foamCase.mesh,
+          timeDirectories: foamCase.timeDirectories,
+          loadField: (name, time) => _fieldAt(foamCase, name, time),
+        );
+        _gradients = FieldGradients(
+          mesh: foamCase.mesh,
+          loadField: (name, time) => _fieldAt(foamCase, name, time),
+        );
+        _tensorViews = TensorViews(
+          mesh: foamCase.mesh,
+          loadField: (name, time) => _fieldAt(foamCase, name, time),
+        );
+        _derivedFields = [];
         _fileFormats = formats;
         _selectedTimeStep = initialTime;
         _availableFields = fields;
@@ -177,9 +270,25 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
     }
   }
 
-  Future<void> _onTimeStepChanged(String? newTimeStep) async {
+  // [fieldData] is the selected field already decoded for the new step,
+  // as handed over by playback ([blended] between it and a neighbour);
+  // otherwise it is loaded here
+  Future<void> _onTimeStepChanged(
+    String? newTimeStep, {
+    FieldData? fieldData,
+    bool blended = false,
+  }) async {
     if (newTimeStep == null || _foamCase == null) return;
 
+    if (fieldData != null) {
+      setState(() {
+        _selectedTimeStep = newTimeStep;
+        _currentFieldData = fieldData;
+        _currentFieldStep = blended ? null : newTimeStep;
+      });
+      return;
+    }
+
     setState(() => _selectedTimeStep = newTimeStep);
 
     // Load fields for the new time step
@@ -190,10 +299,12 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
 
     setState(() {
       _availableFields = fields;
-      _selectedField = fields.isNotEmpty ? fields.first : null;
+      if (!fields.contains(_selectedField) && !_isComputed(_selectedField)) {
+        _selectedField = fields.isNotEmpty ? fields.first : null;
+      }
     });
 
-    // Load the first field data
+    // Load the selected field data
     if (_selectedField != null) {
       await _loadFieldData();
     }
@@ -213,15 +324,131 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
       return;
     }
 
-    final fieldData = await CaseReader.loadFieldData(
-      _foamCase!.casePath,
-      _selectedTimeStep!,
-      _selectedField!,
-      _foamCase!.mesh,
-    );
+    final timeStep = _selectedTimeStep!;
+    FieldData? fieldData;
+    if (MeshQuality.fieldNames.contains(_selectedField)) {
+      fieldData = await MeshQuality.field(_foamCase!.mesh, _selectedField!);
+    } else if (_derivedFields.contains(_selectedField)) {
+      try {
+        fieldData = await _evaluateDerived(_selectedField!, timeStep);
+      } catch (e) {
+        print('Field calculator: $e');
+      }
+    } else {
+      fieldData = await CaseReader.loadFieldData(
+        _foamCase!.casePath,
+        timeStep,
+        _selectedField!,
+        _foamCase!.mesh,
+      );
+    }
 
     setState(() {
       _currentFieldData = fieldData;
+      _currentFieldStep = timeStep;
+    });
+  }
+
+  // Calculator results and mesh metrics, which have no files on disk
+  bool _isComputed(String? field) =>
+      _derivedFields.contains(field) || MeshQuality.fieldNames.contains(field);
+
+  // Computes [name] at any step, for exporting computed fields
+  Future<FieldData?> Function(String timeStep) _computedLoader(String name) {
+    final mesh = _foamCase!.mesh;
+    return (timeStep) => MeshQuality.fieldNames.contains(name)
+        ? MeshQuality.field(mesh, name)
+        : _evaluateDerived(name, timeStep);
+  }
+
+  // Calculator and gradient inputs; the shown field is reused rather than
+  // read again when it holds that stored step (not a blend, and not the
+  // previous step while the new one loads)
+  Future<FieldData?> _fieldAt(OpenFOAMCase foamCase, String name, String time) {
+    if (MeshQuality.fieldNames.contains(name)) {
+      return MeshQuality.field(foamCase.mesh, name);
+    }
+    final current = _currentFieldData;
+    if (current != null &&
+        current.name == name &&
+        time == _currentFieldStep &&
+        identical(foamCase, _foamCase)) {
+      return Future.value(current);
+    }
+    // Only the cell values are used
+    return CaseReader.loadFieldData(
+      foamCase.casePath,
+      time,
+      name,
+      foamCase.mesh,
+      interpolate: false,
+    );
+  }
+
+  // Gradient-based fields such as Q(U), tensor views such as vonMises(R),
+  // otherwise calculator expressions
+  Future<FieldData> _evaluateDerived(String name, String timeStep) {
+    if (FieldGradients.parse(name) != null) {
+      return _gradients!.evaluate(name, timeStep);
+    }
+    if (TensorViews.parse(name) != null) {
+      return _tensorViews!.evaluate(name, timeStep);
+    }
+    return _calculator!.evaluate(name, timeStep, _availableFields);
+  }
+
+  // Evaluates a calculator expression at the current time step and shows
+  // it as a new field; returns an error message on failure
+  Future<String?> _addDerivedField(String expression) async {
+    final timeStep = _selectedTimeStep;
+    if (_calculator == null || timeStep == null) return 'No case loaded';
+    try {
+      final fieldData = await _evaluateDerived(expression, timeStep);
+      if (!mounted) return null;
+      setState(() {
+        if (!_derivedFields.contains(fieldData.name)) {
+          _derivedFields = [..._derivedFields, fieldData.name];
+        }
+        _selectedField = fieldData.name;
+        _currentFieldData = fieldData;
+        _currentFieldStep = timeStep;
+      });
+      return null;
+    } on FormatException catch (e) {
+      return '${e.message} at ${e.offset}';
+    } catch (e) {
+      return '$e';
+    }
+  }
+
+  // Shared by the filters that hide cells; created once per mesh
+  CellSubset _subsetFor(PolyMesh mesh) {
+    return _cellSubset ??= CellSubset(MeshArrays.of(mesh));
+  }
+
+  void _onSubsetChanged() {
+    if (mounted) setState(() {});
+  }
+
+  void _togglePlotOverLine() {
+    setState(() {
+      if (_sampleLine != null) {
+        _sampleLine = null;
+        return;
+      }
+      // Start along the bounding box diagonal
+      final bounds = MeshBounds.of(_foamCase!.mesh);
+      _sampleLine = LineOverlay(bounds.min, bounds.max);
+    });
+  }
+
+  void _onLineHandleDragged(int index, Vector3 position) {
+    final line = _sampleLine;
+    if (line == null) return;
+    setState(() {
+      _sampleLine = index == 0
+          ? LineOverlay(position, line.end)
+          : LineOverlay(line.start, position);
     });
   }
 
@@ -534,14 +761,66 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
         ),
         // 3D viewport
         Expanded(
-          child: Container(
-            color: const Color(0xFF1E1E1E),
-            child: FoamViewer(
-              foamCase: _foamCase!,
-              fieldData: _currentFieldData,
-              showInternalMesh: _showInternalMesh,
-              boundaryVisibility: _boundaryVisibility,
-            ),
+          child: Column(
+            children: [
+              Expanded(
+                child: Container(
+                  color: const Color(0xFF1E1E1E),
+                  child: FoamViewer(
+                    foamCase: _foamCase!,
+                    fieldData: _currentFieldData,
+                    showInternalMesh: _showInternalMesh,
+                    boundaryVisibility: _boundaryVisibility,
+                    onCellPicked: (result) => setState(() => _probe = result),
+                    probePoint: _probe?.point,
+                    cellSubset: _cellSubset,
+                    loadComputedField: _isComputed(_selectedField)
+                        ? _computedLoader(_selectedField!)
+                        : null,
+                    overlays: [
+                      if (_sliceOverlay != null) _sliceOverlay!,
+                      if (_contourOverlay != null) _contourOverlay!,
+                      if (_streamlineOverlay != null) _streamlineOverlay!,
+                      if (_pathlineOverlay != null) _pathlineOverlay!,
+                      if (_glyphOverlay != null) _glyphOverlay!,
+                      if (_sampleLine != null) _sampleLine!,
+                    ],
+                    handles: [
+                      if (_sampleLine != null) ...[
+                        _sampleLine!.start,
+                        _sampleLine!.end,
+                      ],
+                    ],
+                    onHandleDragged: _onLineHandleDragged,
+                  ),
+                ),
+              ),
+              // Field sampled along the dragged line
+              if (_sampleLine != null)
+                SizedBox(
+                  height: 220,
+                  child: LinePlotPanel(
+                    mesh: _foamCase!.mesh,
+                    fieldData: _currentFieldData,
+                    start: _sampleLine!.start,
+                    end: _sampleLine!.end,
+                    onClose: () => setState(() => _sampleLine = null),
+                  ),
+                ),
+              // Time-series probe at the clicked cell
+              if (_probe != null)
+                SizedBox(
+                  height: 240,
+                  child: ProbePanel(
+                    casePath: _foamCase!.casePath,
+                    timeDirectories: _foamCase!.timeDirectories,
+                    availableFields: _availableFields,
+                    initialField: _selectedField,
+                    probe: _probe!,
+                    onClose: () => setState(() => _probe = null),
+                  ),
+                ),
+            ],
           ),
         ),
       ],
@@ -592,13 +871,33 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
           title: 'TIME STEP',
           icon: Icons.access_time,
           child: _foamCase!.timeDirectories.isNotEmpty
-              ? _buildStyledDropdown<String>(
-                  value: _selectedTimeStep,
-                  items: _foamCase!.timeDirectories.map((time) {
-                    return DropdownMenuItem(value: time, child: Text(time));
-                  }).toList(),
-                  onChanged: _onTimeStepChanged,
-                  hint: 'Select time',
+              ? Column(
+                  crossAxisAlignment: CrossAxisAlignment.start,
+                  children: [
+                    _buildStyledDropdown<String>(
+                      value: _selectedTimeStep,
+                      items: _foamCase!.timeDirectories.map((time) {
+                        return DropdownMenuItem(value: time, child: Text(time));
+                      }).toList(),
+                      onChanged: _onTimeStepChanged,
+                      hint: 'Select time',
+                    ),
+                    PlaybackControls(
+                      foamCase: _foamCase!,
+                      // Computed fields have no files to stream
+                      fieldName: _isComputed(_selectedField) ? null : _selectedField,
+                      timeStep: _selectedTimeStep,
+                      onFrame: (timeStep, fieldData, blended) {
+                        if (fieldData != null) {
+                          _onTimeStepChanged(
+                            timeStep,
+                            fieldData: fieldData,
+                            blended: blended,
+                          );
+                        }
+                      },
+                    ),
+                  ],
                 )
               : const Text(
                   'No time directories',
@@ -611,13 +910,26 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
           title: 'SCALAR FIELD',
           icon: Icons.gradient,
           child: _availableFields.isNotEmpty
-              ? _buildStyledDropdown<String>(
-                  value: _selectedField,
-                  items: _availableFields.map((field) {
-                    return DropdownMenuItem(value: field, child: Text(field));
-                  }).toList(),
-                  onChanged: _onFieldChanged,
-                  hint: 'Select field',
+              ? Column(
+                  crossAxisAlignment: CrossAxisAlignment.start,
+                  children: [
+                    _buildStyledDropdown<String>(
+                      value: _selectedField,
+                      items: [
+                        ..._availableFields,
+                        ..._derivedFields,
+                        ...MeshQuality.fieldNames,
+                      ].map((field) {
+                        return DropdownMenuItem(value: field, child: Text(field));
+                      }).toList(),
+                      onChanged: _onFieldChanged,
+                      hint: 'Select field',
+                    ),
+                    if (_availableFields.contains(_currentFieldData?.name))
+                      _buildDerivedChips(_currentFieldData!),
+                    const SizedBox(height: 6),
+                    CalculatorField(onSubmit: _addDerivedField),
+                  ],
                 )
               : const Text(
                   'No fields available',
@@ -625,6 +937,162 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
                 ),
         ),
 
+        // Filters Section
+        _buildPanelSection(
+          title: 'FILTERS',
+          icon: Icons.filter_alt,
+          child: Column(
+            children: [
+              _buildToggleItem(
+                'Plot Over Line',
+                _sampleLine != null,
+                (_) => _togglePlotOverLine(),
+                Icons.show_chart,
+                subtitle: 'Drag the end points in the view',
+              ),
+              _buildToggleItem(
+                'Slice',
+                _sliceEnabled,
+                (value) => setState(() {
+                  _sliceEnabled = value ?? false;
+                  if (!_sliceEnabled) _sliceOverlay = null;
+                }),
+                Icons.layers_clear,
+              ),
+              if (_sliceEnabled)
+                SliceControls(
+                  mesh: _foamCase!.mesh,
+                  fieldData: _currentFieldData,
+                  onOverlayChanged: (overlay) {
+                    if (_sliceEnabled) setState(() => _sliceOverlay = overlay);
+                  },
+                ),
+              _buildToggleItem(
+                'Contour',
+                _contourEnabled,
+                (value) => setState(() {
+                  _contourEnabled = value ?? false;
+                  if (!_contourEnabled) _contourOverlay = null;
+                }),
+                Icons.bubble_chart,
+                subtitle: 'Iso-surface of the active field',
+              ),
+              if (_contourEnabled)
+                IsoSurfaceControls(
+                  mesh: _foamCase!.mesh,
+                  fieldData: _currentFieldData,
+                  onOverlayChanged: (overlay) {
+                    if (_contourEnabled) {
+                      setState(() => _contourOverlay = overlay);
+                    }
+                  },
+                ),
+              _buildToggleItem(
+                'Streamlines',
+                _streamlinesEnabled,
+                (value) => setState(() {
+                  _streamlinesEnabled = value ?? false;
+                  if (!_streamlinesEnabled) _streamlineOverlay = null;
+                }),
+                Icons.air,
+                subtitle: 'Traced through the active vector field',
+              ),
+              if (_streamlinesEnabled)
+                StreamlineControls(
+                  mesh: _foamCase!.mesh,
+                  fieldData: _currentFieldData,
+                  onOverlayChanged: (overlay) {
+                    if (_streamlinesEnabled) {
+                      setState(() => _streamlineOverlay = overlay);
+                    }
+                  },
+                ),
+              _buildToggleItem(
+                'Glyphs',
+                _glyphsEnabled,
+                (value) => setState(() {
+                  _glyphsEnabled = value ?? false;
+                  if (!_glyphsEnabled) _glyphOverlay = null;
+                }),
+                Icons.north_east,
+                subtitle: 'Arrows of the active vector field',
+              ),
+              if (_glyphsEnabled)
+                GlyphControls(
+                  mesh: _foamCase!.mesh,
+                  fieldData: _currentFieldData,
+                  onOverlayChanged: (overlay) {
+                    if (_glyphsEnabled) {
+                      setState(() => _glyphOverlay = overlay);
+                    }
+                  },
+                ),
+              _buildToggleItem(
+                'Pathlines',
+                _pathlinesEnabled,
+                (value) => setState(() {
+                  _pathlinesEnabled = value ?? false;
+                  if (!_pathlinesEnabled) _pathlineOverlay = null;
+                }),
+                Icons.timeline,
+                subtitle: 'Particles advected over the time steps',
+              ),
+              if (_pathlinesEnabled)
+                PathlineControls(
+                  foamCase: _foamCase!,
+                  fieldData: _currentFieldData,
+                  timeStep: _selectedTimeStep,
+                  onOverlayChanged: (overlay) {
+                    if (_pathlinesEnabled) {
+                      setState(() => _pathlineOverlay = overlay);
+                    }
+                  },
+                ),
+              _buildToggleItem(
+                'Clip',
+                _clipEnabled,
+                (value) => setState(() => _clipEnabled = value ?? false),
+                Icons.content_cut,
+                subtitle: 'Hide cells by plane or box',
+              ),
+              if (_clipEnabled)
+                ClipControls(
+                  mesh: _foamCase!.mesh,
+                  subset: _subsetFor(_foamCase!.mesh),
+                  onChanged: _onSubsetChanged,
+                ),
+              _buildToggleItem(
+                'Threshold',
+                _thresholdEnabled,
+                (value) => setState(() => _thresholdEnabled = value ?? false),
+                Icons.tune,
+                subtitle: 'Show cells within a value range',
+              ),
+              if (_thresholdEnabled)
+                ThresholdControls(
+                  fieldData: _currentFieldData,
+                  subset: _subsetFor(_foamCase!.mesh),
+                  onChanged: _onSubsetChanged,
+                ),
+            ],
+          ),
+        ),
+
+        // Patch Integrals Section
+        if (_currentFieldData != null)
+          _buildPanelSection(
+            title: 'PATCH INTEGRALS',
+            icon: Icons.functions,
+            child: PatchIntegralsPanel(
+              mesh: _foamCase!.mesh,
+              fieldData: _currentFieldData,
+              casePath: _foamCase!.casePath,
+              timeDirectories: _foamCase!.timeDirectories,
+              // Computed fields have no files to read over time
+              fieldName: _isComputed(_selectedField) ? null : _selectedField,
+            ),
+          ),
+
         // Mesh Statistics Section
         _buildPanelSection(
           title: 'MESH INFO',
@@ -791,6 +1259,36 @@ class _OpenFOAMViewerPageState extends State<OpenFOAMViewerPage> {
     );
   }
 
+  // Shortcuts to the gradient-based fields or tensor views of the shown field
+  Widget _buildDerivedChips(FieldData field) {
+    final operations = field.isTensor
+        ? const {
+            'trace': 'Trace',
+            'vonMises': 'von Mises',
+            'eigMax': 'λ max',
+            'eigMid': 'λ mid',
+            'eigMin': 'λ min',
+          }
+        : field.isVector
+            ? const {'vorticity': 'Vorticity', 'Q': 'Q', 'lambda2': 'λ2', 'div': 'Div'}
+            : const {'grad': 'Gradient'};
+    return Padding(
+      padding: const EdgeInsets.only(top: 6),
+      child: Wrap(
+        spacing: 6,
+        runSpacing: 4,
+        children: [
+          for (final MapEntry(key: operation, value: label) in operations.entries)
+            ActionChip(
+              label: Text(label, style: const TextStyle(fontSize: 10)),
+              visualDensity: VisualDensity.compact,
+              onPressed: () => _addDerivedField('$operation(${field.name})'),
+            ),
+        ],
+      ),
+    );
+  }
+
   Widget _buildStatRow(String label, int value, IconData icon) {
     return Row(
       children: [
@@ -1,5 +1,10 @@
 // lib/models/openfoam_case.dart
 
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../utils/tensor_math.dart';
+
 class OpenFOAMCase {
   final String casePath;
   final PolyMesh mesh;
@@ -60,6 +65,9 @@ class FieldData {
   final List<double> internalField; // Cell-centered values
   final Map<String, dynamic> boundaryField;
   final List<double>? pointValues; // Point-based values (interpolated)
+  final Float64List? vectors; // x, y, z per cell for vector fields
+  final Float64List? tensors; // Packed components per cell for tensor fields
+  final Float64List? faceValues; // One per face for surface fields
 
   FieldData({
     required this.name,
@@ -67,8 +75,18 @@ class FieldData {
     required this.internalField,
     required this.boundaryField,
     this.pointValues,
+    this.vectors,
+    this.tensors,
+    this.faceValues,
   });
 
+  bool get isVector => vectors != null;
+  bool get isTensor => tensors != null;
+  bool get isFaceField => faceValues != null;
+
+  /// Components per cell of [tensors]: 6 for symmTensor, 9 for tensor
+  int get tensorComponents => fieldClass.contains('SymmTensor') ? 6 : 9;
+
   // Create a copy with point values
   FieldData withPointValues(List<double> pointValues) {
     return FieldData(
@@ -77,6 +95,37 @@ class FieldData {
       internalField: internalField,
       boundaryField: boundaryField,
       pointValues: pointValues,
+      vectors: vectors,
+      tensors: tensors,
+      faceValues: faceValues,
     );
   }
 }
+
+class ProbeSample {
+  final String timeDir;
+  final double time;
+  final String fieldName;
+  final List<double> values; // Components of the field at the probe cell
+
+  ProbeSample({
+    required this.timeDir,
+    required this.time,
+    required this.fieldName,
+    required this.values,
+  });
+
+  // Scalar value for plotting (magnitude for vectors and tensors, counted
+  // as the viewer colours them: symmetric off-diagonals twice)
+  double get magnitude {
+    if (values.length == 1) return values[0];
+    if (values.length == 6) {
+      return TensorMath.magnitudes(Float64List.fromList(values), 6)[0];
+    }
+    double sum = 0.0;
+    for (final v in values) {
+      sum += v * v;
+    }
+    return math.sqrt(sum);
+  }
+}
@@ -428,8 +428,82 @@ class FoamFileParser {
     return values;
   }
 
+  // Parse the `value` entry of each patch in boundaryField: one number for
+  // `uniform`, the list for `nonuniform List<scalar>`. Patches without a
+  // value (empty, zeroGradient, ...) are left out.
+  static Map<String, List<double>> parseBoundaryScalarValues(String content) =>
+      parseBoundaryValues(content, 1);
+
+  // Parse the `value` entry of each patch in boundaryField as [components]
+  // numbers per face (1 for scalars, 3 for vectors): one tuple for
+  // `uniform`, every face's for `nonuniform`. Patches without a value are
+  // left out.
+  static Map<String, List<double>> parseBoundaryValues(String content, int components) {
+    // The boundaryField follows the internalField, which is not scanned
+    final blockStart = content.lastIndexOf('boundaryField');
+    if (blockStart < 0) return {};
+    content = stripCommentsAndHeader(content.substring(blockStart));
+    final result = <String, List<double>>{};
+    final block = RegExp(r'\bboundaryField\s*\{').firstMatch(content);
+    if (block == null) return result;
+
+    final type = components == 1 ? 'scalar' : 'vector';
+    final entryRegex = RegExp(r'\s*"?([^\s{}"]+)"?\s*\{');
+    final uniformRegex = components == 1
+        ? RegExp(r'\bvalue\s+uniform\s+([-\d.eE+]+)\s*;')
+        : RegExp(r'\bvalue\s+uniform\s+\(([^()]*)\)\s*;');
+    final nonuniformRegex = RegExp(
+      '\\bvalue\\s+nonuniform\\s+List<$type>\\s*(\\d+)\\s*\\((.*?)\\)\\s*;',
+      dotAll: true,
+    );
+    List<double> numbers(String text) => text
+        .split(RegExp(r'[\s()]+'))
+        .where((s) => s.isNotEmpty)
+        .map(double.parse)
+        .toList();
+
+    int i = block.end;
+    while (i < content.length) {
+      final entry = entryRegex.matchAsPrefix(content, i);
+      if (entry == null) break;
+
+      // The patch dictionary runs to its matching brace
+      int depth = 1;
+      int end = entry.end;
+      while (end < content.length && depth > 0) {
+        final char = content[end];
+        if (char == '{') depth++;
+        if (char == '}') depth--;
+        end++;
+      }
+      final body = content.substring(entry.end, end - 1);
+      i = end;
+
+      final nonuniform = nonuniformRegex.firstMatch(body);
+      if (nonuniform != null) {
+        result[entry.group(1)!] = numbers(nonuniform.group(2)!);
+        continue;
+      }
+      final uniform = uniformRegex.firstMatch(body);
+      if (uniform != null) {
+        final value = numbers(uniform.group(1)!);
+        if (value.length == components) result[entry.group(1)!] = value;
+      }
+    }
+    return result;
+  }
+
   // Parse vector field and return magnitude
   static List<double> parseVectorFieldMagnitude(String content) {
+    final magnitudes = vectorMagnitudes(parseVectorField(content));
+    print(
+      'Parsed ${magnitudes.length} vector magnitudes, min: ${magnitudes.reduce((a, b) => a < b ? a : b)}, max: ${magnitudes.reduce((a, b) => a > b ? a : b)}',
+    );
+    return magnitudes;
+  }
+
+  // Parse vector field components: x, y, z per cell
+  static Float64List parseVectorField(String content) {
     content = stripCommentsAndHeader(content);
 
     // Find internalField section with vectors
@@ -454,20 +528,88 @@ class FoamFileParser {
       r'\(\s*([-\d.eE+]+)\s+([-\d.eE+]+)\s+([-\d.eE+]+)\s*\)',
     );
 
-    final magnitudes = <double>[];
+    final components = Float64List(count * 3);
+    int n = 0;
     for (final vectorMatch in vectorRegex.allMatches(vectorContent)) {
-      final x = double.parse(vectorMatch.group(1)!);
-      final y = double.parse(vectorMatch.group(2)!);
-      final z = double.parse(vectorMatch.group(3)!);
+      if (n == count) break;
+      components[n * 3] = double.parse(vectorMatch.group(1)!);
+      components[n * 3 + 1] = double.parse(vectorMatch.group(2)!);
+      components[n * 3 + 2] = double.parse(vectorMatch.group(3)!);
+      n++;
+    }
+    return n == count ? components : components.sublist(0, n * 3);
+  }
 
-      // Calculate magnitude: sqrt(x^2 + y^2 + z^2)
-      final magnitude = math.sqrt(x * x + y * y + z * z);
-      magnitudes.add(magnitude);
+  // Expand `internalField uniform (a b c ...);` to [count] copies of its
+  // [components] numbers; null if the internalField is not a uniform tuple
+  static Float64List? parseUniformField(String content, int components, int count) {
+    final match = RegExp(r'internalField\s+uniform\s+\(([^()]*)\)\s*;')
+        .firstMatch(content);
+    if (match == null) return null;
+    final parts = match.group(1)!.trim().split(RegExp(r'\s+'));
+    if (parts.length != components) {
+      throw FormatException(
+        'Expected $components components in uniform internalField',
+        match.group(0),
+      );
     }
+    final value = [for (final part in parts) double.parse(part)];
+    final values = Float64List(count * components);
+    for (int i = 0; i < count; i++) {
+      values.setRange(i * components, (i + 1) * components, value);
+    }
+    return values;
+  }
 
-    print(
-      'Parsed ${magnitudes.length} vector magnitudes, min: ${magnitudes.reduce((a, b) => a < b ? a : b)}, max: ${magnitudes.reduce((a, b) => a > b ? a : b)}',
+  // Parse tensor field components: 6 per cell for symmTensor (xx xy xz yy
+  // yz zz), 9 for tensor, packed like the vectors
+  static Float64List parseTensorField(String content, int components) {
+    content = stripCommentsAndHeader(content);
+    final type = components == 6 ? 'symmTensor' : 'tensor';
+
+    final internalFieldRegex = RegExp(
+      'internalField\\s+nonuniform\\s+List<$type>\\s*(\\d+)\\s*\\((.*?)\\)\\s*;',
+      dotAll: true,
+      multiLine: true,
     );
+
+    final match = internalFieldRegex.firstMatch(content);
+    if (match == null) {
+      throw Exception('Could not find $type internalField');
+    }
+
+    final count = int.parse(match.group(1)!);
+    final tensorContent = match.group(2)!;
+
+    print('Parsing $type field: $count tensors');
+
+    // Each tensor is a parenthesised list of numbers; the groups are split
+    // by hand rather than with one capture group per component
+    final tupleRegex = RegExp(r'\(([^()]*)\)');
+    final values = Float64List(count * components);
+    int n = 0;
+    for (final tupleMatch in tupleRegex.allMatches(tensorContent)) {
+      if (n == count) break;
+      final parts = tupleMatch.group(1)!.trim().split(RegExp(r'\s+'));
+      if (parts.length != components) continue;
+      for (int k = 0; k < components; k++) {
+        values[n * components + k] = double.parse(parts[k]);
+      }
+      n++;
+    }
+    return n == count ? values : values.sublist(0, n * components);
+  }
+
+  // Magnitude sqrt(x^2 + y^2 + z^2) of each vector
+  static List<double> vectorMagnitudes(Float64List components) {
+    final n = components.length ~/ 3;
+    final magnitudes = List<double>.filled(n, 0.0);
+    for (int i = 0; i < n; i++) {
+      final x = components[i * 3];
+      final y = components[i * 3 + 1];
+      final z = components[i * 3 + 2];
+      magnitudes[i] = math.sqrt(x * x + y * y + z * z);
+    }
     return magnitudes;
   }
 
@@ -1,10 +1,15 @@
 // lib/readers/case_reader.dart
 
 import 'dart:io';
+import 'dart:math' as math;
+import 'dart:typed_data';
 import '../models/openfoam_case.dart';
 import '../parsers/foam_file_parser.dart';
 import '../utils/field_interpolation.dart';
 import '../utils/file_utils.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/tensor_math.dart';
+import 'field_index.dart';
 import 'mesh_reader.dart';
 
 class CaseReader {
@@ -98,21 +103,24 @@ class CaseReader {
   ) async {
     // Use FileUtils to get all files (handles .gz automatically)
     final fields = await FileUtils.listFiles('$casePath/$timeDir');
-    final validFields = <String>[];
+    final candidates = fields
+        // Skip uniform directory and other non-field files
+        .where((name) => name != 'uniform' && !name.startsWith('.'))
+        .toList();
 
-    for (final name in fields) {
-      // Skip uniform directory and other non-field files
-      if (name == 'uniform' || name.startsWith('.')) continue;
+    // Only the header is needed to recognise a field file, so read just the
+    // leading bytes of every candidate in one bounded batch
+    final headers = await FileUtils.readFileHeaders([
+      for (final name in candidates) '$casePath/$timeDir/$name',
+    ]);
 
-      // Check if it's a valid OpenFOAM field file
-      try {
-        final content = await FileUtils.readFileAsString('$casePath/$timeDir/$name');
-        if (content.contains('FoamFile')) {
-          validFields.add(name);
-        }
-      } catch (e) {
-        // Skip files that can't be read
-        print('Skipping $name: $e');
+    final validFields = <String>[];
+    for (int i = 0; i < candidates.length; i++) {
+      final header = headers[i];
+      if (header == null) {
+        print('Skipping ${candidates[i]}: could not be read');
+      } else if (header.contains('FoamFile')) {
+        validFields.add(candidates[i]);
       }
     }
 
@@ -120,13 +128,15 @@ class CaseReader {
     return validFields;
   }
 
-  // Load scalar field data from a time directory
+  // Load scalar field data from a time directory. Without [interpolate]
+  // cell fields get no point values, for callers that only use the cells.
   static Future<FieldData?> loadFieldData(
     String casePath,
     String timeDir,
     String fieldName,
-    PolyMesh mesh,
-  ) async {
+    PolyMesh mesh, {
+    bool interpolate = true,
+  }) async {
     final fieldPath = '$casePath/$timeDir/$fieldName';
 
     if (!await FileUtils.fileExists(fieldPath)) {
@@ -136,43 +146,236 @@ class CaseReader {
 
     try {
       final content = await FileUtils.readFileAsString(fieldPath);
+      return decodeField(
+        content,
+        fieldName,
+        MeshArrays.of(mesh),
+        interpolate: interpolate,
+      );
+    } catch (e) {
+      print('Error loading field $fieldName: $e');
+      return null;
+    }
+  }
 
-      // Parse the field header to check field type
-      final header = FoamFileParser.parseFoamFileHeader(content);
-      final fieldClass = header['class'] ?? '';
+  // Parse a field file's content and, with [interpolate], average cell
+  // fields to the points. Pure and synchronous so it can run on a worker
+  // isolate; returns null for fields that are neither scalar nor vector.
+  static FieldData? decodeField(
+    String content,
+    String fieldName,
+    MeshArrays mesh, {
+    bool interpolate = true,
+  }) {
+    // Parse the field header to check field type
+    final header = FoamFileParser.parseFoamFileHeader(content);
+    final fieldClass = header['class'] ?? '';
 
-      if (!fieldClass.contains('ScalarField') &&
-          !fieldClass.contains('VectorField')) {
-        print(
-          'Field $fieldName is not a scalar or vector field (class: $fieldClass)',
-        );
-        return null;
-      }
+    if (!fieldClass.contains('ScalarField') &&
+        !fieldClass.contains('VectorField') &&
+        !fieldClass.contains('TensorField')) {
+      print(
+        'Field $fieldName is not a scalar, vector or tensor field (class: $fieldClass)',
+      );
+      return null;
+    }
 
-      // Parse the field values (handles both scalar and vector fields)
-      final values = FoamFileParser.parseScalarField(content);
+    if (fieldClass.startsWith('point') || fieldClass.startsWith('surface')) {
+      return _decodeMeshField(content, fieldName, fieldClass, mesh);
+    }
+    // One component per cell, which the tensor views do not handle
+    if (fieldClass.contains('SphericalTensor')) {
+      print('Field $fieldName: $fieldClass is not supported');
+      return null;
+    }
 
-      if (values.isEmpty) {
-        print('No values found in field $fieldName');
-        return null;
-      }
+    // Vector and tensor fields keep their packed components; the magnitude
+    // is shown, and invariants are derived on demand (TensorViews). Uniform
+    // ones are expanded to every cell.
+    final vectors = fieldClass.contains('VectorField')
+        ? FoamFileParser.parseUniformField(content, 3, mesh.nCells) ??
+            (content.contains('List<vector>')
+                ? FoamFileParser.parseVectorField(content)
+                : null)
+        : null;
+    final tensorComponents = fieldClass.contains('SymmTensor') ? 6 : 9;
+    final tensors = fieldClass.contains('TensorField')
+        ? FoamFileParser.parseUniformField(content, tensorComponents, mesh.nCells) ??
+            FoamFileParser.parseTensorField(content, tensorComponents)
+        : null;
+    final List<double> values;
+    if (vectors != null) {
+      values = FoamFileParser.vectorMagnitudes(vectors);
+    } else if (tensors != null) {
+      values = TensorMath.magnitudes(tensors, tensorComponents);
+    } else {
+      values = FoamFileParser.parseScalarField(content);
+    }
+
+    if (values.isEmpty) {
+      print('No values found in field $fieldName');
+      return null;
+    }
+
+    print('Loaded $fieldName: ${values.length} cell values');
 
-      print('Loaded $fieldName: ${values.length} cell values');
+    // Each patch's own values (fixedValue inlets, outlet pressures) where it
+    // has any; tensor patches are not read
+    final patchValues = tensors != null
+        ? const <String, List<double>>{}
+        : FoamFileParser.parseBoundaryValues(content, vectors != null ? 3 : 1);
 
-      // Convert cell data to point data for smooth gradients
-      final pointValues = FieldInterpolation.cellToPoint(values, mesh);
+    // Convert cell data to point data for smooth gradients
+    final pointValues =
+        interpolate ? FieldInterpolation.cellsToPoints(values, mesh) : null;
+    if (pointValues != null) {
       print('Interpolated to ${pointValues.length} point values');
+    }
+
+    return FieldData(
+      name: fieldName,
+      fieldClass: fieldClass,
+      internalField: values,
+      boundaryField: patchValues,
+      pointValues: pointValues,
+      vectors: vectors,
+      tensors: tensors,
+    );
+  }
+
+  // Point and face (surface) scalar fields, kept at their own locations:
+  // point values colour the vertices as they are, face values colour each
+  // face. The cell values, for cell-based filters, are averaged from them.
+  static FieldData? _decodeMeshField(
+    String content,
+    String fieldName,
+    String fieldClass,
+    MeshArrays mesh,
+  ) {
+    if (fieldClass != 'pointScalarField' && fieldClass != 'surfaceScalarField') {
+      print('Field $fieldName: $fieldClass is not supported');
+      return null;
+    }
+    final isPoint = fieldClass == 'pointScalarField';
+    final count = isPoint ? mesh.nPoints : mesh.nInternalFaces;
+    final parsed = FoamFileParser.parseScalarField(content);
+    // A uniform internalField comes back as its one value
+    final internal = parsed.length == 1 && count != 1
+        ? Float64List(count)..fillRange(0, count, parsed.first)
+        : Float64List.fromList(parsed);
+    if (internal.length != count) {
+      print(
+        '${isPoint ? 'Point' : 'Surface'} field $fieldName has ${internal.length} '
+        'values for $count ${isPoint ? 'points' : 'internal faces'}',
+      );
+      return null;
+    }
 
+    if (isPoint) {
+      print('Loaded $fieldName: ${internal.length} point values');
       return FieldData(
         name: fieldName,
         fieldClass: fieldClass,
-        internalField: values,
+        internalField: FieldInterpolation.pointsToCells(internal, mesh),
         boundaryField: {},
-        pointValues: pointValues,
+        pointValues: internal,
       );
-    } catch (e) {
-      print('Error loading field $fieldName: $e');
-      return null;
+    }
+
+    // Internal faces, then each patch's value (0 where a patch has none)
+    final faceValues = Float64List(mesh.nFaces);
+    faceValues.setRange(0, mesh.nInternalFaces, internal);
+    final patchValues = FoamFileParser.parseBoundaryScalarValues(content);
+    for (int p = 0; p < mesh.patchNames.length; p++) {
+      final values = patchValues[mesh.patchNames[p]];
+      if (values == null || values.isEmpty) continue;
+      final start = mesh.patchStarts[p];
+      // A uniform value fills the patch
+      for (int i = 0; i < mesh.patchSizes[p] && start + i < mesh.nFaces; i++) {
+        faceValues[start + i] = values[math.min(i, values.length - 1)];
+      }
+    }
+    print('Loaded $fieldName: ${faceValues.length} face values');
+
+    return FieldData(
+      name: fieldName,
+      fieldClass: fieldClass,
+      internalField: FieldInterpolation.facesToCells(faceValues, mesh),
+      boundaryField: {},
+      faceValues: faceValues,
+    );
+  }
+
+  // Read the internalField values of selected cells only, using the field's
+  // offset index. Returns `components` values per cell, or null if the field
+  // is missing, has no internalField or is not a cell (vol) field.
+  static Future<(Float64List, int)?> readFieldCells(
+    String casePath,
+    String timeDir,
+    String fieldName,
+    List<int> cellIds,
+  ) async {
+    final cacheDirectory = FileUtils.caseCacheDirectory(casePath);
+    final index = await FieldOffsetIndex.open(
+      '$casePath/$timeDir/$fieldName',
+      cacheDirectory: cacheDirectory,
+    );
+    if (index == null) return null;
+
+    final values = await index.readCells(
+      cellIds,
+      cacheDirectory: cacheDirectory,
+    );
+    return (values, index.components);
+  }
+
+  // Stream the values of [fieldNames] at one cell over every time directory.
+  // Reads only the probed cell through each field's offset index, with a few
+  // time steps in flight at once; samples arrive in time order. Cancelling
+  // the subscription stops the job.
+  static Stream<ProbeSample> probeTimeSeries(
+    String casePath,
+    List<String> timeDirectories,
+    List<String> fieldNames,
+    int cellId, {
+    int readAhead = 8,
+  }) async* {
+    Future<List<ProbeSample>> readStep(String timeDir) async {
+      final samples = <ProbeSample>[];
+      for (final fieldName in fieldNames) {
+        try {
+          final cells = await readFieldCells(
+            casePath,
+            timeDir,
+            fieldName,
+            [cellId],
+          );
+          if (cells == null) continue;
+          samples.add(
+            ProbeSample(
+              timeDir: timeDir,
+              time: double.parse(timeDir),
+              fieldName: fieldName,
+              values: cells.$1.toList(),
+            ),
+          );
+        } catch (e) {
+          print('Probe: skipping $fieldName at $timeDir: $e');
+        }
+      }
+      return samples;
+    }
+
+    final pending = <Future<List<ProbeSample>>>[];
+    int next = 0;
+    while (next < timeDirectories.length || pending.isNotEmpty) {
+      while (pending.length < readAhead && next < timeDirectories.length) {
+        pending.add(readStep(timeDirectories[next++]));
+      }
+      final samples = await pending.removeAt(0);
+      for (final sample in samples) {
+        yield sample;
+      }
     }
   }
 }
@@ -0,0 +1,526 @@
+// lib/readers/field_index.dart
+
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+import '../parsers/foam_file_parser.dart';
+import '../utils/file_utils.dart';
+import '../utils/lru_cache.dart';
+
+enum FieldStorage { uniform, binary, ascii }
+
+/// Byte offsets of the internalField payload of one field file, so single
+/// cells can be read without loading the whole field.
+///
+/// Binary files only need the payload offset and element stride (from the
+/// header's `arch` scalar size and byte order). ASCII files
+/// record the offset of every [asciiChunk]-th element, so a cell read parses
+/// at most one chunk. Offsets refer to the uncompressed stream; `.gz` files
+/// are read through their gzip index.
+class FieldOffsetIndex {
+  static const int asciiChunk = 1024;
+  static const int _prefixBytes = 64 * 1024;
+  static const List<int> _magic = [0x44, 0x33, 0x46, 0x49, 0x44, 0x58, 0, 3];
+
+  final String path; // Field path without the .gz extension
+  final int sourceLength;
+  final int sourceModifiedMs;
+  final FieldStorage storage;
+  final int components; // 1 scalar, 3 vector, 6 symmTensor, 9 tensor
+  final int count;
+  final int scalarBytes; // 8, or 4 for `scalar=32` binary files
+  final bool bigEndian; // `MSB` binary files
+  final int payloadStart;
+  final int payloadEnd;
+  final Float64List uniformValue; // Only for uniform fields
+  final Int64List chunkOffsets; // Only for ASCII fields
+
+  FieldOffsetIndex({
+    required this.path,
+    required this.sourceLength,
+    required this.sourceModifiedMs,
+    required this.storage,
+    required this.components,
+    required this.count,
+    required this.scalarBytes,
+    required this.bigEndian,
+    required this.payloadStart,
+    required this.payloadEnd,
+    required this.uniformValue,
+    required this.chunkOffsets,
+  });
+
+  int get stride => components * scalarBytes;
+
+  // Indices of recently probed fields; a probe touches one field per time
+  // step, so this only needs to cover a time series or two
+  static final LruCache<String, FieldOffsetIndex> _loaded = LruCache(256);
+
+  /// Returns the index of the field at [path] ('name' or 'name.gz'), loading
+  /// it from [cacheDirectory] or building it on first use. Returns null if
+  /// the file does not exist, is a point or surface field (its values are
+  /// not per cell) or has no recognisable internalField.
+  static Future<FieldOffsetIndex?> open(
+    String path, {
+    String? cacheDirectory,
+  }) async {
+    final actualPath = await FileUtils.getActualFilePath(path);
+    if (actualPath == null) return null;
+
+    final stat = await File(actualPath).stat();
+    final modifiedMs = stat.modified.millisecondsSinceEpoch;
+
+    final loaded = _loaded[path];
+    if (loaded != null && loaded._matches(stat.size, modifiedMs)) {
+      return loaded;
+    }
+
+    final indexFile = cacheDirectory == null
+        ? null
+        : File(_indexPath(path, cacheDirectory));
+
+    FieldOffsetIndex? index;
+    if (indexFile != null && await indexFile.exists()) {
+      try {
+        index = _decode(path, await indexFile.readAsBytes());
+        if (!index._matches(stat.size, modifiedMs)) index = null;
+      } catch (e) {
+        print('Ignoring unreadable field index ${indexFile.path}: $e');
+        index = null;
+      }
+    }
+
+    if (index == null) {
+      index = await _build(path, stat.size, modifiedMs, cacheDirectory);
+      if (index == null) return null;
+
+      if (indexFile != null) {
+        try {
+          await indexFile.parent.create(recursive: true);
+          await indexFile.writeAsBytes(index._encode());
+        } catch (e) {
+          print('Could not save field index ${indexFile.path}: $e');
+        }
+      }
+    }
+
+    _loaded[path] = index;
+    return index;
+  }
+
+  static Future<FieldOffsetIndex?> _build(
+    String path,
+    int sourceLength,
+    int modifiedMs,
+    String? cacheDirectory,
+  ) async {
+    // Uniform and binary fields are fully described by their first bytes.
+    // The prefix of a .gz file is inflated on its own; the ASCII scan below
+    // inflates the whole file once and builds the gzip index for cell reads
+    // in that same pass.
+    final prefix = await FileUtils.readFilePrefix(path, _prefixBytes);
+    final fieldClass = _fieldClass(prefix);
+    if (fieldClass != null && !fieldClass.startsWith('vol')) {
+      print('Not indexing $path: $fieldClass has no cell values');
+      return null;
+    }
+    final binary = FoamFileParser.isBinaryFormat(prefix);
+
+    var header = _PayloadHeader.parse(prefix, binary: binary);
+    Uint8List? bytes;
+    if (header == null || header.storage == FieldStorage.ascii) {
+      // ASCII payloads need one full scan to find the chunk offsets
+      bytes = await FileUtils.readFileBytesIndexed(
+        path,
+        cacheDirectory: cacheDirectory,
+      );
+      header ??= _PayloadHeader.parse(bytes, binary: binary);
+    }
+    if (header == null) {
+      print('No internalField found in $path');
+      return null;
+    }
+
+    Int64List chunkOffsets = Int64List(0);
+    int payloadEnd = header.payloadStart +
+        header.count * header.components * header.scalarBytes;
+    if (header.storage == FieldStorage.uniform) {
+      payloadEnd = header.payloadStart;
+    } else if (header.storage == FieldStorage.ascii) {
+      final scan = _scanAscii(bytes!, header);
+      chunkOffsets = scan.$1;
+      payloadEnd = scan.$2;
+    }
+
+    print(
+      'Indexed $path: ${header.storage.name}, ${header.count} x '
+      '${header.components} values',
+    );
+
+    return FieldOffsetIndex(
+      path: path,
+      sourceLength: sourceLength,
+      sourceModifiedMs: modifiedMs,
+      storage: header.storage,
+      components: header.components,
+      count: header.count,
+      scalarBytes: header.scalarBytes,
+      bigEndian: header.bigEndian,
+      payloadStart: header.payloadStart,
+      payloadEnd: payloadEnd,
+      uniformValue: header.uniformValue,
+      chunkOffsets: chunkOffsets,
+    );
+  }
+
+  /// Records the offset of every [asciiChunk]-th element and the end of the
+  /// payload
+  static (Int64List, int) _scanAscii(Uint8List bytes, _PayloadHeader header) {
+    final offsets = Int64List((header.count + asciiChunk - 1) ~/ asciiChunk);
+    int pos = header.payloadStart;
+    for (int i = 0; i < header.count; i++) {
+      while (pos < bytes.length && _isSpace(bytes[pos])) {
+        pos++;
+      }
+      if (i % asciiChunk == 0) offsets[i ~/ asciiChunk] = pos;
+
+      // Tuples are parenthesised, even sphericalTensor's single component
+      if (pos >= bytes.length || bytes[pos] != 0x28) {
+        while (pos < bytes.length &&
+            !_isSpace(bytes[pos]) &&
+            bytes[pos] != 0x29) {
+          pos++;
+        }
+      } else {
+        while (pos < bytes.length && bytes[pos] != 0x29) {
+          pos++;
+        }
+        pos++; // Closing ')' of the element
+      }
+    }
+    return (offsets, pos);
+  }
+
+  // The header's class, or null for a file without a FoamFile header
+  static String? _fieldClass(Uint8List prefix) {
+    try {
+      return FoamFileParser.parseFoamFileHeaderFromBytes(prefix)['class'] as String?;
+    } catch (_) {
+      return null;
+    }
+  }
+
+  /// Reads the values of [cellIds], returned as `components` consecutive
+  /// values per requested cell
+  Future<Float64List> readCells(
+    List<int> cellIds, {
+    String? cacheDirectory,
+  }) async {
+    final result = Float64List(cellIds.length * components);
+
+    if (storage == FieldStorage.binary) {
+      return _readBinaryCells(cellIds, result, cacheDirectory);
+    }
+    if (storage == FieldStorage.ascii) {
+      return _readAsciiCells(cellIds, result, cacheDirectory);
+    }
+
+    for (int i = 0; i < cellIds.length; i++) {
+      result.setRange(i * components, (i + 1) * components, uniformValue);
+    }
+    return result;
+  }
+
+  Future<Float64List> _readBinaryCells(
+    List<int> cellIds,
+    Float64List result,
+    String? cacheDirectory,
+  ) async {
+    // Coalesce nearby cells into runs so neighbouring cells share one read
+    const maxGap = 512;
+    final order = List<int>.generate(cellIds.length, (i) => i)
+      ..sort((a, b) => cellIds[a].compareTo(cellIds[b]));
+
+    final runs = <(int, int)>[]; // Element ranges [first, last]
+    for (final i in order) {
+      final cell = cellIds[i];
+      if (cell < 0 || cell >= count) continue;
+      if (runs.isNotEmpty && cell - runs.last.$2 <= maxGap) {
+        runs[runs.length - 1] = (runs.last.$1, cell);
+      } else {
+        runs.add((cell, cell));
+      }
+    }
+
+    final data = await FileUtils.readFileRanges(
+      path,
+      [
+        for (final run in runs)
+          (payloadStart + run.$1 * stride, (run.$2 - run.$1 + 1) * stride),
+      ],
+      cacheDirectory: cacheDirectory,
+    );
+
+    for (int r = 0; r < runs.length; r++) {
+      final expected = (runs[r].$2 - runs[r].$1 + 1) * stride;
+      if (data[r].length < expected) {
+        throw FormatException(
+          'Binary field $path ends before cell ${runs[r].$2} '
+          '(read ${data[r].length} of $expected bytes)',
+        );
+      }
+    }
+
+    final endian = bigEndian ? Endian.big : Endian.little;
+    int r = 0;
+    for (final i in order) {
+      final cell = cellIds[i];
+      if (cell < 0 || cell >= count) continue;
+      while (cell > runs[r].$2) {
+        r++;
+      }
+      final view = ByteData.sublistView(data[r]);
+      final base = (cell - runs[r].$1) * stride;
+      for (int c = 0; c < components; c++) {
+        final at = base + c * scalarBytes;
+        result[i * components + c] = scalarBytes == 4
+            ? view.getFloat32(at, endian)
+            : view.getFloat64(at, endian);
+      }
+    }
+    return result;
+  }
+
+  Future<Float64List> _readAsciiCells(
+    List<int> cellIds,
+    Float64List result,
+    String? cacheDirectory,
+  ) async {
+    final chunks = <int>{
+      for (final cell in cellIds)
+        if (cell >= 0 && cell < count) cell ~/ asciiChunk,
+    }.toList()
+      ..sort();
+
+    final data = await FileUtils.readFileRanges(
+      path,
+      [
+        for (final chunk in chunks)
+          (
+            chunkOffsets[chunk],
+            (chunk + 1 < chunkOffsets.length
+                    ? chunkOffsets[chunk + 1]
+                    : payloadEnd) -
+                chunkOffsets[chunk],
+          ),
+      ],
+      cacheDirectory: cacheDirectory,
+    );
+
+    final parsed = <int, List<double>>{};
+    for (int k = 0; k < chunks.length; k++) {
+      final text = latin1.decode(data[k]).replaceAll('(', ' ').replaceAll(')', ' ');
+      parsed[chunks[k]] = text
+          .split(RegExp(r'\s+'))
+          .where((s) => s.isNotEmpty)
+          .map((s) => double.tryParse(s) ?? 0.0)
+          .toList();
+    }
+
+    for (int i = 0; i < cellIds.length; i++) {
+      final cell = cellIds[i];
+      if (cell < 0 || cell >= count) continue;
+      final values = parsed[cell ~/ asciiChunk]!;
+      final base = (cell % asciiChunk) * components;
+      for (int c = 0; c < components && base + c < values.length; c++) {
+        result[i * components + c] = values[base + c];
+      }
+    }
+    return result;
+  }
+
+  bool _matches(int size, int modified) =>
+      sourceLength == size && sourceModifiedMs == modified;
+
+  static bool _isSpace(int b) => b == 0x20 || b == 0x0A || b == 0x0D || b == 0x09;
+
+  static String _indexPath(String path, String cacheDirectory) {
+    final flat = path.replaceAll(RegExp(r'[\\/:]'), '_');
+    return '$cacheDirectory${Platform.pathSeparator}$flat.fidx';
+  }
+
+  Uint8List _encode() {
+    final size = _magic.length + 8 * 11 + uniformValue.length * 8 +
+        chunkOffsets.length * 8;
+    final bytes = Uint8List(size);
+    final data = ByteData.sublistView(bytes);
+    bytes.setRange(0, _magic.length, _magic);
+
+    int pos = _magic.length;
+    for (final value in [
+      sourceLength,
+      sourceModifiedMs,
+      storage.index,
+      components,
+      count,
+      scalarBytes,
+      bigEndian ? 1 : 0,
+      payloadStart,
+      payloadEnd,
+      uniformValue.length,
+      chunkOffsets.length,
+    ]) {
+      data.setInt64(pos, value, Endian.little);
+      pos += 8;
+    }
+    for (final value in uniformValue) {
+      data.setFloat64(pos, value, Endian.little);
+      pos += 8;
+    }
+    for (final offset in chunkOffsets) {
+      data.setInt64(pos, offset, Endian.little);
+      pos += 8;
+    }
+    return bytes;
+  }
+
+  static FieldOffsetIndex _decode(String path, Uint8List bytes) {
+    for (int i = 0; i < _magic.length; i++) {
+      if (bytes[i] != _magic[i]) {
+        throw const FormatException('Not a field index file');
+      }
+    }
+    final data = ByteData.sublistView(bytes);
+    int pos = _magic.length;
+    int next() {
+      final value = data.getInt64(pos, Endian.little);
+      pos += 8;
+      return value;
+    }
+
+    final sourceLength = next();
+    final sourceModifiedMs = next();
+    final storage = FieldStorage.values[next()];
+    final components = next();
+    final count = next();
+    final scalarBytes = next();
+    final bigEndian = next() != 0;
+    final payloadStart = next();
+    final payloadEnd = next();
+    final uniformValue = Float64List(next());
+    final chunkOffsets = Int64List(next());
+    for (int i = 0; i < uniformValue.length; i++) {
+      uniformValue[i] = data.getFloat64(pos, Endian.little);
+      pos += 8;
+    }
+    for (int i = 0; i < chunkOffsets.length; i++) {
+      chunkOffsets[i] = next();
+    }
+
+    return FieldOffsetIndex(
+      path: path,
+      sourceLength: sourceLength,
+      sourceModifiedMs: sourceModifiedMs,
+      storage: storage,
+      components: components,
+      count: count,
+      scalarBytes: scalarBytes,
+      bigEndian: bigEndian,
+      payloadStart: payloadStart,
+      payloadEnd: payloadEnd,
+      uniformValue: uniformValue,
+      chunkOffsets: chunkOffsets,
+    );
+  }
+}
+
+/// Location and shape of an internalField payload
+class _PayloadHeader {
+  final FieldStorage storage;
+  final int components;
+  final int count;
+  final int payloadStart;
+  final Float64List uniformValue;
+  final int scalarBytes;
+  final bool bigEndian;
+
+  _PayloadHeader(
+    this.storage,
+    this.components,
+    this.count,
+    this.payloadStart, {
+    Float64List? uniformValue,
+    this.scalarBytes = 8,
+    this.bigEndian = false,
+  }) : uniformValue = uniformValue ?? Float64List(0);
+
+  static const Map<String, int> _componentsByType = {
+    'scalar': 1,
+    'vector': 3,
+    'sphericalTensor': 1,
+    'symmTensor': 6,
+    'tensor': 9,
+  };
+
+  /// Parses the internalField declaration, or returns null if it is not
+  /// (completely) contained in [bytes]
+  static _PayloadHeader? parse(Uint8List bytes, {required bool binary}) {
+    final start = _indexOf(bytes, ascii.encode('internalField'), 0);
+    if (start < 0) return null;
+
+    // The declaration itself is plain text and short
+    final end = start + 256 < bytes.length ? start + 256 : bytes.length;
+    final text = latin1.decode(Uint8List.sublistView(bytes, start, end));
+
+    final uniform = RegExp(r'^internalField\s+uniform\s+([^;]+);')
+        .firstMatch(text);
+    if (uniform != null) {
+      final numbers = RegExp(r'[-+]?[\d.]+(?:[eE][-+]?\d+)?')
+          .allMatches(uniform.group(1)!)
+          .map((m) => double.parse(m.group(0)!))
+          .toList();
+      return _PayloadHeader(
+        FieldStorage.uniform,
+        numbers.length,
+        0,
+        start,
+        uniformValue: Float64List.fromList(numbers),
+      );
+    }
+
+    final nonuniform = RegExp(
+      r'^internalField\s+nonuniform\s+List<(\w+)>\s*(\d+)\s*\(',
+    ).firstMatch(text);
+    if (nonuniform == null) return null;
+
+    final components = _componentsByType[nonuniform.group(1)!];
+    if (components == null) return null;
+
+    // Binary layout from the header, e.g. arch "LSB;label=32;scalar=64"
+    final header = latin1.decode(Uint8List.sublistView(bytes, 0, start));
+    final arch = RegExp(r'arch\s+"([^"]*)"').firstMatch(header)?.group(1) ?? '';
+    final scalarBits = RegExp(r'scalar=(\d+)').firstMatch(arch)?.group(1);
+
+    // Latin-1 maps bytes to characters one to one, so offsets carry over
+    return _PayloadHeader(
+      binary ? FieldStorage.binary : FieldStorage.ascii,
+      components,
+      int.parse(nonuniform.group(2)!),
+      start + nonuniform.end,
+      scalarBytes: scalarBits == '32' ? 4 : 8,
+      bigEndian: arch.contains('MSB'),
+    );
+  }
+
+  static int _indexOf(Uint8List bytes, List<int> pattern, int from) {
+    outer:
+    for (int i = from; i <= bytes.length - pattern.length; i++) {
+      for (int j = 0; j < pattern.length; j++) {
+        if (bytes[i + j] != pattern[j]) continue outer;
+      }
+      return i;
+    }
+    return -1;
+  }
+}
@@ -0,0 +1,154 @@
+// lib/readers/frame_pipeline.dart
+
+import 'dart:async';
+import 'dart:convert';
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import '../utils/file_utils.dart';
+import '../utils/mesh_arrays.dart';
+import '../utils/worker_pool.dart';
+import 'case_reader.dart';
+
+/// Decode-ahead loader for playing one field through the time directories.
+///
+/// Each frame is read on the main isolate (file I/O is asynchronous
+/// there), then parsed and interpolated to the points on a worker, so
+/// several upcoming frames are prepared in parallel while the current one
+/// is shown. The caller names the frames it still wants with [retain];
+/// anything else is forgotten, so memory stays bounded by the window.
+///
+/// At most [maxInFlight] decodes run at once. A decode on a worker cannot
+/// be stopped, so frames dropped while running still hold their slot until
+/// they finish; wanted frames wait for a slot in the order of the latest
+/// [retain], and frames dropped before starting are never decoded.
+class FramePipeline {
+  final String casePath;
+  final PolyMesh mesh;
+  final String fieldName;
+  final List<String> timeDirectories;
+  final int maxInFlight;
+
+  final Map<int, Completer<FieldData?>> _pending = {};
+  final Map<int, FieldData?> _ready = {};
+  List<int> _queued = []; // Pending frames not started, in start order
+  int _inFlight = 0; // Decodes running, including dropped frames
+  Future<int>? _meshKey;
+  bool _closed = false;
+
+  FramePipeline({
+    required this.casePath,
+    required this.mesh,
+    required this.fieldName,
+    required this.timeDirectories,
+    int? maxInFlight,
+  }) : maxInFlight = maxInFlight ?? WorkerPool.shared.size;
+
+  /// Whether frame [index] has finished decoding (it may still be null if
+  /// the file could not be read)
+  bool isReady(int index) => _ready.containsKey(index);
+
+  /// Whether frame [index] is decoded, being decoded or waiting to be
+  bool isRequested(int index) =>
+      _ready.containsKey(index) || _pending.containsKey(index);
+
+  /// The decoded frame at [index], or null if it is not ready
+  FieldData? readyFrame(int index) => _ready[index];
+
+  /// The frame at [index], decoded ahead of the other waiting frames. If
+  /// the frame is dropped by [retain] before its decode starts, the
+  /// future completes with null.
+  Future<FieldData?> frame(int index) {
+    if (_ready.containsKey(index)) return Future.value(_ready[index]);
+    final pending = _pending[index];
+    if (pending != null) {
+      if (_queued.remove(index)) _queued.insert(0, index);
+    } else {
+      _pending[index] = Completer<FieldData?>();
+      _queued.insert(0, index);
+    }
+    final future = _pending[index]!.future;
+    _startQueued();
+    return future;
+  }
+
+  /// Keeps the frames in [indices], queueing the missing ones in that
+  /// order, and drops every other frame whether decoded, waiting or still
+  /// in flight
+  void retain(Iterable<int> indices) {
+    final keep = <int>{
+      for (final index in indices)
+        if (index >= 0 && index < timeDirectories.length) index,
+    };
+    _ready.removeWhere((index, _) => !keep.contains(index));
+    for (final index in _queued) {
+      if (!keep.contains(index)) _pending.remove(index)?.complete(null);
+    }
+    _pending.removeWhere((index, _) => !keep.contains(index));
+
+    final queued = _queued.toSet();
+    _queued = [
+      for (final index in keep)
+        if (queued.contains(index) || !isRequested(index)) index,
+    ];
+    for (final index in _queued) {
+      _pending.putIfAbsent(index, Completer<FieldData?>.new);
+    }
+    _startQueued();
+  }
+
+  /// Drops every frame; decodes still running are ignored when they finish
+  void close() {
+    _closed = true;
+    for (final index in _queued) {
+      _pending[index]?.complete(null);
+    }
+    _queued = [];
+    _pending.clear();
+    _ready.clear();
+  }
+
+  void _startQueued() {
+    while (!_closed && _inFlight < maxInFlight && _queued.isNotEmpty) {
+      final index = _queued.removeAt(0);
+      final completer = _pending[index]!;
+      _inFlight++;
+      _decode(index).then((result) {
+        _inFlight--;
+        // Only kept if the frame was not dropped meanwhile
+        if (!_closed && identical(_pending[index], completer)) {
+          _pending.remove(index);
+          _ready[index] = result;
+        }
+        completer.complete(result);
+        _startQueued();
+      });
+    }
+  }
+
+  Future<FieldData?> _decode(int index) async {
+    try {
+      final pool = WorkerPool.shared;
+      final meshKey = await (_meshKey ??= pool.shareObject(MeshArrays.of(mesh)));
+      final raw = await FileUtils.readFileBytes(
+        '$casePath/${timeDirectories[index]}/$fieldName',
+      );
+      final bytes = raw is Uint8List ? raw : Uint8List.fromList(raw);
+      return await pool.run(_decodeTask(meshKey, bytes, fieldName));
+    } catch (e) {
+      print('Playback: skipping $fieldName at ${timeDirectories[index]}: $e');
+      return null;
+    }
+  }
+
+  static WorkerTask<FieldData?> _decodeTask(
+    int meshKey,
+    Uint8List bytes,
+    String fieldName,
+  ) =>
+      (store) => CaseReader.decodeField(
+            utf8.decode(bytes, allowMalformed: true),
+            fieldName,
+            store[meshKey] as MeshArrays,
+          );
+}
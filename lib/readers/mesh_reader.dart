@@ -1,5 +1,6 @@
 // lib/readers/mesh_reader.dart
 
+import 'dart:convert';
 import '../models/openfoam_case.dart';
 import '../parsers/foam_file_parser.dart';
 import '../utils/file_utils.dart';
@@ -8,9 +9,18 @@ class MeshReader {
   static Future<PolyMesh> readMesh(String casePath) async {
     final meshPath = '$casePath/constant/polyMesh';
 
-    // Read points (supports both normal and .gz files)
+    // Read all mesh files in one batch (supports both normal and .gz files)
+    final meshFiles = await FileUtils.readFilesBytes([
+      '$meshPath/points',
+      '$meshPath/faces',
+      '$meshPath/owner',
+      '$meshPath/neighbour',
+      '$meshPath/boundary',
+    ]);
+
+    // Parse points
     print('Reading points...');
-    final pointsBytes = await FileUtils.readFileBytes('$meshPath/points');
+    final pointsBytes = meshFiles[0];
     final List<Vector3> points;
 
     if (FoamFileParser.isBinaryFormat(pointsBytes)) {
@@ -22,9 +32,9 @@ class MeshReader {
     }
     print('Points loaded: ${points.length}');
 
-    // Read faces (supports both normal and .gz files)
+    // Parse faces
     print('Reading faces...');
-    final facesBytes = await FileUtils.readFileBytes('$meshPath/faces');
+    final facesBytes = meshFiles[1];
     final List<Face> faces;
 
     if (FoamFileParser.isBinaryFormat(facesBytes)) {
@@ -36,9 +46,9 @@ class MeshReader {
     }
     print('Faces loaded: ${faces.length}');
 
-    // Read owner (supports both normal and .gz files)
+    // Parse owner
     print('Reading owner...');
-    final ownerBytes = await FileUtils.readFileBytes('$meshPath/owner');
+    final ownerBytes = meshFiles[2];
     final List<int> owner;
 
     if (FoamFileParser.isBinaryFormat(ownerBytes)) {
@@ -50,9 +60,9 @@ class MeshReader {
     }
     print('Owner loaded: ${owner.length}');
 
-    // Read neighbour (supports both normal and .gz files)
+    // Parse neighbour
     print('Reading neighbour...');
-    final neighbourBytes = await FileUtils.readFileBytes('$meshPath/neighbour');
+    final neighbourBytes = meshFiles[3];
     final List<int> neighbour;
 
     if (FoamFileParser.isBinaryFormat(neighbourBytes)) {
@@ -64,9 +74,9 @@ class MeshReader {
     }
     print('Neighbour loaded: ${neighbour.length}');
 
-    // Read boundary (usually ASCII even in binary cases, supports .gz)
+    // Parse boundary (usually ASCII even in binary cases)
     print('Reading boundary...');
-    final boundaryContent = await FileUtils.readFileAsString('$meshPath/boundary');
+    final boundaryContent = utf8.decode(meshFiles[4], allowMalformed: true);
     final boundaries = FoamFileParser.parseBoundary(boundaryContent);
     print('Boundaries loaded: ${boundaries.length}');
 
@@ -0,0 +1,166 @@
+// lib/utils/batch_file_reader.dart
+
+import 'dart:async';
+import 'dart:collection';
+import 'dart:io';
+import 'dart:typed_data';
+
+/// A single read: a whole file, or a byte range inside a file.
+class ReadRequest {
+  final String path;
+  final int offset;
+
+  /// Number of bytes to read, or null to read up to the end of the file
+  final int? length;
+
+  /// Optional caller-owned buffer to read into (must hold [length] bytes)
+  final Uint8List? buffer;
+
+  ReadRequest(this.path, {this.offset = 0, this.length, this.buffer});
+}
+
+/// Outcome of a [ReadRequest]
+class ReadResult {
+  final int index; // Position of the request in the submitted batch
+  final ReadRequest request;
+  final Uint8List? buffer;
+  final int bytesRead;
+  final Object? error;
+
+  ReadResult({
+    required this.index,
+    required this.request,
+    this.buffer,
+    this.bytesRead = 0,
+    this.error,
+  });
+
+  bool get isSuccess => error == null && buffer != null;
+
+  /// View of the bytes actually read (no copy)
+  Uint8List get bytes => Uint8List.sublistView(buffer!, 0, bytesRead);
+}
+
+/// Reads many files, or ranges within files, with a bounded number of
+/// reads in flight.
+///
+/// Scanning a case with thousands of fields and time steps used to issue one
+/// `File.readAsBytes` future per file all at once, which floods the I/O
+/// thread pool and grows every result buffer incrementally. Here each request
+/// is sized up front, read with positional reads straight into a single
+/// preallocated buffer, and at most [queueDepth] requests are submitted at
+/// any time, across every batch sharing the reader.
+class BatchFileReader {
+  final int queueDepth;
+
+  // Reads submitted across all batches, and the batches waiting for a slot
+  int _active = 0;
+  final Queue<Completer<void>> _waiting = Queue<Completer<void>>();
+
+  BatchFileReader({this.queueDepth = 32})
+      : assert(queueDepth > 0, 'queueDepth must be positive');
+
+  /// Streams results in completion order. Failed reads are reported through
+  /// [ReadResult.error] rather than terminating the stream.
+  Stream<ReadResult> readStream(List<ReadRequest> requests) {
+    final controller = StreamController<ReadResult>();
+    int next = 0;
+    int inFlight = 0;
+
+    void pump() {
+      while (inFlight < queueDepth && next < requests.length) {
+        final index = next++;
+        inFlight++;
+        _withSlot(() => _read(index, requests[index])).then((result) {
+          inFlight--;
+          if (!controller.isClosed) controller.add(result);
+          if (next >= requests.length && inFlight == 0) {
+            controller.close();
+          } else {
+            pump();
+          }
+        });
+      }
+    }
+
+    controller.onListen = () {
+      if (requests.isEmpty) {
+        controller.close();
+      } else {
+        pump();
+      }
+    };
+    return controller.stream;
+  }
+
+  /// Reads the whole batch and returns the results in request order
+  Future<List<ReadResult>> readAll(List<ReadRequest> requests) async {
+    final results = List<ReadResult?>.filled(requests.length, null);
+    await for (final result in readStream(requests)) {
+      results[result.index] = result;
+    }
+    return results.cast<ReadResult>();
+  }
+
+  // Runs [read] once fewer than [queueDepth] reads are in flight; a
+  // finished read hands its slot straight to the longest waiting one
+  Future<T> _withSlot<T>(Future<T> Function() read) async {
+    if (_active < queueDepth) {
+      _active++;
+    } else {
+      final slot = Completer<void>();
+      _waiting.add(slot);
+      await slot.future;
+    }
+    try {
+      return await read();
+    } finally {
+      if (_waiting.isNotEmpty) {
+        _waiting.removeFirst().complete();
+      } else {
+        _active--;
+      }
+    }
+  }
+
+  static Future<ReadResult> _read(int index, ReadRequest request) async {
+    RandomAccessFile? raf;
+    try {
+      raf = await File(request.path).open();
+      final fileLength = await raf.length();
+
+      final start = request.offset.clamp(0, fileLength);
+      final available = fileLength - start;
+      final wanted = request.length == null
+          ? available
+          : (request.length! < available ? request.length! : available);
+
+      final buffer = request.buffer ?? Uint8List(wanted);
+      if (buffer.length < wanted) {
+        throw ArgumentError(
+          'Buffer for ${request.path} holds ${buffer.length} bytes, '
+          'need $wanted',
+        );
+      }
+
+      await raf.setPosition(start);
+      int read = 0;
+      while (read < wanted) {
+        final n = await raf.readInto(buffer, read, wanted);
+        if (n <= 0) break;
+        read += n;
+      }
+
+      return ReadResult(
+        index: index,
+        request: request,
+        buffer: buffer,
+        bytesRead: read,
+      );
+    } catch (e) {
+      return ReadResult(index: index, request: request, error: e);
+    } finally {
+      await raf?.close();
+    }
+  }
+}
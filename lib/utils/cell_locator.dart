@@ -0,0 +1,335 @@
+// lib/utils/cell_locator.dart
+
+import 'dart:isolate';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import 'future_cache.dart';
+import 'mesh_arrays.dart';
+import 'mesh_geometry.dart';
+import 'worker_pool.dart';
+
+/// Finds the cell containing a point (point-in-cell search).
+///
+/// Cell bounding boxes are binned into a uniform grid with roughly one mesh
+/// cell per bin. A query checks the cells in its bin, first by bounding box
+/// and then exactly against the cell's face planes: a point is inside when it
+/// lies behind every outward-facing face. This is exact for convex cells with
+/// planar faces; warped faces are tested against the plane through their
+/// [MeshGeometry] centre normal to their area vector.
+///
+/// Built once per mesh on a worker isolate. Large batches are spread over
+/// [WorkerPool.shared], with the locator copied to each worker once.
+class CellLocator implements SizedData {
+  static const int _maxGridDim = 1024;
+  static const int _parallelThreshold = 16384;
+
+  final int nCells;
+  final Int32List cellFaceOffsets; // Faces of cell c: cellFaces[offsets[c]..offsets[c+1])
+  final Int32List cellFaces; // Face f if the cell owns it, ~f if it is the neighbour
+  final Float64List faceCentres; // x, y, z per face
+  final Float64List faceNormals; // Unit normal per face, pointing out of the owner
+  final Float64List cellBounds; // minX, minY, minZ, maxX, maxY, maxZ per cell
+  final Float64List gridMin; // Lower corner of the grid
+  final Float64List gridInvStep; // Bins per unit length along x, y, z
+  final Int32List gridDims;
+  final Int32List gridOffsets; // Cells in bin b: gridCells[offsets[b]..offsets[b+1])
+  final Int32List gridCells;
+  final double tolerance;
+
+  CellLocator._({
+    required this.nCells,
+    required this.cellFaceOffsets,
+    required this.cellFaces,
+    required this.faceCentres,
+    required this.faceNormals,
+    required this.cellBounds,
+    required this.gridMin,
+    required this.gridInvStep,
+    required this.gridDims,
+    required this.gridOffsets,
+    required this.gridCells,
+    required this.tolerance,
+  });
+
+  @override
+  int get lengthInBytes =>
+      cellFaceOffsets.lengthInBytes +
+      cellFaces.lengthInBytes +
+      faceCentres.lengthInBytes +
+      faceNormals.lengthInBytes +
+      cellBounds.lengthInBytes +
+      gridOffsets.lengthInBytes +
+      gridCells.lengthInBytes;
+
+  static final Expando<Future<CellLocator>> _cache =
+      Expando<Future<CellLocator>>();
+
+  /// The locator for [mesh], built on first use
+  static Future<CellLocator> of(PolyMesh mesh) {
+    return _cache.putIfAbsentFuture(mesh, () async {
+      final geometry = await MeshGeometry.of(mesh);
+      return _buildOnWorker(MeshArrays.of(mesh), geometry);
+    });
+  }
+
+  // Kept separate so the worker closure captures only the flat arrays
+  static Future<CellLocator> _buildOnWorker(
+    MeshArrays arrays,
+    MeshGeometry geometry,
+  ) =>
+      Isolate.run(() => build(arrays, geometry));
+
+  /// Builds the locator on this isolate, from [geometry] if it is already
+  /// known
+  static CellLocator build(MeshArrays mesh, [MeshGeometry? geometry]) {
+    final stopwatch = Stopwatch()..start();
+    final nCells = mesh.nCells;
+    final nFaces = mesh.nFaces;
+    final points = mesh.points;
+
+    final cellFaceOffsets = mesh.cellFaceOffsets;
+    final cellFaces = mesh.cellFaces;
+
+    // Face centres from the mesh geometry; unit normals from its area vectors
+    geometry ??= MeshGeometry.build(mesh);
+    final faceCentres = geometry.faceCentres;
+    final faceAreas = geometry.faceAreas;
+    final faceNormals = Float64List(nFaces * 3);
+    for (int f = 0; f < nFaces; f++) {
+      final nx = faceAreas[f * 3], ny = faceAreas[f * 3 + 1], nz = faceAreas[f * 3 + 2];
+      final length = math.sqrt(nx * nx + ny * ny + nz * nz);
+      if (length > 0) {
+        faceNormals[f * 3] = nx / length;
+        faceNormals[f * 3 + 1] = ny / length;
+        faceNormals[f * 3 + 2] = nz / length;
+      }
+    }
+
+    // Cell bounding boxes and the overall extent
+    final cellBounds = Float64List(nCells * 6);
+    for (int c = 0; c < nCells; c++) {
+      cellBounds[c * 6] = cellBounds[c * 6 + 1] = cellBounds[c * 6 + 2] =
+          double.infinity;
+      cellBounds[c * 6 + 3] = cellBounds[c * 6 + 4] = cellBounds[c * 6 + 5] =
+          double.negativeInfinity;
+    }
+    final lo = Float64List(3)..fillRange(0, 3, double.infinity);
+    final hi = Float64List(3)..fillRange(0, 3, double.negativeInfinity);
+    for (int c = 0; c < nCells; c++) {
+      final b = c * 6;
+      for (int k = cellFaceOffsets[c]; k < cellFaceOffsets[c + 1]; k++) {
+        final encoded = cellFaces[k];
+        final f = encoded >= 0 ? encoded : ~encoded;
+        for (int i = mesh.faceOffsets[f]; i < mesh.faceOffsets[f + 1]; i++) {
+          final p = mesh.faceVertices[i] * 3;
+          for (int axis = 0; axis < 3; axis++) {
+            final v = points[p + axis];
+            if (v < cellBounds[b + axis]) cellBounds[b + axis] = v;
+            if (v > cellBounds[b + 3 + axis]) cellBounds[b + 3 + axis] = v;
+          }
+        }
+      }
+      for (int axis = 0; axis < 3; axis++) {
+        if (cellBounds[b + axis] < lo[axis]) lo[axis] = cellBounds[b + axis];
+        if (cellBounds[b + 3 + axis] > hi[axis]) hi[axis] = cellBounds[b + 3 + axis];
+      }
+    }
+
+    // Bin size for about one cell per bin over the domain
+    final extent = Float64List(3);
+    double diagonal = 0;
+    for (int axis = 0; axis < 3; axis++) {
+      extent[axis] = nCells == 0 ? 0 : hi[axis] - lo[axis];
+      diagonal += extent[axis] * extent[axis];
+    }
+    diagonal = math.sqrt(diagonal);
+    final minExtent = math.max(diagonal * 1e-6, 1e-30);
+    double volume = 1;
+    for (int axis = 0; axis < 3; axis++) {
+      volume *= math.max(extent[axis], minExtent);
+    }
+    final binSize = math.pow(volume / math.max(nCells, 1), 1 / 3).toDouble();
+
+    final gridDims = Int32List(3);
+    final gridInvStep = Float64List(3);
+    final gridMin = Float64List(3);
+    for (int axis = 0; axis < 3; axis++) {
+      final dim = binSize > 0
+          ? (extent[axis] / binSize).ceil().clamp(1, _maxGridDim)
+          : 1;
+      gridDims[axis] = dim;
+      gridMin[axis] = nCells == 0 ? 0 : lo[axis];
+      gridInvStep[axis] = extent[axis] > 0 ? dim / extent[axis] : 0;
+    }
+    final nBins = gridDims[0] * gridDims[1] * gridDims[2];
+
+    // Two passes: count cells per bin, then fill
+    final gridOffsets = Int32List(nBins + 1);
+    final range = Int32List(6);
+    for (int c = 0; c < nCells; c++) {
+      _binRange(cellBounds, c, gridMin, gridInvStep, gridDims, range);
+      for (int k = range[2]; k <= range[5]; k++) {
+        for (int j = range[1]; j <= range[4]; j++) {
+          for (int i = range[0]; i <= range[3]; i++) {
+            gridOffsets[(k * gridDims[1] + j) * gridDims[0] + i + 1]++;
+          }
+        }
+      }
+    }
+    for (int b = 0; b < nBins; b++) {
+      gridOffsets[b + 1] += gridOffsets[b];
+    }
+    final gridCells = Int32List(gridOffsets[nBins]);
+    final binFill = Int32List.fromList(gridOffsets.sublist(0, nBins));
+    for (int c = 0; c < nCells; c++) {
+      _binRange(cellBounds, c, gridMin, gridInvStep, gridDims, range);
+      for (int k = range[2]; k <= range[5]; k++) {
+        for (int j = range[1]; j <= range[4]; j++) {
+          for (int i = range[0]; i <= range[3]; i++) {
+            gridCells[binFill[(k * gridDims[1] + j) * gridDims[0] + i]++] = c;
+          }
+        }
+      }
+    }
+
+    print(
+      'Built cell locator: $nCells cells in '
+      '${gridDims[0]}x${gridDims[1]}x${gridDims[2]} bins, '
+      '${stopwatch.elapsedMilliseconds} ms',
+    );
+
+    return CellLocator._(
+      nCells: nCells,
+      cellFaceOffsets: cellFaceOffsets,
+      cellFaces: cellFaces,
+      faceCentres: faceCentres,
+      faceNormals: faceNormals,
+      cellBounds: cellBounds,
+      gridMin: gridMin,
+      gridInvStep: gridInvStep,
+      gridDims: gridDims,
+      gridOffsets: gridOffsets,
+      gridCells: gridCells,
+      tolerance: diagonal * 1e-9,
+    );
+  }
+
+  // Inclusive bin index range (i0, j0, k0, i1, j1, k1) covered by a cell's box
+  static void _binRange(
+    Float64List cellBounds,
+    int cell,
+    Float64List gridMin,
+    Float64List gridInvStep,
+    Int32List gridDims,
+    Int32List out,
+  ) {
+    for (int axis = 0; axis < 3; axis++) {
+      final maxIndex = gridDims[axis] - 1;
+      final lo = ((cellBounds[cell * 6 + axis] - gridMin[axis]) * gridInvStep[axis])
+          .floor()
+          .clamp(0, maxIndex);
+      final hi = ((cellBounds[cell * 6 + 3 + axis] - gridMin[axis]) * gridInvStep[axis])
+          .floor()
+          .clamp(0, maxIndex);
+      out[axis] = lo;
+      out[axis + 3] = hi;
+    }
+  }
+
+  /// Whether the point lies inside [cell] (on its faces counts as inside)
+  bool contains(int cell, double x, double y, double z) {
+    for (int k = cellFaceOffsets[cell]; k < cellFaceOffsets[cell + 1]; k++) {
+      final encoded = cellFaces[k];
+      final f = (encoded >= 0 ? encoded : ~encoded) * 3;
+      double d = (x - faceCentres[f]) * faceNormals[f] +
+          (y - faceCentres[f + 1]) * faceNormals[f + 1] +
+          (z - faceCentres[f + 2]) * faceNormals[f + 2];
+      if (encoded < 0) d = -d; // Neighbour side: the normal points inwards
+      if (d > tolerance) return false;
+    }
+    return true;
+  }
+
+  /// The cell containing the point, or -1 if it lies outside the mesh.
+  ///
+  /// [hint] is tried first, which makes marching queries (lines, particle
+  /// paths) cheap when consecutive points share a cell.
+  int locate(double x, double y, double z, {int hint = -1}) {
+    if (hint >= 0 && hint < nCells && contains(hint, x, y, z)) return hint;
+
+    final i = _binIndex(x, 0);
+    final j = _binIndex(y, 1);
+    final k = _binIndex(z, 2);
+    if (i < 0 || j < 0 || k < 0) return -1;
+
+    final bin = (k * gridDims[1] + j) * gridDims[0] + i;
+    for (int n = gridOffsets[bin]; n < gridOffsets[bin + 1]; n++) {
+      final cell = gridCells[n];
+      final b = cell * 6;
+      if (x < cellBounds[b] - tolerance ||
+          y < cellBounds[b + 1] - tolerance ||
+          z < cellBounds[b + 2] - tolerance ||
+          x > cellBounds[b + 3] + tolerance ||
+          y > cellBounds[b + 4] + tolerance ||
+          z > cellBounds[b + 5] + tolerance) {
+        continue;
+      }
+      if (contains(cell, x, y, z)) return cell;
+    }
+    return -1;
+  }
+
+  // Bin index along one axis, or -1 outside the grid
+  int _binIndex(double v, int axis) {
+    final scaled = (v - gridMin[axis]) * gridInvStep[axis];
+    final dim = gridDims[axis];
+    if (scaled < -tolerance * gridInvStep[axis] ||
+        scaled > dim + tolerance * gridInvStep[axis]) {
+      return -1;
+    }
+    final index = scaled.floor();
+    return index < 0 ? 0 : (index >= dim ? dim - 1 : index);
+  }
+
+  /// Locates every point of [xyz] (x, y, z triples) on this isolate
+  Int32List locateAllSync(Float64List xyz) {
+    final n = xyz.length ~/ 3;
+    final cells = Int32List(n);
+    int hint = -1;
+    for (int p = 0; p < n; p++) {
+      final cell = locate(xyz[p * 3], xyz[p * 3 + 1], xyz[p * 3 + 2], hint: hint);
+      cells[p] = cell;
+      if (cell >= 0) hint = cell;
+    }
+    return cells;
+  }
+
+  /// Locates every point of [xyz] in parallel across the worker pool
+  Future<Int32List> locateAll(Float64List xyz) async {
+    final n = xyz.length ~/ 3;
+    if (n < _parallelThreshold) return locateAllSync(xyz);
+
+    final pool = WorkerPool.shared;
+    final key = await pool.shareObject(this);
+
+    final parts = await pool.forRanges(
+      n,
+      // A copy, so only this chunk is sent rather than the whole buffer
+      (start, end) => _locateTask(key, xyz.sublist(start * 3, end * 3)),
+      minChunk: _parallelThreshold ~/ 4,
+    );
+
+    final cells = Int32List(n);
+    int offset = 0;
+    for (final part in parts) {
+      cells.setAll(offset, part);
+      offset += part.length;
+    }
+    return cells;
+  }
+
+  static WorkerTask<Int32List> _locateTask(int key, Float64List chunk) =>
+      (store) => (store[key] as CellLocator).locateAllSync(chunk);
+}
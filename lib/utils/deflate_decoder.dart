@@ -0,0 +1,451 @@
+// lib/utils/deflate_decoder.dart
+
+import 'dart:io';
+import 'dart:typed_data';
+
+/// Receives decoded bytes `out[start..end)`, which begin at uncompressed
+/// [offset]. Return false to stop decoding.
+typedef DeflateConsumer = bool Function(
+  Uint8List out,
+  int start,
+  int end,
+  int offset,
+);
+
+/// Resumable gzip/deflate decoder that reads straight from a file.
+///
+/// dart:io's zlib cannot stop at a block boundary or restart decoding in the
+/// middle of a stream, which is what random access into a `.gz` file needs.
+/// This decoder exposes both: [onBlockBoundary] fires between deflate blocks
+/// with the exact bit position and output offset, and [resume] restarts at
+/// such a position given the 32 KB of output that preceded it.
+class DeflateDecoder {
+  static const int windowSize = 32768;
+  static const int _chunkSize = 1 << 18;
+  static const int _limit = windowSize + _chunkSize;
+
+  final RandomAccessFile _file;
+
+  // Input buffer
+  final Uint8List _input = Uint8List(1 << 20);
+  int _inputStart = 0; // File offset of _input[0]
+  int _inputLength = 0;
+  int _inputPos = 0;
+  int _bitBuf = 0;
+  int _bitCount = 0;
+  int _padBits = 0; // Zero bits appended past end of file
+
+  // Output: the last windowSize bytes of history followed by new output.
+  // The slack covers the longest match written past _limit.
+  final Uint8List _out = Uint8List(_limit + 258);
+  int _outPos = windowSize;
+  int _deliverStart = windowSize;
+  int _origin = -windowSize; // Uncompressed offset of _out[0]
+
+  bool _atMemberStart = true;
+  bool _stopped = false;
+
+  /// Called between deflate blocks (never after the last block of a member)
+  void Function(int bitOffset, int uncompressedOffset)? onBlockBoundary;
+
+  /// Starts decoding at the beginning of a gzip file
+  DeflateDecoder(this._file) {
+    _seek(0);
+  }
+
+  /// Starts decoding at a block boundary previously reported through
+  /// [onBlockBoundary], given the [window] of output that preceded it
+  DeflateDecoder.resume(
+    this._file, {
+    required int bitOffset,
+    required int uncompressedOffset,
+    required Uint8List window,
+  }) {
+    _seek(bitOffset >> 3);
+    final skip = bitOffset & 7;
+    if (skip > 0) _bits(skip);
+    _out.setRange(0, windowSize, window);
+    _origin = uncompressedOffset - windowSize;
+    _atMemberStart = false;
+  }
+
+  /// Uncompressed offset of the next byte to be decoded
+  int get position => _origin + _outPos;
+
+  /// Bit offset in the file of the next unread bit
+  int get bitOffset =>
+      (_inputStart + _inputPos) * 8 - (_bitCount - _padBits);
+
+  /// The last [windowSize] bytes of output
+  Uint8List window() => _out.sublist(_outPos - windowSize, _outPos);
+
+  /// Decodes until the end of the file or until [consumer] returns false
+  void run([DeflateConsumer? consumer]) {
+    _stopped = false;
+    while (!_stopped) {
+      if (_atMemberStart) {
+        if (!_readGzipHeader()) break;
+        _atMemberStart = false;
+      }
+
+      final last = _bits(1) == 1;
+      final type = _bits(2);
+      switch (type) {
+        case 0:
+          _storedBlock(consumer);
+          break;
+        case 1:
+          _codesBlock(_fixedLengths, _fixedDistances, consumer);
+          break;
+        case 2:
+          _dynamicBlock(consumer);
+          break;
+        default:
+          throw const FormatException('Invalid deflate block type');
+      }
+      if (_stopped) break;
+
+      if (last) {
+        // Skip CRC32 and ISIZE; the next member (if any) follows
+        _alignToByte();
+        for (int i = 0; i < 8; i++) {
+          _bits(8);
+        }
+        _atMemberStart = true;
+      } else if (onBlockBoundary != null) {
+        onBlockBoundary!(bitOffset, position);
+      }
+    }
+    _flush(consumer);
+  }
+
+  // ---------------------------------------------------------------------------
+  // Input
+  // ---------------------------------------------------------------------------
+
+  void _seek(int fileOffset) {
+    _file.setPositionSync(fileOffset);
+    _inputStart = fileOffset;
+    _inputLength = 0;
+    _inputPos = 0;
+    _bitBuf = 0;
+    _bitCount = 0;
+    _padBits = 0;
+  }
+
+  void _fetchByte() {
+    if (_inputPos == _inputLength) {
+      _inputStart += _inputLength;
+      _inputLength = _file.readIntoSync(_input);
+      _inputPos = 0;
+      if (_inputLength <= 0) {
+        _inputLength = 0;
+        _padBits += 8;
+        _bitCount += 8;
+        return;
+      }
+    }
+    _bitBuf |= _input[_inputPos++] << _bitCount;
+    _bitCount += 8;
+  }
+
+  int _bits(int n) {
+    while (_bitCount < n) {
+      _fetchByte();
+    }
+    final value = _bitBuf & ((1 << n) - 1);
+    _bitBuf >>= n;
+    _bitCount -= n;
+    if (_bitCount < _padBits) {
+      throw const FormatException('Unexpected end of gzip stream');
+    }
+    return value;
+  }
+
+  void _alignToByte() {
+    final drop = _bitCount & 7;
+    _bitBuf >>= drop;
+    _bitCount -= drop;
+  }
+
+  bool get _atEndOfInput {
+    if (_bitCount - _padBits > 0) return false;
+    if (_inputPos < _inputLength) return false;
+    _inputStart += _inputLength;
+    _inputLength = _file.readIntoSync(_input);
+    _inputPos = 0;
+    if (_inputLength < 0) _inputLength = 0;
+    return _inputLength == 0;
+  }
+
+  bool _readGzipHeader() {
+    _alignToByte();
+    if (_atEndOfInput) return false;
+
+    // Trailing garbage after the last member ends the stream
+    if (_bits(8) != 0x1f || _bits(8) != 0x8b) return false;
+    if (_bits(8) != 8) {
+      throw const FormatException('Unsupported gzip compression method');
+    }
+    final flags = _bits(8);
+    for (int i = 0; i < 6; i++) {
+      _bits(8); // MTIME, XFL, OS
+    }
+    if (flags & 0x04 != 0) {
+      final extraLength = _bits(16);
+      for (int i = 0; i < extraLength; i++) {
+        _bits(8);
+      }
+    }
+    if (flags & 0x08 != 0) {
+      while (_bits(8) != 0) {} // File name
+    }
+    if (flags & 0x10 != 0) {
+      while (_bits(8) != 0) {} // Comment
+    }
+    if (flags & 0x02 != 0) {
+      _bits(16); // Header CRC
+    }
+    return true;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Output
+  // ---------------------------------------------------------------------------
+
+  void _flush(DeflateConsumer? consumer) {
+    if (consumer != null && _outPos > _deliverStart) {
+      if (!consumer(_out, _deliverStart, _outPos, _origin + _deliverStart)) {
+        _stopped = true;
+      }
+    }
+    _deliverStart = _outPos;
+
+    if (_outPos >= _limit) {
+      final shift = _outPos - windowSize;
+      _out.setRange(0, windowSize, _out, shift);
+      _origin += shift;
+      _outPos = windowSize;
+      _deliverStart = windowSize;
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // Blocks
+  // ---------------------------------------------------------------------------
+
+  void _storedBlock(DeflateConsumer? consumer) {
+    _alignToByte();
+    final length = _bits(16);
+    final complement = _bits(16);
+    if (length != (~complement & 0xffff)) {
+      throw const FormatException('Corrupt stored block length');
+    }
+    for (int i = 0; i < length; i++) {
+      _out[_outPos++] = _bits(8);
+      if (_outPos >= _limit) {
+        _flush(consumer);
+        if (_stopped) return;
+      }
+    }
+  }
+
+  void _codesBlock(
+    _Huffman lengths,
+    _Huffman distances,
+    DeflateConsumer? consumer,
+  ) {
+    final out = _out;
+    while (true) {
+      final symbol = _decode(lengths);
+      if (symbol < 256) {
+        out[_outPos++] = symbol;
+      } else if (symbol == 256) {
+        return;
+      } else {
+        final lengthIndex = symbol - 257;
+        if (lengthIndex >= 29) {
+          throw const FormatException('Invalid deflate length code');
+        }
+        final length =
+            _lengthBase[lengthIndex] + _bits(_lengthExtra[lengthIndex]);
+
+        final distanceIndex = _decode(distances);
+        if (distanceIndex >= 30) {
+          throw const FormatException('Invalid deflate distance code');
+        }
+        final distance =
+            _distanceBase[distanceIndex] + _bits(_distanceExtra[distanceIndex]);
+        if (distance > position) {
+          throw const FormatException('Deflate distance too far back');
+        }
+
+        int from = _outPos - distance;
+        final end = _outPos + length;
+        while (_outPos < end) {
+          out[_outPos++] = out[from++];
+        }
+      }
+
+      if (_outPos >= _limit) {
+        _flush(consumer);
+        if (_stopped) return;
+      }
+    }
+  }
+
+  void _dynamicBlock(DeflateConsumer? consumer) {
+    final nLengths = _bits(5) + 257;
+    final nDistances = _bits(5) + 1;
+    final nCodeLengths = _bits(4) + 4;
+    if (nLengths > 286 || nDistances > 30) {
+      throw const FormatException('Too many deflate codes');
+    }
+
+    final codeLengths = Uint8List(19);
+    for (int i = 0; i < nCodeLengths; i++) {
+      codeLengths[_codeLengthOrder[i]] = _bits(3);
+    }
+    final codeLengthCode = _Huffman(codeLengths);
+
+    final lengths = Uint8List(nLengths + nDistances);
+    int index = 0;
+    while (index < lengths.length) {
+      final symbol = _decode(codeLengthCode);
+      if (symbol < 16) {
+        lengths[index++] = symbol;
+        continue;
+      }
+
+      int repeatValue = 0;
+      int repeat;
+      if (symbol == 16) {
+        if (index == 0) {
+          throw const FormatException('Repeat with no previous length');
+        }
+        repeatValue = lengths[index - 1];
+        repeat = 3 + _bits(2);
+      } else if (symbol == 17) {
+        repeat = 3 + _bits(3);
+      } else {
+        repeat = 11 + _bits(7);
+      }
+      if (index + repeat > lengths.length) {
+        throw const FormatException('Too many code lengths');
+      }
+      while (repeat-- > 0) {
+        lengths[index++] = repeatValue;
+      }
+    }
+
+    if (lengths[256] == 0) {
+      throw const FormatException('Missing end-of-block code');
+    }
+
+    _codesBlock(
+      _Huffman(Uint8List.sublistView(lengths, 0, nLengths)),
+      _Huffman(Uint8List.sublistView(lengths, nLengths)),
+      consumer,
+    );
+  }
+
+  int _decode(_Huffman huffman) {
+    while (_bitCount < huffman.maxBits) {
+      _fetchByte();
+    }
+    final entry = huffman.table[_bitBuf & huffman.mask];
+    final length = entry & 15;
+    if (length == 0) {
+      throw const FormatException('Invalid Huffman code');
+    }
+    _bitBuf >>= length;
+    _bitCount -= length;
+    if (_bitCount < _padBits) {
+      throw const FormatException('Unexpected end of gzip stream');
+    }
+    return entry >> 4;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Tables
+  // ---------------------------------------------------------------------------
+
+  static const List<int> _codeLengthOrder = [
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+  ];
+  static const List<int> _lengthBase = [
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, //
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+  ];
+  static const List<int> _lengthExtra = [
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, //
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+  ];
+  static const List<int> _distanceBase = [
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, //
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, //
+    8193, 12289, 16385, 24577,
+  ];
+  static const List<int> _distanceExtra = [
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, //
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+  ];
+
+  static final _Huffman _fixedLengths = _Huffman(
+    Uint8List(288)
+      ..fillRange(0, 144, 8)
+      ..fillRange(144, 256, 9)
+      ..fillRange(256, 280, 7)
+      ..fillRange(280, 288, 8),
+  );
+  static final _Huffman _fixedDistances = _Huffman(
+    Uint8List(30)..fillRange(0, 30, 5),
+  );
+}
+
+/// Canonical Huffman code as a single lookup table indexed by the next
+/// [maxBits] input bits; entries are `symbol << 4 | codeLength`.
+class _Huffman {
+  late final int maxBits;
+  late final int mask;
+  late final Int32List table;
+
+  _Huffman(Uint8List lengths) {
+    final counts = List<int>.filled(16, 0);
+    int longest = 1;
+    for (final length in lengths) {
+      counts[length]++;
+      if (length > longest) longest = length;
+    }
+    counts[0] = 0;
+
+    maxBits = longest;
+    mask = (1 << longest) - 1;
+    table = Int32List(1 << longest);
+
+    final nextCode = List<int>.filled(16, 0);
+    int code = 0;
+    for (int bits = 1; bits <= 15; bits++) {
+      code = (code + counts[bits - 1]) << 1;
+      nextCode[bits] = code;
+    }
+
+    for (int symbol = 0; symbol < lengths.length; symbol++) {
+      final length = lengths[symbol];
+      if (length == 0) continue;
+
+      // Deflate packs Huffman codes most-significant bit first
+      int reversed = 0;
+      int c = nextCode[length]++;
+      for (int i = 0; i < length; i++) {
+        reversed = (reversed << 1) | (c & 1);
+        c >>= 1;
+      }
+
+      final entry = (symbol << 4) | length;
+      for (int i = reversed; i < table.length; i += 1 << length) {
+        table[i] = entry;
+      }
+    }
+  }
+}
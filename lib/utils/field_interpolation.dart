@@ -1,64 +1,219 @@
 // lib/utils/field_interpolation.dart
 
+import 'dart:typed_data';
+
 import '../models/openfoam_case.dart';
+import 'mesh_arrays.dart';
+import 'worker_pool.dart';
 
 class FieldInterpolation {
-  /// Convert cell-centered data to point data by averaging values from all cells sharing each point
-  static List<double> cellToPoint(List<double> cellData, PolyMesh mesh) {
-    final nPoints = mesh.points.length;
-    final nCells = cellData.length;
+  static final Expando<Float64List> _cellArrays = Expando<Float64List>();
+  static final Expando<Float64List> _pointArrays = Expando<Float64List>();
+  static final Expando<Float64List> _vectorPointArrays = Expando<Float64List>();
+
+  /// Cell values of [field] as a typed array, converted once per field
+  static Float64List cellArray(FieldData field) {
+    return _cellArrays[field] ??= field.internalField is Float64List
+        ? field.internalField as Float64List
+        : Float64List.fromList(field.internalField);
+  }
 
-    // Initialize point values and count how many cells contribute to each point
-    final pointValues = List<double>.filled(nPoints, 0.0);
-    final pointCounts = List<int>.filled(nPoints, 0);
+  /// Point values of [field]: its own if present, otherwise interpolated
+  /// from the cells once per field
+  static Float64List pointArray(FieldData field, PolyMesh mesh) {
+    return _pointArrays[field] ??= Float64List.fromList(
+      field.pointValues ?? cellToPoint(field.internalField, mesh),
+    );
+  }
 
-    // For each face, add the owner cell value to all points of that face
-    for (int faceIdx = 0; faceIdx < mesh.faces.length; faceIdx++) {
-      final face = mesh.faces[faceIdx];
+  /// Point vectors of a vector [field] (x, y, z per point), averaged from
+  /// the cells like [cellToPoint], once per field
+  static Float64List? vectorPointArray(FieldData field, PolyMesh mesh) {
+    final vectors = field.vectors;
+    if (vectors == null) return null;
+    return _vectorPointArrays[field] ??= vectorsToPoints(
+      vectors,
+      MeshArrays.of(mesh),
+    );
+  }
 
-      // Get owner cell index
-      if (faceIdx >= mesh.owner.length) continue;
-      final ownerCell = mesh.owner[faceIdx];
+  /// Cell vectors (x, y, z per cell) averaged onto the points
+  static Float64List vectorsToPoints(Float64List vectors, MeshArrays mesh) {
+    final nCells = vectors.length ~/ 3;
+    final sums = Float64List(mesh.nPoints * 3);
+    final counts = Int32List(mesh.nPoints);
+
+    void add(int f, int cell) {
+      if (cell < 0 || cell >= nCells) return;
+      for (int i = mesh.faceOffsets[f]; i < mesh.faceOffsets[f + 1]; i++) {
+        final p = mesh.faceVertices[i];
+        sums[p * 3] += vectors[cell * 3];
+        sums[p * 3 + 1] += vectors[cell * 3 + 1];
+        sums[p * 3 + 2] += vectors[cell * 3 + 2];
+        counts[p]++;
+      }
+    }
 
-      // Skip if owner cell index is out of bounds
-      if (ownerCell < 0 || ownerCell >= nCells) continue;
+    for (int f = 0; f < mesh.nFaces; f++) {
+      if (f < mesh.owner.length) add(f, mesh.owner[f]);
+      if (f < mesh.nInternalFaces) add(f, mesh.neighbour[f]);
+    }
+    for (int p = 0; p < mesh.nPoints; p++) {
+      if (counts[p] == 0) continue;
+      sums[p * 3] /= counts[p];
+      sums[p * 3 + 1] /= counts[p];
+      sums[p * 3 + 2] /= counts[p];
+    }
+    return sums;
+  }
 
-      final cellValue = cellData[ownerCell];
+  /// Cell values averaged onto the points: each point takes the mean of the
+  /// owner and neighbour values of every face it lies on. Works over the
+  /// flat arrays so it can run on a worker
+  static Float64List cellsToPoints(List<double> cellData, MeshArrays mesh) {
+    final nCells = cellData.length;
+    final sums = Float64List(mesh.nPoints);
+    final counts = Int32List(mesh.nPoints);
+
+    void add(int f, int cell) {
+      if (cell < 0 || cell >= nCells) return;
+      final value = cellData[cell];
+      for (int i = mesh.faceOffsets[f]; i < mesh.faceOffsets[f + 1]; i++) {
+        final p = mesh.faceVertices[i];
+        sums[p] += value;
+        counts[p]++;
+      }
+    }
 
-      // Add this cell's value to all points of the face
-      for (final pointIdx in face.pointIndices) {
-        if (pointIdx >= 0 && pointIdx < nPoints) {
-          pointValues[pointIdx] += cellValue;
-          pointCounts[pointIdx]++;
-        }
+    for (int f = 0; f < mesh.nFaces; f++) {
+      if (f < mesh.owner.length) add(f, mesh.owner[f]);
+      if (f < mesh.nInternalFaces) add(f, mesh.neighbour[f]);
+    }
+    for (int p = 0; p < mesh.nPoints; p++) {
+      if (counts[p] > 0) sums[p] /= counts[p];
+    }
+    return sums;
+  }
+
+  /// Worker task for [cellsToPoints] over the mesh shared under [meshKey]
+  static WorkerTask<Float64List> pointTask(int meshKey, Float64List values) =>
+      (store) => cellsToPoints(values, store[meshKey] as MeshArrays);
+
+  /// Point values averaged onto the cells, over the vertices of each
+  /// cell's faces (a point shared by several faces counts once per face,
+  /// as in [cellsToPoints])
+  static Float64List pointsToCells(List<double> pointData, MeshArrays mesh) {
+    final sums = Float64List(mesh.nCells);
+    final counts = Int32List(mesh.nCells);
+
+    void add(int f, int cell) {
+      for (int i = mesh.faceOffsets[f]; i < mesh.faceOffsets[f + 1]; i++) {
+        final p = mesh.faceVertices[i];
+        if (p >= pointData.length) continue;
+        sums[cell] += pointData[p];
+        counts[cell]++;
       }
+    }
+
+    for (int f = 0; f < mesh.nFaces; f++) {
+      if (f < mesh.owner.length) add(f, mesh.owner[f]);
+      if (f < mesh.nInternalFaces) add(f, mesh.neighbour[f]);
+    }
+    for (int c = 0; c < mesh.nCells; c++) {
+      if (counts[c] > 0) sums[c] /= counts[c];
+    }
+    return sums;
+  }
 
-      // If this is an internal face, also add the neighbour cell contribution
-      if (faceIdx < mesh.neighbour.length) {
-        final neighbourCell = mesh.neighbour[faceIdx];
-        if (neighbourCell >= 0 && neighbourCell < nCells) {
-          final neighbourValue = cellData[neighbourCell];
-
-          for (final pointIdx in face.pointIndices) {
-            if (pointIdx >= 0 && pointIdx < nPoints) {
-              pointValues[pointIdx] += neighbourValue;
-              pointCounts[pointIdx]++;
-            }
-          }
-        }
+  /// Mean magnitude of the face values around each cell, a cell-centred
+  /// stand-in for face fields such as fluxes, whose sign depends on the
+  /// face orientation
+  static Float64List facesToCells(List<double> faceData, MeshArrays mesh) {
+    final sums = Float64List(mesh.nCells);
+    final counts = Int32List(mesh.nCells);
+    final n = faceData.length < mesh.nFaces ? faceData.length : mesh.nFaces;
+
+    for (int f = 0; f < n; f++) {
+      final value = faceData[f].abs();
+      if (f < mesh.owner.length) {
+        sums[mesh.owner[f]] += value;
+        counts[mesh.owner[f]]++;
       }
+      if (f < mesh.nInternalFaces) {
+        sums[mesh.neighbour[f]] += value;
+        counts[mesh.neighbour[f]]++;
+      }
+    }
+    for (int c = 0; c < mesh.nCells; c++) {
+      if (counts[c] > 0) sums[c] /= counts[c];
     }
+    return sums;
+  }
 
-    // Average the values
-    for (int i = 0; i < nPoints; i++) {
-      if (pointCounts[i] > 0) {
-        pointValues[i] /= pointCounts[i];
+  /// a + (b - a) * t, element-wise, two lanes at a time
+  static Float64List lerp(List<double> a, List<double> b, double t) {
+    final n = a.length < b.length ? a.length : b.length;
+    final av = a is Float64List ? a : Float64List.fromList(a);
+    final bv = b is Float64List ? b : Float64List.fromList(b);
+    final out = Float64List(n);
+
+    // SIMD lanes need 16-byte aligned views; fresh arrays always are
+    int i = 0;
+    if (av.offsetInBytes % 16 == 0 && bv.offsetInBytes % 16 == 0) {
+      final pairs = n ~/ 2;
+      final a2 = Float64x2List.view(av.buffer, av.offsetInBytes, pairs);
+      final b2 = Float64x2List.view(bv.buffer, bv.offsetInBytes, pairs);
+      final out2 = Float64x2List.view(out.buffer, 0, pairs);
+      final t2 = Float64x2.splat(t);
+      for (int k = 0; k < pairs; k++) {
+        final x = a2[k];
+        out2[k] = x + (b2[k] - x) * t2;
       }
+      i = pairs * 2;
+    }
+    for (; i < n; i++) {
+      out[i] = av[i] + (bv[i] - av[i]) * t;
     }
+    return out;
+  }
 
-    return pointValues;
+  /// The field [t] of the way from [a] to [b] (0..1), for frames between
+  /// two stored time steps. Every array, patch values included, is blended
+  /// linearly, so a vector field's shown magnitude is the blend of the two
+  /// magnitudes.
+  static FieldData blend(FieldData a, FieldData b, double t) {
+    if (t <= 0) return a;
+    if (t >= 1) return b;
+    final pa = a.pointValues, pb = b.pointValues;
+    final va = a.vectors, vb = b.vectors;
+    final ta = a.tensors, tb = b.tensors;
+    final fa = a.faceValues, fb = b.faceValues;
+    return FieldData(
+      name: a.name,
+      fieldClass: a.fieldClass,
+      internalField: lerp(cellArray(a), cellArray(b), t),
+      boundaryField: {
+        for (final MapEntry(:key, :value) in a.boundaryField.entries)
+          key: _blendPatch(value, b.boundaryField[key], t),
+      },
+      pointValues: pa != null && pb != null ? lerp(pa, pb, t) : null,
+      vectors: va != null && vb != null ? lerp(va, vb, t) : null,
+      tensors: ta != null && tb != null ? lerp(ta, tb, t) : null,
+      faceValues: fa != null && fb != null ? lerp(fa, fb, t) : null,
+    );
   }
 
+  // Patch values of the same length are blended; others are kept from [a]
+  static Object? _blendPatch(Object? a, Object? b, double t) =>
+      a is List<double> && b is List<double> && a.length == b.length
+          ? lerp(a, b, t)
+          : a;
+
+  /// Convert cell-centered data to point data by averaging values from all
+  /// cells sharing each point (see [cellsToPoints])
+  static List<double> cellToPoint(List<double> cellData, PolyMesh mesh) =>
+      cellsToPoints(cellData, MeshArrays.of(mesh));
+
   /// Get min and max values from a list
   static (double, double) getMinMax(List<double> values) {
     if (values.isEmpty) return (0.0, 1.0);
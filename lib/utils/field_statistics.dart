@@ -0,0 +1,72 @@
+// lib/utils/field_statistics.dart
+
+import 'dart:typed_data';
+
+/// Range, mean and histogram of a list of field values, ignoring NaN and
+/// infinite entries.
+/// Cached per list, so repainting a legend does not rescan the field.
+class FieldStatistics {
+  static const int defaultBins = 32;
+
+  final int count; // Finite values counted
+  final double min;
+  final double max;
+  final double mean;
+  final Int32List bins; // Equal-width bins over [min, max]
+
+  const FieldStatistics({
+    required this.count,
+    required this.min,
+    required this.max,
+    required this.mean,
+    required this.bins,
+  });
+
+  /// The largest bin count, for scaling bars
+  int get maxBin {
+    int largest = 0;
+    for (final n in bins) {
+      if (n > largest) largest = n;
+    }
+    return largest;
+  }
+
+  static final Expando<FieldStatistics> _cache = Expando<FieldStatistics>();
+
+  /// Statistics of [values], computed on first use
+  static FieldStatistics of(List<double> values) {
+    return _cache[values] ??= compute(values);
+  }
+
+  /// Two passes: range and mean, then the histogram
+  static FieldStatistics compute(List<double> values, {int bins = defaultBins}) {
+    int count = 0;
+    double min = double.infinity, max = double.negativeInfinity, sum = 0;
+    for (final v in values) {
+      if (!v.isFinite) continue;
+      count++;
+      sum += v;
+      if (v < min) min = v;
+      if (v > max) max = v;
+    }
+    final histogram = Int32List(bins);
+    if (count == 0) {
+      return FieldStatistics(count: 0, min: 0, max: 0, mean: 0, bins: histogram);
+    }
+
+    final span = max - min;
+    for (final v in values) {
+      if (!v.isFinite) continue;
+      int bin = span > 0 ? ((v - min) / span * bins).floor() : 0;
+      if (bin >= bins) bin = bins - 1; // The maximum closes the last bin
+      histogram[bin]++;
+    }
+    return FieldStatistics(
+      count: count,
+      min: min,
+      max: max,
+      mean: sum / count,
+      bins: histogram,
+    );
+  }
+}
@@ -2,9 +2,17 @@
 
 import 'dart:io';
 import 'dart:convert';
+import 'dart:typed_data';
+
+import 'batch_file_reader.dart';
+import 'gzip_index.dart';
+import 'gzip_inflater.dart';
 
 /// Utility class for reading OpenFOAM files that may be compressed with gzip
 class FileUtils {
+  /// Shared reader so concurrent batches still respect one submission bound
+  static final BatchFileReader _batchReader = BatchFileReader();
+
   /// Reads a file that may exist as either 'filename' or 'filename.gz'
   /// Returns the file content as bytes
   static Future<List<int>> readFileBytes(String path) async {
@@ -18,7 +26,7 @@ class FileUtils {
       // Check if it's already gzipped (even without .gz extension)
       if (_isGzipped(bytes)) {
         print('  → Detected gzip compression, decompressing...');
-        return gzip.decode(bytes);
+        return GzipInflater.inflateAsync(bytes);
       }
       
       return bytes;
@@ -34,7 +42,7 @@ class FileUtils {
       
       // Decompress the gzipped file
       print('  → Decompressing gzip file...');
-      return gzip.decode(compressedBytes);
+      return GzipInflater.inflateAsync(compressedBytes);
     }
     
     // Neither file exists
@@ -44,6 +52,215 @@ class FileUtils {
     );
   }
   
+  /// Reads several files in one bounded batch (each may be 'name' or
+  /// 'name.gz'). Returns the decompressed bytes in the order of [paths].
+  static Future<List<List<int>>> readFilesBytes(List<String> paths) async {
+    final actualPaths = await Future.wait(paths.map(getActualFilePath));
+
+    for (int i = 0; i < paths.length; i++) {
+      if (actualPaths[i] == null) {
+        throw FileSystemException(
+          'File not found: ${paths[i]} (also tried ${paths[i]}.gz)',
+          paths[i],
+        );
+      }
+    }
+
+    print('Batch reading ${paths.length} files...');
+    final results = await _batchReader.readAll([
+      for (final path in actualPaths) ReadRequest(path!),
+    ]);
+
+    final contents = <List<int>>[];
+    final compressedIndices = <int>[];
+    for (final result in results) {
+      if (!result.isSuccess) {
+        throw FileSystemException(
+          'Failed to read file: ${result.error}',
+          result.request.path,
+        );
+      }
+
+      if (_isGzipped(result.bytes)) {
+        compressedIndices.add(contents.length);
+      }
+      contents.add(result.bytes);
+    }
+
+    // Inflate all compressed files of the batch in parallel
+    if (compressedIndices.isNotEmpty) {
+      print('  → Decompressing ${compressedIndices.length} gzip files...');
+      final inflated = await GzipInflater.inflateAll([
+        for (final i in compressedIndices) contents[i],
+      ]);
+      for (int k = 0; k < compressedIndices.length; k++) {
+        contents[compressedIndices[k]] = inflated[k];
+      }
+    }
+
+    return contents;
+  }
+
+  /// Reads only the leading bytes of several files in one bounded batch,
+  /// decompressing just enough of gzipped files to cover [headerBytes].
+  /// Missing or unreadable files map to null. Meant for sniffing FoamFile
+  /// headers when scanning time directories.
+  static Future<List<String?>> readFileHeaders(
+    List<String> paths, {
+    int headerBytes = 4096,
+  }) async {
+    final actualPaths = await Future.wait(paths.map(getActualFilePath));
+
+    final requestIndices = <int>[];
+    final requests = <ReadRequest>[];
+    for (int i = 0; i < actualPaths.length; i++) {
+      if (actualPaths[i] == null) continue;
+      requestIndices.add(i);
+      requests.add(ReadRequest(actualPaths[i]!, length: headerBytes));
+    }
+
+    final headers = List<String?>.filled(paths.length, null);
+    final results = await _batchReader.readAll(requests);
+
+    for (int r = 0; r < results.length; r++) {
+      final result = results[r];
+      if (!result.isSuccess) continue;
+
+      List<int> bytes = result.bytes;
+      if (_isGzipped(bytes)) {
+        bytes = _inflatePrefix(bytes);
+      }
+      headers[requestIndices[r]] = utf8.decode(bytes, allowMalformed: true);
+    }
+
+    return headers;
+  }
+
+  /// Inflates as much as possible of a truncated gzip stream
+  static List<int> _inflatePrefix(List<int> compressed) {
+    final filter = RawZLibFilter.inflateFilter();
+    final output = BytesBuilder(copy: false);
+    try {
+      filter.process(compressed, 0, compressed.length);
+      while (true) {
+        final chunk = filter.processed(flush: true);
+        if (chunk == null) break;
+        output.add(chunk);
+      }
+    } catch (e) {
+      // Truncated input is expected; keep whatever was inflated so far
+    }
+    return output.takeBytes();
+  }
+
+  /// Directory inside a case where derived data (such as gzip indices) is
+  /// cached between sessions
+  static String caseCacheDirectory(String casePath) => '$casePath/.d3_viewer';
+
+  /// Reads the uncompressed byte range [offset, offset + length) of a file
+  /// that may exist as 'filename' or 'filename.gz'. Compressed files are
+  /// read through a [GzipIndex], which is built on the first range read and
+  /// saved under [cacheDirectory] when one is given. The result is shorter
+  /// than [length] if the file ends first.
+  static Future<Uint8List> readFileRange(
+    String path,
+    int offset,
+    int length, {
+    String? cacheDirectory,
+  }) async {
+    final ranges = await readFileRanges(
+      path,
+      [(offset, length)],
+      cacheDirectory: cacheDirectory,
+    );
+    return ranges.first;
+  }
+
+  /// Reads several `(offset, length)` byte ranges of one file, with the same
+  /// compressed-file handling as [readFileRange]
+  static Future<List<Uint8List>> readFileRanges(
+    String path,
+    List<(int, int)> ranges, {
+    String? cacheDirectory,
+  }) async {
+    final actualPath = await getActualFilePath(path);
+    if (actualPath == null) {
+      throw FileSystemException(
+        'File not found: $path (also tried $path.gz)',
+        path,
+      );
+    }
+    if (ranges.isEmpty) return [];
+
+    final magic = await _batchReader.readAll([ReadRequest(actualPath, length: 2)]);
+    if (magic[0].isSuccess && _isGzipped(magic[0].bytes)) {
+      final index = await GzipIndex.open(
+        actualPath,
+        cacheDirectory: cacheDirectory,
+      );
+      return index.readRanges(ranges);
+    }
+
+    final results = await _batchReader.readAll([
+      for (final (offset, length) in ranges)
+        ReadRequest(actualPath, offset: offset, length: length),
+    ]);
+    for (final result in results) {
+      if (!result.isSuccess) {
+        throw FileSystemException(
+          'Could not read ${result.request.length} bytes at '
+          '${result.request.offset}: ${result.error}',
+          actualPath,
+        );
+      }
+    }
+    return [for (final result in results) result.bytes];
+  }
+
+  /// Reads a whole file like [readFileBytes], but a gzipped file is inflated
+  /// in the same pass that builds its [GzipIndex], so later [readFileRanges]
+  /// calls on it need no second full inflate
+  static Future<Uint8List> readFileBytesIndexed(
+    String path, {
+    String? cacheDirectory,
+  }) async {
+    final actualPath = await getActualFilePath(path);
+    if (actualPath == null) {
+      throw FileSystemException(
+        'File not found: $path (also tried $path.gz)',
+        path,
+      );
+    }
+    final magic = await _batchReader.readAll([ReadRequest(actualPath, length: 2)]);
+    if (magic[0].isSuccess && _isGzipped(magic[0].bytes)) {
+      return GzipIndex.inflateIndexed(actualPath, cacheDirectory: cacheDirectory);
+    }
+    print('Reading file: $actualPath');
+    return File(actualPath).readAsBytes();
+  }
+
+  /// Reads the first [length] uncompressed bytes of a file that may exist as
+  /// 'filename' or 'filename.gz', inflating only what the leading
+  /// compressed bytes cover. Shorter for small files; throws if missing.
+  static Future<Uint8List> readFilePrefix(String path, int length) async {
+    final actualPath = await getActualFilePath(path);
+    if (actualPath == null) {
+      throw FileSystemException(
+        'File not found: $path (also tried $path.gz)',
+        path,
+      );
+    }
+    final result =
+        (await _batchReader.readAll([ReadRequest(actualPath, length: length)])).first;
+    if (!result.isSuccess) {
+      throw FileSystemException('Could not read: ${result.error}', actualPath);
+    }
+    final bytes = result.bytes;
+    if (!_isGzipped(bytes)) return bytes;
+    final inflated = _inflatePrefix(bytes);
+    return inflated is Uint8List ? inflated : Uint8List.fromList(inflated);
+  }
+
   /// Reads a file as a string (decompresses if needed)
   static Future<String> readFileAsString(String path) async {
     final bytes = await readFileBytes(path);
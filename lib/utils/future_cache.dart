@@ -0,0 +1,42 @@
+// lib/utils/future_cache.dart
+
+/// Caches of computations still in flight.
+///
+/// A cached future that fails would otherwise fail every later lookup for
+/// the life of its key (a mesh or field), so each of these stores the
+/// future and drops it again once it fails; the next call retries.
+extension FutureCacheEntry<T> on Future<T> {
+  /// This future, calling [drop] if it fails
+  Future<T> droppedOnError(void Function() drop) {
+    then<void>((_) {}, onError: (Object _) => drop());
+    return this;
+  }
+}
+
+/// Per-object caches, such as one computation per mesh or field
+extension ExpandoFutureCache<T> on Expando<Future<T>> {
+  /// The future for [key], starting it with [create] if needed
+  Future<T> putIfAbsentFuture(Object key, Future<T> Function() create) {
+    final cached = this[key];
+    if (cached != null) return cached;
+    final result = create();
+    this[key] = result;
+    return result.droppedOnError(() {
+      if (identical(this[key], result)) this[key] = null;
+    });
+  }
+}
+
+/// Keyed caches, such as one computation per name
+extension MapFutureCache<K, T> on Map<K, Future<T>> {
+  /// The future for [key], starting it with [create] if needed
+  Future<T> putIfAbsentFuture(K key, Future<T> Function() create) {
+    final cached = this[key];
+    if (cached != null) return cached;
+    final result = create();
+    this[key] = result;
+    return result.droppedOnError(() {
+      if (identical(this[key], result)) remove(key);
+    });
+  }
+}
@@ -0,0 +1,364 @@
+// lib/utils/gzip_index.dart
+
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
+
+import 'deflate_decoder.dart';
+import 'lru_cache.dart';
+
+/// Point in a gzip stream from which decoding can restart
+class GzipCheckpoint {
+  final int bitOffset; // Compressed position of the next deflate block
+  final int uncompressedOffset;
+  final Uint8List window; // The 32 KB of output preceding this point
+
+  GzipCheckpoint(this.bitOffset, this.uncompressedOffset, this.window);
+}
+
+/// Random-access index for a gzip file (in the style of zlib's zran.c).
+///
+/// Reading one cell or processor slice out of a multi-GB `.gz` field used to
+/// mean inflating the whole file. The index records a checkpoint roughly
+/// every [span] bytes of output, so a range read only inflates from the
+/// nearest checkpoint before it. Indices are saved next to the case (see
+/// [open]) and invalidated when the compressed file changes.
+class GzipIndex {
+  static const int defaultSpan = 4 << 20;
+  static const List<int> _magic = [0x44, 0x33, 0x47, 0x5a, 0x49, 0x58, 0, 1];
+
+  final String path;
+  final int compressedLength;
+  final int modifiedMs;
+  final int uncompressedLength;
+  final int span;
+  final List<GzipCheckpoint> checkpoints;
+
+  GzipIndex({
+    required this.path,
+    required this.compressedLength,
+    required this.modifiedMs,
+    required this.uncompressedLength,
+    required this.span,
+    required this.checkpoints,
+  });
+
+  // Indices loaded or loading in this session, keyed by gzip path and span.
+  // Each checkpoint holds a 32 KB window, so only the most recent few are
+  // kept.
+  static final LruCache<(String, int), Future<GzipIndex>> _loaded = LruCache(4);
+
+  /// Returns the index for [gzPath] with checkpoints every [span] bytes,
+  /// loading it from [cacheDirectory] or building (and saving) it on first
+  /// use. Concurrent calls for the same file and span share one load.
+  static Future<GzipIndex> open(
+    String gzPath, {
+    String? cacheDirectory,
+    int span = defaultSpan,
+  }) async {
+    final stat = await File(gzPath).stat();
+    final modifiedMs = stat.modified.millisecondsSinceEpoch;
+
+    final key = (gzPath, span);
+    final pending = _loaded.putIfAbsentFuture(
+      key,
+      () => _load(gzPath, cacheDirectory, span),
+    );
+    final index = await pending;
+    if (index._matches(stat.size, modifiedMs)) return index;
+
+    // The file changed since this index was loaded: load it once more. A
+    // file still being written (a running solver) changes again during
+    // that load, so the fresh index, which describes the bytes it read, is
+    // returned as it is rather than rebuilt over and over.
+    _loaded.removeIfSame(key, pending);
+    return _loaded.putIfAbsentFuture(
+      key,
+      () => _load(gzPath, cacheDirectory, span),
+    );
+  }
+
+  /// Forgets the indices loaded in this session; saved ones stay on disk
+  static void clearLoaded() => _loaded.clear();
+
+  static Future<GzipIndex> _load(
+    String gzPath,
+    String? cacheDirectory,
+    int span,
+  ) async {
+    final stat = await File(gzPath).stat();
+    final modifiedMs = stat.modified.millisecondsSinceEpoch;
+    final indexFile =
+        cacheDirectory == null ? null : File(_indexPath(gzPath, cacheDirectory));
+
+    if (indexFile != null && await indexFile.exists()) {
+      try {
+        final saved = _decode(gzPath, await indexFile.readAsBytes());
+        // Saved with another span: rebuilt and saved over
+        if (saved._matches(stat.size, modifiedMs) && saved.span == span) return saved;
+      } catch (e) {
+        print('Ignoring unreadable gzip index ${indexFile.path}: $e');
+      }
+    }
+
+    print('Building gzip index for $gzPath...');
+    final index = await Isolate.run(() => build(gzPath, span: span));
+    print(
+      '  → ${index.checkpoints.length} checkpoints over '
+      '${index.uncompressedLength} bytes',
+    );
+    if (indexFile != null) await _save(index, indexFile);
+    return index;
+  }
+
+  /// Inflates the whole of [gzPath] on a worker isolate and returns its
+  /// content, recording the index on the way: the index is then loaded (and
+  /// saved) as if by [open], so later range reads cost no second pass
+  static Future<Uint8List> inflateIndexed(
+    String gzPath, {
+    String? cacheDirectory,
+    int span = defaultSpan,
+  }) async {
+    print('Inflating $gzPath and building its gzip index...');
+    final (index, bytes) =
+        await Isolate.run(() => _build(gzPath, span, keepBytes: true));
+    _loaded[(gzPath, span)] = Future.value(index);
+    if (cacheDirectory != null) {
+      await _save(index, File(_indexPath(gzPath, cacheDirectory)));
+    }
+    return bytes!;
+  }
+
+  static Future<void> _save(GzipIndex index, File indexFile) async {
+    try {
+      await indexFile.parent.create(recursive: true);
+      await indexFile.writeAsBytes(index._encode());
+    } catch (e) {
+      print('Could not save gzip index ${indexFile.path}: $e');
+    }
+  }
+
+  /// Inflates the whole file once, recording a checkpoint at the first block
+  /// boundary after every [span] bytes of output
+  static GzipIndex build(String gzPath, {int span = defaultSpan}) =>
+      _build(gzPath, span, keepBytes: false).$1;
+
+  // With [keepBytes], also returns the inflated content
+  static (GzipIndex, Uint8List?) _build(
+    String gzPath,
+    int span, {
+    required bool keepBytes,
+  }) {
+    final file = File(gzPath);
+    final stat = file.statSync();
+    final raf = file.openSync();
+    try {
+      final checkpoints = <GzipCheckpoint>[];
+      final decoder = DeflateDecoder(raf);
+      int last = 0;
+      decoder.onBlockBoundary = (bitOffset, uncompressedOffset) {
+        if (uncompressedOffset - last >= span) {
+          checkpoints.add(
+            GzipCheckpoint(bitOffset, uncompressedOffset, decoder.window()),
+          );
+          last = uncompressedOffset;
+        }
+      };
+      final output = keepBytes ? BytesBuilder() : null;
+      decoder.run(
+        output == null
+            ? null
+            : (out, start, end, _) {
+                output.add(Uint8List.sublistView(out, start, end));
+                return true;
+              },
+      );
+
+      final index = GzipIndex(
+        path: gzPath,
+        compressedLength: stat.size,
+        modifiedMs: stat.modified.millisecondsSinceEpoch,
+        uncompressedLength: decoder.position,
+        span: span,
+        checkpoints: checkpoints,
+      );
+      return (index, output?.takeBytes());
+    } finally {
+      raf.closeSync();
+    }
+  }
+
+  /// Reads uncompressed bytes [offset, offset + length) on a worker isolate
+  Future<Uint8List> readRange(int offset, int length) {
+    final checkpoint = _checkpointBefore(offset);
+    final path = this.path;
+    return Isolate.run(() => _readRangeSync(path, checkpoint, offset, length));
+  }
+
+  /// Reads several `(offset, length)` ranges on one worker isolate
+  Future<List<Uint8List>> readRanges(List<(int, int)> ranges) {
+    final starts = [for (final r in ranges) _checkpointBefore(r.$1)];
+    final path = this.path;
+    return Isolate.run(() => [
+          for (int i = 0; i < ranges.length; i++)
+            _readRangeSync(path, starts[i], ranges[i].$1, ranges[i].$2),
+        ]);
+  }
+
+  /// Synchronous variant of [readRange] for callers already off the UI isolate
+  Uint8List readRangeSync(int offset, int length) =>
+      _readRangeSync(path, _checkpointBefore(offset), offset, length);
+
+  GzipCheckpoint? _checkpointBefore(int offset) {
+    // Binary search for the last checkpoint at or before offset
+    int lo = 0;
+    int hi = checkpoints.length - 1;
+    GzipCheckpoint? best;
+    while (lo <= hi) {
+      final mid = (lo + hi) >> 1;
+      if (checkpoints[mid].uncompressedOffset <= offset) {
+        best = checkpoints[mid];
+        lo = mid + 1;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    return best;
+  }
+
+  static Uint8List _readRangeSync(
+    String path,
+    GzipCheckpoint? checkpoint,
+    int offset,
+    int length,
+  ) {
+    final result = Uint8List(length);
+    if (length <= 0) return result;
+
+    final raf = File(path).openSync();
+    try {
+      final decoder = checkpoint == null
+          ? DeflateDecoder(raf)
+          : DeflateDecoder.resume(
+              raf,
+              bitOffset: checkpoint.bitOffset,
+              uncompressedOffset: checkpoint.uncompressedOffset,
+              window: checkpoint.window,
+            );
+
+      final end = offset + length;
+      int filled = 0;
+      decoder.run((out, start, stop, chunkOffset) {
+        final chunkEnd = chunkOffset + (stop - start);
+        if (chunkEnd <= offset) return true;
+
+        final from = offset > chunkOffset ? offset : chunkOffset;
+        final to = end < chunkEnd ? end : chunkEnd;
+        result.setRange(
+          from - offset,
+          to - offset,
+          out,
+          start + (from - chunkOffset),
+        );
+        filled = to - offset;
+        return chunkEnd < end;
+      });
+
+      return filled == length ? result : Uint8List.sublistView(result, 0, filled);
+    } finally {
+      raf.closeSync();
+    }
+  }
+
+  bool _matches(int size, int modified) =>
+      compressedLength == size && modifiedMs == modified;
+
+  static String _indexPath(String gzPath, String cacheDirectory) {
+    // Flatten the path so indices for every time directory share one folder
+    final flat = gzPath.replaceAll(RegExp(r'[\\/:]'), '_');
+    return '$cacheDirectory${Platform.pathSeparator}$flat.gzidx';
+  }
+
+  // Layout: magic, then int64 fields, then per checkpoint two int64 offsets,
+  // the zlib-compressed window length (int32) and the compressed window
+  Uint8List _encode() {
+    final windows = [for (final c in checkpoints) zlib.encode(c.window)];
+    int size = _magic.length + 8 * 5;
+    for (final w in windows) {
+      size += 8 + 8 + 4 + w.length;
+    }
+
+    final bytes = Uint8List(size);
+    final data = ByteData.sublistView(bytes);
+    bytes.setRange(0, _magic.length, _magic);
+    int pos = _magic.length;
+    for (final value in [
+      compressedLength,
+      modifiedMs,
+      uncompressedLength,
+      span,
+      checkpoints.length,
+    ]) {
+      data.setInt64(pos, value, Endian.little);
+      pos += 8;
+    }
+    for (int i = 0; i < checkpoints.length; i++) {
+      data.setInt64(pos, checkpoints[i].bitOffset, Endian.little);
+      data.setInt64(pos + 8, checkpoints[i].uncompressedOffset, Endian.little);
+      data.setInt32(pos + 16, windows[i].length, Endian.little);
+      pos += 20;
+      bytes.setRange(pos, pos + windows[i].length, windows[i]);
+      pos += windows[i].length;
+    }
+    return bytes;
+  }
+
+  static GzipIndex _decode(String gzPath, Uint8List bytes) {
+    for (int i = 0; i < _magic.length; i++) {
+      if (bytes[i] != _magic[i]) {
+        throw const FormatException('Not a gzip index file');
+      }
+    }
+    final data = ByteData.sublistView(bytes);
+    int pos = _magic.length;
+    int next() {
+      final value = data.getInt64(pos, Endian.little);
+      pos += 8;
+      return value;
+    }
+
+    final compressedLength = next();
+    final modifiedMs = next();
+    final uncompressedLength = next();
+    final span = next();
+    final count = next();
+
+    final checkpoints = <GzipCheckpoint>[];
+    for (int i = 0; i < count; i++) {
+      final bitOffset = next();
+      final uncompressedOffset = next();
+      final windowLength = data.getInt32(pos, Endian.little);
+      pos += 4;
+      final window = zlib.decode(
+        Uint8List.sublistView(bytes, pos, pos + windowLength),
+      );
+      pos += windowLength;
+      checkpoints.add(
+        GzipCheckpoint(
+          bitOffset,
+          uncompressedOffset,
+          Uint8List.fromList(window),
+        ),
+      );
+    }
+
+    return GzipIndex(
+      path: gzPath,
+      compressedLength: compressedLength,
+      modifiedMs: modifiedMs,
+      uncompressedLength: uncompressedLength,
+      span: span,
+      checkpoints: checkpoints,
+    );
+  }
+}
@@ -0,0 +1,115 @@
+// lib/utils/gzip_inflater.dart
+
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+/// Gzip decompression tuned for large mesh and field files.
+///
+/// `gzip.decode` collects output in small chunks and concatenates them at the
+/// end, so every byte is copied at least twice. Here the output buffer is
+/// allocated once from the gzip ISIZE trailer and each chunk zlib produces
+/// is copied into it once, with no regrowth or final concatenation. Several
+/// files can be inflated at once on worker isolates.
+class GzipInflater {
+  /// Compressed input is fed to zlib in slices of this size
+  static const int _inputSlice = 1 << 20;
+
+  /// Inputs smaller than this are inflated inline; an isolate costs more
+  static const int _isolateThreshold = 256 * 1024;
+
+  /// Deflate cannot expand data by more than about 1032:1, so a larger
+  /// ISIZE means a corrupt trailer
+  static const int _maxRatio = 1032;
+
+  /// Uncompressed size recorded in the gzip trailer (modulo 2^32), or 0
+  static int expectedSize(List<int> compressed) {
+    final n = compressed.length;
+    if (n < 18) return 0;
+    return compressed[n - 4] |
+        (compressed[n - 3] << 8) |
+        (compressed[n - 2] << 16) |
+        (compressed[n - 1] << 24);
+  }
+
+  /// Size of the output buffer allocated for [compressed]: ISIZE when it is
+  /// plausible for the compressed size, otherwise a small guess
+  static int initialCapacity(List<int> compressed) {
+    final expected = expectedSize(compressed);
+    if (expected <= 0 || expected > compressed.length * _maxRatio) {
+      return compressed.length * 4;
+    }
+    return expected;
+  }
+
+  /// Inflates a complete gzip stream into a buffer presized from ISIZE
+  static Uint8List inflate(List<int> compressed) {
+    // ISIZE wraps for members over 4 GB and only covers the last member of a
+    // multi-member file, so the buffer still grows if the guess is short
+    var output = Uint8List(initialCapacity(compressed));
+    int written = 0;
+
+    void append(List<int> chunk) {
+      final needed = written + chunk.length;
+      if (needed > output.length) {
+        final grown = Uint8List(math.max(needed, output.length * 2));
+        grown.setRange(0, written, output);
+        output = grown;
+      }
+      output.setRange(written, needed, chunk);
+      written = needed;
+    }
+
+    final filter = RawZLibFilter.inflateFilter();
+    for (int start = 0; start < compressed.length; start += _inputSlice) {
+      final end = math.min(start + _inputSlice, compressed.length);
+      filter.process(compressed, start, end);
+      while (true) {
+        final chunk = filter.processed(flush: false);
+        if (chunk == null) break;
+        append(chunk);
+      }
+    }
+    while (true) {
+      final chunk = filter.processed(end: true);
+      if (chunk == null) break;
+      append(chunk);
+    }
+
+    if (written == output.length) return output;
+    return Uint8List.sublistView(output, 0, written);
+  }
+
+  /// Inflates off the calling isolate when the input is large enough to
+  /// be worth it
+  static Future<Uint8List> inflateAsync(List<int> compressed) {
+    if (compressed.length < _isolateThreshold) {
+      return Future.value(inflate(compressed));
+    }
+    final input = compressed is Uint8List
+        ? compressed
+        : Uint8List.fromList(compressed);
+    return Isolate.run(() => inflate(input));
+  }
+
+  /// Inflates several gzip streams in parallel, at most one per core at a
+  /// time. Results are returned in input order.
+  static Future<List<Uint8List>> inflateAll(List<List<int>> inputs) async {
+    final results = List<Uint8List?>.filled(inputs.length, null);
+    final workers = math.max(1, Platform.numberOfProcessors);
+    int next = 0;
+
+    Future<void> worker() async {
+      while (next < inputs.length) {
+        final index = next++;
+        results[index] = await inflateAsync(inputs[index]);
+      }
+    }
+
+    await Future.wait([
+      for (int i = 0; i < math.min(workers, inputs.length); i++) worker(),
+    ]);
+    return results.cast<Uint8List>();
+  }
+}
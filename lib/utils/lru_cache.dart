@@ -0,0 +1,76 @@
+// lib/utils/lru_cache.dart
+
+import 'future_cache.dart';
+
+/// Map with a fixed capacity that forgets its least recently used entry.
+///
+/// For per-(field, time) caches of large results: scrubbing through a long
+/// case would otherwise keep every step visited alive. Dart maps iterate in
+/// insertion order, so an entry is moved to the end when it is used and the
+/// first one is the next to go.
+class LruCache<K, V> {
+  final int capacity;
+
+  /// Called with each entry dropped to make room (not on [remove] or [clear])
+  final void Function(K key, V value)? onEvict;
+
+  final Map<K, V> _entries = {};
+
+  LruCache(this.capacity, {this.onEvict}) : assert(capacity > 0);
+
+  int get length => _entries.length;
+  Iterable<K> get keys => _entries.keys;
+  Iterable<V> get values => _entries.values;
+
+  /// The value for [key], marking it most recently used
+  V? operator [](K key) {
+    if (!_entries.containsKey(key)) return null;
+    final value = _entries.remove(key) as V;
+    _entries[key] = value;
+    return value;
+  }
+
+  void operator []=(K key, V value) {
+    _entries.remove(key);
+    _entries[key] = value;
+    while (_entries.length > capacity) {
+      final oldest = _entries.keys.first;
+      final evicted = _entries.remove(oldest) as V;
+      onEvict?.call(oldest, evicted);
+    }
+  }
+
+  /// The value for [key], computing and storing it with [ifAbsent] if needed
+  V putIfAbsent(K key, V Function() ifAbsent) {
+    if (_entries.containsKey(key)) return this[key] as V;
+    final value = ifAbsent();
+    this[key] = value;
+    return value;
+  }
+
+  V? remove(K key) => _entries.remove(key);
+
+  /// Removes [key] only while it still maps to [value], so a late failure
+  /// does not drop a newer entry stored under the same key
+  void removeIfSame(K key, V value) {
+    if (identical(_entries[key], value)) _entries.remove(key);
+  }
+
+  void removeWhere(bool Function(K key, V value) test) =>
+      _entries.removeWhere(test);
+
+  void clear() => _entries.clear();
+}
+
+/// Caches of computations still in flight
+extension LruFutureCache<K, T> on LruCache<K, Future<T>> {
+  /// The future for [key], starting it with [create] if needed. A future
+  /// that fails is dropped once it does, so the next call retries.
+  Future<T> putIfAbsentFuture(K key, Future<T> Function() create) {
+    final cached = this[key];
+    if (cached != null) return cached;
+    final result = create();
+    this[key] = result;
+    return result.droppedOnError(() => removeIfSame(key, result));
+  }
+}
@@ -0,0 +1,47 @@
+// lib/utils/mesh_addressing.dart
+
+import '../models/openfoam_case.dart';
+import 'mesh_arrays.dart';
+
+/// Patch lookups for a [PolyMesh], read from its cached [MeshArrays]
+class MeshAddressing {
+  final MeshArrays arrays;
+
+  MeshAddressing._(this.arrays);
+
+  static final Expando<MeshAddressing> _cache = Expando<MeshAddressing>();
+
+  static MeshAddressing of(PolyMesh mesh) =>
+      _cache[mesh] ??= MeshAddressing._(MeshArrays.of(mesh));
+
+  int get nCells => arrays.nCells;
+  int get nInternalFaces => arrays.nInternalFaces;
+
+  /// Patch names in the order used by [patchIndexOf]
+  List<String> get patchNames => arrays.patchNames;
+
+  /// Patch index of [faceIndex], or -1 for internal faces
+  int patchIndexOf(int faceIndex) {
+    final boundaryFace = faceIndex - arrays.nInternalFaces;
+    final facePatch = arrays.boundaryFacePatch;
+    if (boundaryFace < 0 || boundaryFace >= facePatch.length) return -1;
+    return facePatch[boundaryFace];
+  }
+
+  /// Patch name of [faceIndex], or null for internal faces
+  String? patchOf(int faceIndex) {
+    final patch = patchIndexOf(faceIndex);
+    return patch < 0 ? null : patchNames[patch];
+  }
+
+  /// Whether [faceIndex] is shown under the viewer's visibility settings
+  bool isFaceVisible(
+    int faceIndex,
+    bool showInternalMesh,
+    Map<String, bool> boundaryVisibility,
+  ) {
+    final patch = patchIndexOf(faceIndex);
+    if (patch < 0) return faceIndex >= nInternalFaces || showInternalMesh;
+    return boundaryVisibility[patchNames[patch]] ?? true;
+  }
+}
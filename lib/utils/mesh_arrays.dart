@@ -0,0 +1,148 @@
+// lib/utils/mesh_arrays.dart
+
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import 'worker_pool.dart';
+
+/// Flat typed-array copy of a [PolyMesh] for numeric kernels.
+///
+/// `PolyMesh` stores points and faces as lists of objects, which are slow to
+/// walk and expensive to send to worker isolates. Kernels (picking, cell
+/// location, geometry, filters) use this layout instead: xyz triples for
+/// points and a CSR list for face vertices. Built once per mesh and cached.
+class MeshArrays implements SizedData {
+  final Float64List points; // x, y, z per point
+  final Int32List faceOffsets; // Face f uses faceVertices[faceOffsets[f]..faceOffsets[f+1])
+  final Int32List faceVertices;
+  final Int32List owner;
+  final Int32List neighbour;
+  final int nCells;
+  final List<String> patchNames; // Boundary patches, in face order
+  final Int32List patchStarts; // First face of each patch
+  final Int32List patchSizes;
+
+  MeshArrays({
+    required this.points,
+    required this.faceOffsets,
+    required this.faceVertices,
+    required this.owner,
+    required this.neighbour,
+    required this.nCells,
+    this.patchNames = const [],
+    Int32List? patchStarts,
+    Int32List? patchSizes,
+  })  : patchStarts = patchStarts ?? Int32List(0),
+        patchSizes = patchSizes ?? Int32List(0);
+
+  int get nPoints => points.length ~/ 3;
+  int get nFaces => faceOffsets.length - 1;
+  int get nInternalFaces => neighbour.length;
+
+  // The cell-face lists built on first use are left out
+  @override
+  int get lengthInBytes =>
+      points.lengthInBytes +
+      faceOffsets.lengthInBytes +
+      faceVertices.lengthInBytes +
+      owner.lengthInBytes +
+      neighbour.lengthInBytes;
+
+  /// Faces of cell c: cellFaces[cellFaceOffsets[c]..cellFaceOffsets[c+1]).
+  /// Entries are f for faces the cell owns and ~f for faces where it is the
+  /// neighbour (whose normal points into the cell). Built on first use.
+  late final Int32List cellFaceOffsets = _buildCellFaceOffsets();
+  late final Int32List cellFaces = _buildCellFaces();
+
+  /// Patch index of each boundary face, boundaryFacePatch[f - nInternalFaces];
+  /// -1 for faces outside every patch. Built on first use.
+  late final Int32List boundaryFacePatch = _buildBoundaryFacePatch();
+
+  Int32List _buildBoundaryFacePatch() {
+    final patches = Int32List(nFaces - nInternalFaces);
+    patches.fillRange(0, patches.length, -1);
+    for (int p = 0; p < patchNames.length; p++) {
+      final start = patchStarts[p] - nInternalFaces;
+      for (int i = 0; i < patchSizes[p]; i++) {
+        if (start + i >= 0 && start + i < patches.length) patches[start + i] = p;
+      }
+    }
+    return patches;
+  }
+
+  Int32List _buildCellFaceOffsets() {
+    final offsets = Int32List(nCells + 1);
+    for (int f = 0; f < owner.length; f++) {
+      offsets[owner[f] + 1]++;
+    }
+    for (int f = 0; f < neighbour.length; f++) {
+      offsets[neighbour[f] + 1]++;
+    }
+    for (int c = 0; c < nCells; c++) {
+      offsets[c + 1] += offsets[c];
+    }
+    return offsets;
+  }
+
+  Int32List _buildCellFaces() {
+    final offsets = cellFaceOffsets;
+    final faces = Int32List(offsets[nCells]);
+    final fill = Int32List.fromList(offsets.sublist(0, nCells));
+    for (int f = 0; f < owner.length; f++) {
+      faces[fill[owner[f]]++] = f;
+    }
+    for (int f = 0; f < neighbour.length; f++) {
+      faces[fill[neighbour[f]]++] = ~f;
+    }
+    return faces;
+  }
+
+  static final Expando<MeshArrays> _cache = Expando<MeshArrays>();
+
+  static MeshArrays of(PolyMesh mesh) {
+    final cached = _cache[mesh];
+    if (cached != null) return cached;
+
+    final points = Float64List(mesh.points.length * 3);
+    for (int i = 0; i < mesh.points.length; i++) {
+      final p = mesh.points[i];
+      points[i * 3] = p.x;
+      points[i * 3 + 1] = p.y;
+      points[i * 3 + 2] = p.z;
+    }
+
+    final faceOffsets = Int32List(mesh.faces.length + 1);
+    for (int f = 0; f < mesh.faces.length; f++) {
+      faceOffsets[f + 1] = faceOffsets[f] + mesh.faces[f].pointIndices.length;
+    }
+    final faceVertices = Int32List(faceOffsets[mesh.faces.length]);
+    for (int f = 0; f < mesh.faces.length; f++) {
+      faceVertices.setAll(faceOffsets[f], mesh.faces[f].pointIndices);
+    }
+
+    final owner = Int32List.fromList(mesh.owner);
+    final neighbour = Int32List.fromList(mesh.neighbour);
+    int nCells = 0;
+    for (final cell in owner) {
+      if (cell + 1 > nCells) nCells = cell + 1;
+    }
+    for (final cell in neighbour) {
+      if (cell + 1 > nCells) nCells = cell + 1;
+    }
+
+    final patches = mesh.boundaries.values.toList();
+    final arrays = MeshArrays(
+      points: points,
+      faceOffsets: faceOffsets,
+      faceVertices: faceVertices,
+      owner: owner,
+      neighbour: neighbour,
+      nCells: nCells,
+      patchNames: [for (final patch in patches) patch.name],
+      patchStarts: Int32List.fromList([for (final patch in patches) patch.startFace]),
+      patchSizes: Int32List.fromList([for (final patch in patches) patch.nFaces]),
+    );
+    _cache[mesh] = arrays;
+    return arrays;
+  }
+}
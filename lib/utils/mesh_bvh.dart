@@ -0,0 +1,332 @@
+// lib/utils/mesh_bvh.dart
+
+import 'dart:typed_data';
+
+import 'mesh_arrays.dart';
+
+/// Bounding volume hierarchy over the fan-triangulated visible faces of a
+/// mesh, answering nearest ray hits in logarithmic time.
+///
+/// Everything is stored in flat typed arrays so a tree over tens of millions
+/// of triangles can be built on a worker isolate and handed back without
+/// copying. Nodes are laid out with both children of a node adjacent.
+class MeshBvh {
+  static const int _leafSize = 4;
+
+  final Float64List points; // Mesh points, by vertex id
+  final Int32List triangles; // a, b, c vertex ids per triangle (in tree order)
+  final Int32List triangleFaces; // Source face of each triangle
+  final Float64List nodeBounds; // minX, minY, minZ, maxX, maxY, maxZ per node
+  final Int32List nodeInfo; // Leaf: (first triangle, count); inner: (left child, 0)
+
+  MeshBvh._(
+    this.points,
+    this.triangles,
+    this.triangleFaces,
+    this.nodeBounds,
+    this.nodeInfo,
+  );
+
+  int get triangleCount => triangleFaces.length;
+
+  /// This tree reading [points] (the same points, e.g. the caller's own
+  /// [MeshArrays.points]) instead of its own copy
+  MeshBvh withPoints(Float64List points) =>
+      MeshBvh._(points, triangles, triangleFaces, nodeBounds, nodeInfo);
+
+  /// Builds the tree over faces whose entry in [faceVisible] is non-zero
+  static MeshBvh build(MeshArrays mesh, Uint8List faceVisible) {
+    final offsets = mesh.faceOffsets;
+    final vertices = mesh.faceVertices;
+    final points = mesh.points;
+
+    int nTriangles = 0;
+    for (int f = 0; f < mesh.nFaces; f++) {
+      final n = offsets[f + 1] - offsets[f];
+      if (faceVisible[f] != 0 && n >= 3) nTriangles += n - 2;
+    }
+
+    // Fan triangulation, as in the renderer
+    final rawTriangles = Int32List(nTriangles * 3);
+    final rawFaces = Int32List(nTriangles);
+    final centroids = Float64List(nTriangles * 3);
+    int t = 0;
+    for (int f = 0; f < mesh.nFaces; f++) {
+      final start = offsets[f];
+      final n = offsets[f + 1] - start;
+      if (faceVisible[f] == 0 || n < 3) continue;
+      for (int i = 1; i < n - 1; i++) {
+        final a = vertices[start];
+        final b = vertices[start + i];
+        final c = vertices[start + i + 1];
+        rawTriangles[t * 3] = a;
+        rawTriangles[t * 3 + 1] = b;
+        rawTriangles[t * 3 + 2] = c;
+        rawFaces[t] = f;
+        for (int k = 0; k < 3; k++) {
+          centroids[t * 3 + k] =
+              (points[a * 3 + k] + points[b * 3 + k] + points[c * 3 + k]) / 3;
+        }
+        t++;
+      }
+    }
+
+    final order = Int32List(nTriangles);
+    for (int i = 0; i < nTriangles; i++) {
+      order[i] = i;
+    }
+
+    final maxNodes = nTriangles == 0 ? 1 : 2 * nTriangles;
+    final nodeBounds = Float64List(maxNodes * 6);
+    final nodeInfo = Int32List(maxNodes * 2);
+    int nodeCount = 1;
+
+    // Explicit stack of (node, start, end) to avoid deep recursion
+    final stack = <int>[0, 0, nTriangles];
+    while (stack.isNotEmpty) {
+      final end = stack.removeLast();
+      final start = stack.removeLast();
+      final node = stack.removeLast();
+
+      // Bounds of the node's triangles and of their centroids
+      double minX = double.infinity, minY = double.infinity, minZ = double.infinity;
+      double maxX = double.negativeInfinity,
+          maxY = double.negativeInfinity,
+          maxZ = double.negativeInfinity;
+      double cMinX = double.infinity, cMinY = double.infinity, cMinZ = double.infinity;
+      double cMaxX = double.negativeInfinity,
+          cMaxY = double.negativeInfinity,
+          cMaxZ = double.negativeInfinity;
+      for (int i = start; i < end; i++) {
+        final tri = order[i];
+        for (int k = 0; k < 3; k++) {
+          final p = rawTriangles[tri * 3 + k] * 3;
+          final x = points[p], y = points[p + 1], z = points[p + 2];
+          if (x < minX) minX = x;
+          if (x > maxX) maxX = x;
+          if (y < minY) minY = y;
+          if (y > maxY) maxY = y;
+          if (z < minZ) minZ = z;
+          if (z > maxZ) maxZ = z;
+        }
+        final cx = centroids[tri * 3], cy = centroids[tri * 3 + 1], cz = centroids[tri * 3 + 2];
+        if (cx < cMinX) cMinX = cx;
+        if (cx > cMaxX) cMaxX = cx;
+        if (cy < cMinY) cMinY = cy;
+        if (cy > cMaxY) cMaxY = cy;
+        if (cz < cMinZ) cMinZ = cz;
+        if (cz > cMaxZ) cMaxZ = cz;
+      }
+      nodeBounds[node * 6] = minX;
+      nodeBounds[node * 6 + 1] = minY;
+      nodeBounds[node * 6 + 2] = minZ;
+      nodeBounds[node * 6 + 3] = maxX;
+      nodeBounds[node * 6 + 4] = maxY;
+      nodeBounds[node * 6 + 5] = maxZ;
+
+      if (end - start <= _leafSize) {
+        nodeInfo[node * 2] = start;
+        nodeInfo[node * 2 + 1] = end - start;
+        continue;
+      }
+
+      // Median split along the widest centroid axis
+      final dx = cMaxX - cMinX, dy = cMaxY - cMinY, dz = cMaxZ - cMinZ;
+      final axis = dx >= dy && dx >= dz ? 0 : (dy >= dz ? 1 : 2);
+      final mid = (start + end) >> 1;
+      _select(order, centroids, axis, start, end - 1, mid);
+
+      final left = nodeCount;
+      nodeCount += 2;
+      nodeInfo[node * 2] = left;
+      nodeInfo[node * 2 + 1] = 0;
+      stack
+        ..addAll([left, start, mid])
+        ..addAll([left + 1, mid, end]);
+    }
+
+    // Store triangles in tree order so leaves are contiguous
+    final triangles = Int32List(nTriangles * 3);
+    final triangleFaces = Int32List(nTriangles);
+    for (int i = 0; i < nTriangles; i++) {
+      final tri = order[i];
+      triangles[i * 3] = rawTriangles[tri * 3];
+      triangles[i * 3 + 1] = rawTriangles[tri * 3 + 1];
+      triangles[i * 3 + 2] = rawTriangles[tri * 3 + 2];
+      triangleFaces[i] = rawFaces[tri];
+    }
+
+    return MeshBvh._(
+      points,
+      triangles,
+      triangleFaces,
+      Float64List.sublistView(nodeBounds, 0, nodeCount * 6),
+      Int32List.sublistView(nodeInfo, 0, nodeCount * 2),
+    );
+  }
+
+  /// Quickselect: reorders order[lo..hi] so order[k] holds the triangle with
+  /// the k-th smallest centroid along [axis]
+  static void _select(
+    Int32List order,
+    Float64List centroids,
+    int axis,
+    int lo,
+    int hi,
+    int k,
+  ) {
+    while (lo < hi) {
+      final pivot = centroids[order[(lo + hi) >> 1] * 3 + axis];
+      int i = lo;
+      int j = hi;
+      while (i <= j) {
+        while (centroids[order[i] * 3 + axis] < pivot) {
+          i++;
+        }
+        while (centroids[order[j] * 3 + axis] > pivot) {
+          j--;
+        }
+        if (i <= j) {
+          final tmp = order[i];
+          order[i] = order[j];
+          order[j] = tmp;
+          i++;
+          j--;
+        }
+      }
+      if (k <= j) {
+        hi = j;
+      } else if (k >= i) {
+        lo = i;
+      } else {
+        return;
+      }
+    }
+  }
+
+  /// Nearest hit along the ray, as (face index, ray parameter), or null
+  (int, double)? intersect(
+    double ox,
+    double oy,
+    double oz,
+    double dx,
+    double dy,
+    double dz,
+  ) {
+    if (triangleCount == 0) return null;
+
+    final invX = 1.0 / dx, invY = 1.0 / dy, invZ = 1.0 / dz;
+    double bestT = double.infinity;
+    int bestTriangle = -1;
+
+    final stack = Int32List(128);
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0) {
+      final node = stack[--sp];
+      if (_entry(node, ox, oy, oz, invX, invY, invZ) >= bestT) continue;
+
+      final count = nodeInfo[node * 2 + 1];
+      if (count > 0) {
+        final first = nodeInfo[node * 2];
+        for (int i = first; i < first + count; i++) {
+          final t = _intersectTriangle(i, ox, oy, oz, dx, dy, dz);
+          if (t < bestT) {
+            bestT = t;
+            bestTriangle = i;
+          }
+        }
+        continue;
+      }
+
+      // Visit the nearer child first by pushing it last
+      final left = nodeInfo[node * 2];
+      final tLeft = _entry(left, ox, oy, oz, invX, invY, invZ);
+      final tRight = _entry(left + 1, ox, oy, oz, invX, invY, invZ);
+      if (tLeft <= tRight) {
+        if (tRight < bestT) stack[sp++] = left + 1;
+        if (tLeft < bestT) stack[sp++] = left;
+      } else {
+        if (tLeft < bestT) stack[sp++] = left;
+        if (tRight < bestT) stack[sp++] = left + 1;
+      }
+    }
+
+    if (bestTriangle < 0) return null;
+    return (triangleFaces[bestTriangle], bestT);
+  }
+
+  /// Ray parameter where the ray enters a node's box (infinity on a miss)
+  double _entry(
+    int node,
+    double ox,
+    double oy,
+    double oz,
+    double invX,
+    double invY,
+    double invZ,
+  ) {
+    final b = node * 6;
+    double t1 = (nodeBounds[b] - ox) * invX;
+    double t2 = (nodeBounds[b + 3] - ox) * invX;
+    double tMin = t1 < t2 ? t1 : t2;
+    double tMax = t1 < t2 ? t2 : t1;
+
+    t1 = (nodeBounds[b + 1] - oy) * invY;
+    t2 = (nodeBounds[b + 4] - oy) * invY;
+    tMin = _max(tMin, t1 < t2 ? t1 : t2);
+    tMax = _min(tMax, t1 < t2 ? t2 : t1);
+
+    t1 = (nodeBounds[b + 2] - oz) * invZ;
+    t2 = (nodeBounds[b + 5] - oz) * invZ;
+    tMin = _max(tMin, t1 < t2 ? t1 : t2);
+    tMax = _min(tMax, t1 < t2 ? t2 : t1);
+
+    if (tMax < 0 || tMin > tMax) return double.infinity;
+    return tMin < 0 ? 0 : tMin;
+  }
+
+  // NaN-safe min/max for slab tests with axis-parallel rays
+  static double _max(double a, double b) => b > a ? b : a;
+  static double _min(double a, double b) => b < a ? b : a;
+
+  /// Möller–Trumbore test against triangle [i]; infinity on a miss
+  double _intersectTriangle(
+    int i,
+    double ox,
+    double oy,
+    double oz,
+    double dx,
+    double dy,
+    double dz,
+  ) {
+    final a = triangles[i * 3] * 3;
+    final b = triangles[i * 3 + 1] * 3;
+    final c = triangles[i * 3 + 2] * 3;
+    final ax = points[a], ay = points[a + 1], az = points[a + 2];
+
+    final e1x = points[b] - ax, e1y = points[b + 1] - ay, e1z = points[b + 2] - az;
+    final e2x = points[c] - ax, e2y = points[c + 1] - ay, e2z = points[c + 2] - az;
+
+    final px = dy * e2z - dz * e2y;
+    final py = dz * e2x - dx * e2z;
+    final pz = dx * e2y - dy * e2x;
+    final det = e1x * px + e1y * py + e1z * pz;
+    if (det == 0.0) return double.infinity;
+    final invDet = 1.0 / det;
+
+    final tx = ox - ax, ty = oy - ay, tz = oz - az;
+    final u = (tx * px + ty * py + tz * pz) * invDet;
+    if (u < 0 || u > 1) return double.infinity;
+
+    final qx = ty * e1z - tz * e1y;
+    final qy = tz * e1x - tx * e1z;
+    final qz = tx * e1y - ty * e1x;
+    final v = (dx * qx + dy * qy + dz * qz) * invDet;
+    if (v < 0 || u + v > 1) return double.infinity;
+
+    final t = (e2x * qx + e2y * qy + e2z * qz) * invDet;
+    return t >= 0 ? t : double.infinity;
+  }
+}
@@ -0,0 +1,288 @@
+// lib/utils/mesh_geometry.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import 'future_cache.dart';
+import 'mesh_arrays.dart';
+import 'worker_pool.dart';
+
+/// Face centres, face area vectors, cell centres and cell volumes, computed
+/// with OpenFOAM's decomposition formulas.
+///
+/// Faces are split into triangles around their mean point; the centre is
+/// the area-weighted mean of the triangle centres and the area vector the
+/// sum of the triangle normals, pointing out of the owner. Cells are split
+/// into pyramids from each face to the mean of the face centres; the
+/// volume is the pyramid sum and the centre the volume-weighted mean of the
+/// pyramid centroids. Like OpenFOAM, flat triangles and inverted pyramids
+/// are given a tiny positive weight so degenerate elements stay finite.
+///
+/// Computed once per mesh: faces and then cells in chunks across
+/// [WorkerPool.shared].
+class MeshGeometry implements SizedData {
+  static const double _vSmall = 1e-300;
+
+  final Float64List faceCentres; // x, y, z per face
+  final Float64List faceAreas; // Area vector per face, out of the owner
+  final Float64List cellCentres; // x, y, z per cell
+  final Float64List cellVolumes;
+
+  const MeshGeometry({
+    required this.faceCentres,
+    required this.faceAreas,
+    required this.cellCentres,
+    required this.cellVolumes,
+  });
+
+  int get nFaces => faceCentres.length ~/ 3;
+  int get nCells => cellVolumes.length;
+
+  @override
+  int get lengthInBytes =>
+      faceCentres.lengthInBytes +
+      faceAreas.lengthInBytes +
+      cellCentres.lengthInBytes +
+      cellVolumes.lengthInBytes;
+
+  /// Magnitude of the area vector of face [f]
+  double faceArea(int f) => math.sqrt(
+        faceAreas[f * 3] * faceAreas[f * 3] +
+            faceAreas[f * 3 + 1] * faceAreas[f * 3 + 1] +
+            faceAreas[f * 3 + 2] * faceAreas[f * 3 + 2],
+      );
+
+  static final Expando<Future<MeshGeometry>> _cache =
+      Expando<Future<MeshGeometry>>();
+
+  /// The geometry of [mesh], computed on first use
+  static Future<MeshGeometry> of(PolyMesh mesh) {
+    return _cache.putIfAbsentFuture(mesh, () => _compute(MeshArrays.of(mesh)));
+  }
+
+  static Future<MeshGeometry> _compute(MeshArrays arrays) async {
+    final stopwatch = Stopwatch()..start();
+    final pool = WorkerPool.shared;
+    final meshKey = await pool.shareObject(arrays);
+
+    final faceParts = await pool.forRanges(
+      arrays.nFaces,
+      (start, end) => _faceTask(meshKey, start, end),
+      minChunk: 65536,
+    );
+    final faceCentres = Float64List(arrays.nFaces * 3);
+    final faceAreas = Float64List(arrays.nFaces * 3);
+    int offset = 0;
+    for (final (centres, areas) in faceParts) {
+      faceCentres.setAll(offset, centres);
+      faceAreas.setAll(offset, areas);
+      offset += centres.length;
+    }
+
+    final centresKey = await pool.shareObject(faceCentres);
+    final areasKey = await pool.shareObject(faceAreas);
+    final cellParts = await pool.forRanges(
+      arrays.nCells,
+      (start, end) => _cellTask(meshKey, centresKey, areasKey, start, end),
+      minChunk: 65536,
+    );
+    final cellCentres = Float64List(arrays.nCells * 3);
+    final cellVolumes = Float64List(arrays.nCells);
+    offset = 0;
+    for (final (centres, volumes) in cellParts) {
+      cellCentres.setAll(offset * 3, centres);
+      cellVolumes.setAll(offset, volumes);
+      offset += volumes.length;
+    }
+
+    print('Computed mesh geometry in ${stopwatch.elapsedMilliseconds} ms');
+    return MeshGeometry(
+      faceCentres: faceCentres,
+      faceAreas: faceAreas,
+      cellCentres: cellCentres,
+      cellVolumes: cellVolumes,
+    );
+  }
+
+  static WorkerTask<(Float64List, Float64List)> _faceTask(
+    int meshKey,
+    int start,
+    int end,
+  ) =>
+      (store) => faceGeometry(store[meshKey] as MeshArrays, start, end);
+
+  static WorkerTask<(Float64List, Float64List)> _cellTask(
+    int meshKey,
+    int centresKey,
+    int areasKey,
+    int start,
+    int end,
+  ) =>
+      (store) => cellGeometry(
+            store[meshKey] as MeshArrays,
+            store[centresKey] as Float64List,
+            store[areasKey] as Float64List,
+            start,
+            end,
+          );
+
+  /// The whole geometry on this isolate
+  static MeshGeometry build(MeshArrays m) {
+    final (faceCentres, faceAreas) = faceGeometry(m, 0, m.nFaces);
+    final (cellCentres, cellVolumes) =
+        cellGeometry(m, faceCentres, faceAreas, 0, m.nCells);
+    return MeshGeometry(
+      faceCentres: faceCentres,
+      faceAreas: faceAreas,
+      cellCentres: cellCentres,
+      cellVolumes: cellVolumes,
+    );
+  }
+
+  /// Centres and area vectors of faces [start]..[end)
+  static (Float64List, Float64List) faceGeometry(
+    MeshArrays m,
+    int start,
+    int end,
+  ) {
+    final points = m.points;
+    final centres = Float64List((end - start) * 3);
+    final areas = Float64List((end - start) * 3);
+
+    for (int f = start; f < end; f++) {
+      final first = m.faceOffsets[f];
+      final last = m.faceOffsets[f + 1];
+      final n = last - first;
+      final o = (f - start) * 3;
+      if (n < 3) continue;
+
+      if (n == 3) {
+        final a = m.faceVertices[first] * 3;
+        final b = m.faceVertices[first + 1] * 3;
+        final c = m.faceVertices[first + 2] * 3;
+        centres[o] = (points[a] + points[b] + points[c]) / 3;
+        centres[o + 1] = (points[a + 1] + points[b + 1] + points[c + 1]) / 3;
+        centres[o + 2] = (points[a + 2] + points[b + 2] + points[c + 2]) / 3;
+        final ux = points[b] - points[a], uy = points[b + 1] - points[a + 1], uz = points[b + 2] - points[a + 2];
+        final vx = points[c] - points[a], vy = points[c + 1] - points[a + 1], vz = points[c + 2] - points[a + 2];
+        areas[o] = 0.5 * (uy * vz - uz * vy);
+        areas[o + 1] = 0.5 * (uz * vx - ux * vz);
+        areas[o + 2] = 0.5 * (ux * vy - uy * vx);
+        continue;
+      }
+
+      // Estimated centre: the mean point
+      double ex = 0, ey = 0, ez = 0;
+      for (int i = first; i < last; i++) {
+        final p = m.faceVertices[i] * 3;
+        ex += points[p];
+        ey += points[p + 1];
+        ez += points[p + 2];
+      }
+      ex /= n;
+      ey /= n;
+      ez /= n;
+
+      // Triangles (p[i], p[i+1], estimate)
+      double sx = 0, sy = 0, sz = 0; // Sum of normals
+      double sumA = 0, cx = 0, cy = 0, cz = 0;
+      for (int i = first; i < last; i++) {
+        final a = m.faceVertices[i] * 3;
+        final b = m.faceVertices[i + 1 < last ? i + 1 : first] * 3;
+        final ux = points[b] - points[a], uy = points[b + 1] - points[a + 1], uz = points[b + 2] - points[a + 2];
+        final vx = ex - points[a], vy = ey - points[a + 1], vz = ez - points[a + 2];
+        final nx = uy * vz - uz * vy;
+        final ny = uz * vx - ux * vz;
+        final nz = ux * vy - uy * vx;
+        final area = math.sqrt(nx * nx + ny * ny + nz * nz);
+        sx += nx;
+        sy += ny;
+        sz += nz;
+        sumA += area;
+        cx += area * (points[a] + points[b] + ex);
+        cy += area * (points[a + 1] + points[b + 1] + ey);
+        cz += area * (points[a + 2] + points[b + 2] + ez);
+      }
+
+      if (sumA < _vSmall) {
+        centres[o] = ex;
+        centres[o + 1] = ey;
+        centres[o + 2] = ez;
+      } else {
+        centres[o] = cx / (3 * sumA);
+        centres[o + 1] = cy / (3 * sumA);
+        centres[o + 2] = cz / (3 * sumA);
+      }
+      areas[o] = 0.5 * sx;
+      areas[o + 1] = 0.5 * sy;
+      areas[o + 2] = 0.5 * sz;
+    }
+    return (centres, areas);
+  }
+
+  /// Centres and volumes of cells [start]..[end), from all face centres
+  /// and area vectors
+  static (Float64List, Float64List) cellGeometry(
+    MeshArrays m,
+    Float64List faceCentres,
+    Float64List faceAreas,
+    int start,
+    int end,
+  ) {
+    final offsets = m.cellFaceOffsets;
+    final cellFaces = m.cellFaces;
+    final centres = Float64List((end - start) * 3);
+    final volumes = Float64List(end - start);
+
+    for (int c = start; c < end; c++) {
+      final first = offsets[c];
+      final last = offsets[c + 1];
+      final o = c - start;
+      if (last == first) continue;
+
+      // Estimated centre: the mean of the face centres
+      double ex = 0, ey = 0, ez = 0;
+      for (int k = first; k < last; k++) {
+        final encoded = cellFaces[k];
+        final f = (encoded >= 0 ? encoded : ~encoded) * 3;
+        ex += faceCentres[f];
+        ey += faceCentres[f + 1];
+        ez += faceCentres[f + 2];
+      }
+      final n = last - first;
+      ex /= n;
+      ey /= n;
+      ez /= n;
+
+      // Pyramids from each face to the estimate, weighted by 3x volume
+      double volume = 0, cx = 0, cy = 0, cz = 0;
+      for (int k = first; k < last; k++) {
+        final encoded = cellFaces[k];
+        final f = (encoded >= 0 ? encoded : ~encoded) * 3;
+        final fx = faceCentres[f], fy = faceCentres[f + 1], fz = faceCentres[f + 2];
+        double pyramid = faceAreas[f] * (fx - ex) +
+            faceAreas[f + 1] * (fy - ey) +
+            faceAreas[f + 2] * (fz - ez);
+        if (encoded < 0) pyramid = -pyramid; // Neighbour: area points in
+        if (pyramid < _vSmall) pyramid = _vSmall;
+        volume += pyramid;
+        cx += pyramid * (0.75 * fx + 0.25 * ex);
+        cy += pyramid * (0.75 * fy + 0.25 * ey);
+        cz += pyramid * (0.75 * fz + 0.25 * ez);
+      }
+
+      if (volume > _vSmall * n) {
+        centres[o * 3] = cx / volume;
+        centres[o * 3 + 1] = cy / volume;
+        centres[o * 3 + 2] = cz / volume;
+      } else {
+        centres[o * 3] = ex;
+        centres[o * 3 + 1] = ey;
+        centres[o * 3 + 2] = ez;
+      }
+      volumes[o] = volume / 3;
+    }
+    return (centres, volumes);
+  }
+}
@@ -0,0 +1,236 @@
+// lib/utils/mesh_picker.dart
+
+import 'dart:isolate';
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import 'mesh_addressing.dart';
+import 'mesh_arrays.dart';
+import 'mesh_bvh.dart';
+import 'lru_cache.dart';
+
+/// What lies under a screen position
+class PickResult {
+  final int faceIndex;
+  final int cellIndex; // Owner cell of the picked face
+  final String? patchName; // Null for internal faces
+  final Vector3 point; // Hit position in mesh space
+  final double distance; // Along the pick ray
+
+  PickResult({
+    required this.faceIndex,
+    required this.cellIndex,
+    required this.patchName,
+    required this.point,
+    required this.distance,
+  });
+}
+
+/// Ray picking against the visible faces of a mesh.
+///
+/// Picks go through a [MeshBvh] once one has been built for the mesh and
+/// visibility settings (see [prepare]); until then they fall back to testing
+/// every visible face.
+class MeshPicker {
+  static const int _maxTreesPerMesh = 4;
+
+  // Trees per mesh, keyed by visibility settings
+  static final Expando<LruCache<String, MeshBvh>> _trees =
+      Expando<LruCache<String, MeshBvh>>();
+  static final Expando<Map<String, Future<MeshBvh>>> _pending =
+      Expando<Map<String, Future<MeshBvh>>>();
+
+  static String _visibilityKey(
+    MeshAddressing addressing,
+    bool showInternalMesh,
+    Map<String, bool> boundaryVisibility,
+  ) {
+    final hidden = [
+      for (final name in addressing.patchNames)
+        if (!(boundaryVisibility[name] ?? true)) name,
+    ];
+    return '${showInternalMesh ? 1 : 0}|${hidden.join('|')}';
+  }
+
+  /// The tree for these settings if it has already been built
+  static MeshBvh? treeFor(
+    PolyMesh mesh, {
+    bool showInternalMesh = true,
+    Map<String, bool> boundaryVisibility = const {},
+  }) {
+    final addressing = MeshAddressing.of(mesh);
+    final key = _visibilityKey(addressing, showInternalMesh, boundaryVisibility);
+    return _trees[mesh]?[key];
+  }
+
+  /// Builds (once) the tree for these settings on a worker isolate
+  static Future<MeshBvh> prepare(
+    PolyMesh mesh, {
+    bool showInternalMesh = true,
+    Map<String, bool> boundaryVisibility = const {},
+  }) {
+    final addressing = MeshAddressing.of(mesh);
+    final key = _visibilityKey(addressing, showInternalMesh, boundaryVisibility);
+    final trees = _trees[mesh] ??= LruCache<String, MeshBvh>(_maxTreesPerMesh);
+    final existing = trees[key];
+    if (existing != null) return Future.value(existing);
+
+    final pending = _pending[mesh] ??= <String, Future<MeshBvh>>{};
+    final inFlight = pending[key];
+    if (inFlight != null) return inFlight;
+
+    final build = () async {
+      final arrays = MeshArrays.of(mesh);
+      final visible = Uint8List(arrays.nFaces);
+      for (int f = 0; f < visible.length; f++) {
+        if (addressing.isFaceVisible(f, showInternalMesh, boundaryVisibility)) {
+          visible[f] = 1;
+        }
+      }
+
+      final stopwatch = Stopwatch()..start();
+      final tree = await _buildOnWorker(arrays, visible);
+      print(
+        'Built picking BVH: ${tree.triangleCount} triangles, '
+        '${tree.nodeInfo.length ~/ 2} nodes in ${stopwatch.elapsedMilliseconds} ms',
+      );
+      trees[key] = tree;
+      return tree;
+    }();
+    // Stored before it can complete, so a failed build is always removed
+    // and retried on the next call
+    pending[key] = build;
+    build.then<void>(
+      (_) => pending.remove(key),
+      onError: (Object _) => pending.remove(key),
+    );
+    return build;
+  }
+
+  // Kept separate so the worker closure captures only the flat arrays. The
+  // worker works on a copy of the points; the tree is pointed back at the
+  // caller's so that copy can be freed.
+  static Future<MeshBvh> _buildOnWorker(MeshArrays arrays, Uint8List visible) async {
+    final tree = await Isolate.run(() => MeshBvh.build(arrays, visible));
+    return tree.withPoints(arrays.points);
+  }
+
+  /// Returns the closest visible face hit by the ray, or null
+  static PickResult? pick(
+    PolyMesh mesh,
+    Vector3 origin,
+    Vector3 direction, {
+    bool showInternalMesh = true,
+    Map<String, bool> boundaryVisibility = const {},
+  }) {
+    final addressing = MeshAddressing.of(mesh);
+
+    final tree = treeFor(
+      mesh,
+      showInternalMesh: showInternalMesh,
+      boundaryVisibility: boundaryVisibility,
+    );
+    if (tree != null) {
+      final hit = tree.intersect(
+        origin.x,
+        origin.y,
+        origin.z,
+        direction.x,
+        direction.y,
+        direction.z,
+      );
+      if (hit == null) return null;
+      return _result(mesh, addressing, origin, direction, hit.$1, hit.$2);
+    }
+
+    final points = mesh.points;
+
+    int bestFace = -1;
+    double bestT = double.infinity;
+
+    for (int faceIdx = 0; faceIdx < mesh.faces.length; faceIdx++) {
+      if (!addressing.isFaceVisible(
+        faceIdx,
+        showInternalMesh,
+        boundaryVisibility,
+      )) {
+        continue;
+      }
+
+      final indices = mesh.faces[faceIdx].pointIndices;
+      if (indices.length < 3) continue;
+
+      // Fan triangulation, as in the renderer
+      final a = points[indices[0]];
+      for (int i = 1; i < indices.length - 1; i++) {
+        final t = intersectTriangle(
+          origin,
+          direction,
+          a,
+          points[indices[i]],
+          points[indices[i + 1]],
+        );
+        if (t != null && t < bestT) {
+          bestT = t;
+          bestFace = faceIdx;
+        }
+      }
+    }
+
+    if (bestFace < 0) return null;
+    return _result(mesh, addressing, origin, direction, bestFace, bestT);
+  }
+
+  static PickResult _result(
+    PolyMesh mesh,
+    MeshAddressing addressing,
+    Vector3 origin,
+    Vector3 direction,
+    int face,
+    double t,
+  ) {
+    return PickResult(
+      faceIndex: face,
+      cellIndex: face < mesh.owner.length ? mesh.owner[face] : -1,
+      patchName: addressing.patchOf(face),
+      point: Vector3(
+        origin.x + direction.x * t,
+        origin.y + direction.y * t,
+        origin.z + direction.z * t,
+      ),
+      distance: t,
+    );
+  }
+
+  /// Möller–Trumbore ray/triangle test; returns the ray parameter of the hit
+  static double? intersectTriangle(
+    Vector3 origin,
+    Vector3 direction,
+    Vector3 a,
+    Vector3 b,
+    Vector3 c,
+  ) {
+    final e1x = b.x - a.x, e1y = b.y - a.y, e1z = b.z - a.z;
+    final e2x = c.x - a.x, e2y = c.y - a.y, e2z = c.z - a.z;
+
+    final px = direction.y * e2z - direction.z * e2y;
+    final py = direction.z * e2x - direction.x * e2z;
+    final pz = direction.x * e2y - direction.y * e2x;
+    final det = e1x * px + e1y * py + e1z * pz;
+    if (det == 0.0) return null;
+    final invDet = 1.0 / det;
+
+    final tx = origin.x - a.x, ty = origin.y - a.y, tz = origin.z - a.z;
+    final u = (tx * px + ty * py + tz * pz) * invDet;
+    if (u < 0 || u > 1) return null;
+
+    final qx = ty * e1z - tz * e1y;
+    final qy = tz * e1x - tx * e1z;
+    final qz = tx * e1y - ty * e1x;
+    final v = (direction.x * qx + direction.y * qy + direction.z * qz) * invDet;
+    if (v < 0 || u + v > 1) return null;
+
+    final t = (e2x * qx + e2y * qy + e2z * qz) * invDet;
+    return t >= 0 ? t : null;
+  }
+}
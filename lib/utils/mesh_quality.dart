@@ -0,0 +1,290 @@
+// lib/utils/mesh_quality.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import '../models/openfoam_case.dart';
+import 'field_interpolation.dart';
+import 'future_cache.dart';
+import 'mesh_arrays.dart';
+import 'mesh_geometry.dart';
+import 'worker_pool.dart';
+
+/// checkMesh-style quality metrics per cell, each the worst value over the
+/// cell's faces:
+///
+/// * non-orthogonality: angle in degrees between the face area vector and
+///   the line joining the centres of the cells either side (internal
+///   faces only, like checkMesh)
+/// * skewness: distance from the face centre to where that line crosses
+///   the face, relative to the face size in that direction
+/// * aspect ratio: the larger of the Cartesian and hydraulic ratios, 1 for
+///   a cube
+/// * volume ratio: smallest neighbour-to-cell volume ratio, 1 when equal
+/// * face concavity: largest turn in degrees at a concave face corner
+///
+/// Computed once per mesh from the owner/neighbour addressing and
+/// [MeshGeometry], in cell chunks across [WorkerPool.shared]. Every cell
+/// writes only its own entries, so chunks never conflict.
+class MeshQuality {
+  static const double _rootVSmall = 1e-150;
+
+  /// Metric names, in the order of [metric]
+  static const List<String> metrics = [
+    'nonOrthogonality',
+    'skewness',
+    'aspectRatio',
+    'volumeRatio',
+    'faceConcavity',
+  ];
+
+  /// Selectable field names for the metrics, e.g. `quality:skewness`
+  static final List<String> fieldNames = [
+    for (final name in metrics) 'quality:$name',
+  ];
+
+  final Float64List nonOrthogonality;
+  final Float64List skewness;
+  final Float64List aspectRatio;
+  final Float64List volumeRatio;
+  final Float64List faceConcavity;
+
+  const MeshQuality({
+    required this.nonOrthogonality,
+    required this.skewness,
+    required this.aspectRatio,
+    required this.volumeRatio,
+    required this.faceConcavity,
+  });
+
+  int get nCells => nonOrthogonality.length;
+
+  /// Cell values of the metric called [name] (one of [metrics])
+  Float64List metric(String name) => switch (name) {
+        'nonOrthogonality' => nonOrthogonality,
+        'skewness' => skewness,
+        'aspectRatio' => aspectRatio,
+        'volumeRatio' => volumeRatio,
+        'faceConcavity' => faceConcavity,
+        _ => throw ArgumentError.value(name, 'name', 'Unknown mesh metric'),
+      };
+
+  static final Expando<Future<MeshQuality>> _cache =
+      Expando<Future<MeshQuality>>();
+  static final Expando<Map<String, Future<FieldData>>> _fields =
+      Expando<Map<String, Future<FieldData>>>();
+
+  /// The metrics of [mesh], computed on first use
+  static Future<MeshQuality> of(PolyMesh mesh) {
+    return _cache.putIfAbsentFuture(mesh, () => _compute(mesh));
+  }
+
+  /// The metric behind [fieldName] (one of [fieldNames]) as a cell field
+  /// with point values, built once per mesh
+  static Future<FieldData> field(PolyMesh mesh, String fieldName) {
+    final fields = _fields[mesh] ??= {};
+    return fields.putIfAbsentFuture(fieldName, () => _field(mesh, fieldName));
+  }
+
+  static Future<FieldData> _field(PolyMesh mesh, String fieldName) async {
+    final name = fieldName.substring('quality:'.length);
+    final values = (await of(mesh)).metric(name);
+    final pool = WorkerPool.shared;
+    final meshKey = await pool.shareObject(MeshArrays.of(mesh));
+    final pointValues = await pool.run(FieldInterpolation.pointTask(meshKey, values));
+    return FieldData(
+      name: fieldName,
+      fieldClass: 'volScalarField',
+      internalField: values,
+      boundaryField: {},
+      pointValues: pointValues,
+    );
+  }
+
+  static Future<MeshQuality> _compute(PolyMesh mesh) async {
+    final geometry = await MeshGeometry.of(mesh);
+    final stopwatch = Stopwatch()..start();
+    final pool = WorkerPool.shared;
+    final arrays = MeshArrays.of(mesh);
+    final meshKey = await pool.shareObject(arrays);
+    final geometryKey = await pool.shareObject(geometry);
+
+    final parts = await pool.forRanges(
+      arrays.nCells,
+      (start, end) => _qualityTask(meshKey, geometryKey, start, end),
+      minChunk: 65536,
+    );
+    Float64List join(Float64List Function(MeshQuality part) metric) {
+      final out = Float64List(arrays.nCells);
+      int offset = 0;
+      for (final part in parts) {
+        out.setAll(offset, metric(part));
+        offset += part.nCells;
+      }
+      return out;
+    }
+
+    final quality = MeshQuality(
+      nonOrthogonality: join((q) => q.nonOrthogonality),
+      skewness: join((q) => q.skewness),
+      aspectRatio: join((q) => q.aspectRatio),
+      volumeRatio: join((q) => q.volumeRatio),
+      faceConcavity: join((q) => q.faceConcavity),
+    );
+    print('Computed mesh quality in ${stopwatch.elapsedMilliseconds} ms');
+    return quality;
+  }
+
+  static WorkerTask<MeshQuality> _qualityTask(
+    int meshKey,
+    int geometryKey,
+    int start,
+    int end,
+  ) =>
+      (store) => build(
+            store[meshKey] as MeshArrays,
+            store[geometryKey] as MeshGeometry,
+            start,
+            end,
+          );
+
+  /// Metrics of cells [start]..[end) on this isolate
+  static MeshQuality build(
+    MeshArrays m,
+    MeshGeometry g, [
+    int start = 0,
+    int? end,
+  ]) {
+    end ??= m.nCells;
+    final n = end - start;
+    final nonOrthogonality = Float64List(n);
+    final skewness = Float64List(n);
+    final aspectRatio = Float64List(n);
+    final volumeRatio = Float64List(n);
+    final faceConcavity = Float64List(n);
+    final offsets = m.cellFaceOffsets;
+    final cellFaces = m.cellFaces;
+    final cc = g.cellCentres;
+    final fc = g.faceCentres;
+    final sf = g.faceAreas;
+    final points = m.points;
+
+    for (int c = start; c < end; c++) {
+      final px = cc[c * 3], py = cc[c * 3 + 1], pz = cc[c * 3 + 2];
+      final volume = g.cellVolumes[c];
+      double maxCos = 1, maxSkew = 0, minRatio = 1, maxConcave = 0;
+      double sumX = 0, sumY = 0, sumZ = 0; // Summed |area| components
+
+      for (int k = offsets[c]; k < offsets[c + 1]; k++) {
+        final encoded = cellFaces[k];
+        final owned = encoded >= 0;
+        final f = owned ? encoded : ~encoded;
+        final fx = fc[f * 3], fy = fc[f * 3 + 1], fz = fc[f * 3 + 2];
+        // Area vector out of this cell
+        final sign = owned ? 1.0 : -1.0;
+        final sx = sign * sf[f * 3], sy = sign * sf[f * 3 + 1], sz = sign * sf[f * 3 + 2];
+        final magS = math.sqrt(sx * sx + sy * sy + sz * sz);
+        sumX += sx.abs();
+        sumY += sy.abs();
+        sumZ += sz.abs();
+
+        // Cell centre to face centre
+        final cx = fx - px, cy = fy - py, cz = fz - pz;
+        // Cell centre to the neighbour's centre, or to the boundary face
+        // along its normal
+        double dx, dy, dz;
+        if (f < m.nInternalFaces) {
+          final other = owned ? m.neighbour[f] : m.owner[f];
+          dx = cc[other * 3] - px;
+          dy = cc[other * 3 + 1] - py;
+          dz = cc[other * 3 + 2] - pz;
+          final otherVolume = g.cellVolumes[other];
+          final ratio = math.min(volume, otherVolume) /
+              (math.max(volume, otherVolume) + _rootVSmall);
+          if (ratio < minRatio) minRatio = ratio;
+        } else {
+          final normal = (sx * cx + sy * cy + sz * cz) / (magS * magS + _rootVSmall);
+          dx = normal * sx;
+          dy = normal * sy;
+          dz = normal * sz;
+        }
+        final magD = math.sqrt(dx * dx + dy * dy + dz * dz);
+
+        if (f < m.nInternalFaces) {
+          final cos = (sx * dx + sy * dy + sz * dz) / (magS * magD + _rootVSmall);
+          if (cos < maxCos) maxCos = cos;
+        }
+
+        // Skewness vector: face centre minus where the centre line crosses
+        final t = (sx * cx + sy * cy + sz * cz) / ((sx * dx + sy * dy + sz * dz) + _rootVSmall);
+        final vx = cx - t * dx, vy = cy - t * dy, vz = cz - t * dz;
+        final magV = math.sqrt(vx * vx + vy * vy + vz * vz);
+        final hx = vx / (magV + _rootVSmall), hy = vy / (magV + _rootVSmall), hz = vz / (magV + _rootVSmall);
+        double extent = 0.2 * magD + _rootVSmall;
+        for (int i = m.faceOffsets[f]; i < m.faceOffsets[f + 1]; i++) {
+          final p = m.faceVertices[i] * 3;
+          final reach = (hx * (points[p] - fx) + hy * (points[p + 1] - fy) + hz * (points[p + 2] - fz)).abs();
+          if (reach > extent) extent = reach;
+        }
+        final skew = magV / extent;
+        if (skew > maxSkew) maxSkew = skew;
+
+        final concave = _concavity(m, sf, f);
+        if (concave > maxConcave) maxConcave = concave;
+      }
+
+      final o = c - start;
+      nonOrthogonality[o] = math.acos(maxCos.clamp(-1.0, 1.0)) * 180 / math.pi;
+      skewness[o] = maxSkew;
+      volumeRatio[o] = minRatio;
+      faceConcavity[o] = maxConcave;
+
+      final maxSum = math.max(sumX, math.max(sumY, sumZ));
+      final minSum = math.min(sumX, math.min(sumY, sumZ));
+      final hydraulic = (sumX + sumY + sumZ) /
+          (6 * math.pow(math.max(volume, _rootVSmall), 2.0 / 3.0));
+      aspectRatio[o] = math.max(maxSum / (minSum + _rootVSmall), hydraulic);
+    }
+
+    return MeshQuality(
+      nonOrthogonality: nonOrthogonality,
+      skewness: skewness,
+      aspectRatio: aspectRatio,
+      volumeRatio: volumeRatio,
+      faceConcavity: faceConcavity,
+    );
+  }
+
+  // Largest turn in degrees at a corner of face [f] whose edge cross
+  // product points against the face normal; 0 for convex faces
+  static double _concavity(MeshArrays m, Float64List sf, int f) {
+    final first = m.faceOffsets[f];
+    final last = m.faceOffsets[f + 1];
+    if (last - first < 4) return 0; // Triangles are always convex
+    final points = m.points;
+    final nx = sf[f * 3], ny = sf[f * 3 + 1], nz = sf[f * 3 + 2];
+    final magN = math.sqrt(nx * nx + ny * ny + nz * nz) + _rootVSmall;
+
+    // Unit edge into vertex [i] from its predecessor
+    (double, double, double) edge(int i) {
+      final a = m.faceVertices[i > first ? i - 1 : last - 1] * 3;
+      final b = m.faceVertices[i] * 3;
+      final x = points[b] - points[a], y = points[b + 1] - points[a + 1], z = points[b + 2] - points[a + 2];
+      final length = math.sqrt(x * x + y * y + z * z) + _rootVSmall;
+      return (x / length, y / length, z / length);
+    }
+
+    double maxSin = 0;
+    var (ax, ay, az) = edge(first);
+    for (int i = first; i < last; i++) {
+      final (bx, by, bz) = edge(i + 1 < last ? i + 1 : first);
+      final ex = ay * bz - az * by, ey = az * bx - ax * bz, ez = ax * by - ay * bx;
+      final magE = math.sqrt(ex * ex + ey * ey + ez * ez);
+      if (magE > maxSin && (ex * nx + ey * ny + ez * nz) / magN < 0) {
+        maxSin = magE;
+      }
+      (ax, ay, az) = (bx, by, bz);
+    }
+    return math.asin(math.min(maxSin, 1.0)) * 180 / math.pi;
+  }
+}
@@ -0,0 +1,126 @@
+// lib/utils/sort_utils.dart
+
+import 'dart:typed_data';
+
+/// Sorting on typed arrays, for the sorted indexes behind interactive filters.
+///
+/// `List.sort` with a comparator boxes every element and calls a closure per
+/// comparison, which is far too slow for tens of millions of cells. These
+/// sort a key array in place together with a parallel index array.
+class SortUtils {
+  static const int _insertionThreshold = 24;
+
+  /// Permutation that sorts [keys] ascending; [keys] itself is left unchanged
+  /// and the sorted keys are returned alongside. NaN keys sort last.
+  static (Int32List order, Float64List sortedKeys) argsort(List<double> keys) {
+    final n = keys.length;
+    final sorted = Float64List(n);
+    final order = Int32List(n);
+    int front = 0;
+    int back = n;
+    // NaNs do not compare, so move them out of the way first
+    for (int i = 0; i < n; i++) {
+      final key = keys[i];
+      if (key.isNaN) {
+        back--;
+        sorted[back] = key;
+        order[back] = i;
+      } else {
+        sorted[front] = key;
+        order[front] = i;
+        front++;
+      }
+    }
+    sortPairs(sorted, order, 0, front);
+    return (order, sorted);
+  }
+
+  /// Sorts keys[start..end) ascending, applying the same moves to [values]
+  static void sortPairs(Float64List keys, Int32List values, int start, int end) {
+    // Quicksort on the larger side iteratively, recursing on the smaller one
+    // keeps the stack depth logarithmic
+    while (end - start > _insertionThreshold) {
+      final mid = start + ((end - start) >> 1);
+      final pivot = _median(keys[start], keys[mid], keys[end - 1]);
+      int i = start;
+      int j = end - 1;
+      while (i <= j) {
+        while (keys[i] < pivot) {
+          i++;
+        }
+        while (keys[j] > pivot) {
+          j--;
+        }
+        if (i <= j) {
+          final k = keys[i];
+          keys[i] = keys[j];
+          keys[j] = k;
+          final v = values[i];
+          values[i] = values[j];
+          values[j] = v;
+          i++;
+          j--;
+        }
+      }
+      if (j + 1 - start < end - i) {
+        sortPairs(keys, values, start, j + 1);
+        start = i;
+      } else {
+        sortPairs(keys, values, i, end);
+        end = j + 1;
+      }
+    }
+
+    for (int i = start + 1; i < end; i++) {
+      final k = keys[i];
+      final v = values[i];
+      int j = i - 1;
+      while (j >= start && keys[j] > k) {
+        keys[j + 1] = keys[j];
+        values[j + 1] = values[j];
+        j--;
+      }
+      keys[j + 1] = k;
+      values[j + 1] = v;
+    }
+  }
+
+  static double _median(double a, double b, double c) {
+    if (a < b) {
+      if (b < c) return b;
+      return a < c ? c : a;
+    }
+    if (a < c) return a;
+    return b < c ? c : b;
+  }
+
+  /// First index in sorted[start..end) whose key is >= [value]
+  static int lowerBound(Float64List sorted, double value, [int start = 0, int? end]) {
+    int lo = start;
+    int hi = end ?? sorted.length;
+    while (lo < hi) {
+      final mid = (lo + hi) >> 1;
+      if (sorted[mid] < value) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /// First index in sorted[start..end) whose key is > [value]
+  static int upperBound(Float64List sorted, double value, [int start = 0, int? end]) {
+    int lo = start;
+    int hi = end ?? sorted.length;
+    while (lo < hi) {
+      final mid = (lo + hi) >> 1;
+      if (sorted[mid] <= value) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+}
@@ -0,0 +1,138 @@
+// lib/utils/tensor_math.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+/// Small-tensor helpers on packed arrays. Symmetric tensors are stored as
+/// six components in OpenFOAM order (xx, xy, xz, yy, yz, zz), full tensors
+/// as nine (xx, xy, xz, yx, yy, yz, zx, zy, zz).
+class TensorMath {
+  static const double _twoThirdsPi = 2 * math.pi / 3;
+
+  /// Frobenius norm of each tensor in [packed] ([components] 6 or 9 per
+  /// tensor), the value shown for a tensor field like |v| for vectors
+  static Float64List magnitudes(Float64List packed, int components) {
+    final n = packed.length ~/ components;
+    final out = Float64List(n);
+    for (int c = 0; c < n; c++) {
+      final i = c * components;
+      double sum = 0;
+      if (components == 6) {
+        final xy = packed[i + 1], xz = packed[i + 2], yz = packed[i + 4];
+        sum = packed[i] * packed[i] +
+            packed[i + 3] * packed[i + 3] +
+            packed[i + 5] * packed[i + 5] +
+            2 * (xy * xy + xz * xz + yz * yz);
+      } else {
+        for (int k = i; k < i + components; k++) {
+          sum += packed[k] * packed[k];
+        }
+      }
+      out[c] = math.sqrt(sum);
+    }
+    return out;
+  }
+
+  /// Traces of tensors [start]..[end) of [packed]
+  static Float64List traces(Float64List packed, int components, int start, int end) {
+    final out = Float64List(end - start);
+    // Diagonal offsets: xx, yy, zz
+    final yy = components == 6 ? 3 : 4;
+    final zz = components == 6 ? 5 : 8;
+    for (int c = start; c < end; c++) {
+      final i = c * components;
+      out[c - start] = packed[i] + packed[i + yy] + packed[i + zz];
+    }
+    return out;
+  }
+
+  /// von Mises equivalents sqrt(3/2 dev(T):dev(T)) of tensors
+  /// [start]..[end), from their symmetric parts
+  static Float64List vonMises(Float64List packed, int components, int start, int end) {
+    final out = Float64List(end - start);
+    final t = Float64List(6);
+    for (int c = start; c < end; c++) {
+      _symm(packed, components, c, t);
+      final xx = t[0], yy = t[3], zz = t[5];
+      final shear = t[1] * t[1] + t[2] * t[2] + t[4] * t[4];
+      out[c - start] = math.sqrt(0.5 *
+              ((xx - yy) * (xx - yy) + (yy - zz) * (yy - zz) + (zz - xx) * (zz - xx)) +
+          3 * shear);
+    }
+    return out;
+  }
+
+  /// Principal values of tensors [start]..[end), three per tensor in
+  /// descending order; full tensors use their symmetric part
+  static Float64List eigenvalues(Float64List packed, int components, int start, int end) {
+    final out = Float64List((end - start) * 3);
+    if (components == 6) {
+      for (int c = start; c < end; c++) {
+        symmEigenvalues(packed, c * 6, out, (c - start) * 3);
+      }
+      return out;
+    }
+    final t = Float64List(6);
+    for (int c = start; c < end; c++) {
+      _symm(packed, components, c, t);
+      symmEigenvalues(t, 0, out, (c - start) * 3);
+    }
+    return out;
+  }
+
+  // Symmetric part of tensor [c] of [packed] into [t]
+  static void _symm(Float64List packed, int components, int c, Float64List t) {
+    final i = c * components;
+    if (components == 6) {
+      t.setRange(0, 6, packed, i);
+      return;
+    }
+    t[0] = packed[i];
+    t[1] = 0.5 * (packed[i + 1] + packed[i + 3]);
+    t[2] = 0.5 * (packed[i + 2] + packed[i + 6]);
+    t[3] = packed[i + 4];
+    t[4] = 0.5 * (packed[i + 5] + packed[i + 7]);
+    t[5] = packed[i + 8];
+  }
+
+  /// Eigenvalues of the symmetric tensor at [t][i..i+6), written in
+  /// descending order to [out][o..o+3).
+  ///
+  /// Closed form (trigonometric solution of the characteristic cubic), so
+  /// the cost is fixed and there is no iteration to converge.
+  static void symmEigenvalues(Float64List t, int i, Float64List out, int o) {
+    final xx = t[i], xy = t[i + 1], xz = t[i + 2];
+    final yy = t[i + 3], yz = t[i + 4], zz = t[i + 5];
+    final offDiagonal = xy * xy + xz * xz + yz * yz;
+
+    if (offDiagonal == 0) {
+      // Diagonal: sort the three entries
+      double a = xx, b = yy, c = zz;
+      if (a < b) (a, b) = (b, a);
+      if (b < c) (b, c) = (c, b);
+      if (a < b) (a, b) = (b, a);
+      out[o] = a;
+      out[o + 1] = b;
+      out[o + 2] = c;
+      return;
+    }
+
+    final q = (xx + yy + zz) / 3;
+    final dx = xx - q, dy = yy - q, dz = zz - q;
+    final p = math.sqrt((dx * dx + dy * dy + dz * dz + 2 * offDiagonal) / 6);
+    // r = det((A - qI) / p) / 2, clamped against rounding
+    final det = dx * (dy * dz - yz * yz) -
+        xy * (xy * dz - yz * xz) +
+        xz * (xy * yz - dy * xz);
+    double r = det / (2 * p * p * p);
+    if (r < -1) r = -1;
+    if (r > 1) r = 1;
+    final phi = math.acos(r) / 3;
+
+    final largest = q + 2 * p * math.cos(phi);
+    final smallest = q + 2 * p * math.cos(phi + _twoThirdsPi);
+    out[o] = largest;
+    out[o + 1] = 3 * q - largest - smallest;
+    out[o + 2] = smallest;
+  }
+}
@@ -0,0 +1,155 @@
+// lib/utils/view_transform.dart
+
+import 'dart:math' as math;
+import 'dart:ui';
+
+import '../models/openfoam_case.dart';
+
+/// Camera used by the viewer: the mesh is centred on its bounding box,
+/// rotated about X then Y, and projected orthographically looking down -Z.
+///
+/// Drawing and picking both go through this class so that a screen position
+/// always maps back to what was drawn there.
+class ViewTransform {
+  final Vector3 center;
+  final double rotationX;
+  final double rotationY;
+  final double zoom;
+  final Size size;
+
+  final double _cosX;
+  final double _sinX;
+  final double _cosY;
+  final double _sinY;
+
+  ViewTransform({
+    required this.center,
+    required this.rotationX,
+    required this.rotationY,
+    required this.zoom,
+    required this.size,
+  })  : _cosX = math.cos(rotationX),
+        _sinX = math.sin(rotationX),
+        _cosY = math.cos(rotationY),
+        _sinY = math.sin(rotationY);
+
+  /// Camera centred on [mesh]
+  factory ViewTransform.forMesh(
+    PolyMesh mesh, {
+    required double rotationX,
+    required double rotationY,
+    required double zoom,
+    required Size size,
+  }) {
+    return ViewTransform(
+      center: MeshBounds.of(mesh).center,
+      rotationX: rotationX,
+      rotationY: rotationY,
+      zoom: zoom,
+      size: size,
+    );
+  }
+
+  double get _screenCenterX => size.width / 2;
+  double get _screenCenterY => size.height / 2;
+
+  /// Screen position of a mesh-space point
+  Offset project(double x, double y, double z) {
+    x -= center.x;
+    y -= center.y;
+    z -= center.z;
+    final y1 = y * _cosX - z * _sinX;
+    final z1 = y * _sinX + z * _cosX;
+    final x2 = x * _cosY + z1 * _sinY;
+    return Offset(_screenCenterX + x2 * zoom, _screenCenterY - y1 * zoom);
+  }
+
+  /// View depth of a mesh-space point (larger is closer to the viewer)
+  double depth(double x, double y, double z) {
+    x -= center.x;
+    y -= center.y;
+    z -= center.z;
+    final z1 = y * _sinX + z * _cosX;
+    return -x * _sinY + z1 * _cosY;
+  }
+
+  /// Maps a direction from view space back to mesh space
+  Vector3 _unrotate(double x2, double y1, double z2) {
+    final x = x2 * _cosY - z2 * _sinY;
+    final z1 = x2 * _sinY + z2 * _cosY;
+    final y = y1 * _cosX + z1 * _sinX;
+    final z = -y1 * _sinX + z1 * _cosX;
+    return Vector3(x, y, z);
+  }
+
+  /// Mesh-space displacement for a screen-space drag, kept in the view plane
+  Vector3 screenDelta(Offset delta) =>
+      _unrotate(delta.dx / zoom, -delta.dy / zoom, 0);
+
+  /// Ray through a screen position, starting [distance] in front of the
+  /// mesh centre and pointing into the screen
+  (Vector3, Vector3) screenRay(Offset position, {required double distance}) {
+    final viewX = (position.dx - _screenCenterX) / zoom;
+    final viewY = -(position.dy - _screenCenterY) / zoom;
+    final origin = _unrotate(viewX, viewY, distance);
+    final direction = _unrotate(0, 0, -1);
+    return (
+      Vector3(origin.x + center.x, origin.y + center.y, origin.z + center.z),
+      direction,
+    );
+  }
+}
+
+/// Axis-aligned bounds of a mesh, computed once per mesh
+class MeshBounds {
+  final Vector3 min;
+  final Vector3 max;
+
+  MeshBounds(this.min, this.max);
+
+  static final Expando<MeshBounds> _cache = Expando<MeshBounds>();
+
+  static MeshBounds of(PolyMesh mesh) {
+    final cached = _cache[mesh];
+    if (cached != null) return cached;
+
+    double minX = double.infinity;
+    double maxX = double.negativeInfinity;
+    double minY = double.infinity;
+    double maxY = double.negativeInfinity;
+    double minZ = double.infinity;
+    double maxZ = double.negativeInfinity;
+
+    for (final point in mesh.points) {
+      minX = math.min(minX, point.x);
+      maxX = math.max(maxX, point.x);
+      minY = math.min(minY, point.y);
+      maxY = math.max(maxY, point.y);
+      minZ = math.min(minZ, point.z);
+      maxZ = math.max(maxZ, point.z);
+    }
+    if (mesh.points.isEmpty) {
+      minX = maxX = minY = maxY = minZ = maxZ = 0.0;
+    }
+
+    final bounds = MeshBounds(
+      Vector3(minX, minY, minZ),
+      Vector3(maxX, maxY, maxZ),
+    );
+    _cache[mesh] = bounds;
+    return bounds;
+  }
+
+  Vector3 get center => Vector3(
+        (min.x + max.x) / 2,
+        (min.y + max.y) / 2,
+        (min.z + max.z) / 2,
+      );
+
+  double get diagonal {
+    final dx = max.x - min.x;
+    final dy = max.y - min.y;
+    final dz = max.z - min.z;
+    return math.sqrt(dx * dx + dy * dy + dz * dz);
+  }
+}
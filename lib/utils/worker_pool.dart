@@ -0,0 +1,242 @@
+// lib/utils/worker_pool.dart
+
+import 'dart:async';
+import 'dart:collection';
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+/// Per-worker storage for data shared with [WorkerPool.share]
+typedef WorkerStore = Map<int, Object?>;
+
+/// A task run on a worker; it gets the worker's resident data
+typedef WorkerTask<R> = R Function(WorkerStore store);
+
+/// Shared data that reports its size, so [WorkerPool] can bound what stays
+/// resident on the workers (typed arrays are measured directly)
+abstract interface class SizedData {
+  int get lengthInBytes;
+}
+
+/// Long-lived worker isolates for interactive parallel kernels.
+///
+/// `Isolate.run` copies everything a task captures on every call, which is
+/// fine for one-off passes but not for kernels that query the same mesh
+/// structure many times (cell location, slicing, thresholds). Here large
+/// read-only data is sent to each worker once with [share] and tasks look it
+/// up by key, so a call only carries its own inputs.
+///
+/// Tasks are closures sent to the worker, so they should capture as little
+/// as possible: build them in static helpers rather than inside methods that
+/// hold references to meshes or fields. Data read by a single task is better
+/// captured in it than shared, since every worker keeps a shared copy.
+///
+/// Objects shared with [shareObject] stay resident until they are garbage
+/// collected, but their copies across all workers are bounded by
+/// [maxResidentBytes]: whenever the pool goes idle over budget, the least
+/// recently shared objects are dropped from the workers (and shared again
+/// if used later). Objects shared since the previous trim are kept, so a
+/// caller that runs its task straight after sharing never loses its data.
+class WorkerPool {
+  final int size;
+  final int maxResidentBytes;
+  final List<Future<_Worker>?> _workers;
+  final Set<int> _shared = {};
+  final Expando<int> _objectKeys = Expando<int>();
+  late final Finalizer<int> _releaseOnCollect = Finalizer<int>(release);
+  int _next = 0;
+  static int _nextKey = 0;
+
+  // Size of one copy of each object shared with [shareObject], least
+  // recently shared first, and the keys shared since the last trim
+  final LinkedHashMap<int, int> _objectBytes = LinkedHashMap<int, int>();
+  final Set<int> _recent = {};
+  int _residentBytes = 0; // Across all workers
+  int _running = 0;
+
+  WorkerPool(this.size, {this.maxResidentBytes = 4 << 30})
+      : _workers = List<Future<_Worker>?>.filled(size, null);
+
+  /// Pool sized to the machine, used by the mesh kernels
+  static final WorkerPool shared = WorkerPool(
+    math.max(1, Platform.numberOfProcessors),
+  );
+
+  /// Bytes of shared objects currently held across all workers
+  int get residentBytes => _residentBytes;
+
+  /// A fresh key for [share]
+  static int newKey() => _nextKey++;
+
+  /// Splits [0, n) into at most [parts] contiguous ranges of at least [minChunk]
+  static List<(int, int)> ranges(int n, int parts, {int minChunk = 1}) {
+    if (n <= 0) return const [];
+    final count = math.max(1, math.min(parts, (n + minChunk - 1) ~/ minChunk));
+    final step = (n + count - 1) ~/ count;
+    return [
+      for (int start = 0; start < n; start += step)
+        (start, math.min(start + step, n)),
+    ];
+  }
+
+  // Workers start on first use; messages to one worker run in order
+  Future<_Worker> _worker(int index) => _workers[index] ??= _Worker.spawn();
+
+  /// Runs [task] on one worker (round robin unless [worker] is given)
+  Future<R> run<R>(WorkerTask<R> task, {int? worker}) async {
+    final index = (worker ?? _next++) % size;
+    _running++;
+    try {
+      final w = await _worker(index);
+      return await w.send(task) as R;
+    } finally {
+      if (--_running == 0 && _residentBytes > maxResidentBytes) {
+        // After the caller's continuation, which may run a follow-up task
+        Timer.run(_trim);
+      }
+    }
+  }
+
+  /// Runs one task per range of [0, n), spread across the workers
+  Future<List<R>> forRanges<R>(
+    int n,
+    WorkerTask<R> Function(int start, int end) taskFor, {
+    int minChunk = 1,
+  }) {
+    final parts = ranges(n, size, minChunk: minChunk);
+    return Future.wait([
+      for (int i = 0; i < parts.length; i++)
+        run(taskFor(parts[i].$1, parts[i].$2), worker: i),
+    ]);
+  }
+
+  /// Whether [key] is resident on the workers
+  bool isShared(int key) => _shared.contains(key);
+
+  /// Copies [value] to every worker under [key]; tasks read it from the store
+  Future<void> share(int key, Object? value) async {
+    if (_shared.contains(key)) return;
+    _shared.add(key);
+    await Future.wait([
+      for (int i = 0; i < size; i++) run(_storeTask(key, value), worker: i),
+    ]);
+  }
+
+  /// Shares [value] under a key tied to its identity and returns the key.
+  /// The workers' copies are dropped once [value] is garbage collected, or
+  /// earlier when the pool is over [maxResidentBytes].
+  Future<int> shareObject(Object value) async {
+    var key = _objectKeys[value];
+    if (key == null) {
+      key = newKey();
+      _objectKeys[value] = key;
+      _releaseOnCollect.attach(value, key);
+    }
+    _recent.add(key);
+    final bytes = _objectBytes.remove(key);
+    if (bytes != null) {
+      _objectBytes[key] = bytes; // Most recently shared
+    } else {
+      _objectBytes[key] = _sizeOf(value);
+      _residentBytes += _objectBytes[key]! * size;
+    }
+    await share(key, value);
+    return key;
+  }
+
+  /// Drops [key] from every running worker
+  void release(int key) {
+    final bytes = _objectBytes.remove(key);
+    if (bytes != null) _residentBytes -= bytes * size;
+    _recent.remove(key);
+    if (!_shared.remove(key)) return;
+    for (final worker in _workers) {
+      worker?.then((w) => w.send(_removeTask(key)));
+    }
+  }
+
+  // Releases the least recently shared objects not used since the last
+  // trim until the copies fit in [maxResidentBytes]
+  void _trim() {
+    if (_running > 0) return;
+    final candidates = [
+      for (final key in _objectBytes.keys)
+        if (!_recent.contains(key)) key,
+    ];
+    for (final key in candidates) {
+      if (_residentBytes <= maxResidentBytes) break;
+      release(key);
+    }
+    _recent.clear();
+  }
+
+  static int _sizeOf(Object value) => switch (value) {
+        TypedData data => data.lengthInBytes,
+        SizedData data => data.lengthInBytes,
+        _ => 0,
+      };
+
+  static WorkerTask<void> _storeTask(int key, Object? value) =>
+      (store) => store[key] = value;
+
+  static WorkerTask<void> _removeTask(int key) => (store) => store.remove(key);
+}
+
+class _Worker {
+  final SendPort _commands;
+  final ReceivePort _responses;
+  final Map<int, Completer<Object?>> _pending = {};
+  int _nextId = 0;
+
+  _Worker._(this._commands, this._responses) {
+    _responses.listen((message) {
+      final (int id, bool ok, Object? value) = message as (int, bool, Object?);
+      final completer = _pending.remove(id);
+      if (completer == null) return;
+      if (ok) {
+        completer.complete(value);
+      } else {
+        final (error, stack) = value as (String, String);
+        completer.completeError(RemoteError(error, stack));
+      }
+    });
+  }
+
+  static Future<_Worker> spawn() async {
+    final handshake = ReceivePort();
+    final results = ReceivePort();
+    await Isolate.spawn(
+      _main,
+      (handshake.sendPort, results.sendPort),
+      debugName: 'mesh-worker',
+    );
+    final commands = await handshake.first as SendPort;
+    return _Worker._(commands, results);
+  }
+
+  Future<Object?> send(WorkerTask<Object?> task) {
+    final id = _nextId++;
+    final completer = Completer<Object?>();
+    _pending[id] = completer;
+    _commands.send((id, task));
+    return completer.future;
+  }
+
+  static void _main((SendPort, SendPort) ports) {
+    final (handshake, results) = ports;
+    final commands = ReceivePort();
+    handshake.send(commands.sendPort);
+
+    final WorkerStore store = {};
+    commands.listen((message) {
+      final (int id, WorkerTask<Object?> task) =
+          message as (int, WorkerTask<Object?>);
+      try {
+        results.send((id, true, task(store)));
+      } catch (e, stack) {
+        results.send((id, false, (e.toString(), stack.toString())));
+      }
+    });
+  }
+}
@@ -0,0 +1,76 @@
+// lib/widgets/calculator_field.dart
+
+import 'package:flutter/material.dart';
+
+/// Text entry for a field calculator expression, e.g. `p + 0.5*mag(U)^2`.
+/// [onSubmit] evaluates it and returns an error message, or null when the
+/// derived field was added.
+class CalculatorField extends StatefulWidget {
+  final Future<String?> Function(String expression) onSubmit;
+
+  const CalculatorField({super.key, required this.onSubmit});
+
+  @override
+  State<CalculatorField> createState() => _CalculatorFieldState();
+}
+
+class _CalculatorFieldState extends State<CalculatorField> {
+  final TextEditingController _controller = TextEditingController();
+  bool _running = false;
+  String? _error;
+
+  @override
+  void dispose() {
+    _controller.dispose();
+    super.dispose();
+  }
+
+  Future<void> _submit() async {
+    final expression = _controller.text.trim();
+    if (expression.isEmpty || _running) return;
+    setState(() {
+      _running = true;
+      _error = null;
+    });
+    final error = await widget.onSubmit(expression);
+    if (!mounted) return;
+    setState(() {
+      _running = false;
+      _error = error;
+      if (error == null) _controller.clear();
+    });
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        TextField(
+          controller: _controller,
+          enabled: !_running,
+          style: const TextStyle(fontSize: 11, color: Color(0xFFE0E0E0)),
+          decoration: InputDecoration(
+            isDense: true,
+            hintText: 'Calculator, e.g. p + 0.5*mag(U)^2',
+            hintStyle: const TextStyle(fontSize: 10, color: Color(0xFF606060)),
+            suffixIcon: IconButton(
+              icon: Icon(_running ? Icons.hourglass_empty : Icons.calculate, size: 14),
+              visualDensity: VisualDensity.compact,
+              onPressed: _running ? null : _submit,
+            ),
+          ),
+          onSubmitted: (_) => _submit(),
+        ),
+        if (_error != null)
+          Padding(
+            padding: const EdgeInsets.only(top: 4),
+            child: Text(
+              _error!,
+              style: const TextStyle(fontSize: 9, color: Color(0xFFE57373)),
+            ),
+          ),
+      ],
+    );
+  }
+}
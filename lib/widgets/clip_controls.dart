@@ -0,0 +1,234 @@
+// lib/widgets/clip_controls.dart
+
+import 'package:flutter/material.dart';
+import '../filters/cell_subset.dart';
+import '../filters/clip_filter.dart';
+import '../models/openfoam_case.dart';
+import '../utils/color_map.dart';
+
+/// Sidebar controls for the clip filter: a plane along one axis or a box,
+/// either of which can be inverted. Updates are coalesced like the slice.
+/// The clip is removed from [subset] when the controls are closed.
+class ClipControls extends StatefulWidget {
+  final PolyMesh mesh;
+  final CellSubset subset;
+  final VoidCallback onChanged; // The subset was edited
+
+  const ClipControls({
+    super.key,
+    required this.mesh,
+    required this.subset,
+    required this.onChanged,
+  });
+
+  @override
+  State<ClipControls> createState() => _ClipControlsState();
+}
+
+class _ClipControlsState extends State<ClipControls> {
+  late ClipFilter _filter;
+  bool _box = false;
+  bool _invert = false;
+  int _axis = 0;
+  double _offset = 0;
+  Vector3 _lo = Vector3(0, 0, 0);
+  Vector3 _hi = Vector3(1, 1, 1);
+  (Vector3, Vector3)? _bounds;
+  bool _running = false;
+  bool _dirty = false;
+  int _visited = 0;
+  int _elapsedMs = 0;
+
+  @override
+  void initState() {
+    super.initState();
+    _filter = ClipFilter(widget.mesh, widget.subset);
+    _init();
+  }
+
+  @override
+  void didUpdateWidget(covariant ClipControls oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.subset != widget.subset) {
+      _filter.apply(null);
+      _filter = ClipFilter(widget.mesh, widget.subset);
+      _init();
+    }
+  }
+
+  @override
+  void dispose() {
+    final onChanged = widget.onChanged;
+    _filter.apply(null).then((_) => onChanged());
+    super.dispose();
+  }
+
+  Future<void> _init() async {
+    final bounds = await _filter.centreBounds();
+    if (!mounted) return;
+    final (lo, hi) = bounds;
+    setState(() {
+      _bounds = bounds;
+      _offset = (_component(lo, _axis) + _component(hi, _axis)) / 2;
+      // Default box: the central half of the domain
+      _lo = Vector3(
+        lo.x + (hi.x - lo.x) / 4,
+        lo.y + (hi.y - lo.y) / 4,
+        lo.z + (hi.z - lo.z) / 4,
+      );
+      _hi = Vector3(
+        hi.x - (hi.x - lo.x) / 4,
+        hi.y - (hi.y - lo.y) / 4,
+        hi.z - (hi.z - lo.z) / 4,
+      );
+    });
+    _apply();
+  }
+
+  static double _component(Vector3 v, int axis) =>
+      axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+
+  static Vector3 _withComponent(Vector3 v, int axis, double value) => Vector3(
+        axis == 0 ? value : v.x,
+        axis == 1 ? value : v.y,
+        axis == 2 ? value : v.z,
+      );
+
+  ClipRegion get _region => _box
+      ? ClipBox(_lo, _hi, invert: _invert)
+      : ClipPlane(_axis, _offset, invert: _invert);
+
+  Future<void> _apply() async {
+    if (_running) {
+      _dirty = true;
+      return;
+    }
+    _running = true;
+    try {
+      do {
+        _dirty = false;
+        final stopwatch = Stopwatch()..start();
+        final visited = await _filter.apply(_region);
+        if (!mounted) return;
+        widget.onChanged();
+        setState(() {
+          _visited = visited;
+          _elapsedMs = stopwatch.elapsedMilliseconds;
+        });
+      } while (_dirty);
+    } finally {
+      _running = false;
+    }
+  }
+
+  Widget _chip(String label, bool selected, VoidCallback onSelected) {
+    return Padding(
+      padding: const EdgeInsets.only(right: 6),
+      child: ChoiceChip(
+        label: Text(label, style: const TextStyle(fontSize: 10)),
+        selected: selected,
+        visualDensity: VisualDensity.compact,
+        onSelected: (_) => onSelected(),
+      ),
+    );
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final bounds = _bounds;
+    if (bounds == null) {
+      return const LinearProgressIndicator(minHeight: 2);
+    }
+    final (lo, hi) = bounds;
+
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Row(
+          children: [
+            _chip('Plane', !_box, () {
+              setState(() => _box = false);
+              _apply();
+            }),
+            _chip('Box', _box, () {
+              setState(() => _box = true);
+              _apply();
+            }),
+            FilterChip(
+              label: const Text('Invert', style: TextStyle(fontSize: 10)),
+              selected: _invert,
+              visualDensity: VisualDensity.compact,
+              onSelected: (selected) {
+                setState(() => _invert = selected);
+                _apply();
+              },
+            ),
+          ],
+        ),
+        if (!_box) ...[
+          const SizedBox(height: 4),
+          Row(
+            children: [
+              for (int axis = 0; axis < 3; axis++)
+                _chip('XYZ'[axis], _axis == axis, () {
+                  setState(() {
+                    _axis = axis;
+                    _offset = (_component(lo, axis) + _component(hi, axis)) / 2;
+                  });
+                  _apply();
+                }),
+            ],
+          ),
+          Slider(
+            value: _offset.clamp(_component(lo, _axis), _component(hi, _axis)),
+            min: _component(lo, _axis),
+            max: _component(hi, _axis) > _component(lo, _axis)
+                ? _component(hi, _axis)
+                : _component(lo, _axis) + 1,
+            onChanged: (value) {
+              setState(() => _offset = value);
+              _apply();
+            },
+          ),
+        ] else
+          for (int axis = 0; axis < 3; axis++)
+            Row(
+              children: [
+                SizedBox(
+                  width: 12,
+                  child: Text(
+                    'xyz'[axis],
+                    style: const TextStyle(fontSize: 10, color: Color(0xFF808080)),
+                  ),
+                ),
+                Expanded(
+                  child: RangeSlider(
+                    values: RangeValues(
+                      _component(_lo, axis).clamp(_component(lo, axis), _component(hi, axis)),
+                      _component(_hi, axis).clamp(_component(lo, axis), _component(hi, axis)),
+                    ),
+                    min: _component(lo, axis),
+                    max: _component(hi, axis) > _component(lo, axis)
+                        ? _component(hi, axis)
+                        : _component(lo, axis) + 1,
+                    onChanged: (values) {
+                      setState(() {
+                        _lo = _withComponent(_lo, axis, values.start);
+                        _hi = _withComponent(_hi, axis, values.end);
+                      });
+                      _apply();
+                    },
+                  ),
+                ),
+              ],
+            ),
+        Text(
+          '${_box ? 'box' : '${'xyz'[_axis]} = ${ColorMap.formatValue(_offset)}'}   '
+          '${widget.subset.hiddenCount} cells hidden, '
+          '$_visited visited, $_elapsedMs ms',
+          style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+        ),
+      ],
+    );
+  }
+}
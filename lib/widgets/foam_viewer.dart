@@ -1,11 +1,19 @@
 // lib/widgets/foam_viewer.dart
 
+import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
 import 'package:flutter/gestures.dart';
+import 'package:file_picker/file_picker.dart';
 import 'dart:math' as math;
 import 'dart:ui' as ui;
+import '../filters/cell_subset.dart';
 import '../models/openfoam_case.dart';
 import '../utils/color_map.dart';
+import '../utils/field_statistics.dart';
+import '../utils/mesh_picker.dart';
+import '../utils/view_transform.dart';
+import 'scene_overlays.dart';
+import 'sequence_exporter.dart';
 
 enum MeshRepresentation { wireframe, surface, surfaceWithEdges }
 
@@ -16,6 +24,14 @@ class FoamViewer extends StatefulWidget {
   final FieldData? fieldData;
   final bool showInternalMesh;
   final Map<String, bool> boundaryVisibility;
+  final ValueChanged<PickResult>? onCellPicked; // Called when a face is clicked
+  final Vector3? probePoint; // Marker for the active probe
+  final List<SceneOverlay> overlays; // Filter output drawn over the mesh
+  final List<Vector3> handles; // Points the user can drag, e.g. line ends
+  final void Function(int index, Vector3 position)? onHandleDragged;
+  final CellSubset? cellSubset; // Cells left by clip/threshold filters
+  // Per-step loader for computed fields, which have no files to export from
+  final Future<FieldData?> Function(String timeStep)? loadComputedField;
 
   const FoamViewer({
     super.key,
@@ -23,6 +39,13 @@ class FoamViewer extends StatefulWidget {
     this.fieldData,
     this.showInternalMesh = true,
     this.boundaryVisibility = const {},
+    this.onCellPicked,
+    this.probePoint,
+    this.overlays = const [],
+    this.handles = const [],
+    this.onHandleDragged,
+    this.cellSubset,
+    this.loadComputedField,
   });
 
   @override
@@ -34,14 +57,73 @@ class _FoamViewerState extends State<FoamViewer> {
   double _rotationY = 0.3;
   double _zoom = 500.0; // Increased default zoom
   Offset? _lastPanPosition;
+  int? _draggedHandle;
+  Size _viewportSize = Size.zero;
   MeshRepresentation _representation = MeshRepresentation.surface;
   DataMode _dataMode = DataMode.pointData;
 
+  // Mesh and visibility the picking BVH was last prepared for
+  PolyMesh? _pickingMesh;
+  bool? _pickingInternalMesh;
+  Map<String, bool> _pickingVisibility = const {};
+
+  // Hover readout; updated without repainting the mesh
+  final ValueNotifier<(PickResult, Offset)?> _hover =
+      ValueNotifier<(PickResult, Offset)?>(null);
+
+  // PNG sequence export progress (frames written, total), null when idle
+  final ValueNotifier<(int, int)?> _export = ValueNotifier<(int, int)?>(null);
+  bool _exportCancelled = false;
+
   @override
   void initState() {
     super.initState();
     // Auto-calculate zoom based on mesh size
     _calculateAutoZoom();
+    _preparePicking();
+  }
+
+  @override
+  void didUpdateWidget(covariant FoamViewer oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.foamCase.mesh != widget.foamCase.mesh) {
+      _hover.value = null;
+    }
+    _preparePicking();
+  }
+
+  @override
+  void dispose() {
+    _exportCancelled = true;
+    _hover.dispose();
+    _export.dispose();
+    super.dispose();
+  }
+
+  // Build the picking BVH for the current visibility in the background.
+  // Patch toggles edit the visibility map in place, so it is compared with
+  // a copy of the one the last tree was prepared for.
+  void _preparePicking() {
+    final mesh = widget.foamCase.mesh;
+    if (identical(mesh, _pickingMesh) &&
+        widget.showInternalMesh == _pickingInternalMesh &&
+        mapEquals(widget.boundaryVisibility, _pickingVisibility)) {
+      return;
+    }
+    _pickingMesh = mesh;
+    _pickingInternalMesh = widget.showInternalMesh;
+    _pickingVisibility = Map.of(widget.boundaryVisibility);
+    MeshPicker.prepare(
+      mesh,
+      showInternalMesh: widget.showInternalMesh,
+      boundaryVisibility: widget.boundaryVisibility,
+    ).then<void>(
+      (_) {},
+      onError: (Object e) {
+        print('Could not build picking BVH: $e');
+        _pickingMesh = null; // Retry on the next update
+      },
+    );
   }
 
   void _calculateAutoZoom() {
@@ -83,60 +165,241 @@ class _FoamViewerState extends State<FoamViewer> {
   void _setLeftView() => setState(() { _rotationX = math.pi / 2; _rotationY = -math.pi / 2; });
   void _setIsometricView() => setState(() { _rotationX = math.pi / 4; _rotationY = math.pi / 4; });
 
+  // Pick the visible face under a click and report it
+  void _handleTap(Offset position) {
+    if (widget.onCellPicked == null) return;
+    final result = _pickAt(position);
+    if (result != null) {
+      widget.onCellPicked!(result);
+    }
+  }
+
+  // Hover picks only go through the BVH, so they never stall the UI
+  void _handleHover(Offset position) {
+    if (_lastPanPosition != null) return;
+    final mesh = widget.foamCase.mesh;
+    final tree = MeshPicker.treeFor(
+      mesh,
+      showInternalMesh: widget.showInternalMesh,
+      boundaryVisibility: widget.boundaryVisibility,
+    );
+    if (tree == null) return;
+
+    final result = _pickAt(position);
+    _hover.value = result == null ? null : (result, position);
+  }
+
+  ViewTransform _transform() => ViewTransform.forMesh(
+        widget.foamCase.mesh,
+        rotationX: _rotationX,
+        rotationY: _rotationY,
+        zoom: _zoom,
+        size: _viewportSize,
+      );
+
+  // Index of the handle under a screen position, if any
+  int? _handleAt(Offset position) {
+    if (widget.onHandleDragged == null || _viewportSize.isEmpty) return null;
+    final transform = _transform();
+    for (int i = 0; i < widget.handles.length; i++) {
+      final h = widget.handles[i];
+      if ((transform.project(h.x, h.y, h.z) - position).distance <= 12) {
+        return i;
+      }
+    }
+    return null;
+  }
+
+  // Move a handle in the view plane by a screen-space drag
+  void _dragHandle(int index, Offset delta) {
+    final h = widget.handles[index];
+    final d = _transform().screenDelta(delta);
+    widget.onHandleDragged!(index, Vector3(h.x + d.x, h.y + d.y, h.z + d.z));
+  }
+
+  PickResult? _pickAt(Offset position) {
+    if (_viewportSize.isEmpty) return null;
+
+    final mesh = widget.foamCase.mesh;
+    final transform = _transform();
+    final (origin, direction) = transform.screenRay(
+      position,
+      distance: MeshBounds.of(mesh).diagonal,
+    );
+
+    return MeshPicker.pick(
+      mesh,
+      origin,
+      direction,
+      showInternalMesh: widget.showInternalMesh,
+      boundaryVisibility: widget.boundaryVisibility,
+    );
+  }
+
+  // Renders a range of time steps of the shown field from the current
+  // camera, framed as on screen at the chosen resolution
+  Future<void> _exportSequence() async {
+    final fieldData = widget.fieldData;
+    final times = widget.foamCase.timeDirectories;
+    if (fieldData == null || times.isEmpty || _export.value != null) return;
+    if (_viewportSize.isEmpty) return;
+
+    final settings = await showDialog<_ExportSettings>(
+      context: context,
+      builder: (_) => _ExportDialog(
+        timeDirectories: times,
+        viewportSize: _viewportSize,
+      ),
+    );
+    if (settings == null) return;
+    final directory = await FilePicker.platform.getDirectoryPath();
+    if (directory == null || !mounted) return;
+
+    final mesh = widget.foamCase.mesh;
+    final rotationX = _rotationX;
+    final rotationY = _rotationY;
+    final zoom = _zoom *
+        math.min(
+          settings.size.width / _viewportSize.width,
+          settings.size.height / _viewportSize.height,
+        );
+    final representation = _representation;
+    final dataMode = _dataMode;
+    final showInternalMesh = widget.showInternalMesh;
+    final boundaryVisibility = Map<String, bool>.of(widget.boundaryVisibility);
+
+    // Overlays and the cell subset were computed from the step on screen,
+    // so the other steps are painted without them
+    final exporter = SequenceExporter(
+      foamCase: widget.foamCase,
+      fieldName: fieldData.name,
+      loadField: widget.loadComputedField,
+      size: settings.size,
+      painterFor: (frame) => FoamMeshPainter(
+        mesh,
+        rotationX,
+        rotationY,
+        zoom,
+        representation,
+        frame,
+        dataMode,
+        showInternalMesh,
+        boundaryVisibility,
+      ),
+    );
+
+    _exportCancelled = false;
+    _export.value = (0, settings.last - settings.first + 1);
+    final stopwatch = Stopwatch()..start();
+    try {
+      final written = await exporter.export(
+        directory,
+        first: settings.first,
+        last: settings.last,
+        onProgress: (done, total) {
+          if (mounted) _export.value = (done, total);
+        },
+        isCancelled: () => _exportCancelled,
+      );
+      print('Exported $written frames to $directory '
+          'in ${stopwatch.elapsedMilliseconds} ms');
+    } catch (e) {
+      print('PNG sequence export failed: $e');
+    } finally {
+      if (mounted) _export.value = null;
+    }
+  }
 
   @override
   Widget build(BuildContext context) {
     return ClipRect(
       child: Stack(
         children: [
-          Listener(
-            onPointerSignal: (event) {
-              if (event is PointerScrollEvent) {
-                setState(() {
-                  // Zoom with mouse wheel - proportional to current zoom level
-                  // This makes zooming smooth at all zoom levels
-                  final zoomFactor = event.scrollDelta.dy > 0 ? 0.9 : 1.1;
-                  _zoom *= zoomFactor;
+          MouseRegion(
+            onHover: (event) => _handleHover(event.localPosition),
+            onExit: (_) => _hover.value = null,
+            child: Listener(
+              onPointerSignal: (event) {
+                if (event is PointerScrollEvent) {
+                  setState(() {
+                    // Zoom with mouse wheel - proportional to current zoom level
+                    // This makes zooming smooth at all zoom levels
+                    final zoomFactor = event.scrollDelta.dy > 0 ? 0.9 : 1.1;
+                    _zoom *= zoomFactor;
                   
-                  // More generous clamping range
-                  _zoom = _zoom.clamp(0.1, 10000.0);
-                });
-              }
-            },
-            child: GestureDetector(
-              onPanStart: (details) {
-                _lastPanPosition = details.localPosition;
+                    // More generous clamping range
+                    _zoom = _zoom.clamp(0.1, 10000.0);
+                  });
+                }
               },
-              onPanUpdate: (details) {
-                setState(() {
+              child: GestureDetector(
+                onPanStart: (details) {
+                  _lastPanPosition = details.localPosition;
+                  _draggedHandle = _handleAt(details.localPosition);
+                  _hover.value = null;
+                },
+                onPanUpdate: (details) {
                   final delta = details.localPosition - _lastPanPosition!;
-                  _rotationY += delta.dx * 0.01;
-                  _rotationX += delta.dy * 0.01;
                   _lastPanPosition = details.localPosition;
-                });
-              },
-              onPanEnd: (details) {
-                _lastPanPosition = null;
-              },
-              child: Container(
-                color: const Color(0xFF1E1E1E),
-                child: CustomPaint(
-                  painter: FoamMeshPainter(
-                    widget.foamCase.mesh,
-                    _rotationX,
-                    _rotationY,
-                    _zoom,
-                    _representation,
-                    widget.fieldData,
-                    _dataMode,
-                    widget.showInternalMesh,
-                    widget.boundaryVisibility,
+                  if (_draggedHandle != null &&
+                      _draggedHandle! < widget.handles.length) {
+                    _dragHandle(_draggedHandle!, delta);
+                    return;
+                  }
+                  setState(() {
+                    _rotationY += delta.dx * 0.01;
+                    _rotationX += delta.dy * 0.01;
+                  });
+                },
+                onPanEnd: (details) {
+                  _lastPanPosition = null;
+                  _draggedHandle = null;
+                },
+                onTapUp: (details) => _handleTap(details.localPosition),
+                child: Container(
+                  color: const Color(0xFF1E1E1E),
+                  child: LayoutBuilder(
+                    builder: (context, constraints) {
+                      _viewportSize = constraints.biggest;
+                      return CustomPaint(
+                        painter: FoamMeshPainter(
+                          widget.foamCase.mesh,
+                          _rotationX,
+                          _rotationY,
+                          _zoom,
+                          _representation,
+                          widget.fieldData,
+                          _dataMode,
+                          widget.showInternalMesh,
+                          widget.boundaryVisibility,
+                          probePoint: widget.probePoint,
+                          overlays: widget.overlays,
+                          handles: widget.handles,
+                          cellSubset: widget.cellSubset,
+                        ),
+                        size: Size.infinite,
+                      );
+                    },
                   ),
-                  size: Size.infinite,
                 ),
               ),
             ),
           ),
+          // Hover readout
+          ValueListenableBuilder<(PickResult, Offset)?>(
+            valueListenable: _hover,
+            builder: (context, hover, _) {
+              if (hover == null) return const SizedBox.shrink();
+              final (pick, position) = hover;
+              return Positioned(
+                left: position.dx + 14,
+                top: position.dy + 14,
+                child: IgnorePointer(
+                  child: _HoverReadout(pick: pick, fieldData: widget.fieldData),
+                ),
+              );
+            },
+          ),
           // Top-right controls
           Positioned(
             top: 12,
@@ -248,6 +511,53 @@ class _FoamViewerState extends State<FoamViewer> {
               ],
             ),
           ),
+          // PNG sequence export progress
+          ValueListenableBuilder<(int, int)?>(
+            valueListenable: _export,
+            builder: (context, progress, _) {
+              if (progress == null) return const SizedBox.shrink();
+              final (done, total) = progress;
+              return Positioned(
+                left: 16,
+                bottom: 16,
+                child: Container(
+                  width: 220,
+                  padding: const EdgeInsets.all(8),
+                  decoration: BoxDecoration(
+                    color: const Color(0xFF2D2D2D),
+                    borderRadius: BorderRadius.circular(6),
+                    border: Border.all(color: const Color(0xFF404040)),
+                  ),
+                  child: Row(
+                    children: [
+                      Expanded(
+                        child: Column(
+                          crossAxisAlignment: CrossAxisAlignment.start,
+                          children: [
+                            Text(
+                              'Exporting frame $done / $total',
+                              style: const TextStyle(fontSize: 10, color: Color(0xFFE0E0E0)),
+                            ),
+                            const SizedBox(height: 4),
+                            LinearProgressIndicator(
+                              value: total > 0 ? done / total : null,
+                              minHeight: 2,
+                            ),
+                          ],
+                        ),
+                      ),
+                      IconButton(
+                        icon: const Icon(Icons.close, size: 14),
+                        tooltip: 'Cancel',
+                        visualDensity: VisualDensity.compact,
+                        onPressed: () => _exportCancelled = true,
+                      ),
+                    ],
+                  ),
+                ),
+              );
+            },
+          ),
           // Color legend (only show when field data is loaded)
           if (widget.fieldData != null)
             Positioned(
@@ -316,6 +626,14 @@ class _FoamViewerState extends State<FoamViewer> {
                       tooltip: 'Isometric View',
                       onPressed: _setIsometricView,
                     ),
+                    if (widget.fieldData != null) ...[
+                      const Divider(height: 12, thickness: 1, color: Color(0xFF404040)),
+                      _ViewButton(
+                        icon: Icons.movie_creation_outlined,
+                        tooltip: 'Export PNG Sequence',
+                        onPressed: _exportSequence,
+                      ),
+                    ],
                   ],
                 ),
               ),
@@ -337,6 +655,11 @@ class FoamMeshPainter extends CustomPainter {
   final DataMode dataMode;
   final bool showInternalMesh;
   final Map<String, bool> boundaryVisibility;
+  final Vector3? probePoint;
+  final List<SceneOverlay> overlays;
+  final List<Vector3> handles;
+  final CellSubset? cellSubset;
+  final int cellSubsetRevision; // The subset is edited in place
 
   // Cache for point data interpolation
   List<double>? _pointData;
@@ -356,8 +679,12 @@ class FoamMeshPainter extends CustomPainter {
     this.fieldData,
     this.dataMode,
     this.showInternalMesh,
-    this.boundaryVisibility,
-  ) {
+    this.boundaryVisibility, {
+    this.probePoint,
+    this.overlays = const [],
+    this.handles = const [],
+    this.cellSubset,
+  }) : cellSubsetRevision = cellSubset?.revision ?? 0 {
     // Use cached point data if available and valid
     if (_cachedFieldData == fieldData && 
         _cachedDataMode == dataMode && 
@@ -366,9 +693,11 @@ class FoamMeshPainter extends CustomPainter {
       _pointData = _cachedPointData;
     } else if (fieldData != null &&
         fieldData!.internalField.isNotEmpty &&
+        !fieldData!.isFaceField &&
         dataMode == DataMode.pointData) {
-      // Convert cell data to point data if needed (cache it)
-      _pointData = _interpolateCellToPoint();
+      // Point values decoded with the field are used as they are;
+      // otherwise convert cell data to point data (cache it)
+      _pointData = fieldData!.pointValues ?? _interpolateCellToPoint();
       _cachedPointData = _pointData;
       _cachedFieldData = fieldData;
       _cachedDataMode = dataMode;
@@ -449,30 +778,24 @@ class FoamMeshPainter extends CustomPainter {
       return;
     }
 
-    double minX = double.infinity;
-    double maxX = double.negativeInfinity;
-    double minY = double.infinity;
-    double maxY = double.negativeInfinity;
-    double minZ = double.infinity;
-    double maxZ = double.negativeInfinity;
-
-    for (final point in mesh.points) {
-      minX = math.min(minX, point.x);
-      maxX = math.max(maxX, point.x);
-      minY = math.min(minY, point.y);
-      maxY = math.max(maxY, point.y);
-      minZ = math.min(minZ, point.z);
-      maxZ = math.max(maxZ, point.z);
-    }
-
-    final centerMeshX = (minX + maxX) / 2;
-    final centerMeshY = (minY + maxY) / 2;
-    final centerMeshZ = (minZ + maxZ) / 2;
+    final transform = ViewTransform.forMesh(
+      mesh,
+      rotationX: rotationX,
+      rotationY: rotationY,
+      zoom: zoom,
+      size: size,
+    );
 
     // Get field data min/max for color mapping
     double? minFieldValue;
     double? maxFieldValue;
-    if (fieldData != null) {
+    final faceValues = fieldData?.faceValues;
+    if (faceValues != null) {
+      // Face fields colour each face by its own value in either mode
+      final range = FieldStatistics.of(faceValues);
+      minFieldValue = range.min;
+      maxFieldValue = range.max;
+    } else if (fieldData != null) {
       if (dataMode == DataMode.pointData &&
           _pointData != null &&
           _pointData!.isNotEmpty) {
@@ -495,21 +818,10 @@ class FoamMeshPainter extends CustomPainter {
     
     for (int i = 0; i < mesh.points.length; i++) {
       final point = mesh.points[i];
-      
-      // Center the mesh
-      final x = point.x - centerMeshX;
-      final y = point.y - centerMeshY;
-      final z = point.z - centerMeshZ;
-
-      // Apply 3D rotation
-      final rotated = _rotate3D(x, y, z, rotationX, rotationY);
-
-      // Project to 2D
-      transformedPoints[i] = Offset(
-        centerX + rotated[0] * zoom,
-        centerY - rotated[1] * zoom,
-      );
-      transformedDepths[i] = rotated[2];
+
+      // Center, rotate and project to 2D
+      transformedPoints[i] = transform.project(point.x, point.y, point.z);
+      transformedDepths[i] = transform.depth(point.x, point.y, point.z);
     }
 
     // ============================================
@@ -517,6 +829,7 @@ class FoamMeshPainter extends CustomPainter {
     // ============================================
     final List<_TransformedFace> transformedFaces = [];
     final numInternalFaces = mesh.neighbour.length;
+    final subset = cellSubset != null && cellSubset!.isActive ? cellSubset : null;
 
     for (int faceIdx = 0; faceIdx < mesh.faces.length; faceIdx++) {
       final face = mesh.faces[faceIdx];
@@ -537,8 +850,10 @@ class FoamMeshPainter extends CustomPainter {
         }
       }
 
-      // Skip face if it should be hidden based on visibility settings
-      if (isInternal && !showInternalMesh) continue;
+      // Skip face if it should be hidden based on visibility settings; with
+      // cells clipped away, internal faces show only where they bound them
+      if (subset != null && subset.faceShown[faceIdx] == 0) continue;
+      if (isInternal && subset == null && !showInternalMesh) continue;
       if (!isInternal &&
           boundaryName != null &&
           !(boundaryVisibility[boundaryName] ?? true))
@@ -551,7 +866,9 @@ class FoamMeshPainter extends CustomPainter {
 
       // Get cell index (owner) for this face for cell data mode
       int cellIdx = -1;
-      if (faceIdx < mesh.owner.length) {
+      if (subset != null) {
+        cellIdx = subset.visibleCellOf(faceIdx);
+      } else if (faceIdx < mesh.owner.length) {
         cellIdx = mesh.owner[faceIdx];
       }
 
@@ -566,7 +883,7 @@ class FoamMeshPainter extends CustomPainter {
       if (screenPoints.isNotEmpty) {
         final avgZ = totalZ / screenPoints.length;
         transformedFaces.add(
-          _TransformedFace(screenPoints, avgZ, cellIdx, pointIndices),
+          _TransformedFace(screenPoints, avgZ, cellIdx, faceIdx, pointIndices),
         );
       }
     }
@@ -584,6 +901,25 @@ class FoamMeshPainter extends CustomPainter {
       maxFieldValue,
     );
 
+    // Filter output
+    for (final overlay in overlays) {
+      overlay.paint(canvas, transform);
+    }
+
+    // Draggable handles
+    for (final handle in handles) {
+      final position = transform.project(handle.x, handle.y, handle.z);
+      canvas.drawCircle(position, 7, Paint()..color = Colors.black54);
+      canvas.drawCircle(position, 5, Paint()..color = Colors.white);
+    }
+
+    // Probe marker
+    if (probePoint != null) {
+      final marker = transform.project(probePoint!.x, probePoint!.y, probePoint!.z);
+      canvas.drawCircle(marker, 6, Paint()..color = Colors.white);
+      canvas.drawCircle(marker, 4, Paint()..color = const Color(0xFFE91E63));
+    }
+
     // Draw info text
     final textPainter = TextPainter(
       text: TextSpan(
@@ -632,7 +968,27 @@ class FoamMeshPainter extends CustomPainter {
       if (representation == MeshRepresentation.surface ||
           representation == MeshRepresentation.surfaceWithEdges) {
         
-        if (dataMode == DataMode.pointData &&
+        final faceValues = fieldData?.faceValues;
+        if (faceValues != null &&
+            minFieldValue != null &&
+            maxFieldValue != null &&
+            transformedFace.faceIdx < faceValues.length) {
+          // FACE DATA: each face in its own value's color
+          _batchTrianglesFromFace(
+            transformedFace.points,
+            transformedFace.pointIndices,
+            minFieldValue,
+            maxFieldValue,
+            allTriangleVertices,
+            allTriangleColors,
+            uniformColor: ColorMap.getFastColor(
+              faceValues[transformedFace.faceIdx],
+              minFieldValue,
+              maxFieldValue,
+            ),
+          );
+
+        } else if (dataMode == DataMode.pointData &&
             _pointData != null &&
             minFieldValue != null &&
             maxFieldValue != null &&
@@ -782,28 +1138,6 @@ class FoamMeshPainter extends CustomPainter {
     }
   }
 
-  List<double> _rotate3D(
-    double x,
-    double y,
-    double z,
-    double angleX,
-    double angleY,
-  ) {
-    // Rotate around X axis
-    final cosX = math.cos(angleX);
-    final sinX = math.sin(angleX);
-    final y1 = y * cosX - z * sinX;
-    final z1 = y * sinX + z * cosX;
-
-    // Rotate around Y axis
-    final cosY = math.cos(angleY);
-    final sinY = math.sin(angleY);
-    final x2 = x * cosY + z1 * sinY;
-    final z2 = -x * sinY + z1 * cosY;
-
-    return [x2, y1, z2];
-  }
-
   @override
   bool shouldRepaint(covariant FoamMeshPainter oldDelegate) {
     return oldDelegate.rotationX != rotationX ||
@@ -813,7 +1147,12 @@ class FoamMeshPainter extends CustomPainter {
         oldDelegate.fieldData != fieldData ||
         oldDelegate.dataMode != dataMode ||
         oldDelegate.showInternalMesh != showInternalMesh ||
-        oldDelegate.boundaryVisibility != boundaryVisibility;
+        oldDelegate.boundaryVisibility != boundaryVisibility ||
+        oldDelegate.probePoint != probePoint ||
+        oldDelegate.cellSubset != cellSubset ||
+        oldDelegate.cellSubsetRevision != cellSubsetRevision ||
+        !listEquals(oldDelegate.overlays, overlays) ||
+        !listEquals(oldDelegate.handles, handles);
   }
 }
 
@@ -822,16 +1161,64 @@ class _TransformedFace {
   final List<Offset> points;
   final double depth;
   final int cellIdx;
+  final int faceIdx;
   final List<int> pointIndices;
 
   _TransformedFace(
     this.points,
     this.depth,
-    this.cellIdx, [
+    this.cellIdx,
+    this.faceIdx, [
     this.pointIndices = const [],
   ]);
 }
 
+// Cell, patch and value under the mouse
+class _HoverReadout extends StatelessWidget {
+  final PickResult pick;
+  final FieldData? fieldData;
+
+  const _HoverReadout({required this.pick, this.fieldData});
+
+  @override
+  Widget build(BuildContext context) {
+    // Face fields show the picked face's own value
+    final faceValues = fieldData?.faceValues;
+    final values = faceValues ?? fieldData?.internalField;
+    final index = faceValues != null ? pick.faceIndex : pick.cellIndex;
+    final cell = pick.cellIndex;
+    final hasValue = values != null && index >= 0 && index < values.length;
+
+    return Container(
+      padding: const EdgeInsets.symmetric(horizontal: 8, vertical: 6),
+      decoration: BoxDecoration(
+        color: const Color(0xE62D2D2D),
+        borderRadius: BorderRadius.circular(4),
+        border: Border.all(color: const Color(0xFF404040)),
+      ),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        mainAxisSize: MainAxisSize.min,
+        children: [
+          Text(
+            'Cell $cell',
+            style: const TextStyle(fontSize: 11, color: Color(0xFFE0E0E0)),
+          ),
+          Text(
+            pick.patchName ?? 'internal face',
+            style: const TextStyle(fontSize: 10, color: Color(0xFF808080)),
+          ),
+          if (hasValue)
+            Text(
+              '${fieldData!.name} = ${ColorMap.formatValue(values[index])}',
+              style: const TextStyle(fontSize: 11, color: Color(0xFF64B5F6)),
+            ),
+        ],
+      ),
+    );
+  }
+}
+
 // Color legend widget
 class _ColorLegend extends StatelessWidget {
   final FieldData fieldData;
@@ -840,15 +1227,23 @@ class _ColorLegend extends StatelessWidget {
 
   @override
   Widget build(BuildContext context) {
-    // Use point values if available for better range, otherwise use internal field
-    final values = fieldData.pointValues ?? fieldData.internalField;
-    final minValue = values.reduce(math.min);
-    final maxValue = values.reduce(math.max);
+    // Face fields are drawn from their face values; otherwise use point
+    // values if available for better range, else the internal field
+    final faceValues = fieldData.faceValues;
+    final range = FieldStatistics.of(
+      faceValues ?? fieldData.pointValues ?? fieldData.internalField,
+    );
+    final minValue = range.min;
+    final maxValue = range.max;
+    // Distribution of the face or cell values
+    final cells = FieldStatistics.of(faceValues ?? fieldData.internalField);
 
     // Extract field type from class name
     String fieldType = 'Field';
     if (fieldData.fieldClass.contains('Vector')) {
       fieldType = 'Velocity Magnitude';
+    } else if (fieldData.isTensor) {
+      fieldType = '|${fieldData.name}|';
     } else if (fieldData.fieldClass.contains('Scalar')) {
       fieldType = fieldData.name;
     }
@@ -886,6 +1281,13 @@ class _ColorLegend extends StatelessWidget {
             ],
           ),
           const SizedBox(height: 12),
+          // Histogram of cell values
+          SizedBox(
+            width: 200,
+            height: 36,
+            child: CustomPaint(painter: _HistogramPainter(cells)),
+          ),
+          const SizedBox(height: 2),
           // Color bar
           Container(
             width: 200,
@@ -914,12 +1316,49 @@ class _ColorLegend extends StatelessWidget {
               ),
             ],
           ),
+          const SizedBox(height: 4),
+          Text(
+            '${cells.count} ${faceValues != null ? 'faces' : 'cells'}, '
+            'mean ${ColorMap.formatValue(cells.mean)}',
+            style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+          ),
         ],
       ),
     );
   }
 }
 
+// Bars for the histogram bins, on a log scale so a few outlying cells
+// (bad mesh cells, say) stay visible next to the bulk
+class _HistogramPainter extends CustomPainter {
+  final FieldStatistics statistics;
+
+  _HistogramPainter(this.statistics);
+
+  @override
+  void paint(Canvas canvas, Size size) {
+    final bins = statistics.bins;
+    final largest = statistics.maxBin;
+    if (largest == 0) return;
+    final scale = math.log(largest + 1);
+    final barWidth = size.width / bins.length;
+
+    for (int i = 0; i < bins.length; i++) {
+      if (bins[i] == 0) continue;
+      final height = size.height * math.log(bins[i] + 1) / scale;
+      final color = ColorMap.getFastColor((i + 0.5) / bins.length, 0.0, 1.0);
+      canvas.drawRect(
+        Rect.fromLTWH(i * barWidth, size.height - height, barWidth - 1, height),
+        Paint()..color = color,
+      );
+    }
+  }
+
+  @override
+  bool shouldRepaint(covariant _HistogramPainter oldDelegate) =>
+      !identical(oldDelegate.statistics, statistics);
+}
+
 // Custom painter for the color bar gradient
 class _ColorBarPainter extends CustomPainter {
   @override
@@ -943,6 +1382,121 @@ class _ColorBarPainter extends CustomPainter {
   bool shouldRepaint(covariant CustomPainter oldDelegate) => false;
 }
 
+// Resolution and time range of a PNG sequence export
+class _ExportSettings {
+  final Size size;
+  final int first;
+  final int last;
+
+  const _ExportSettings(this.size, this.first, this.last);
+}
+
+class _ExportDialog extends StatefulWidget {
+  final List<String> timeDirectories;
+  final Size viewportSize;
+
+  const _ExportDialog({
+    required this.timeDirectories,
+    required this.viewportSize,
+  });
+
+  @override
+  State<_ExportDialog> createState() => _ExportDialogState();
+}
+
+class _ExportDialogState extends State<_ExportDialog> {
+  late final TextEditingController _width = TextEditingController(
+    text: '${widget.viewportSize.width.round()}',
+  );
+  late final TextEditingController _height = TextEditingController(
+    text: '${widget.viewportSize.height.round()}',
+  );
+  late RangeValues _range = RangeValues(
+    0,
+    (widget.timeDirectories.length - 1).toDouble(),
+  );
+
+  @override
+  void dispose() {
+    _width.dispose();
+    _height.dispose();
+    super.dispose();
+  }
+
+  Widget _sizeField(String label, TextEditingController controller) {
+    return SizedBox(
+      width: 80,
+      child: TextField(
+        controller: controller,
+        keyboardType: TextInputType.number,
+        style: const TextStyle(fontSize: 12),
+        decoration: InputDecoration(labelText: label, isDense: true),
+      ),
+    );
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final times = widget.timeDirectories;
+    final last = times.length - 1;
+    return AlertDialog(
+      title: const Text('Export PNG Sequence', style: TextStyle(fontSize: 14)),
+      content: Column(
+        mainAxisSize: MainAxisSize.min,
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          Row(
+            children: [
+              _sizeField('Width', _width),
+              const SizedBox(width: 12),
+              _sizeField('Height', _height),
+            ],
+          ),
+          const SizedBox(height: 12),
+          Text(
+            'Time ${times[_range.start.round()]} to ${times[_range.end.round()]}',
+            style: const TextStyle(fontSize: 11),
+          ),
+          if (last > 0)
+            RangeSlider(
+              values: _range,
+              min: 0,
+              max: last.toDouble(),
+              divisions: last,
+              onChanged: (values) => setState(() => _range = values),
+            ),
+          // Overlays and the threshold subset belong to the shown step
+          const Text(
+            'Filter overlays and hidden cells are not exported',
+            style: TextStyle(fontSize: 10, color: Color(0xFF808080)),
+          ),
+        ],
+      ),
+      actions: [
+        TextButton(
+          onPressed: () => Navigator.of(context).pop(),
+          child: const Text('Cancel'),
+        ),
+        TextButton(
+          onPressed: () {
+            final width = int.tryParse(_width.text) ?? 0;
+            final height = int.tryParse(_height.text) ?? 0;
+            if (width <= 0 || height <= 0) return;
+            Navigator.of(context).pop(
+              _ExportSettings(
+                Size(width.toDouble(), height.toDouble()),
+                _range.start.round(),
+                _range.end.round(),
+              ),
+            );
+          },
+          child: const Text('Export'),
+        ),
+      ],
+    );
+  }
+}
+
 // View preset button widget
 class _ViewButton extends StatelessWidget {
   final IconData icon;
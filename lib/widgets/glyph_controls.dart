@@ -0,0 +1,149 @@
+// lib/widgets/glyph_controls.dart
+
+import 'package:flutter/material.dart';
+import '../filters/glyph_source.dart';
+import '../models/openfoam_case.dart';
+import 'scene_overlays.dart';
+
+/// Sidebar controls for arrow glyphs of the active vector field, at cell
+/// centres or on the boundary. Spacing changes only restyle the overlay;
+/// the candidates are rebuilt when the field or placement changes.
+class GlyphControls extends StatefulWidget {
+  final PolyMesh mesh;
+  final FieldData? fieldData;
+  final ValueChanged<SceneOverlay?> onOverlayChanged;
+
+  const GlyphControls({
+    super.key,
+    required this.mesh,
+    required this.fieldData,
+    required this.onOverlayChanged,
+  });
+
+  @override
+  State<GlyphControls> createState() => _GlyphControlsState();
+}
+
+class _GlyphControlsState extends State<GlyphControls> {
+  bool _surface = false;
+  double _spacing = 24;
+  GlyphSource? _source;
+  bool _running = false;
+  bool _dirty = false;
+  int _elapsedMs = 0;
+
+  @override
+  void initState() {
+    super.initState();
+    _build();
+  }
+
+  @override
+  void didUpdateWidget(covariant GlyphControls oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.mesh != widget.mesh ||
+        oldWidget.fieldData != widget.fieldData) {
+      _build();
+    }
+  }
+
+  Future<void> _build() async {
+    if (_running) {
+      _dirty = true;
+      return;
+    }
+    _running = true;
+    try {
+      do {
+        _dirty = false;
+        final field = widget.fieldData;
+        if (field == null || !field.isVector) {
+          _source = null;
+          // May run from initState: clear the overlay after this frame
+          WidgetsBinding.instance.addPostFrameCallback((_) {
+            if (mounted && widget.fieldData == field) widget.onOverlayChanged(null);
+          });
+          return;
+        }
+        final stopwatch = Stopwatch()..start();
+        final source = _surface
+            ? await GlyphSource.boundary(widget.mesh, field)
+            : await GlyphSource.cells(widget.mesh, field);
+        if (!mounted) return;
+        setState(() {
+          _source = source;
+          _elapsedMs = stopwatch.elapsedMilliseconds;
+        });
+        _publish();
+      } while (_dirty);
+    } finally {
+      _running = false;
+    }
+  }
+
+  void _publish() {
+    final source = _source;
+    if (source == null) return;
+    widget.onOverlayChanged(
+      GlyphOverlay(
+        source,
+        minValue: 0,
+        maxValue: source.maxMagnitude,
+        spacing: _spacing,
+      ),
+    );
+  }
+
+  Widget _chip(String label, bool selected, VoidCallback onSelected) {
+    return Padding(
+      padding: const EdgeInsets.only(right: 6),
+      child: ChoiceChip(
+        label: Text(label, style: const TextStyle(fontSize: 10)),
+        selected: selected,
+        visualDensity: VisualDensity.compact,
+        onSelected: (_) => onSelected(),
+      ),
+    );
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    if (widget.fieldData == null || !widget.fieldData!.isVector) {
+      return const Text(
+        'Select a vector field, e.g. U',
+        style: TextStyle(fontSize: 9, color: Color(0xFF808080)),
+      );
+    }
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Row(
+          children: [
+            _chip('Cells', !_surface, () {
+              setState(() => _surface = false);
+              _build();
+            }),
+            _chip('Surface', _surface, () {
+              setState(() => _surface = true);
+              _build();
+            }),
+          ],
+        ),
+        Slider(
+          value: _spacing,
+          min: 12,
+          max: 64,
+          onChanged: (value) {
+            setState(() => _spacing = value);
+            _publish();
+          },
+        ),
+        Text(
+          '${_spacing.round()} px spacing   '
+          '${_source?.length ?? 0} candidates, $_elapsedMs ms',
+          style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+        ),
+      ],
+    );
+  }
+}
@@ -0,0 +1,141 @@
+// lib/widgets/iso_surface_controls.dart
+
+import 'package:flutter/material.dart';
+import '../filters/iso_surface_filter.dart';
+import '../models/openfoam_case.dart';
+import '../utils/color_map.dart';
+import 'scene_overlays.dart';
+
+/// Sidebar controls for the iso-surface filter: the contour value of the
+/// active field. Contours are coalesced like the slice updates.
+class IsoSurfaceControls extends StatefulWidget {
+  final PolyMesh mesh;
+  final FieldData? fieldData;
+  final ValueChanged<SceneOverlay?> onOverlayChanged;
+
+  const IsoSurfaceControls({
+    super.key,
+    required this.mesh,
+    required this.fieldData,
+    required this.onOverlayChanged,
+  });
+
+  @override
+  State<IsoSurfaceControls> createState() => _IsoSurfaceControlsState();
+}
+
+class _IsoSurfaceControlsState extends State<IsoSurfaceControls> {
+  late IsoSurfaceFilter _filter;
+  double _iso = 0;
+  (double, double) _range = (0, 1);
+  bool _running = false;
+  bool _dirty = false;
+  int _triangles = 0;
+  int _elapsedMs = 0;
+
+  @override
+  void initState() {
+    super.initState();
+    _filter = IsoSurfaceFilter(widget.mesh);
+    _setField();
+  }
+
+  @override
+  void didUpdateWidget(covariant IsoSurfaceControls oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.mesh != widget.mesh) {
+      _filter = IsoSurfaceFilter(widget.mesh);
+    }
+    if (oldWidget.mesh != widget.mesh ||
+        oldWidget.fieldData != widget.fieldData) {
+      _setField();
+    }
+  }
+
+  Future<void> _setField() async {
+    final field = widget.fieldData;
+    if (field == null || field.internalField.isEmpty) {
+      // Called from initState and didUpdateWidget, i.e. while the parent
+      // builds, so the parent's setState has to wait for the frame
+      WidgetsBinding.instance.addPostFrameCallback((_) {
+        if (mounted && widget.fieldData == field) widget.onOverlayChanged(null);
+      });
+      return;
+    }
+    final previous = _range;
+    final range = await _filter.valueRange(field);
+    if (!mounted || field != widget.fieldData) return;
+    setState(() {
+      _range = range;
+      // Keep the contour value across time steps when it is still in range
+      if (previous != range && (_iso < range.$1 || _iso > range.$2)) {
+        _iso = (range.$1 + range.$2) / 2;
+      }
+    });
+    _contour();
+  }
+
+  Future<void> _contour() async {
+    if (_running) {
+      _dirty = true;
+      return;
+    }
+    _running = true;
+    try {
+      do {
+        _dirty = false;
+        final field = widget.fieldData;
+        if (field == null || field.internalField.isEmpty) return;
+        final stopwatch = Stopwatch()..start();
+        final surface = await _filter.contour(field, _iso);
+        if (!mounted) return;
+
+        final (minValue, maxValue) = _range;
+        widget.onOverlayChanged(
+          SurfaceOverlay(
+            surface,
+            minValue: minValue,
+            maxValue: maxValue,
+            depthSort: true,
+          ),
+        );
+        setState(() {
+          _triangles = surface.triangleCount;
+          _elapsedMs = stopwatch.elapsedMilliseconds;
+        });
+      } while (_dirty);
+    } finally {
+      _running = false;
+    }
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    if (widget.fieldData == null) {
+      return const Text(
+        'Select a field to contour',
+        style: TextStyle(fontSize: 9, color: Color(0xFF808080)),
+      );
+    }
+    final (lo, hi) = _range;
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Slider(
+          value: _iso.clamp(lo, hi),
+          min: lo,
+          max: hi > lo ? hi : lo + 1,
+          onChanged: (value) {
+            setState(() => _iso = value);
+            _contour();
+          },
+        ),
+        Text(
+          '${widget.fieldData!.name} = ${ColorMap.formatValue(_iso)}   '
+          '$_triangles triangles, $_elapsedMs ms',
+          style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+        ),
+      ],
+    );
+  }
+}
@@ -0,0 +1,112 @@
+// lib/widgets/line_plot.dart
+
+import 'dart:math' as math;
+import 'package:flutter/material.dart';
+import '../utils/color_map.dart';
+
+/// One curve of a [LinePlotPainter]; NaN y values leave a gap
+class PlotSeries {
+  final List<double> x;
+  final List<double> y;
+  final Color color;
+
+  const PlotSeries(this.x, this.y, this.color);
+}
+
+/// Minimal 2D line plot with min/max labels on both axes
+class LinePlotPainter extends CustomPainter {
+  final List<PlotSeries> series;
+  final String xLabel;
+
+  LinePlotPainter(this.series, {this.xLabel = 'x'});
+
+  @override
+  void paint(Canvas canvas, Size size) {
+    final axisPaint = Paint()
+      ..color = const Color(0xFF404040)
+      ..strokeWidth = 1;
+    const leftMargin = 56.0;
+    const bottomMargin = 16.0;
+    final plot = Rect.fromLTRB(
+      leftMargin,
+      4,
+      size.width - 8,
+      size.height - bottomMargin,
+    );
+    canvas.drawRect(plot, axisPaint..style = PaintingStyle.stroke);
+
+    double minX = double.infinity, maxX = double.negativeInfinity;
+    double minY = double.infinity, maxY = double.negativeInfinity;
+    for (final s in series) {
+      for (int i = 0; i < s.x.length && i < s.y.length; i++) {
+        if (s.y[i].isNaN) continue;
+        minX = math.min(minX, s.x[i]);
+        maxX = math.max(maxX, s.x[i]);
+        minY = math.min(minY, s.y[i]);
+        maxY = math.max(maxY, s.y[i]);
+      }
+    }
+    if (!minX.isFinite || !minY.isFinite) return;
+    if (maxX == minX) maxX = minX + 1;
+    if (maxY == minY) {
+      maxY += 0.5;
+      minY -= 0.5;
+    }
+
+    Offset toScreen(double x, double y) => Offset(
+          plot.left + (x - minX) / (maxX - minX) * plot.width,
+          plot.bottom - (y - minY) / (maxY - minY) * plot.height,
+        );
+
+    for (final s in series) {
+      final path = Path();
+      bool penDown = false;
+      for (int i = 0; i < s.x.length && i < s.y.length; i++) {
+        if (s.y[i].isNaN) {
+          penDown = false;
+          continue;
+        }
+        final p = toScreen(s.x[i], s.y[i]);
+        if (penDown) {
+          path.lineTo(p.dx, p.dy);
+        } else {
+          path.moveTo(p.dx, p.dy);
+          penDown = true;
+        }
+      }
+      canvas.drawPath(
+        path,
+        Paint()
+          ..color = s.color
+          ..strokeWidth = 1.5
+          ..style = PaintingStyle.stroke,
+      );
+    }
+
+    void label(String text, Offset position, {bool alignRight = false}) {
+      final painter = TextPainter(
+        text: TextSpan(
+          text: text,
+          style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+        ),
+        textDirection: TextDirection.ltr,
+      )..layout();
+      painter.paint(
+        canvas,
+        alignRight ? position - Offset(painter.width, 0) : position,
+      );
+    }
+
+    label(ColorMap.formatValue(maxY), Offset(leftMargin - 4, plot.top), alignRight: true);
+    label(ColorMap.formatValue(minY), Offset(leftMargin - 4, plot.bottom - 10), alignRight: true);
+    label('$xLabel = ${ColorMap.formatValue(minX)}', Offset(plot.left, plot.bottom + 2));
+    label(
+      '$xLabel = ${ColorMap.formatValue(maxX)}',
+      Offset(plot.right, plot.bottom + 2),
+      alignRight: true,
+    );
+  }
+
+  @override
+  bool shouldRepaint(covariant LinePlotPainter oldDelegate) => true;
+}
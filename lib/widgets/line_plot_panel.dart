@@ -0,0 +1,195 @@
+// lib/widgets/line_plot_panel.dart
+
+import 'package:flutter/material.dart';
+import '../filters/line_sampler.dart';
+import '../models/openfoam_case.dart';
+import '../utils/color_map.dart';
+import '../utils/field_interpolation.dart';
+import 'line_plot.dart';
+
+/// Plot-over-line panel: the active field sampled along a segment whose end
+/// points are dragged in the viewer.
+///
+/// Updates are coalesced: while one resample is running, further line moves
+/// only record the latest line, which is sampled as soon as the first ends.
+class LinePlotPanel extends StatefulWidget {
+  final PolyMesh mesh;
+  final FieldData? fieldData;
+  final Vector3 start;
+  final Vector3 end;
+  final VoidCallback onClose;
+
+  const LinePlotPanel({
+    super.key,
+    required this.mesh,
+    required this.fieldData,
+    required this.start,
+    required this.end,
+    required this.onClose,
+  });
+
+  @override
+  State<LinePlotPanel> createState() => _LinePlotPanelState();
+}
+
+class _LinePlotPanelState extends State<LinePlotPanel> {
+  static const List<int> _sampleCounts = [100, 200, 500, 1000, 5000];
+
+  late LineSampler _sampler;
+  int _sampleCount = 200;
+  bool _interpolate = true;
+  bool _running = false;
+  bool _dirty = false;
+  List<double> _values = const [];
+
+  @override
+  void initState() {
+    super.initState();
+    _sampler = LineSampler(widget.mesh);
+    _resample();
+  }
+
+  @override
+  void didUpdateWidget(covariant LinePlotPanel oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.mesh != widget.mesh) {
+      _sampler = LineSampler(widget.mesh);
+    }
+    if (oldWidget.mesh != widget.mesh ||
+        oldWidget.start != widget.start ||
+        oldWidget.end != widget.end) {
+      _resample();
+    } else if (oldWidget.fieldData != widget.fieldData) {
+      // Same line: the sample cells are still valid
+      _evaluate();
+    }
+  }
+
+  Future<void> _resample() async {
+    if (_running) {
+      _dirty = true;
+      return;
+    }
+    _running = true;
+    try {
+      do {
+        _dirty = false;
+        await _sampler.update(widget.start, widget.end, _sampleCount);
+        if (!mounted) return;
+        _evaluate();
+      } while (_dirty);
+    } catch (e) {
+      print('Plot over line failed: $e');
+      if (mounted) setState(() => _values = const []);
+    } finally {
+      _running = false;
+    }
+  }
+
+  void _evaluate() {
+    final field = widget.fieldData;
+    if (field == null || field.internalField.isEmpty) {
+      setState(() => _values = const []);
+      return;
+    }
+
+    final pointValues = _interpolate
+        ? FieldInterpolation.pointArray(field, widget.mesh)
+        : null;
+
+    setState(() {
+      _values = _sampler.sample(field.internalField, pointValues: pointValues);
+    });
+  }
+
+  String _format(Vector3 p) =>
+      '(${ColorMap.formatValue(p.x)}, ${ColorMap.formatValue(p.y)}, ${ColorMap.formatValue(p.z)})';
+
+  @override
+  Widget build(BuildContext context) {
+    return Container(
+      decoration: const BoxDecoration(
+        color: Color(0xFF252525),
+        border: Border(top: BorderSide(color: Color(0xFF404040), width: 1)),
+      ),
+      padding: const EdgeInsets.fromLTRB(16, 8, 8, 12),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          Row(
+            children: [
+              const Icon(Icons.show_chart, size: 16, color: Color(0xFFFFEB3B)),
+              const SizedBox(width: 8),
+              Text(
+                'PLOT OVER LINE  ${widget.fieldData?.name ?? ''}',
+                style: const TextStyle(
+                  fontSize: 11,
+                  fontWeight: FontWeight.bold,
+                  color: Color(0xFFE0E0E0),
+                  letterSpacing: 0.5,
+                ),
+              ),
+              const SizedBox(width: 12),
+              Expanded(
+                child: Text(
+                  '${_format(widget.start)} → ${_format(widget.end)}   '
+                  'relocated ${_sampler.relocated} / ${_sampler.cells.length}',
+                  style: const TextStyle(fontSize: 10, color: Color(0xFF808080)),
+                  overflow: TextOverflow.ellipsis,
+                ),
+              ),
+              DropdownButton<int>(
+                value: _sampleCount,
+                underline: const SizedBox(),
+                dropdownColor: const Color(0xFF2D2D2D),
+                style: const TextStyle(fontSize: 11, color: Color(0xFFE0E0E0)),
+                items: [
+                  for (final count in _sampleCounts)
+                    DropdownMenuItem(value: count, child: Text('$count samples')),
+                ],
+                onChanged: (value) {
+                  if (value == null) return;
+                  setState(() => _sampleCount = value);
+                  _resample();
+                },
+              ),
+              const SizedBox(width: 8),
+              FilterChip(
+                label: const Text('Interpolate', style: TextStyle(fontSize: 10)),
+                selected: _interpolate,
+                visualDensity: VisualDensity.compact,
+                onSelected: (selected) {
+                  _interpolate = selected;
+                  _evaluate();
+                },
+              ),
+              IconButton(
+                icon: const Icon(Icons.close, size: 16),
+                tooltip: 'Close Plot',
+                visualDensity: VisualDensity.compact,
+                onPressed: widget.onClose,
+              ),
+            ],
+          ),
+          const SizedBox(height: 8),
+          Expanded(
+            child: CustomPaint(
+              painter: LinePlotPainter(
+                [
+                  if (_values.length == _sampler.distances.length)
+                    PlotSeries(
+                      _sampler.distances,
+                      _values,
+                      const Color(0xFFFFEB3B),
+                    ),
+                ],
+                xLabel: 'd',
+              ),
+              size: Size.infinite,
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+}
@@ -0,0 +1,257 @@
+// lib/widgets/patch_integrals_panel.dart
+
+import 'dart:async';
+import 'package:flutter/foundation.dart';
+import 'package:flutter/material.dart';
+import '../filters/patch_integrals.dart';
+import '../models/openfoam_case.dart';
+import '../utils/color_map.dart';
+import 'line_plot.dart';
+
+/// Sidebar table of per-patch averages, integrals and fluxes of the shown
+/// field, with a background job that computes the same for every time step
+/// and plots the selected patch's curve as results stream in.
+class PatchIntegralsPanel extends StatefulWidget {
+  final PolyMesh mesh;
+  final FieldData? fieldData;
+  final String casePath;
+  final List<String> timeDirectories;
+  final String? fieldName; // Field on disk for the time series; null for computed fields
+
+  const PatchIntegralsPanel({
+    super.key,
+    required this.mesh,
+    required this.fieldData,
+    required this.casePath,
+    required this.timeDirectories,
+    required this.fieldName,
+  });
+
+  @override
+  State<PatchIntegralsPanel> createState() => _PatchIntegralsPanelState();
+}
+
+enum _Quantity { average, integral, flux }
+
+class _PatchIntegralsPanelState extends State<PatchIntegralsPanel> {
+  List<PatchIntegral>? _rows;
+  String? _patch;
+  _Quantity _quantity = _Quantity.average;
+  bool _running = false;
+  bool _dirty = false;
+
+  // Time series: one set of rows per finished time step
+  final List<(double, List<PatchIntegral>)> _series = [];
+  StreamSubscription<(int, List<PatchIntegral>)>? _job;
+
+  @override
+  void initState() {
+    super.initState();
+    _update();
+  }
+
+  @override
+  void didUpdateWidget(covariant PatchIntegralsPanel oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.mesh != widget.mesh ||
+        oldWidget.fieldData != widget.fieldData) {
+      _update();
+    }
+    if (oldWidget.mesh != widget.mesh ||
+        oldWidget.fieldName != widget.fieldName) {
+      _stopSeries(clear: true);
+    } else if (!listEquals(oldWidget.timeDirectories, widget.timeDirectories) &&
+        (_job != null || _series.isNotEmpty)) {
+      // Step indices refer to the old list: start over on the new one
+      _startSeries();
+    }
+  }
+
+  @override
+  void dispose() {
+    _job?.cancel();
+    super.dispose();
+  }
+
+  Future<void> _update() async {
+    if (_running) {
+      _dirty = true;
+      return;
+    }
+    _running = true;
+    try {
+      do {
+        _dirty = false;
+        final field = widget.fieldData;
+        final rows = field == null
+            ? null
+            : await PatchIntegrals.compute(widget.mesh, field);
+        if (!mounted) return;
+        setState(() {
+          _rows = rows;
+          if (rows != null && !rows.any((row) => row.name == _patch)) {
+            _patch = rows.isNotEmpty ? rows.first.name : null;
+          }
+          // Surface fields only have a flux
+          final first = rows?.firstOrNull;
+          if (first != null && first.integral == null) {
+            _quantity = _Quantity.flux;
+          } else if (_quantity == _Quantity.flux && first?.flux == null) {
+            _quantity = _Quantity.average;
+          }
+        });
+      } while (_dirty);
+    } finally {
+      _running = false;
+    }
+  }
+
+  void _startSeries() {
+    final fieldName = widget.fieldName;
+    if (fieldName == null) return;
+    _stopSeries(clear: true);
+    _job = PatchIntegrals.overTime(
+      casePath: widget.casePath,
+      mesh: widget.mesh,
+      fieldName: fieldName,
+      timeDirectories: widget.timeDirectories,
+    ).listen(
+      (step) {
+        if (!mounted) return;
+        final (index, rows) = step;
+        final time = double.tryParse(widget.timeDirectories[index]) ?? index.toDouble();
+        setState(() => _series.add((time, rows)));
+      },
+      onDone: () {
+        if (!mounted) return;
+        setState(() => _job = null);
+      },
+    );
+    setState(() {});
+  }
+
+  void _stopSeries({bool clear = false}) {
+    _job?.cancel();
+    _job = null;
+    if (clear) _series.clear();
+  }
+
+  double _value(PatchIntegral row) => switch (_quantity) {
+        _Quantity.average => row.average ?? double.nan,
+        _Quantity.integral => row.integral ?? double.nan,
+        _Quantity.flux => row.flux ?? double.nan,
+      };
+
+  Widget _chip(String label, bool selected, VoidCallback onSelected) {
+    return Padding(
+      padding: const EdgeInsets.only(right: 6),
+      child: ChoiceChip(
+        label: Text(label, style: const TextStyle(fontSize: 10)),
+        selected: selected,
+        visualDensity: VisualDensity.compact,
+        onSelected: (_) => onSelected(),
+      ),
+    );
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final rows = _rows;
+    if (rows == null || rows.isEmpty) {
+      return const Text(
+        'Select a field',
+        style: TextStyle(fontSize: 9, color: Color(0xFF808080)),
+      );
+    }
+    final hasIntegral = rows.first.integral != null;
+    final hasFlux = rows.first.flux != null;
+    final curve = [
+      for (final (time, stepRows) in _series)
+        for (final row in stepRows)
+          if (row.name == _patch) (time, _value(row)),
+    ];
+
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Row(
+          children: [
+            if (hasIntegral) ...[
+              _chip('Average', _quantity == _Quantity.average,
+                  () => setState(() => _quantity = _Quantity.average)),
+              _chip('Integral', _quantity == _Quantity.integral,
+                  () => setState(() => _quantity = _Quantity.integral)),
+            ],
+            if (hasFlux)
+              _chip('Flux', _quantity == _Quantity.flux,
+                  () => setState(() => _quantity = _Quantity.flux)),
+          ],
+        ),
+        const SizedBox(height: 4),
+        for (final row in rows)
+          InkWell(
+            onTap: () => setState(() => _patch = row.name),
+            child: Padding(
+              padding: const EdgeInsets.symmetric(vertical: 2),
+              child: Row(
+                children: [
+                  Expanded(
+                    child: Text(
+                      row.name,
+                      overflow: TextOverflow.ellipsis,
+                      style: TextStyle(
+                        fontSize: 10,
+                        color: row.name == _patch
+                            ? const Color(0xFF64B5F6)
+                            : const Color(0xFFB0B0B0),
+                      ),
+                    ),
+                  ),
+                  Text(
+                    ColorMap.formatValue(_value(row)),
+                    style: const TextStyle(fontSize: 10, color: Color(0xFFE0E0E0)),
+                  ),
+                ],
+              ),
+            ),
+          ),
+        const SizedBox(height: 4),
+        Row(
+          children: [
+            TextButton.icon(
+              icon: Icon(_job != null ? Icons.stop : Icons.show_chart, size: 14),
+              label: Text(
+                _job != null
+                    ? 'Stop (${_series.length}/${widget.timeDirectories.length})'
+                    : 'Over time',
+                style: const TextStyle(fontSize: 10),
+              ),
+              onPressed: widget.fieldName == null
+                  ? null
+                  : (_job != null
+                      ? () => setState(() => _stopSeries())
+                      : _startSeries),
+            ),
+          ],
+        ),
+        if (curve.isNotEmpty)
+          SizedBox(
+            height: 110,
+            child: CustomPaint(
+              painter: LinePlotPainter(
+                [
+                  PlotSeries(
+                    [for (final (time, _) in curve) time],
+                    [for (final (_, value) in curve) value],
+                    const Color(0xFF64B5F6),
+                  ),
+                ],
+                xLabel: 't',
+              ),
+              size: Size.infinite,
+            ),
+          ),
+      ],
+    );
+  }
+}
@@ -0,0 +1,172 @@
+// lib/widgets/pathline_controls.dart
+
+import 'dart:typed_data';
+import 'package:flutter/material.dart';
+import '../filters/pathline_tracer.dart';
+import '../filters/stream_tracer.dart';
+import '../models/openfoam_case.dart';
+import '../utils/view_transform.dart';
+import 'scene_overlays.dart';
+
+/// Sidebar controls for pathlines: particles released on a mid-plane at
+/// the selected time step and advected to the last one. Tracing runs on
+/// demand, with progress and cancel.
+class PathlineControls extends StatefulWidget {
+  final OpenFOAMCase foamCase;
+  final FieldData? fieldData; // The velocity field to follow
+  final String? timeStep; // Release time
+  final ValueChanged<SceneOverlay?> onOverlayChanged;
+
+  const PathlineControls({
+    super.key,
+    required this.foamCase,
+    required this.fieldData,
+    required this.timeStep,
+    required this.onOverlayChanged,
+  });
+
+  @override
+  State<PathlineControls> createState() => _PathlineControlsState();
+}
+
+class _PathlineControlsState extends State<PathlineControls> {
+  static const List<int> _seedCounts = [25, 100, 250, 500, 1000];
+
+  int _axis = 0;
+  int _seedCount = 100;
+  bool _running = false;
+  bool _cancelled = false;
+  double _progress = 0;
+  String _status = '';
+
+  @override
+  void dispose() {
+    _cancelled = true;
+    super.dispose();
+  }
+
+  Future<void> _trace() async {
+    final field = widget.fieldData;
+    final times = widget.foamCase.timeDirectories;
+    if (field == null || !field.isVector || _running) return;
+
+    final first = widget.timeStep != null ? times.indexOf(widget.timeStep!) : 0;
+    final bounds = MeshBounds.of(widget.foamCase.mesh);
+    final Float64List seeds =
+        SeedSources.plane(bounds.min, bounds.max, _axis, _seedCount);
+
+    setState(() {
+      _running = true;
+      _cancelled = false;
+      _progress = 0;
+      _status = '';
+    });
+    final stopwatch = Stopwatch()..start();
+    try {
+      final lines = await PathlineTracer(
+        casePath: widget.foamCase.casePath,
+        mesh: widget.foamCase.mesh,
+        fieldName: field.name,
+        timeDirectories: times,
+      ).trace(
+        seeds,
+        first: first < 0 ? 0 : first,
+        onProgress: (done, total) {
+          if (mounted) setState(() => _progress = done / total);
+        },
+        isCancelled: () => _cancelled,
+      );
+      if (!mounted) return;
+
+      double minValue = double.infinity;
+      double maxValue = double.negativeInfinity;
+      for (final v in lines.values) {
+        if (v < minValue) minValue = v;
+        if (v > maxValue) maxValue = v;
+      }
+      widget.onOverlayChanged(
+        PolylineOverlay(
+          lines,
+          minValue: minValue.isFinite ? minValue : 0,
+          maxValue: maxValue.isFinite ? maxValue : 1,
+        ),
+      );
+      setState(() {
+        _status = '${lines.lineCount} pathlines, ${lines.pointCount} points, '
+            '${stopwatch.elapsedMilliseconds} ms';
+      });
+    } catch (e) {
+      print('Pathline tracing failed: $e');
+      if (mounted) setState(() => _status = 'Failed: $e');
+    } finally {
+      if (mounted) setState(() => _running = false);
+    }
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    if (widget.fieldData == null || !widget.fieldData!.isVector) {
+      return const Text(
+        'Select a vector field, e.g. U',
+        style: TextStyle(fontSize: 9, color: Color(0xFF808080)),
+      );
+    }
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Row(
+          children: [
+            for (int axis = 0; axis < 3; axis++)
+              Padding(
+                padding: const EdgeInsets.only(right: 6),
+                child: ChoiceChip(
+                  label: Text(
+                    'XYZ'[axis],
+                    style: const TextStyle(fontSize: 10),
+                  ),
+                  selected: _axis == axis,
+                  visualDensity: VisualDensity.compact,
+                  onSelected: _running ? null : (_) => setState(() => _axis = axis),
+                ),
+              ),
+            DropdownButton<int>(
+              value: _seedCount,
+              underline: const SizedBox(),
+              dropdownColor: const Color(0xFF2D2D2D),
+              style: const TextStyle(fontSize: 10, color: Color(0xFFE0E0E0)),
+              items: [
+                for (final count in _seedCounts)
+                  DropdownMenuItem(value: count, child: Text('$count seeds')),
+              ],
+              onChanged: _running
+                  ? null
+                  : (value) {
+                      if (value != null) setState(() => _seedCount = value);
+                    },
+            ),
+          ],
+        ),
+        const SizedBox(height: 4),
+        Row(
+          children: [
+            TextButton.icon(
+              icon: Icon(_running ? Icons.stop : Icons.play_arrow, size: 14),
+              label: Text(
+                _running ? 'Cancel' : 'Trace from ${widget.timeStep ?? ''}',
+                style: const TextStyle(fontSize: 10),
+              ),
+              onPressed: _running ? () => _cancelled = true : _trace,
+            ),
+            if (_running)
+              Expanded(child: LinearProgressIndicator(value: _progress, minHeight: 2)),
+          ],
+        ),
+        if (_status.isNotEmpty)
+          Text(
+            _status,
+            style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+          ),
+      ],
+    );
+  }
+}
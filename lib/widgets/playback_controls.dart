@@ -0,0 +1,316 @@
+// lib/widgets/playback_controls.dart
+
+import 'dart:async';
+import 'dart:math' as math;
+import 'package:flutter/material.dart';
+import '../models/openfoam_case.dart';
+import '../readers/frame_pipeline.dart';
+import '../utils/field_interpolation.dart';
+
+/// Play, pause, loop and scrub through the time directories.
+///
+/// The playhead follows the wall clock. Upcoming frames are decoded ahead
+/// by a [FramePipeline]; on every tick the newest decoded frame at or
+/// before the playhead is shown, and frames that were not ready by then
+/// are dropped instead of stalling playback. With Smooth on, playback and
+/// the timeline slider show frames blended between the two neighbouring
+/// steps, which stay decoded around the playhead.
+class PlaybackControls extends StatefulWidget {
+  final OpenFOAMCase foamCase;
+  final String? fieldName;
+  final String? timeStep; // Shown when playback starts
+  // [blended] frames lie between two steps and are labelled with the nearer
+  final void Function(String timeStep, FieldData? fieldData, bool blended) onFrame;
+
+  const PlaybackControls({
+    super.key,
+    required this.foamCase,
+    required this.fieldName,
+    required this.timeStep,
+    required this.onFrame,
+  });
+
+  @override
+  State<PlaybackControls> createState() => _PlaybackControlsState();
+}
+
+class _PlaybackControlsState extends State<PlaybackControls> {
+  static const List<int> _rates = [2, 5, 10, 15, 24, 30];
+  static const int _lookAhead = 6; // Frames decoded ahead of the playhead
+  static const int _smoothRate = 30; // Display rate of blended playback
+
+  FramePipeline? _pipeline;
+  Timer? _timer;
+  final Stopwatch _clock = Stopwatch();
+  bool _loop = false;
+  bool _smooth = false;
+  int _fps = 10; // Time steps per second
+  int _start = 0; // Frame count position where the clock started
+  int _shown = 0; // Frame count position on screen (unwrapped when looping)
+  int _dropped = 0;
+  double _position = 0; // Timeline position, fractional between steps
+
+  bool get _playing => _timer != null;
+  int get _frameCount => widget.foamCase.timeDirectories.length;
+
+  @override
+  void initState() {
+    super.initState();
+    _position = _stepIndex().toDouble();
+  }
+
+  @override
+  void didUpdateWidget(covariant PlaybackControls oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.foamCase != widget.foamCase ||
+        oldWidget.fieldName != widget.fieldName) {
+      _pause();
+      _pipeline?.close();
+      _pipeline = null;
+    }
+    // Picked from the time step list rather than by this widget
+    final index = _stepIndex();
+    if (!_playing && index != _position.round()) _position = index.toDouble();
+  }
+
+  @override
+  void dispose() {
+    _timer?.cancel();
+    _pipeline?.close();
+    super.dispose();
+  }
+
+  int _stepIndex() {
+    final timeStep = widget.timeStep;
+    if (timeStep == null) return 0;
+    return math.max(0, widget.foamCase.timeDirectories.indexOf(timeStep));
+  }
+
+  FramePipeline? _ensurePipeline() {
+    final fieldName = widget.fieldName;
+    if (fieldName == null) return null;
+    return _pipeline ??= FramePipeline(
+      casePath: widget.foamCase.casePath,
+      mesh: widget.foamCase.mesh,
+      fieldName: fieldName,
+      timeDirectories: widget.foamCase.timeDirectories,
+    );
+  }
+
+  void _play() {
+    final pipeline = _ensurePipeline();
+    if (pipeline == null || _frameCount < 2) return;
+
+    final current = _stepIndex();
+    // Playing from the end starts over
+    _start = current >= _frameCount - 1 ? 0 : current;
+    _shown = _start;
+    _dropped = 0;
+    pipeline.retain(_window(pipeline, _start));
+    _clock.reset(); // Started by the first tick with the next frame ready
+    final rate = _smooth ? _smoothRate : _fps;
+    setState(() {
+      _timer = Timer.periodic(
+        Duration(microseconds: 1000000 ~/ rate),
+        (_) => _tick(),
+      );
+    });
+  }
+
+  void _pause() {
+    _timer?.cancel();
+    _clock.stop();
+    if (mounted) setState(() => _timer = null);
+  }
+
+  int _index(int position) => _loop ? position % _frameCount : position;
+
+  // Frames still wanted with the playhead at [target]: those already in
+  // flight since the last shown one, then the look-ahead. A frame the
+  // playhead reaches before its decode was started cannot be on time.
+  Iterable<int> _window(FramePipeline pipeline, int target) sync* {
+    for (int p = math.max(_shown + 1, target - _lookAhead); p <= target + _lookAhead; p++) {
+      if (!_loop && p >= _frameCount) break;
+      if (p > target || pipeline.isRequested(_index(p))) yield _index(p);
+    }
+    // The shown frame is kept as the lower end of blends
+    if (_smooth) yield _index(target);
+  }
+
+  // Shows a decoded step as it is (null if it could not be read)
+  void _showStep(FramePipeline pipeline, int index) {
+    widget.onFrame(
+      widget.foamCase.timeDirectories[index],
+      pipeline.readyFrame(index),
+      false,
+    );
+  }
+
+  // Shows the blend of steps [i] and [j] if both are decoded
+  bool _showBlend(FramePipeline pipeline, int i, int j, double t) {
+    if (!pipeline.isReady(i) || !pipeline.isReady(j)) return false;
+    final a = pipeline.readyFrame(i);
+    final b = pipeline.readyFrame(j);
+    if (a == null || b == null) return false;
+    widget.onFrame(
+      widget.foamCase.timeDirectories[t < 0.5 ? i : j],
+      FieldInterpolation.blend(a, b, t),
+      t > 0 && t < 1,
+    );
+    return true;
+  }
+
+  void _tick() {
+    final pipeline = _pipeline;
+    if (pipeline == null) return;
+    if (!_clock.isRunning) {
+      if (!pipeline.isReady(_index(_start + 1))) return;
+      _clock.start();
+    }
+    final playhead = _start + _clock.elapsedMicroseconds * _fps / 1000000;
+    int target = playhead.floor();
+    if (!_loop) target = math.min(target, _frameCount - 1);
+
+    // Blended frame between the playhead's two steps, unless wrapping
+    final i = _index(target);
+    final t = playhead - target;
+    final blended = _smooth &&
+        i + 1 < _frameCount &&
+        t < 1 &&
+        _showBlend(pipeline, i, i + 1, t);
+    if (blended) {
+      _dropped += math.max(0, target - _shown - 1);
+      _shown = target;
+      _position = i + t;
+    } else {
+      // Newest ready frame not after the playhead; older ones are dropped
+      for (int p = target; p > _shown; p--) {
+        final index = _index(p);
+        if (!pipeline.isReady(index)) continue;
+        _dropped += p - _shown - 1;
+        _shown = p;
+        _position = index.toDouble();
+        _showStep(pipeline, index);
+        break;
+      }
+    }
+    pipeline.retain(_window(pipeline, target));
+
+    if (!_loop && _shown >= _frameCount - 1) {
+      _pause();
+    } else {
+      setState(() {});
+    }
+  }
+
+  // Timeline drag: frames blended from the decoded neighbours, or just the
+  // nearest step without Smooth. Steps not cached yet are requested and
+  // shown when they arrive, if the slider is still there. Only the steps
+  // shown are kept, so steps passed while dragging are skipped rather
+  // than decoded.
+  void _scrub(double value) {
+    if (_playing) _pause();
+    setState(() => _position = value);
+    final pipeline = _ensurePipeline();
+    if (pipeline == null) return;
+
+    if (!_smooth) {
+      final k = value.round().clamp(0, _frameCount - 1);
+      pipeline.retain([k]);
+      if (pipeline.isReady(k)) {
+        _showStep(pipeline, k);
+        return;
+      }
+      pipeline.frame(k).then((_) {
+        if (mounted &&
+            _position == value &&
+            identical(_pipeline, pipeline) &&
+            pipeline.isReady(k)) {
+          _showStep(pipeline, k);
+        }
+      });
+      return;
+    }
+
+    final i = value.floor().clamp(0, _frameCount - 1);
+    final j = math.min(i + 1, _frameCount - 1);
+    final t = value - i;
+    pipeline.retain([i, j]);
+    if (_showBlend(pipeline, i, j, t)) return;
+    Future.wait([pipeline.frame(i), pipeline.frame(j)]).then((_) {
+      if (mounted && _position == value && identical(_pipeline, pipeline)) {
+        _showBlend(pipeline, i, j, t);
+      }
+    });
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    if (_frameCount < 2) return const SizedBox.shrink();
+    final enabled = widget.fieldName != null;
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Slider(
+          value: _position.clamp(0.0, (_frameCount - 1).toDouble()),
+          min: 0,
+          max: (_frameCount - 1).toDouble(),
+          onChanged: enabled ? _scrub : null,
+        ),
+        Row(
+          children: [
+            IconButton(
+              icon: Icon(_playing ? Icons.pause : Icons.play_arrow, size: 16),
+              tooltip: _playing ? 'Pause' : 'Play',
+              visualDensity: VisualDensity.compact,
+              onPressed: enabled ? (_playing ? _pause : _play) : null,
+            ),
+            IconButton(
+              icon: Icon(
+                Icons.repeat,
+                size: 16,
+                color: _loop ? const Color(0xFF64B5F6) : const Color(0xFF808080),
+              ),
+              tooltip: 'Loop',
+              visualDensity: VisualDensity.compact,
+              onPressed: () => setState(() => _loop = !_loop),
+            ),
+            IconButton(
+              icon: Icon(
+                Icons.blur_linear,
+                size: 16,
+                color: _smooth ? const Color(0xFF64B5F6) : const Color(0xFF808080),
+              ),
+              tooltip: 'Smooth: blend between time steps',
+              visualDensity: VisualDensity.compact,
+              onPressed: _playing ? null : () => setState(() => _smooth = !_smooth),
+            ),
+            DropdownButton<int>(
+              value: _fps,
+              underline: const SizedBox(),
+              dropdownColor: const Color(0xFF2D2D2D),
+              style: const TextStyle(fontSize: 10, color: Color(0xFFE0E0E0)),
+              items: [
+                for (final rate in _rates)
+                  DropdownMenuItem(value: rate, child: Text('$rate fps')),
+              ],
+              onChanged: _playing
+                  ? null
+                  : (value) {
+                      if (value != null) setState(() => _fps = value);
+                    },
+            ),
+            if (_playing || _dropped > 0)
+              Padding(
+                padding: const EdgeInsets.only(left: 6),
+                child: Text(
+                  '$_dropped dropped',
+                  style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+                ),
+              ),
+          ],
+        ),
+      ],
+    );
+  }
+}
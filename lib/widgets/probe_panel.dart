@@ -0,0 +1,224 @@
+// lib/widgets/probe_panel.dart
+
+import 'dart:async';
+import 'package:flutter/foundation.dart';
+import 'package:flutter/material.dart';
+import '../models/openfoam_case.dart';
+import '../readers/case_reader.dart';
+import '../utils/mesh_picker.dart';
+import 'line_plot.dart';
+
+/// Plots fields at one probed cell across every time directory.
+///
+/// Each plotted field is read by its own background job
+/// ([CaseReader.probeTimeSeries]) that streams samples in as time steps are
+/// read, so the curves grow while the rest of the series loads.
+class ProbePanel extends StatefulWidget {
+  final String casePath;
+  final List<String> timeDirectories;
+  final List<String> availableFields;
+  final String? initialField;
+  final PickResult probe;
+  final VoidCallback onClose;
+
+  const ProbePanel({
+    super.key,
+    required this.casePath,
+    required this.timeDirectories,
+    required this.availableFields,
+    required this.probe,
+    required this.onClose,
+    this.initialField,
+  });
+
+  @override
+  State<ProbePanel> createState() => _ProbePanelState();
+}
+
+class _ProbePanelState extends State<ProbePanel> {
+  static const List<Color> _seriesColors = [
+    Color(0xFF64B5F6),
+    Color(0xFFFFB74D),
+    Color(0xFF81C784),
+    Color(0xFFE57373),
+    Color(0xFFBA68C8),
+    Color(0xFF4DD0E1),
+  ];
+
+  final Map<String, List<ProbeSample>> _series = {};
+  final Map<String, StreamSubscription<ProbeSample>> _jobs = {};
+
+  @override
+  void initState() {
+    super.initState();
+    if (widget.initialField != null) {
+      _startField(widget.initialField!);
+    }
+  }
+
+  @override
+  void didUpdateWidget(covariant ProbePanel oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.probe.cellIndex != widget.probe.cellIndex ||
+        oldWidget.casePath != widget.casePath ||
+        !listEquals(oldWidget.timeDirectories, widget.timeDirectories)) {
+      // New probe location or time steps: restart every plotted field
+      final fields = _series.keys.toList();
+      _cancelAll();
+      _series.clear();
+      for (final field in fields) {
+        _startField(field);
+      }
+    }
+  }
+
+  @override
+  void dispose() {
+    _cancelAll();
+    super.dispose();
+  }
+
+  void _cancelAll() {
+    for (final job in _jobs.values) {
+      job.cancel();
+    }
+    _jobs.clear();
+  }
+
+  void _startField(String field) {
+    _series[field] = [];
+    _jobs[field] = CaseReader.probeTimeSeries(
+      widget.casePath,
+      widget.timeDirectories,
+      [field],
+      widget.probe.cellIndex,
+    ).listen(
+      (sample) {
+        if (!mounted) return;
+        setState(() => _series[field]?.add(sample));
+      },
+      onDone: () {
+        if (!mounted) return;
+        setState(() => _jobs.remove(field));
+      },
+    );
+  }
+
+  void _toggleField(String field, bool selected) {
+    setState(() {
+      if (selected) {
+        _startField(field);
+      } else {
+        _jobs.remove(field)?.cancel();
+        _series.remove(field);
+      }
+    });
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final fields = _series.keys.toList();
+    final loaded = _series.values.fold<int>(0, (sum, s) => sum + s.length);
+    final total = widget.timeDirectories.length * fields.length;
+
+    return Container(
+      decoration: const BoxDecoration(
+        color: Color(0xFF252525),
+        border: Border(top: BorderSide(color: Color(0xFF404040), width: 1)),
+      ),
+      padding: const EdgeInsets.fromLTRB(16, 8, 8, 12),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          Row(
+            children: [
+              const Icon(Icons.timeline, size: 16, color: Color(0xFF64B5F6)),
+              const SizedBox(width: 8),
+              Text(
+                'PROBE  cell ${widget.probe.cellIndex}'
+                '${widget.probe.patchName != null ? '  (${widget.probe.patchName})' : ''}',
+                style: const TextStyle(
+                  fontSize: 11,
+                  fontWeight: FontWeight.bold,
+                  color: Color(0xFFE0E0E0),
+                  letterSpacing: 0.5,
+                ),
+              ),
+              const SizedBox(width: 12),
+              if (_jobs.isNotEmpty)
+                Text(
+                  'Reading $loaded / $total',
+                  style: const TextStyle(fontSize: 10, color: Color(0xFF808080)),
+                ),
+              const Spacer(),
+              IconButton(
+                icon: const Icon(Icons.close, size: 16),
+                tooltip: 'Close Probe',
+                visualDensity: VisualDensity.compact,
+                onPressed: widget.onClose,
+              ),
+            ],
+          ),
+          SizedBox(
+            height: 28,
+            child: ListView(
+              scrollDirection: Axis.horizontal,
+              children: [
+                for (final field in widget.availableFields)
+                  Padding(
+                    padding: const EdgeInsets.only(right: 6),
+                    child: FilterChip(
+                      label: Text(field, style: const TextStyle(fontSize: 10)),
+                      selected: _series.containsKey(field),
+                      visualDensity: VisualDensity.compact,
+                      onSelected: (selected) => _toggleField(field, selected),
+                    ),
+                  ),
+              ],
+            ),
+          ),
+          const SizedBox(height: 8),
+          Expanded(
+            child: CustomPaint(
+              // Magnitude for non-scalar fields
+              painter: LinePlotPainter(
+                [
+                  for (int i = 0; i < fields.length; i++)
+                    PlotSeries(
+                      [for (final sample in _series[fields[i]]!) sample.time],
+                      [for (final sample in _series[fields[i]]!) sample.magnitude],
+                      _seriesColors[i % _seriesColors.length],
+                    ),
+                ],
+                xLabel: 't',
+              ),
+              size: Size.infinite,
+            ),
+          ),
+          const SizedBox(height: 4),
+          Wrap(
+            spacing: 12,
+            children: [
+              for (int i = 0; i < fields.length; i++)
+                Row(
+                  mainAxisSize: MainAxisSize.min,
+                  children: [
+                    Container(
+                      width: 10,
+                      height: 2,
+                      color: _seriesColors[i % _seriesColors.length],
+                    ),
+                    const SizedBox(width: 4),
+                    Text(
+                      fields[i],
+                      style: const TextStyle(fontSize: 10, color: Color(0xFFB0B0B0)),
+                    ),
+                  ],
+                ),
+            ],
+          ),
+        ],
+      ),
+    );
+  }
+}
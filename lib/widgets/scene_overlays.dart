@@ -0,0 +1,319 @@
+// lib/widgets/scene_overlays.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+import 'dart:ui' as ui;
+import 'package:flutter/material.dart';
+import '../filters/glyph_source.dart';
+import '../filters/polylines.dart';
+import '../filters/triangle_surface.dart';
+import '../models/openfoam_case.dart';
+import '../utils/color_map.dart';
+import '../utils/sort_utils.dart';
+import '../utils/view_transform.dart';
+
+/// Extra geometry drawn by [FoamMeshPainter] on top of the mesh, such as
+/// filter outputs. Overlays are immutable; hand the viewer a new instance
+/// when the content changes so it knows to repaint.
+abstract class SceneOverlay {
+  const SceneOverlay();
+
+  void paint(Canvas canvas, ViewTransform transform);
+}
+
+/// A straight segment, e.g. the plot-over-line probe
+class LineOverlay extends SceneOverlay {
+  final Vector3 start;
+  final Vector3 end;
+  final Color color;
+
+  const LineOverlay(
+    this.start,
+    this.end, {
+    this.color = const Color(0xFFFFEB3B),
+  });
+
+  @override
+  void paint(Canvas canvas, ViewTransform transform) {
+    canvas.drawLine(
+      transform.project(start.x, start.y, start.z),
+      transform.project(end.x, end.y, end.z),
+      Paint()
+        ..color = color
+        ..strokeWidth = 2,
+    );
+  }
+}
+
+/// Filter output triangles coloured by their vertex values
+class SurfaceOverlay extends SceneOverlay {
+  final TriangleSurface surface;
+  final double minValue;
+  final double maxValue;
+  final bool depthSort; // Needed when the surface can overlap itself
+
+  const SurfaceOverlay(
+    this.surface, {
+    required this.minValue,
+    required this.maxValue,
+    this.depthSort = false,
+  });
+
+  @override
+  void paint(Canvas canvas, ViewTransform transform) {
+    if (surface.isEmpty) return;
+
+    final positions = surface.positions;
+    final nVertices = surface.vertexCount;
+    final screen = Float32List(nVertices * 2);
+    final colors = Int32List(nVertices);
+    final fallback = Colors.grey.shade400.toARGB32();
+    for (int v = 0; v < nVertices; v++) {
+      final x = positions[v * 3], y = positions[v * 3 + 1], z = positions[v * 3 + 2];
+      final p = transform.project(x, y, z);
+      screen[v * 2] = p.dx;
+      screen[v * 2 + 1] = p.dy;
+      final value = surface.values[v];
+      colors[v] = value.isNaN
+          ? fallback
+          : ColorMap.getFastColor(value, minValue, maxValue).toARGB32();
+    }
+
+    // Triangle order, back to front when requested
+    final triangles = surface.triangles;
+    final nTriangles = surface.triangleCount;
+    var order = Int32List(nTriangles);
+    for (int t = 0; t < nTriangles; t++) {
+      order[t] = t;
+    }
+    if (depthSort) {
+      final depths = Float64List(nTriangles);
+      for (int t = 0; t < nTriangles; t++) {
+        double depth = 0;
+        for (int k = 0; k < 3; k++) {
+          final v = triangles[t * 3 + k] * 3;
+          depth += transform.depth(positions[v], positions[v + 1], positions[v + 2]);
+        }
+        depths[t] = depth;
+      }
+      order = SortUtils.argsort(depths).$1;
+    }
+
+    // Expanded, unindexed vertices: index buffers are limited to 16 bits
+    final vertexPositions = Float32List(nTriangles * 6);
+    final vertexColors = Int32List(nTriangles * 3);
+    for (int n = 0; n < nTriangles; n++) {
+      final t = order[n];
+      for (int k = 0; k < 3; k++) {
+        final v = triangles[t * 3 + k];
+        vertexPositions[(n * 3 + k) * 2] = screen[v * 2];
+        vertexPositions[(n * 3 + k) * 2 + 1] = screen[v * 2 + 1];
+        vertexColors[n * 3 + k] = colors[v];
+      }
+    }
+
+    canvas.drawVertices(
+      ui.Vertices.raw(
+        ui.VertexMode.triangles,
+        vertexPositions,
+        colors: vertexColors,
+      ),
+      BlendMode.srcOver,
+      Paint(),
+    );
+  }
+}
+
+/// Filter output lines (streamlines, pathlines) coloured by their values.
+///
+/// Segments are grouped into [bands] colour bands and each band is drawn
+/// with one `drawRawPoints` call.
+class PolylineOverlay extends SceneOverlay {
+  static const int bands = 32;
+
+  final Polylines lines;
+  final double minValue;
+  final double maxValue;
+  final double strokeWidth;
+
+  const PolylineOverlay(
+    this.lines, {
+    required this.minValue,
+    required this.maxValue,
+    this.strokeWidth = 1.5,
+  });
+
+  int _band(double value) {
+    if (value.isNaN || maxValue <= minValue) return 0;
+    final t = (value - minValue) / (maxValue - minValue);
+    return (t * bands).floor().clamp(0, bands - 1);
+  }
+
+  @override
+  void paint(Canvas canvas, ViewTransform transform) {
+    if (lines.isEmpty) return;
+
+    final positions = lines.positions;
+    final screen = Float32List(lines.pointCount * 2);
+    for (int p = 0; p < lines.pointCount; p++) {
+      final offset = transform.project(
+        positions[p * 3],
+        positions[p * 3 + 1],
+        positions[p * 3 + 2],
+      );
+      screen[p * 2] = offset.dx;
+      screen[p * 2 + 1] = offset.dy;
+    }
+
+    // Two passes: segments per band, then their end points
+    final counts = Int32List(bands + 1);
+    for (int l = 0; l < lines.lineCount; l++) {
+      for (int p = lines.offsets[l]; p < lines.offsets[l + 1] - 1; p++) {
+        counts[_band((lines.values[p] + lines.values[p + 1]) / 2) + 1]++;
+      }
+    }
+    for (int b = 0; b < bands; b++) {
+      counts[b + 1] += counts[b];
+    }
+    final ends = Float32List(counts[bands] * 4);
+    final fill = Int32List.fromList(counts.sublist(0, bands));
+    for (int l = 0; l < lines.lineCount; l++) {
+      for (int p = lines.offsets[l]; p < lines.offsets[l + 1] - 1; p++) {
+        final segment = fill[_band((lines.values[p] + lines.values[p + 1]) / 2)]++;
+        ends.setRange(segment * 4, segment * 4 + 4, screen, p * 2);
+      }
+    }
+
+    final paint = Paint()
+      ..strokeWidth = strokeWidth
+      ..strokeCap = StrokeCap.round;
+    for (int b = 0; b < bands; b++) {
+      if (counts[b + 1] == counts[b]) continue;
+      paint.color = ColorMap.getFastColor(
+        minValue + (maxValue - minValue) * (b + 0.5) / bands,
+        minValue,
+        maxValue,
+      );
+      canvas.drawRawPoints(
+        ui.PointMode.lines,
+        Float32List.sublistView(ends, counts[b] * 4, counts[b + 1] * 4),
+        paint,
+      );
+    }
+  }
+}
+
+/// Arrow glyphs for a vector field.
+///
+/// Every frame the candidates of the [GlyphSource] are binned into a
+/// screen grid of [spacing] pixels and only the frontmost one per bin is
+/// kept, so at most a few thousand arrows are drawn however large the mesh
+/// or however far it is zoomed out. Arrows are sized in screen space by
+/// |v| relative to [maxValue], coloured by |v|, and stamped from one
+/// template into a single `drawVertices` call.
+class GlyphOverlay extends SceneOverlay {
+  // Unit arrow along +x: shaft quad as two triangles, then the head
+  static final Float32List _template = Float32List.fromList([
+    0.0, -0.05, 0.65, -0.05, 0.65, 0.05, //
+    0.0, -0.05, 0.65, 0.05, 0.0, 0.05, //
+    0.65, -0.18, 1.0, 0.0, 0.65, 0.18, //
+  ]);
+  static int get _templateVertices => _template.length ~/ 2;
+
+  final GlyphSource source;
+  final double minValue;
+  final double maxValue;
+  final double spacing; // Screen grid cell, in pixels
+  final double scale; // Arrow length at maxValue, in grid cells
+
+  const GlyphOverlay(
+    this.source, {
+    required this.minValue,
+    required this.maxValue,
+    this.spacing = 24,
+    this.scale = 1.5,
+  });
+
+  @override
+  void paint(Canvas canvas, ViewTransform transform) {
+    if (source.length == 0 || maxValue <= 0) return;
+
+    final width = transform.size.width;
+    final height = transform.size.height;
+    final columns = math.max(1, (width / spacing).ceil());
+    final rows = math.max(1, (height / spacing).ceil());
+    final chosen = Int32List(columns * rows)..fillRange(0, columns * rows, -1);
+    final chosenDepth = Float64List(columns * rows);
+
+    // Frontmost candidate per screen bin; zero and NaN vectors are skipped
+    final positions = source.positions;
+    final vectors = source.vectors;
+    for (int g = 0; g < source.length; g++) {
+      final vx = vectors[g * 3], vy = vectors[g * 3 + 1], vz = vectors[g * 3 + 2];
+      if (!(vx * vx + vy * vy + vz * vz > 0)) continue;
+      final x = positions[g * 3], y = positions[g * 3 + 1], z = positions[g * 3 + 2];
+      final p = transform.project(x, y, z);
+      if (p.dx < 0 || p.dy < 0 || p.dx >= width || p.dy >= height) continue;
+      final bin = (p.dy ~/ spacing) * columns + p.dx ~/ spacing;
+      final depth = transform.depth(x, y, z);
+      if (chosen[bin] < 0 || depth > chosenDepth[bin]) {
+        chosen[bin] = g;
+        chosenDepth[bin] = depth;
+      }
+    }
+
+    final count = chosen.where((g) => g >= 0).length;
+    if (count == 0) return;
+    final perGlyph = _templateVertices;
+    final vertexPositions = Float32List(count * perGlyph * 2);
+    final vertexColors = Int32List(count * perGlyph);
+    final origin = transform.project(0, 0, 0);
+    final fullLength = spacing * scale;
+    int n = 0;
+
+    for (final g in chosen) {
+      if (g < 0) continue;
+      final vx = vectors[g * 3], vy = vectors[g * 3 + 1], vz = vectors[g * 3 + 2];
+      final magnitude = math.sqrt(vx * vx + vy * vy + vz * vz);
+
+      // Projected direction; the projection is linear up to its offset
+      final tip = transform.project(vx, vy, vz) - origin;
+      final screenLength = tip.distance;
+      final length = fullLength * (magnitude / maxValue).clamp(0.0, 1.0);
+      double dx = 0, dy = 0;
+      if (screenLength > 0) {
+        // Shortened by foreshortening, like the vector itself
+        final along = length * screenLength / (magnitude * transform.zoom);
+        dx = tip.dx / screenLength * along;
+        dy = tip.dy / screenLength * along;
+      }
+      final px = -dy, py = dx;
+      final centre = transform.project(
+        positions[g * 3],
+        positions[g * 3 + 1],
+        positions[g * 3 + 2],
+      );
+      final color = ColorMap.getFastColor(magnitude, minValue, maxValue).toARGB32();
+
+      for (int k = 0; k < perGlyph; k++) {
+        final u = _template[k * 2];
+        final w = _template[k * 2 + 1];
+        final v = n * perGlyph + k;
+        vertexPositions[v * 2] = centre.dx + dx * u + px * w;
+        vertexPositions[v * 2 + 1] = centre.dy + dy * u + py * w;
+        vertexColors[v] = color;
+      }
+      n++;
+    }
+
+    canvas.drawVertices(
+      ui.Vertices.raw(
+        ui.VertexMode.triangles,
+        vertexPositions,
+        colors: vertexColors,
+      ),
+      BlendMode.srcOver,
+      Paint(),
+    );
+  }
+}
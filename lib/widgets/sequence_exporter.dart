@@ -0,0 +1,124 @@
+// lib/widgets/sequence_exporter.dart
+
+import 'dart:io';
+import 'dart:ui' as ui;
+import 'package:flutter/material.dart';
+import '../models/openfoam_case.dart';
+import '../readers/frame_pipeline.dart';
+
+/// Renders a range of time steps to a numbered PNG sequence without
+/// driving the UI.
+///
+/// Fields are decoded ahead on the worker pool through a [FramePipeline],
+/// at most [inFlight] at a time. Each frame is painted into an offscreen
+/// picture (dart:ui recording only runs on the UI isolate), then
+/// rasterised, PNG-encoded by the engine off the UI thread and written
+/// while the following frames are painted. A step whose field cannot be
+/// read, or a failed write, stops the export with that error.
+class SequenceExporter {
+  final OpenFOAMCase foamCase;
+  final String fieldName;
+  final Size size; // Output resolution in pixels
+  final CustomPainter Function(FieldData? fieldData) painterFor;
+  final int inFlight;
+
+  /// Loads computed fields (calculator results, mesh metrics), which have
+  /// no files to decode ahead, one step at a time
+  final Future<FieldData?> Function(String timeStep)? loadField;
+
+  SequenceExporter({
+    required this.foamCase,
+    required this.fieldName,
+    required this.size,
+    required this.painterFor,
+    this.inFlight = 4,
+    this.loadField,
+  });
+
+  static const Color background = Color(0xFF1E1E1E);
+
+  /// Writes time indices [first]..[last] to [directory] as
+  /// frame_0000.png, ... and returns the number of frames written
+  Future<int> export(
+    String directory, {
+    int first = 0,
+    int? last,
+    void Function(int done, int total)? onProgress,
+    bool Function()? isCancelled,
+  }) async {
+    final end = last ?? foamCase.timeDirectories.length - 1;
+    final total = end - first + 1;
+    final digits = '${total - 1}'.length < 4 ? 4 : '${total - 1}'.length;
+    final pipeline = FramePipeline(
+      casePath: foamCase.casePath,
+      mesh: foamCase.mesh,
+      fieldName: fieldName,
+      timeDirectories: foamCase.timeDirectories,
+    );
+    // Writes never fail themselves: the first error is kept and rethrown
+    // once every write still running has finished
+    final writes = <Future<void>>[];
+    (Object, StackTrace)? failure;
+    int done = 0;
+
+    try {
+      for (int index = first; index <= end; index++) {
+        if (failure != null || (isCancelled?.call() ?? false)) break;
+        final FieldData? fieldData;
+        if (loadField != null) {
+          fieldData = await loadField!(foamCase.timeDirectories[index]);
+        } else {
+          pipeline.retain([
+            for (int k = index; k < index + inFlight && k <= end; k++) k,
+          ]);
+          fieldData = await pipeline.frame(index);
+        }
+        if (fieldData == null) {
+          throw StateError(
+            'Could not read $fieldName at ${foamCase.timeDirectories[index]}',
+          );
+        }
+
+        final image = _render(fieldData);
+        final name = 'frame_${'${index - first}'.padLeft(digits, '0')}.png';
+        writes.add(_write(image, '$directory/$name').then<void>(
+          (_) => onProgress?.call(++done, total),
+          onError: (Object e, StackTrace stack) {
+            failure ??= (e, stack);
+          },
+        ));
+
+        // Bounded encode queue: wait for the oldest before painting more
+        if (writes.length >= inFlight) await writes.removeAt(0);
+      }
+    } finally {
+      await Future.wait(writes);
+      pipeline.close();
+    }
+    final error = failure;
+    if (error != null) Error.throwWithStackTrace(error.$1, error.$2);
+    return done;
+  }
+
+  Future<ui.Image> _render(FieldData? fieldData) {
+    final recorder = ui.PictureRecorder();
+    final canvas = Canvas(recorder, Offset.zero & size);
+    canvas.drawRect(Offset.zero & size, Paint()..color = background);
+    painterFor(fieldData).paint(canvas, size);
+    final picture = recorder.endRecording();
+    return picture
+        .toImage(size.width.round(), size.height.round())
+        .whenComplete(picture.dispose);
+  }
+
+  static Future<void> _write(Future<ui.Image> rendered, String path) async {
+    final image = await rendered;
+    try {
+      final png = await image.toByteData(format: ui.ImageByteFormat.png);
+      if (png == null) throw StateError('PNG encoding failed for $path');
+      await File(path).writeAsBytes(png.buffer.asUint8List(), flush: false);
+    } finally {
+      image.dispose();
+    }
+  }
+}
@@ -0,0 +1,151 @@
+// lib/widgets/slice_controls.dart
+
+import 'package:flutter/material.dart';
+import '../filters/slice_filter.dart';
+import '../models/openfoam_case.dart';
+import '../utils/color_map.dart';
+import '../utils/field_interpolation.dart';
+import 'scene_overlays.dart';
+
+/// Sidebar controls for the slice filter: plane normal and position.
+///
+/// Cuts run in the background; while one is running, slider moves only
+/// record the latest position, which is cut as soon as the first finishes.
+class SliceControls extends StatefulWidget {
+  final PolyMesh mesh;
+  final FieldData? fieldData;
+  final ValueChanged<SceneOverlay?> onOverlayChanged;
+
+  const SliceControls({
+    super.key,
+    required this.mesh,
+    required this.fieldData,
+    required this.onOverlayChanged,
+  });
+
+  @override
+  State<SliceControls> createState() => _SliceControlsState();
+}
+
+class _SliceControlsState extends State<SliceControls> {
+  static final List<Vector3> _normals = [
+    Vector3(1, 0, 0),
+    Vector3(0, 1, 0),
+    Vector3(0, 0, 1),
+  ];
+
+  late SliceFilter _filter;
+  int _axis = 0;
+  double _offset = 0;
+  (double, double) _range = (0, 1);
+  bool _running = false;
+  bool _dirty = false;
+  int _triangles = 0;
+  int _elapsedMs = 0;
+
+  @override
+  void initState() {
+    super.initState();
+    _filter = SliceFilter(widget.mesh);
+    _setAxis(0);
+  }
+
+  @override
+  void didUpdateWidget(covariant SliceControls oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.mesh != widget.mesh) {
+      _filter = SliceFilter(widget.mesh);
+      _setAxis(_axis);
+    } else if (oldWidget.fieldData != widget.fieldData) {
+      _cut();
+    }
+  }
+
+  Future<void> _setAxis(int axis) async {
+    _axis = axis;
+    final range = await _filter.offsetRange(_normals[axis]);
+    if (!mounted) return;
+    setState(() {
+      _range = range;
+      _offset = (range.$1 + range.$2) / 2;
+    });
+    _cut();
+  }
+
+  Future<void> _cut() async {
+    if (_running) {
+      _dirty = true;
+      return;
+    }
+    _running = true;
+    try {
+      do {
+        _dirty = false;
+        final field = widget.fieldData;
+        final stopwatch = Stopwatch()..start();
+        final surface = await _filter.cut(
+          _normals[_axis],
+          _offset,
+          pointValues: field != null && field.internalField.isNotEmpty
+              ? FieldInterpolation.pointArray(field, widget.mesh)
+              : null,
+        );
+        if (!mounted) return;
+
+        final (minValue, maxValue) = field != null
+            ? FieldInterpolation.getMinMax(field.internalField)
+            : (0.0, 1.0);
+        widget.onOverlayChanged(
+          SurfaceOverlay(surface, minValue: minValue, maxValue: maxValue),
+        );
+        setState(() {
+          _triangles = surface.triangleCount;
+          _elapsedMs = stopwatch.elapsedMilliseconds;
+        });
+      } while (_dirty);
+    } finally {
+      _running = false;
+    }
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final (lo, hi) = _range;
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Row(
+          children: [
+            for (int axis = 0; axis < 3; axis++)
+              Padding(
+                padding: const EdgeInsets.only(right: 6),
+                child: ChoiceChip(
+                  label: Text(
+                    'XYZ'[axis],
+                    style: const TextStyle(fontSize: 10),
+                  ),
+                  selected: _axis == axis,
+                  visualDensity: VisualDensity.compact,
+                  onSelected: (_) => _setAxis(axis),
+                ),
+              ),
+          ],
+        ),
+        Slider(
+          value: _offset.clamp(lo, hi),
+          min: lo,
+          max: hi > lo ? hi : lo + 1,
+          onChanged: (value) {
+            setState(() => _offset = value);
+            _cut();
+          },
+        ),
+        Text(
+          '${'xyz'[_axis]} = ${ColorMap.formatValue(_offset)}   '
+          '$_triangles triangles, $_elapsedMs ms',
+          style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+        ),
+      ],
+    );
+  }
+}
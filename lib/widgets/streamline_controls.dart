@@ -0,0 +1,187 @@
+// lib/widgets/streamline_controls.dart
+
+import 'dart:typed_data';
+import 'package:flutter/material.dart';
+import '../filters/stream_tracer.dart';
+import '../models/openfoam_case.dart';
+import '../utils/field_interpolation.dart';
+import '../utils/view_transform.dart';
+import 'scene_overlays.dart';
+
+/// Sidebar controls for streamlines of the active vector field, seeded
+/// along the domain diagonal or on a mid-plane. Traces are coalesced like
+/// the slice updates.
+class StreamlineControls extends StatefulWidget {
+  final PolyMesh mesh;
+  final FieldData? fieldData;
+  final ValueChanged<SceneOverlay?> onOverlayChanged;
+
+  const StreamlineControls({
+    super.key,
+    required this.mesh,
+    required this.fieldData,
+    required this.onOverlayChanged,
+  });
+
+  @override
+  State<StreamlineControls> createState() => _StreamlineControlsState();
+}
+
+class _StreamlineControlsState extends State<StreamlineControls> {
+  static const List<int> _seedCounts = [25, 100, 250, 500, 1000];
+
+  late StreamTracer _tracer;
+  bool _planeSeeds = false;
+  int _axis = 0;
+  int _seedCount = 100;
+  bool _running = false;
+  bool _dirty = false;
+  int _lines = 0;
+  int _points = 0;
+  int _elapsedMs = 0;
+
+  @override
+  void initState() {
+    super.initState();
+    _tracer = StreamTracer(widget.mesh);
+    _trace();
+  }
+
+  @override
+  void didUpdateWidget(covariant StreamlineControls oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.mesh != widget.mesh) {
+      _tracer = StreamTracer(widget.mesh);
+    }
+    if (oldWidget.mesh != widget.mesh ||
+        oldWidget.fieldData != widget.fieldData) {
+      _trace();
+    }
+  }
+
+  Float64List _seeds() {
+    final bounds = MeshBounds.of(widget.mesh);
+    if (_planeSeeds) {
+      return SeedSources.plane(bounds.min, bounds.max, _axis, _seedCount);
+    }
+    // The diagonal, pulled in slightly so the end seeds are inside
+    Vector3 along(double t) => Vector3(
+          bounds.min.x + (bounds.max.x - bounds.min.x) * t,
+          bounds.min.y + (bounds.max.y - bounds.min.y) * t,
+          bounds.min.z + (bounds.max.z - bounds.min.z) * t,
+        );
+    return SeedSources.line(along(0.01), along(0.99), _seedCount);
+  }
+
+  Future<void> _trace() async {
+    if (_running) {
+      _dirty = true;
+      return;
+    }
+    _running = true;
+    try {
+      do {
+        _dirty = false;
+        final field = widget.fieldData;
+        if (field == null || !field.isVector) {
+          // Reached synchronously from initState and didUpdateWidget, while
+          // the parent builds, so clear the overlay after the frame
+          WidgetsBinding.instance.addPostFrameCallback((_) {
+            if (mounted && widget.fieldData == field) widget.onOverlayChanged(null);
+          });
+          return;
+        }
+        final stopwatch = Stopwatch()..start();
+        final lines = await _tracer.trace(field, _seeds());
+        if (!mounted) return;
+
+        // Coloured like the field itself, which shows |U|
+        final (minValue, maxValue) = FieldInterpolation.getMinMax(
+          field.internalField,
+        );
+        widget.onOverlayChanged(
+          PolylineOverlay(lines, minValue: minValue, maxValue: maxValue),
+        );
+        setState(() {
+          _lines = lines.lineCount;
+          _points = lines.pointCount;
+          _elapsedMs = stopwatch.elapsedMilliseconds;
+        });
+      } while (_dirty);
+    } finally {
+      _running = false;
+    }
+  }
+
+  Widget _chip(String label, bool selected, VoidCallback onSelected) {
+    return Padding(
+      padding: const EdgeInsets.only(right: 6),
+      child: ChoiceChip(
+        label: Text(label, style: const TextStyle(fontSize: 10)),
+        selected: selected,
+        visualDensity: VisualDensity.compact,
+        onSelected: (_) => onSelected(),
+      ),
+    );
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    if (widget.fieldData == null || !widget.fieldData!.isVector) {
+      return const Text(
+        'Select a vector field, e.g. U',
+        style: TextStyle(fontSize: 9, color: Color(0xFF808080)),
+      );
+    }
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Row(
+          children: [
+            _chip('Line', !_planeSeeds, () {
+              setState(() => _planeSeeds = false);
+              _trace();
+            }),
+            _chip('Plane', _planeSeeds, () {
+              setState(() => _planeSeeds = true);
+              _trace();
+            }),
+            DropdownButton<int>(
+              value: _seedCount,
+              underline: const SizedBox(),
+              dropdownColor: const Color(0xFF2D2D2D),
+              style: const TextStyle(fontSize: 10, color: Color(0xFFE0E0E0)),
+              items: [
+                for (final count in _seedCounts)
+                  DropdownMenuItem(value: count, child: Text('$count seeds')),
+              ],
+              onChanged: (value) {
+                if (value == null) return;
+                setState(() => _seedCount = value);
+                _trace();
+              },
+            ),
+          ],
+        ),
+        if (_planeSeeds)
+          Padding(
+            padding: const EdgeInsets.only(top: 4),
+            child: Row(
+              children: [
+                for (int axis = 0; axis < 3; axis++)
+                  _chip('XYZ'[axis], _axis == axis, () {
+                    setState(() => _axis = axis);
+                    _trace();
+                  }),
+              ],
+            ),
+          ),
+        const SizedBox(height: 4),
+        Text(
+          '$_lines lines, $_points points, $_elapsedMs ms',
+          style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+        ),
+      ],
+    );
+  }
+}
@@ -0,0 +1,147 @@
+// lib/widgets/threshold_controls.dart
+
+import 'package:flutter/material.dart';
+import '../filters/cell_subset.dart';
+import '../filters/threshold_filter.dart';
+import '../models/openfoam_case.dart';
+import '../utils/color_map.dart';
+
+/// Sidebar controls for the threshold filter: a two-handle range over the
+/// active field's cell values. Updates are coalesced like the slice. The
+/// threshold is removed from [subset] when the controls are closed.
+class ThresholdControls extends StatefulWidget {
+  final FieldData? fieldData;
+  final CellSubset subset;
+  final VoidCallback onChanged; // The subset was edited
+
+  const ThresholdControls({
+    super.key,
+    required this.fieldData,
+    required this.subset,
+    required this.onChanged,
+  });
+
+  @override
+  State<ThresholdControls> createState() => _ThresholdControlsState();
+}
+
+class _ThresholdControlsState extends State<ThresholdControls> {
+  late ThresholdFilter _filter;
+  (double, double) _range = (0, 1);
+  RangeValues _values = const RangeValues(0, 1);
+  bool _running = false;
+  bool _dirty = false;
+  int _changed = 0;
+  int _elapsedMs = 0;
+
+  @override
+  void initState() {
+    super.initState();
+    _filter = ThresholdFilter(widget.subset);
+    _setField();
+  }
+
+  @override
+  void didUpdateWidget(covariant ThresholdControls oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.subset != widget.subset) {
+      _filter.apply(null, 0, 0);
+      _filter = ThresholdFilter(widget.subset);
+    }
+    if (oldWidget.subset != widget.subset ||
+        oldWidget.fieldData != widget.fieldData) {
+      _setField();
+    }
+  }
+
+  @override
+  void dispose() {
+    final onChanged = widget.onChanged;
+    _filter.apply(null, 0, 0).then((_) => onChanged());
+    super.dispose();
+  }
+
+  Future<void> _setField() async {
+    final field = widget.fieldData;
+    if (field == null || field.internalField.isEmpty) {
+      _apply();
+      return;
+    }
+    final range = await _filter.valueRange(field);
+    if (!mounted || field != widget.fieldData) return;
+    setState(() {
+      // Keep the thresholds across time steps of the same field
+      if (range != _range) {
+        final (lo, hi) = range;
+        final start = _values.start.clamp(lo, hi);
+        final end = _values.end.clamp(lo, hi);
+        _values = start < end ? RangeValues(start, end) : RangeValues(lo, hi);
+        _range = range;
+      }
+    });
+    _apply();
+  }
+
+  Future<void> _apply() async {
+    if (_running) {
+      _dirty = true;
+      return;
+    }
+    _running = true;
+    try {
+      do {
+        _dirty = false;
+        final field = widget.fieldData;
+        final stopwatch = Stopwatch()..start();
+        final changed = await _filter.apply(
+          field != null && field.internalField.isNotEmpty ? field : null,
+          _values.start,
+          _values.end,
+        );
+        if (!mounted) return;
+        widget.onChanged();
+        setState(() {
+          _changed = changed;
+          _elapsedMs = stopwatch.elapsedMilliseconds;
+        });
+      } while (_dirty);
+    } finally {
+      _running = false;
+    }
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    if (widget.fieldData == null) {
+      return const Text(
+        'Select a field to threshold',
+        style: TextStyle(fontSize: 9, color: Color(0xFF808080)),
+      );
+    }
+    final (lo, hi) = _range;
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        RangeSlider(
+          values: RangeValues(
+            _values.start.clamp(lo, hi),
+            _values.end.clamp(lo, hi),
+          ),
+          min: lo,
+          max: hi > lo ? hi : lo + 1,
+          onChanged: (values) {
+            setState(() => _values = values);
+            _apply();
+          },
+        ),
+        Text(
+          '${ColorMap.formatValue(_values.start)} ≤ ${widget.fieldData!.name} ≤ '
+          '${ColorMap.formatValue(_values.end)}   '
+          '${widget.subset.hiddenCount} cells hidden, '
+          '$_changed changed, $_elapsedMs ms',
+          style: const TextStyle(fontSize: 9, color: Color(0xFF808080)),
+        ),
+      ],
+    );
+  }
+}
@@ -0,0 +1,248 @@
+// test/case_reader_test.dart
+
+import 'dart:io';
+import 'dart:math' as math;
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/parsers/foam_file_parser.dart';
+import 'package:d3_viewer/readers/case_reader.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+import 'package:d3_viewer/utils/tensor_math.dart';
+
+import 'mesh_fixtures.dart';
+
+String _list(List<num> values) => '${values.length}\n(\n${values.join('\n')}\n)';
+
+String _volField(String fieldClass, String type, List<String> values) => '''
+FoamFile
+{
+    format      ascii;
+    class       $fieldClass;
+    object      f;
+}
+internalField   nonuniform List<$type>
+${values.length}
+(
+${values.join('\n')}
+)
+;
+''';
+
+void main() {
+  // 2 x 1 x 1 block: 12 points, 1 internal face, then inlet, outlet, walls
+  final arrays = MeshArrays.of(blockMesh(2, 1, 1));
+
+  group('CaseReader.decodeField', () {
+    test('pointScalarField - point values used as they are', () {
+      final points = List<double>.generate(arrays.nPoints, (p) => p.toDouble());
+      final content = '''
+FoamFile { class pointScalarField; object pointDisplacement; }
+internalField nonuniform List<scalar> ${_list(points)};
+boundaryField { }
+''';
+      final field = CaseReader.decodeField(content, 'pd', arrays)!;
+
+      expect(field.pointValues, points);
+      expect(field.isFaceField, isFalse);
+      expect(field.internalField, hasLength(arrays.nCells));
+      // Cell 0 uses points with x index 0 and 1: 0, 1, 3, 4, 6, 7, 9, 10
+      expect(field.internalField[0], closeTo(5.0, 1e-12));
+    });
+
+    test('surfaceScalarField - internal and patch face values', () {
+      const content = '''
+FoamFile { class surfaceScalarField; object phi; }
+internalField nonuniform List<scalar> 1 ( 2.5 );
+boundaryField
+{
+    inlet { type calculated; value nonuniform List<scalar> 1(-1); }
+    outlet { type calculated; value uniform 1.5; }
+    walls { type calculated; value uniform 0; }
+}
+''';
+      final field = CaseReader.decodeField(content, 'phi', arrays)!;
+      final faces = field.faceValues!;
+
+      expect(faces, hasLength(arrays.nFaces));
+      expect(faces[0], 2.5);
+      expect(faces[arrays.patchStarts[0]], -1.0);
+      expect(faces[arrays.patchStarts[1]], 1.5);
+      expect(faces[arrays.patchStarts[2]], 0.0);
+      expect(field.pointValues, isNull);
+      // Mean face magnitude: cell 0 has the internal, inlet and 4 wall faces
+      expect(field.internalField[0], closeTo((2.5 + 1) / 6, 1e-12));
+    });
+
+    test('surfaceScalarField - wrong internal face count rejected', () {
+      const content = '''
+FoamFile { class surfaceScalarField; object phi; }
+internalField nonuniform List<scalar> 2 ( 2.5 1 );
+boundaryField { }
+''';
+      expect(CaseReader.decodeField(content, 'phi', arrays), isNull);
+    });
+
+    test('pointVectorField - not supported', () {
+      const content = 'FoamFile { class pointVectorField; }\n';
+      expect(CaseReader.decodeField(content, 'pd', arrays), isNull);
+    });
+
+    test('volSymmTensorField - uniform value expanded to every cell', () {
+      const content = '''
+FoamFile { class volSymmTensorField; object R; }
+internalField uniform (1 0 0 2 0 2);
+boundaryField { }
+''';
+      final field = CaseReader.decodeField(content, 'R', arrays)!;
+
+      expect(field.tensorComponents, 6);
+      expect(field.tensors, [1, 0, 0, 2, 0, 2, 1, 0, 0, 2, 0, 2]);
+      expect(field.internalField, [3.0, 3.0]);
+    });
+
+    test('volSphericalTensorField - not supported', () {
+      const content = '''
+FoamFile { class volSphericalTensorField; object k; }
+internalField uniform (1);
+boundaryField { }
+''';
+      expect(CaseReader.decodeField(content, 'k', arrays), isNull);
+    });
+  });
+
+  group('FoamFileParser.parseBoundaryScalarValues', () {
+    test('uniform, nonuniform and missing values', () {
+      const content = '''
+boundaryField
+{
+    "(left|right)" { type fixedValue; value uniform 3; }
+    front { type empty; }
+    back { type calculated; value nonuniform List<scalar> 2(1 2); }
+}
+''';
+      expect(FoamFileParser.parseBoundaryScalarValues(content), {
+        '(left|right)': [3.0],
+        'back': [1.0, 2.0],
+      });
+    });
+  });
+
+  group('FoamFileParser.parseBoundaryValues', () {
+    test('uniform and nonuniform vectors, zeroGradient left out', () {
+      const content = '''
+internalField nonuniform List<vector> 1((9 9 9));
+boundaryField
+{
+    inlet { type fixedValue; value uniform (1 0 0); }
+    outlet { type zeroGradient; }
+    walls { type noSlip; value nonuniform List<vector> 2((0 0 0) (0 1 0)); }
+}
+''';
+      expect(FoamFileParser.parseBoundaryValues(content, 3), {
+        'inlet': [1.0, 0.0, 0.0],
+        'walls': [0.0, 0.0, 0.0, 0.0, 1.0, 0.0],
+      });
+    });
+  });
+
+  group('CaseReader.probeTimeSeries', () {
+    late Directory caseDir;
+
+    setUp(() async {
+      caseDir = await Directory.systemTemp.createTemp('probe_case_');
+    });
+
+    tearDown(() async {
+      await caseDir.delete(recursive: true);
+    });
+
+    // Writes p (and U unless [withU] is false) for 3 cells, scaled by [t]
+    Future<void> writeStep(String timeDir, double t, {bool withU = true}) async {
+      await Directory('${caseDir.path}/$timeDir').create();
+      await File('${caseDir.path}/$timeDir/p').writeAsString(
+        _volField('volScalarField', 'scalar', [for (int c = 0; c < 3; c++) '${t + c}']),
+      );
+      if (withU) {
+        await File('${caseDir.path}/$timeDir/U').writeAsString(
+          _volField('volVectorField', 'vector', [for (int c = 0; c < 3; c++) '($t $c 0)']),
+        );
+      }
+    }
+
+    test('readFieldCells - values and component count of the cells', () async {
+      await writeStep('0', 5);
+
+      final scalar = await CaseReader.readFieldCells(caseDir.path, '0', 'p', [2, 0]);
+      final vector = await CaseReader.readFieldCells(caseDir.path, '0', 'U', [1]);
+
+      expect(scalar!.$1, equals([7.0, 5.0]));
+      expect(scalar.$2, equals(1));
+      expect(vector!.$1, equals([5.0, 1.0, 0.0]));
+      expect(vector.$2, equals(3));
+    });
+
+    test('samples arrive in time order', () async {
+      final times = ['0', '0.5', '1', '2', '3.5'];
+      for (final t in times) {
+        await writeStep(t, double.parse(t));
+      }
+
+      final samples = await CaseReader.probeTimeSeries(
+        caseDir.path,
+        times,
+        ['p', 'U'],
+        1,
+        readAhead: 3,
+      ).toList();
+
+      expect(
+        [for (final s in samples) '${s.timeDir}/${s.fieldName}'],
+        equals([for (final t in times) ...['$t/p', '$t/U']]),
+      );
+      expect(
+        [for (final s in samples.where((s) => s.fieldName == 'p')) s.values.single],
+        equals([1.0, 1.5, 2.0, 3.0, 4.5]),
+      );
+      expect(samples.last.time, equals(3.5));
+    });
+
+    test('a missing field or non-numeric step is skipped', () async {
+      await writeStep('0', 0);
+      await writeStep('1', 1, withU: false);
+      await writeStep('latest', 9);
+      await writeStep('2', 2);
+
+      final samples = await CaseReader.probeTimeSeries(
+        caseDir.path,
+        ['0', '1', 'latest', 'missing', '2'],
+        ['p', 'U'],
+        0,
+      ).toList();
+
+      expect(
+        [for (final s in samples) '${s.timeDir}/${s.fieldName}'],
+        equals(['0/p', '0/U', '1/p', '2/p', '2/U']),
+      );
+    });
+  });
+
+  group('ProbeSample.magnitude', () {
+    ProbeSample sample(List<double> values) =>
+        ProbeSample(timeDir: '0', time: 0, fieldName: 'f', values: values);
+
+    test('scalar as it is, vector as its length', () {
+      expect(sample([-2]).magnitude, equals(-2.0));
+      expect(sample([3, 0, 4]).magnitude, closeTo(5.0, 1e-12));
+    });
+
+    test('symmetric tensor matches the viewed magnitude', () {
+      final values = [1.0, 2.0, 3.0, 4.0, 5.0, 6.0]; // xx xy xz yy yz zz
+      final viewed = TensorMath.magnitudes(Float64List.fromList(values), 6)[0];
+
+      // 1 + 16 + 36 + 2 * (4 + 9 + 25)
+      expect(sample(values).magnitude, closeTo(viewed, 1e-12));
+      expect(viewed, closeTo(math.sqrt(129), 1e-12));
+    });
+  });
+}
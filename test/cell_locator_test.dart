@@ -0,0 +1,56 @@
+// test/cell_locator_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/utils/cell_locator.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('CellLocator', () {
+    final mesh = blockMesh(4, 3, 2);
+    final locator = CellLocator.build(MeshArrays.of(mesh));
+
+    test('locate - finds the cell containing a point', () {
+      expect(locator.locate(0.5, 0.5, 0.5), equals(0));
+      expect(locator.locate(3.5, 0.5, 0.5), equals(3));
+      expect(locator.locate(1.5, 2.5, 1.5), equals(1 + 4 * (2 + 3 * 1)));
+    });
+
+    test('locate - returns -1 outside the mesh', () {
+      expect(locator.locate(-0.1, 0.5, 0.5), equals(-1));
+      expect(locator.locate(2.0, 3.5, 1.0), equals(-1));
+      expect(locator.locate(2.0, 1.0, 2.01), equals(-1));
+    });
+
+    test('locate - uses a correct hint and ignores a wrong one', () {
+      expect(locator.locate(2.5, 1.5, 0.5, hint: 6), equals(6));
+      expect(locator.locate(2.5, 1.5, 0.5, hint: 0), equals(6));
+    });
+
+    test('locateAll - parallel batch matches single queries', () async {
+      const n = 40000;
+      final xyz = Float64List(n * 3);
+      for (int p = 0; p < n; p++) {
+        xyz[p * 3] = (p * 0.37) % 4.4 - 0.2;
+        xyz[p * 3 + 1] = (p * 0.11) % 3.0;
+        xyz[p * 3 + 2] = (p * 0.053) % 2.0;
+      }
+
+      final cells = await locator.locateAll(xyz);
+
+      expect(cells.length, equals(n));
+      for (int p = 0; p < n; p += 997) {
+        final x = xyz[p * 3], y = xyz[p * 3 + 1], z = xyz[p * 3 + 2];
+        // Points on shared faces may land in either cell
+        if (cells[p] < 0) {
+          expect(locator.locate(x, y, z), equals(-1));
+        } else {
+          expect(locator.contains(cells[p], x, y, z), isTrue);
+        }
+      }
+      expect(cells.where((c) => c < 0), isNotEmpty);
+    });
+  });
+}
@@ -0,0 +1,89 @@
+// test/clip_filter_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/cell_subset.dart';
+import 'package:d3_viewer/filters/clip_filter.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+
+import 'mesh_fixtures.dart';
+
+int _shown(CellSubset subset, int start, int end) {
+  int count = 0;
+  for (int f = start; f < end; f++) {
+    count += subset.faceShown[f];
+  }
+  return count;
+}
+
+void main() {
+  group('ClipFilter', () {
+    final mesh = blockMesh(3, 2, 2);
+    final arrays = MeshArrays.of(mesh);
+    final nInternal = arrays.nInternalFaces;
+
+    test('apply - a plane hides cells and uncovers the faces behind them',
+        () async {
+      final subset = CellSubset(arrays);
+      final filter = ClipFilter(mesh, subset);
+
+      await filter.apply(const ClipPlane(0, 2.0));
+      expect(subset.hiddenCount, equals(4));
+      expect(_shown(subset, 0, nInternal), equals(4));
+      expect(_shown(subset, nInternal, arrays.nFaces), equals(20));
+
+      // Moving the plane only visits the cells it crosses
+      final visited = await filter.apply(const ClipPlane(0, 1.0));
+      expect(visited, equals(4));
+      expect(subset.hiddenCount, equals(8));
+      expect(_shown(subset, 0, nInternal), equals(4));
+
+      await filter.apply(null);
+      expect(subset.isActive, isFalse);
+      expect(_shown(subset, 0, nInternal), equals(0));
+      expect(_shown(subset, nInternal, arrays.nFaces), equals(32));
+    });
+
+    test('apply - inverting the plane keeps the other side', () async {
+      final subset = CellSubset(arrays);
+      final filter = ClipFilter(mesh, subset);
+
+      await filter.apply(const ClipPlane(2, 1.0, invert: true));
+      expect(subset.hiddenCount, equals(6));
+      for (int c = 0; c < arrays.nCells; c++) {
+        expect(subset.isVisible(c), equals(c >= 6));
+      }
+    });
+
+    test('apply - a moving box visits its combined x-range', () async {
+      final subset = CellSubset(arrays);
+      final filter = ClipFilter(mesh, subset);
+
+      await filter.apply(ClipBox(Vector3(0.9, 0, 0), Vector3(2.1, 2, 2)));
+      expect(subset.hiddenCount, equals(4));
+      expect(_shown(subset, 0, nInternal), equals(8));
+
+      final visited =
+          await filter.apply(ClipBox(Vector3(1.9, 0, 0), Vector3(3, 2, 2)));
+      expect(visited, equals(8));
+      expect(subset.hiddenCount, equals(4));
+      expect(subset.isVisible(1), isTrue);
+      expect(subset.isVisible(2), isFalse);
+    });
+
+    test('CellSubset - a cell stays hidden while any filter hides it', () {
+      final subset = CellSubset(arrays);
+      final other = ClipFilter(mesh, subset);
+      expect(other.region, isNull);
+
+      subset.hide(Int32List.fromList([0]));
+      subset.hide(Int32List.fromList([0]));
+      subset.show(Int32List.fromList([0]));
+      expect(subset.isVisible(0), isFalse);
+      expect(subset.visibleCellOf(0), equals(1));
+      subset.show(Int32List.fromList([0]));
+      expect(subset.isVisible(0), isTrue);
+    });
+  });
+}
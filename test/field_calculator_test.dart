@@ -0,0 +1,106 @@
+// test/field_calculator_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/field_calculator.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('FieldCalculator', () {
+    final names = {'p', 'U', 'T', 'alpha.water'};
+    final p = Float64List.fromList([1, 2, 3]);
+    final speed = Float64List.fromList([0, 2, 4]); // |U|
+    final u = Float64List.fromList([0, 0, 0, 2, 0, 0, 0, 4, 0]);
+
+    Float64List evaluate(String expression, Map<FieldRef, Float64List> inputs) {
+      final tree = FieldCalculator.parse(expression, names);
+      return FieldCalculator.run(tree, inputs, 0, 3);
+    }
+
+    test('run - fuses the expression into one pass over the cells', () {
+      final result = evaluate('p + 0.5*mag(U)^2', {
+        const FieldRef('p', -1, null): p,
+        const FieldRef('U', -1, null): speed,
+      });
+      expect(result, equals([1.0, 4.0, 11.0]));
+    });
+
+    test('parse - components, dotted names and time references', () {
+      expect(
+        evaluate('U.y - U.x', {
+          const FieldRef('U', 0, null): u,
+          const FieldRef('U', 1, null): u,
+        }),
+        equals([0.0, -2.0, 4.0]),
+      );
+
+      final tree = FieldCalculator.parse('alpha.water + T - T@0.5 + T@prev', names);
+      expect(
+        FieldCalculator.references(tree),
+        equals({
+          const FieldRef('alpha.water', -1, null),
+          const FieldRef('T', -1, null),
+          const FieldRef('T', -1, '0.5'),
+          const FieldRef('T', -1, 'prev'),
+        }),
+      );
+    });
+
+    test('parse - precedence and uniform inputs', () {
+      // -p^2 is -(p^2); a one-value input is a uniform field
+      final result = evaluate('-p^2 + max(T, 2) / 2', {
+        const FieldRef('p', -1, null): p,
+        const FieldRef('T', -1, null): Float64List.fromList([6]),
+      });
+      expect(result, equals([2.0, -1.0, -6.0]));
+    });
+
+    test('parse - reports unknown fields and bad syntax', () {
+      expect(() => FieldCalculator.parse('k + 1', names), throwsFormatException);
+      expect(() => FieldCalculator.parse('p +', names), throwsFormatException);
+      expect(() => FieldCalculator.parse('max(p)', names), throwsFormatException);
+    });
+
+    test('evaluate - splits cells across workers with uniform inputs', () async {
+      // Enough cells for several worker chunks
+      final mesh = blockMesh(64, 64, 3);
+      final nCells = 64 * 64 * 3;
+      final vectors = Float64List(nCells * 3);
+      for (int c = 0; c < nCells; c++) {
+        vectors[c * 3] = c.toDouble();
+      }
+      final fields = {
+        'U': FieldData(
+          name: 'U',
+          fieldClass: 'volVectorField',
+          internalField: Float64List(nCells),
+          boundaryField: {},
+          vectors: vectors,
+        ),
+        'p': FieldData(
+          name: 'p',
+          fieldClass: 'volScalarField',
+          internalField: [0.5],
+          boundaryField: {},
+        ),
+      };
+      final calculator = FieldCalculator(
+        mesh: mesh,
+        timeDirectories: ['0'],
+        loadField: (name, time) async => fields[name],
+      );
+
+      final pending = calculator.evaluate('2*U.x + p', '0', names);
+      expect(calculator.evaluate('2*U.x + p ', '0', names), same(pending));
+      final result = await pending;
+
+      expect(result.internalField.length, equals(nCells));
+      for (final c in [0, 4095, 4096, 8191, 8192, nCells - 1]) {
+        expect(result.internalField[c], equals(2.0 * c + 0.5));
+      }
+      expect(result.pointValues!.length, equals(mesh.points.length));
+    });
+  });
+}
@@ -0,0 +1,78 @@
+// test/field_gradients_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/field_gradients.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+import 'package:d3_viewer/utils/mesh_geometry.dart';
+import 'package:d3_viewer/utils/tensor_math.dart';
+
+import 'matchers.dart';
+import 'mesh_fixtures.dart';
+
+void main() {
+  // Cell (1, 1, 1) of a 3 x 3 x 3 block has only internal faces, where
+  // Gauss linear is exact for linear fields
+  const centre = 13;
+  final arrays = MeshArrays.of(blockMesh(3, 3, 3, spacing: 0.5));
+  final geometry = MeshGeometry.build(arrays);
+  final cc = geometry.cellCentres;
+
+  group('FieldGradients', () {
+    test('parse - derived field names', () {
+      expect(FieldGradients.parse('Q(U)'), ('Q', 'U'));
+      expect(FieldGradients.parse(' grad(alpha.water) '), ('grad', 'alpha.water'));
+      expect(FieldGradients.parse('mag(U)'), isNull);
+      expect(FieldGradients.parse('Q(U) + 1'), isNull);
+    });
+
+    test('gradient - a linear scalar field', () {
+      final values = Float64List.fromList([
+        for (int c = 0; c < arrays.nCells; c++)
+          2 * cc[c * 3] + 3 * cc[c * 3 + 1] - cc[c * 3 + 2],
+      ]);
+      final gradient = FieldGradients.gradient(arrays, geometry, values, 1, 0, arrays.nCells);
+
+      expect(gradient.sublist(centre * 3, centre * 3 + 3), near([2, 3, -1]));
+    });
+
+    test('gradient - chunks match the whole mesh', () {
+      final values = Float64List.fromList([
+        for (int c = 0; c < arrays.nCells; c++) cc[c * 3] * cc[c * 3 + 1],
+      ]);
+      final whole = FieldGradients.gradient(arrays, geometry, values, 1, 0, arrays.nCells);
+      final head = FieldGradients.gradient(arrays, geometry, values, 1, 0, 5);
+      final tail = FieldGradients.gradient(arrays, geometry, values, 1, 5, arrays.nCells);
+
+      expect([...head, ...tail], whole);
+    });
+
+    test('derive - solid body rotation', () {
+      // U = (-y, x, 0): vorticity (0, 0, 2), Q = 1, lambda2 = -1, div = 0
+      final vectors = Float64List.fromList([
+        for (int c = 0; c < arrays.nCells; c++) ...[-cc[c * 3 + 1], cc[c * 3], 0.0],
+      ]);
+      final gradient = FieldGradients.gradient(arrays, geometry, vectors, 3, 0, arrays.nCells);
+
+      final (magnitude, vorticity) =
+          FieldGradients.derive('vorticity', gradient, centre, centre + 1);
+      expect(vorticity, near([0, 0, 2]));
+      expect(magnitude, near([2]));
+      expect(FieldGradients.derive('Q', gradient, centre, centre + 1).$1, near([1]));
+      expect(FieldGradients.derive('lambda2', gradient, centre, centre + 1).$1, near([-1]));
+      expect(FieldGradients.derive('div', gradient, centre, centre + 1).$1, near([0]));
+    });
+  });
+
+  group('TensorMath', () {
+    test('symmEigenvalues - diagonal and full tensors', () {
+      final out = Float64List(3);
+      TensorMath.symmEigenvalues(Float64List.fromList([1, 0, 0, 3, 0, 2]), 0, out, 0);
+      expect(out, [3.0, 2.0, 1.0]);
+
+      // [[2, 1, 0], [1, 2, 0], [0, 0, 5]] has eigenvalues 5, 3, 1
+      TensorMath.symmEigenvalues(Float64List.fromList([2, 1, 0, 2, 0, 5]), 0, out, 0);
+      expect(out, near([5, 3, 1]));
+    });
+  });
+}
@@ -0,0 +1,188 @@
+// test/field_index_test.dart
+
+import 'dart:io';
+import 'dart:convert';
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/readers/field_index.dart';
+
+String _header(String format, String fieldClass) => '''
+FoamFile
+{
+    version     2.0;
+    format      $format;
+    class       $fieldClass;
+    object      p;
+}
+
+dimensions      [0 2 -2 0 0 0 0];
+
+''';
+
+void main() {
+  late Directory testDir;
+
+  setUp(() async {
+    testDir = await Directory.systemTemp.createTemp('field_index_test_');
+  });
+
+  tearDown(() async {
+    if (await testDir.exists()) {
+      await testDir.delete(recursive: true);
+    }
+  });
+
+  group('FieldOffsetIndex', () {
+    test('ASCII scalar field spanning several chunks', () async {
+      const n = 3000;
+      final values = [for (int i = 0; i < n; i++) '${i * 0.5}'].join('\n');
+      await File('${testDir.path}/p').writeAsString(
+        '${_header('ascii', 'volScalarField')}'
+        'internalField   nonuniform List<scalar>\n$n\n(\n$values\n)\n;\n',
+      );
+
+      final index = await FieldOffsetIndex.open('${testDir.path}/p');
+      final cells = await index!.readCells([2999, 0, 1500, 1024]);
+
+      expect(index.storage, equals(FieldStorage.ascii));
+      expect(index.count, equals(n));
+      expect(cells, equals([1499.5, 0.0, 750.0, 512.0]));
+    });
+
+    test('ASCII vector field in a .gz file', () async {
+      const n = 1500;
+      final values = [for (int i = 0; i < n; i++) '($i 0 -$i)'].join('\n');
+      final content = '${_header('ascii', 'volVectorField')}'
+          'internalField   nonuniform List<vector>\n$n\n(\n$values\n)\n;\n';
+      await File('${testDir.path}/U.gz')
+          .writeAsBytes(gzip.encode(utf8.encode(content)));
+
+      final index = await FieldOffsetIndex.open('${testDir.path}/U');
+      final cells = await index!.readCells([1234]);
+
+      expect(index.components, equals(3));
+      expect(cells, equals([1234.0, 0.0, -1234.0]));
+    });
+
+    test('ASCII sphericalTensor field with parenthesised elements', () async {
+      const n = 1500;
+      final values = [for (int i = 0; i < n; i++) '($i)'].join('\n');
+      await File('${testDir.path}/k').writeAsString(
+        '${_header('ascii', 'volSphericalTensorField')}'
+        'internalField   nonuniform List<sphericalTensor>\n$n\n(\n$values\n)\n;\n',
+      );
+
+      final index = await FieldOffsetIndex.open('${testDir.path}/k');
+      final cells = await index!.readCells([1499, 0, 1024]);
+
+      expect(index.components, equals(1));
+      expect(cells, equals([1499.0, 0.0, 1024.0]));
+    });
+
+    test('ASCII .gz field builds its gzip index while indexing', () async {
+      const n = 1500;
+      final values = [for (int i = 0; i < n; i++) '$i'].join('\n');
+      final content = '${_header('ascii', 'volScalarField')}'
+          'internalField   nonuniform List<scalar>\n$n\n(\n$values\n)\n;\n';
+      await File('${testDir.path}/p.gz')
+          .writeAsBytes(gzip.encode(utf8.encode(content)));
+      final cacheDir = '${testDir.path}/cache';
+
+      final index = await FieldOffsetIndex.open(
+        '${testDir.path}/p',
+        cacheDirectory: cacheDir,
+      );
+
+      // Field index and gzip index, both saved before any cell is read
+      expect(await Directory(cacheDir).list().length, equals(2));
+      expect(await index!.readCells([777], cacheDirectory: cacheDir), equals([777.0]));
+    });
+
+    test('binary scalar field', () async {
+      const n = 5000;
+      final payload = Float64List.fromList([for (int i = 0; i < n; i++) i * 2.0]);
+      final builder = BytesBuilder()
+        ..add(utf8.encode(
+          '${_header('binary', 'volScalarField')}'
+          'internalField   nonuniform List<scalar> $n(',
+        ))
+        ..add(payload.buffer.asUint8List())
+        ..add(utf8.encode(');\n'));
+      await File('${testDir.path}/p').writeAsBytes(builder.takeBytes());
+
+      final index = await FieldOffsetIndex.open('${testDir.path}/p');
+      final cells = await index!.readCells([4999, 3, 4, 2000]);
+
+      expect(index.storage, equals(FieldStorage.binary));
+      expect(cells, equals([9998.0, 6.0, 8.0, 4000.0]));
+    });
+
+    test('binary field with 32-bit scalars', () async {
+      const n = 100;
+      final payload = Float32List.fromList([for (int i = 0; i < n; i++) i * 0.25]);
+      final builder = BytesBuilder()
+        ..add(utf8.encode(
+          _header('binary', 'volScalarField').replaceFirst(
+            'class',
+            'arch        "LSB;label=32;scalar=32";\n    class',
+          ),
+        ))
+        ..add(utf8.encode('internalField   nonuniform List<scalar> $n('))
+        ..add(payload.buffer.asUint8List())
+        ..add(utf8.encode(');\n'));
+      await File('${testDir.path}/p').writeAsBytes(builder.takeBytes());
+
+      final index = await FieldOffsetIndex.open('${testDir.path}/p');
+      final cells = await index!.readCells([99, 4]);
+
+      expect(index.stride, equals(4));
+      expect(cells, equals([24.75, 1.0]));
+    });
+
+    test('truncated binary field reports an error', () async {
+      final builder = BytesBuilder()
+        ..add(utf8.encode(
+          '${_header('binary', 'volScalarField')}'
+          'internalField   nonuniform List<scalar> 1000(',
+        ))
+        ..add(Float64List(100).buffer.asUint8List());
+      await File('${testDir.path}/p').writeAsBytes(builder.takeBytes());
+
+      final index = await FieldOffsetIndex.open('${testDir.path}/p');
+
+      expect(index!.readCells([999]), throwsFormatException);
+    });
+
+    test('uniform field returns the same value for every cell', () async {
+      await File('${testDir.path}/T').writeAsString(
+        '${_header('ascii', 'volScalarField')}internalField   uniform 300;\n',
+      );
+
+      final index = await FieldOffsetIndex.open('${testDir.path}/T');
+      final cells = await index!.readCells([0, 42]);
+
+      expect(index.storage, equals(FieldStorage.uniform));
+      expect(cells, equals([300.0, 300.0]));
+    });
+
+    test('surface field is not indexed by cell', () async {
+      await File('${testDir.path}/phi').writeAsString(
+        '${_header('ascii', 'surfaceScalarField')}'
+        'internalField   nonuniform List<scalar>\n2\n(\n1\n2\n)\n;\n',
+      );
+
+      expect(await FieldOffsetIndex.open('${testDir.path}/phi'), isNull);
+    });
+
+    test('saves the index to the cache directory', () async {
+      await File('${testDir.path}/T').writeAsString(
+        '${_header('ascii', 'volScalarField')}internalField   uniform 1;\n',
+      );
+      final cacheDir = '${testDir.path}/cache';
+
+      await FieldOffsetIndex.open('${testDir.path}/T', cacheDirectory: cacheDir);
+
+      expect(await Directory(cacheDir).list().length, equals(1));
+    });
+  });
+}
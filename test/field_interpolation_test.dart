@@ -0,0 +1,54 @@
+// test/field_interpolation_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/field_interpolation.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('FieldInterpolation', () {
+    test('cellsToPoints - averages the cells around each point', () {
+      // 2 x 1 x 1 block: points 0, 1 and 2 run along x at y = z = 0
+      final mesh = blockMesh(2, 1, 1);
+      final points = FieldInterpolation.cellsToPoints([2.0, 6.0], MeshArrays.of(mesh));
+
+      expect(points.length, equals(mesh.points.length));
+      expect(points.sublist(0, 3), equals([2.0, 4.0, 6.0]));
+      expect(FieldInterpolation.cellToPoint([2.0, 6.0], mesh), equals(points));
+    });
+
+    test('lerp - blends every element, including an odd tail', () {
+      final a = Float64List.fromList([0, 1, 2, 3, 4]);
+      final b = Float64List.fromList([10, 11, 12, 13, 14]);
+      expect(FieldInterpolation.lerp(a, b, 0.25), equals([2.5, 3.5, 4.5, 5.5, 6.5]));
+    });
+
+    test('lerp - falls back for unaligned views and plain lists', () {
+      final backing = Float64List.fromList([9, 0, 2, 4]);
+      final a = Float64List.sublistView(backing, 1); // 8-byte offset
+      expect(FieldInterpolation.lerp(a, [2.0, 4.0, 6.0], 0.5), equals([1, 3, 5]));
+    });
+
+    test('blend - returns the ends and blends every array between', () {
+      FieldData field(double v) => FieldData(
+            name: 'U',
+            fieldClass: 'volVectorField',
+            internalField: [v],
+            boundaryField: {},
+            pointValues: [v, v],
+            vectors: Float64List.fromList([v, 0, 0]),
+          );
+      final a = field(1), b = field(3);
+
+      expect(FieldInterpolation.blend(a, b, 0), same(a));
+      expect(FieldInterpolation.blend(a, b, 1), same(b));
+      final mid = FieldInterpolation.blend(a, b, 0.5);
+      expect(mid.internalField, equals([2.0]));
+      expect(mid.pointValues, equals([2.0, 2.0]));
+      expect(mid.vectors, equals([2.0, 0.0, 0.0]));
+    });
+  });
+}
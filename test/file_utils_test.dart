@@ -4,6 +4,7 @@ import 'dart:io';
 import 'dart:convert';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:d3_viewer/utils/file_utils.dart';
+import 'package:d3_viewer/utils/gzip_inflater.dart';
 
 void main() {
   late Directory testDir;
@@ -91,6 +92,68 @@ void main() {
       expect(content, equals(originalContent));
     });
 
+    test('readFileBytes - inflates large .gz file into presized buffer', () async {
+      // Large enough to be inflated on a worker isolate
+      final original = List<int>.generate(3 << 20, (i) => (i * 31) % 251);
+      await File('${testDir.path}/big.gz').writeAsBytes(gzip.encode(original));
+
+      final bytes = await FileUtils.readFileBytes('${testDir.path}/big');
+
+      expect(bytes.length, equals(original.length));
+      expect(bytes, equals(original));
+
+      // Inflated inline, the result is the presized buffer itself
+      final inline = GzipInflater.inflate(gzip.encode(original));
+      expect(inline.buffer.lengthInBytes, equals(original.length));
+      expect(inline, equals(original));
+    });
+
+    test('GzipInflater - ignores an implausible ISIZE trailer', () {
+      final compressed = gzip.encode(List<int>.filled(1000, 7));
+      expect(GzipInflater.initialCapacity(compressed), equals(1000));
+
+      // A corrupt trailer claiming ~4 GB must not be allocated up front
+      final corrupt = List<int>.of(compressed);
+      corrupt.fillRange(corrupt.length - 4, corrupt.length, 0xFF);
+      expect(GzipInflater.initialCapacity(corrupt), equals(corrupt.length * 4));
+    });
+
+    test('readFilesBytes - reads a mixed batch in request order', () async {
+      await File('${testDir.path}/a').writeAsString('plain a');
+      await File('${testDir.path}/b.gz')
+          .writeAsBytes(gzip.encode(utf8.encode('compressed b')));
+
+      final contents = await FileUtils.readFilesBytes([
+        '${testDir.path}/b',
+        '${testDir.path}/a',
+      ]);
+
+      expect(utf8.decode(contents[0]), equals('compressed b'));
+      expect(utf8.decode(contents[1]), equals('plain a'));
+    });
+
+    test('readFileHeaders - reads only leading bytes, null for missing', () async {
+      final header = 'FoamFile { class volScalarField; }';
+      final body = List.filled(20000, '0').join(' ');
+      await File('${testDir.path}/p').writeAsString('$header\n$body');
+      await File('${testDir.path}/U.gz')
+          .writeAsBytes(gzip.encode(utf8.encode('$header\n$body')));
+
+      final headers = await FileUtils.readFileHeaders(
+        [
+          '${testDir.path}/p',
+          '${testDir.path}/U',
+          '${testDir.path}/missing',
+        ],
+        headerBytes: 256,
+      );
+
+      expect(headers[0]!.length, equals(256));
+      expect(headers[0], contains('FoamFile'));
+      expect(headers[1], contains('volScalarField'));
+      expect(headers[2], isNull);
+    });
+
     test('fileExists - returns true for normal file', () async {
       final testFile = File('${testDir.path}/exists_test.txt');
       await testFile.writeAsString('test');
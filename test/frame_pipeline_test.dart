@@ -0,0 +1,92 @@
+// test/frame_pipeline_test.dart
+
+import 'dart:io';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/readers/frame_pipeline.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+
+import 'mesh_fixtures.dart';
+
+String _scalarFile(int nCells, double value) => '''
+FoamFile
+{
+    class       volScalarField;
+    object      p;
+}
+internalField   nonuniform List<scalar>
+$nCells
+(
+${List.generate(nCells, (c) => '${value + c}').join('\n')}
+)
+;
+''';
+
+void main() {
+  group('FramePipeline', () {
+    final mesh = blockMesh(4, 2, 2);
+    final arrays = MeshArrays.of(mesh);
+
+    test('frame - decodes ahead and keeps only retained frames', () async {
+      final directory = await Directory.systemTemp.createTemp('playback');
+      addTearDown(() => directory.delete(recursive: true));
+      final times = ['0', '1', '2', '3'];
+      for (int t = 0; t < times.length; t++) {
+        await Directory('${directory.path}/${times[t]}').create();
+        await File('${directory.path}/${times[t]}/p')
+            .writeAsString(_scalarFile(arrays.nCells, t * 100.0));
+      }
+
+      final pipeline = FramePipeline(
+        casePath: directory.path,
+        mesh: mesh,
+        fieldName: 'p',
+        timeDirectories: times,
+      );
+      pipeline.retain([1, 2]);
+      expect(pipeline.isRequested(1), isTrue);
+      expect(pipeline.isRequested(3), isFalse);
+
+      final frame = await pipeline.frame(2);
+      expect(frame!.internalField.first, equals(200.0));
+      expect(frame.pointValues!.length, equals(arrays.nPoints));
+      await pipeline.frame(1);
+      expect(pipeline.isReady(2), isTrue);
+
+      // Dropped frames are forgotten
+      pipeline.retain([2, 3]);
+      expect(pipeline.isRequested(1), isFalse);
+      expect(pipeline.readyFrame(2), same(frame));
+      pipeline.close();
+    });
+
+    test('retain - caps decodes and skips frames dropped while waiting', () async {
+      final directory = await Directory.systemTemp.createTemp('playback');
+      addTearDown(() => directory.delete(recursive: true));
+      final times = ['0', '1', '2', '3'];
+      for (int t = 0; t < times.length; t++) {
+        await Directory('${directory.path}/${times[t]}').create();
+        await File('${directory.path}/${times[t]}/p')
+            .writeAsString(_scalarFile(arrays.nCells, t * 100.0));
+      }
+
+      final pipeline = FramePipeline(
+        casePath: directory.path,
+        mesh: mesh,
+        fieldName: 'p',
+        timeDirectories: times,
+        maxInFlight: 1,
+      );
+      pipeline.retain([0, 1, 2]);
+      final waiting = pipeline.frame(2);
+      // Frame 0 took the only slot; 2 was moved ahead of 1
+      pipeline.retain([0, 3]);
+
+      expect(await waiting, isNull);
+      expect(pipeline.isRequested(1), isFalse);
+      expect((await pipeline.frame(0))!.internalField.first, equals(0.0));
+      expect((await pipeline.frame(3))!.internalField.first, equals(300.0));
+      expect(pipeline.isReady(2), isFalse);
+      pipeline.close();
+    });
+  });
+}
@@ -0,0 +1,41 @@
+// test/future_cache_test.dart
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/utils/future_cache.dart';
+
+void main() {
+  Future<int> failing() async => throw StateError('no input');
+
+  group('ExpandoFutureCache', () {
+    test('putIfAbsentFuture - shares a future and retries after a failure', () async {
+      final cache = Expando<Future<int>>();
+      final key = Object();
+
+      final first = cache.putIfAbsentFuture(key, failing);
+      expect(cache.putIfAbsentFuture(key, failing), same(first));
+      await expectLater(first, throwsStateError);
+      expect(cache[key], isNull);
+
+      final retried = cache.putIfAbsentFuture(key, () async => 7);
+      expect(await retried, equals(7));
+      expect(cache.putIfAbsentFuture(key, failing), same(retried));
+    });
+  });
+
+  group('MapFutureCache', () {
+    test('putIfAbsentFuture - keeps a newer entry when an old one fails', () async {
+      final cache = <String, Future<int>>{};
+
+      final first = cache.putIfAbsentFuture('a', failing);
+      final newer = Future.value(3);
+      cache['a'] = newer;
+      await expectLater(first, throwsStateError);
+      expect(cache['a'], same(newer));
+
+      cache.remove('a');
+      final failed = cache.putIfAbsentFuture('a', failing);
+      await expectLater(failed, throwsStateError);
+      expect(cache.containsKey('a'), isFalse);
+    });
+  });
+}
@@ -0,0 +1,75 @@
+// test/glyph_source_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/glyph_source.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+import 'package:d3_viewer/utils/mesh_geometry.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('GlyphSource', () {
+    final arrays = MeshArrays.of(blockMesh(4, 2, 2));
+    final geometry = MeshGeometry.build(arrays);
+
+    // Cell c carries (c, 0, 0)
+    final vectors = Float64List(arrays.nCells * 3);
+    for (int c = 0; c < arrays.nCells; c++) {
+      vectors[c * 3] = c.toDouble();
+    }
+
+    test('build - keeps every cell under the limit', () {
+      final source = GlyphSource.build(
+        arrays,
+        vectors,
+        geometry.cellCentres,
+        boundary: false,
+      );
+
+      expect(source.length, equals(arrays.nCells));
+      expect(source.positions, equals(geometry.cellCentres));
+      expect(source.maxMagnitude, equals(15.0));
+    });
+
+    test('build - bins cell centres spatially down to the limit', () {
+      // 8 x 8 x 1 cells into 16 bins: one glyph per 2 x 2 block
+      final plate = MeshArrays.of(blockMesh(8, 8, 1));
+      final centres = MeshGeometry.build(plate).cellCentres;
+      final source = GlyphSource.build(
+        plate,
+        Float64List(plate.nCells * 3),
+        centres,
+        boundary: false,
+        limit: 16,
+      );
+
+      expect(source.length, equals(16));
+      final xs = {for (int g = 0; g < source.length; g++) source.positions[g * 3]};
+      final ys = {for (int g = 0; g < source.length; g++) source.positions[g * 3 + 1]};
+      expect(xs.length, equals(4));
+      expect(ys.length, equals(4));
+      // Every 2 x 2 block holds exactly one glyph
+      final blocks = {
+        for (int g = 0; g < source.length; g++)
+          (source.positions[g * 3] ~/ 2, source.positions[g * 3 + 1] ~/ 2),
+      };
+      expect(blocks.length, equals(16));
+    });
+
+    test('build - boundary faces take the owner cell vector', () {
+      final source = GlyphSource.build(
+        arrays,
+        vectors,
+        geometry.faceCentres,
+        boundary: true,
+      );
+
+      expect(source.length, equals(arrays.nFaces - arrays.nInternalFaces));
+      for (int g = 0; g < source.length; g++) {
+        final owner = arrays.owner[arrays.nInternalFaces + g];
+        expect(source.vectors[g * 3], equals(owner.toDouble()));
+      }
+    });
+  });
+}
@@ -0,0 +1,140 @@
+// test/gzip_index_test.dart
+
+import 'dart:io';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/utils/file_utils.dart';
+import 'package:d3_viewer/utils/gzip_index.dart';
+
+void main() {
+  late Directory testDir;
+
+  // Compressible but non-repeating content, like an ASCII field file
+  final original = List<int>.generate(
+    6 << 20,
+    (i) => 0x30 + ((i * 7 + (i >> 11) * 13) % 10),
+  );
+
+  setUp(() async {
+    testDir = await Directory.systemTemp.createTemp('gzip_index_test_');
+    await File('${testDir.path}/p.gz').writeAsBytes(gzip.encode(original));
+  });
+
+  tearDown(() async {
+    if (await testDir.exists()) {
+      await testDir.delete(recursive: true);
+    }
+  });
+
+  group('GzipIndex', () {
+    test('build - records checkpoints and total size', () {
+      final index = GzipIndex.build('${testDir.path}/p.gz', span: 1 << 20);
+
+      expect(index.uncompressedLength, equals(original.length));
+      expect(index.checkpoints.length, greaterThanOrEqualTo(4));
+    });
+
+    test('readRangeSync - matches the original bytes', () {
+      final index = GzipIndex.build('${testDir.path}/p.gz', span: 1 << 20);
+
+      for (final offset in [0, 12345, 1 << 20, (3 << 20) + 77, original.length - 100]) {
+        final bytes = index.readRangeSync(offset, 100);
+        expect(bytes, equals(original.sublist(offset, offset + 100)));
+      }
+    });
+
+    test('readRangeSync - truncates at end of data', () {
+      final index = GzipIndex.build('${testDir.path}/p.gz', span: 1 << 20);
+
+      final bytes = index.readRangeSync(original.length - 10, 100);
+
+      expect(bytes, equals(original.sublist(original.length - 10)));
+    });
+
+    test('open - saves the index and reloads it', () async {
+      final cacheDir = '${testDir.path}/cache';
+
+      final built = await GzipIndex.open(
+        '${testDir.path}/p.gz',
+        cacheDirectory: cacheDir,
+        span: 1 << 20,
+      );
+      final saved = await Directory(cacheDir).list().toList();
+      GzipIndex.clearLoaded();
+      final reloaded = await GzipIndex.open(
+        '${testDir.path}/p.gz',
+        cacheDirectory: cacheDir,
+        span: 1 << 20,
+      );
+
+      expect(saved.length, equals(1));
+      expect(built.checkpoints, isNotEmpty);
+      expect(identical(reloaded, built), isFalse);
+      expect(reloaded.compressedLength, equals(built.compressedLength));
+      expect(reloaded.modifiedMs, equals(built.modifiedMs));
+      expect(reloaded.uncompressedLength, equals(built.uncompressedLength));
+      expect(reloaded.span, equals(built.span));
+      expect(reloaded.checkpoints.length, equals(built.checkpoints.length));
+      for (int i = 0; i < built.checkpoints.length; i++) {
+        final a = built.checkpoints[i], b = reloaded.checkpoints[i];
+        expect(b.bitOffset, equals(a.bitOffset));
+        expect(b.uncompressedOffset, equals(a.uncompressedOffset));
+        expect(b.window, equals(a.window));
+      }
+    });
+
+    test('open - another span gives its own index', () async {
+      final path = '${testDir.path}/p.gz';
+
+      final coarse = await GzipIndex.open(path, span: 2 << 20);
+      final fine = await GzipIndex.open(path, span: 1 << 20);
+
+      expect(coarse.span, equals(2 << 20));
+      expect(fine.span, equals(1 << 20));
+      expect(fine.checkpoints.length, greaterThan(coarse.checkpoints.length));
+    });
+
+    test('inflateIndexed - returns the content and loads its index', () async {
+      final path = '${testDir.path}/p.gz';
+      final cacheDir = '${testDir.path}/cache';
+      GzipIndex.clearLoaded();
+
+      final bytes = await GzipIndex.inflateIndexed(path, cacheDirectory: cacheDir);
+      final index = await GzipIndex.open(path, cacheDirectory: cacheDir);
+
+      expect(bytes, equals(original));
+      expect(index.uncompressedLength, equals(original.length));
+      expect(index.checkpoints, isNotEmpty);
+      expect(await Directory(cacheDir).list().length, equals(1));
+    });
+
+    test('open - concurrent calls share one index', () async {
+      final path = '${testDir.path}/p.gz';
+
+      final both = await Future.wait([
+        GzipIndex.open(path, span: 1 << 20),
+        GzipIndex.open(path, span: 1 << 20),
+      ]);
+
+      expect(identical(both[0], both[1]), isTrue);
+    });
+
+    test('FileUtils.readFileRange - reads from .gz and plain files', () async {
+      await File('${testDir.path}/q').writeAsBytes(original);
+
+      final fromGzip = await FileUtils.readFileRange(
+        '${testDir.path}/p',
+        (5 << 20) + 3,
+        64,
+      );
+      final fromPlain = await FileUtils.readFileRange(
+        '${testDir.path}/q',
+        (5 << 20) + 3,
+        64,
+      );
+
+      final expected = original.sublist((5 << 20) + 3, (5 << 20) + 67);
+      expect(fromGzip, equals(expected));
+      expect(fromPlain, equals(expected));
+    });
+  });
+}
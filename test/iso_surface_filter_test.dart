@@ -0,0 +1,76 @@
+// test/iso_surface_filter_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/iso_surface_filter.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+import 'package:d3_viewer/utils/mesh_geometry.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('IsoSurfaceFilter', () {
+    final mesh = blockMesh(3, 2, 2);
+    final arrays = MeshArrays.of(mesh);
+    final geometry = MeshGeometry.build(arrays);
+    final allCells = Int32List.fromList(List.generate(arrays.nCells, (c) => c));
+
+    // A field linear in x is reproduced exactly by the tetrahedra
+    final pointValues = Float64List.fromList([for (final p in mesh.points) p.x]);
+    final cellValues = Float64List.fromList([
+      for (int c = 0; c < arrays.nCells; c++) c % 3 + 0.5,
+    ]);
+
+    test('contourCells - a linear field gives a flat cross-section', () {
+      final surface = IsoSurfaceFilter.contourCells(
+        arrays,
+        geometry,
+        allCells,
+        pointValues,
+        cellValues,
+        1.25,
+      );
+
+      expect(surface.isEmpty, isFalse);
+      expect(surfaceArea(surface), closeTo(4.0, 1e-9));
+      // Cut edges shared by neighbouring tetrahedra give one vertex
+      expect(surface.vertexCount, lessThan(surface.triangleCount));
+      for (int v = 0; v < surface.vertexCount; v++) {
+        expect(surface.positions[v * 3], closeTo(1.25, 1e-12));
+        expect(surface.values[v], equals(1.25));
+      }
+    });
+
+    test('contourCells - nothing outside the value range', () {
+      final surface = IsoSurfaceFilter.contourCells(
+        arrays,
+        geometry,
+        allCells,
+        pointValues,
+        cellValues,
+        4.0,
+      );
+
+      expect(surface.isEmpty, isTrue);
+    });
+
+    test('contour - the interval index keeps the whole surface', () async {
+      final field = FieldData(
+        name: 'x',
+        fieldClass: 'volScalarField',
+        internalField: cellValues,
+        boundaryField: const {},
+        pointValues: pointValues,
+      );
+      final filter = IsoSurfaceFilter(mesh);
+
+      final (lo, hi) = await filter.valueRange(field);
+      expect(lo, equals(0.0));
+      expect(hi, equals(3.0));
+
+      final surface = await filter.contour(field, 2.6);
+      expect(surfaceArea(surface), closeTo(4.0, 1e-9));
+    });
+  });
+}
@@ -0,0 +1,53 @@
+// test/line_sampler_test.dart
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/line_sampler.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('LineSampler', () {
+    final mesh = blockMesh(10, 2, 2);
+    // Cell value = its i index, so the value along x steps by one per cell
+    final cellValues = [
+      for (int c = 0; c < 10 * 2 * 2; c++) (c % 10).toDouble(),
+    ];
+
+    test('update - finds the cell of every sample', () async {
+      final sampler = LineSampler(mesh);
+
+      await sampler.update(Vector3(0.25, 0.5, 0.5), Vector3(9.75, 0.5, 0.5), 20);
+
+      expect(sampler.cells.length, equals(20));
+      expect(sampler.cells.first, equals(0));
+      expect(sampler.cells.last, equals(9));
+      expect(sampler.distances.last, closeTo(9.5, 1e-12));
+      expect(sampler.sample(cellValues), equals([for (int i = 0; i < 20; i++) i ~/ 2]));
+    });
+
+    test('update - only relocates samples that left their cell', () async {
+      final sampler = LineSampler(mesh);
+      await sampler.update(Vector3(0.25, 0.5, 0.5), Vector3(9.75, 0.5, 0.5), 20);
+
+      // A small shift across y keeps every sample in its cell
+      await sampler.update(Vector3(0.25, 0.6, 0.5), Vector3(9.75, 0.6, 0.5), 20);
+      expect(sampler.relocated, equals(0));
+
+      // Crossing into the next row of cells relocates all of them
+      await sampler.update(Vector3(0.25, 1.5, 0.5), Vector3(9.75, 1.5, 0.5), 20);
+      expect(sampler.relocated, equals(20));
+      expect(sampler.cells.first, equals(10));
+    });
+
+    test('sample - NaN outside the mesh', () async {
+      final sampler = LineSampler(mesh);
+
+      await sampler.update(Vector3(-1, 0.5, 0.5), Vector3(0.5, 0.5, 0.5), 2);
+      final values = sampler.sample(cellValues);
+
+      expect(values[0].isNaN, isTrue);
+      expect(values[1], equals(0.0));
+    });
+  });
+}
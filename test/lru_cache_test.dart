@@ -0,0 +1,53 @@
+// test/lru_cache_test.dart
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/utils/lru_cache.dart';
+
+void main() {
+  group('LruCache', () {
+    test('evicts the least recently used entry', () {
+      final evicted = <String>[];
+      final cache = LruCache<String, int>(2, onEvict: (key, _) => evicted.add(key));
+
+      cache['a'] = 1;
+      cache['b'] = 2;
+      expect(cache['a'], equals(1)); // a is now the most recent
+      cache['c'] = 3;
+
+      expect(evicted, equals(['b']));
+      expect(cache.keys, equals(['a', 'c']));
+    });
+
+    test('removeIfSame - keeps a newer value under the same key', () {
+      final cache = LruCache<String, List<int>>(4);
+      final old = [1];
+      final newer = [2];
+
+      cache['a'] = old;
+      cache['a'] = newer;
+      cache.removeIfSame('a', old);
+      expect(cache['a'], same(newer));
+
+      cache.removeIfSame('a', newer);
+      expect(cache['a'], isNull);
+    });
+
+    test('putIfAbsentFuture - shares a future and retries after a failure', () async {
+      final cache = LruCache<String, Future<int>>(4);
+      int calls = 0;
+      Future<int> failing() async {
+        calls++;
+        throw StateError('no input');
+      }
+
+      final first = cache.putIfAbsentFuture('a', failing);
+      expect(cache.putIfAbsentFuture('a', failing), same(first));
+      await expectLater(first, throwsStateError);
+
+      final retried = cache.putIfAbsentFuture('a', () async => 7);
+      expect(await retried, equals(7));
+      expect(cache.putIfAbsentFuture('a', failing), same(retried));
+      expect(calls, equals(1));
+    });
+  });
+}
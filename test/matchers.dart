@@ -0,0 +1,7 @@
+// test/matchers.dart
+
+import 'package:flutter_test/flutter_test.dart';
+
+/// Matches a list of doubles each within [tolerance] of [expected]
+Matcher near(List<double> expected, {double tolerance = 1e-9}) =>
+    pairwiseCompare<double, double>(expected, (a, b) => (a - b).abs() < tolerance, 'close to');
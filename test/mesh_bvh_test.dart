@@ -0,0 +1,64 @@
+// test/mesh_bvh_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+import 'package:d3_viewer/utils/mesh_bvh.dart';
+import 'package:d3_viewer/utils/mesh_picker.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('MeshBvh', () {
+    final mesh = blockMesh(6, 5, 4);
+    final arrays = MeshArrays.of(mesh);
+    final all = Uint8List(arrays.nFaces)..fillRange(0, arrays.nFaces, 1);
+
+    test('intersect - finds the nearest face along the ray', () {
+      final tree = MeshBvh.build(arrays, all);
+
+      // Along +x through the middle of cell (0, 2, 1): the inlet face first
+      final hit = tree.intersect(-1, 2.3, 1.6, 1, 0, 0);
+
+      expect(hit, isNotNull);
+      expect(hit!.$2, closeTo(1.0, 1e-12));
+      expect(mesh.owner[hit.$1], equals(0 + 6 * (2 + 5 * 1)));
+      expect(hit.$1, greaterThanOrEqualTo(mesh.boundaries['inlet']!.startFace));
+    });
+
+    test('intersect - skips hidden faces and misses return null', () {
+      final visible = Uint8List(arrays.nFaces);
+      final outlet = mesh.boundaries['outlet']!;
+      visible.fillRange(outlet.startFace, outlet.startFace + outlet.nFaces, 1);
+      final tree = MeshBvh.build(arrays, visible);
+
+      final hit = tree.intersect(-1, 2.3, 1.6, 1, 0, 0);
+
+      expect(hit!.$2, closeTo(7.0, 1e-12));
+      expect(tree.intersect(-1, 7, 1.5, 1, 0, 0), isNull);
+    });
+
+    test('intersect - agrees with testing every face', () {
+      final tree = MeshBvh.build(arrays, all);
+      for (int r = 0; r < 50; r++) {
+        final origin = Vector3(-2, 0.13 + r * 0.097, 0.21 + r * 0.071);
+        final direction = Vector3(1, 0.02 * (r % 7), -0.015 * (r % 5));
+
+        final fromTree = tree.intersect(
+          origin.x, origin.y, origin.z,
+          direction.x, direction.y, direction.z,
+        );
+        final bruteForce = MeshPicker.pick(mesh, origin, direction);
+
+        expect(fromTree?.$2, bruteForce == null ? isNull : closeTo(bruteForce.distance, 1e-9));
+      }
+    });
+
+    test('withPoints - reads the given points', () {
+      final tree = MeshBvh.build(arrays, all).withPoints(arrays.points);
+
+      expect(identical(tree.points, arrays.points), isTrue);
+    });
+  });
+}
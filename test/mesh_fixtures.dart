@@ -0,0 +1,130 @@
+// test/mesh_fixtures.dart
+
+import 'dart:math' as math;
+
+import 'package:d3_viewer/filters/triangle_surface.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+
+/// Structured nx * ny * nz block of unit-spaced hex cells from the origin,
+/// laid out like blockMesh output: internal faces first (normals pointing
+/// from owner to neighbour), then patches 'inlet' (x = 0), 'outlet'
+/// (x = nx * spacing) and 'walls' (the rest), all facing out of the domain.
+/// Cell (i, j, k) has index i + nx * (j + ny * k).
+PolyMesh blockMesh(int nx, int ny, int nz, {double spacing = 1.0}) {
+  int point(int i, int j, int k) => i + (nx + 1) * (j + (ny + 1) * k);
+  int cell(int i, int j, int k) => i + nx * (j + ny * k);
+
+  final points = <Vector3>[
+    for (int k = 0; k <= nz; k++)
+      for (int j = 0; j <= ny; j++)
+        for (int i = 0; i <= nx; i++)
+          Vector3(i * spacing, j * spacing, k * spacing),
+  ];
+
+  // Quads with normals along +x, +y and +z through the lower corner (i, j, k)
+  List<int> xFace(int i, int j, int k) =>
+      [point(i, j, k), point(i, j + 1, k), point(i, j + 1, k + 1), point(i, j, k + 1)];
+  List<int> yFace(int i, int j, int k) =>
+      [point(i, j, k), point(i, j, k + 1), point(i + 1, j, k + 1), point(i + 1, j, k)];
+  List<int> zFace(int i, int j, int k) =>
+      [point(i, j, k), point(i + 1, j, k), point(i + 1, j + 1, k), point(i, j + 1, k)];
+
+  final faces = <Face>[];
+  final owner = <int>[];
+  final neighbour = <int>[];
+
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        if (i + 1 < nx) {
+          faces.add(Face(xFace(i + 1, j, k)));
+          owner.add(cell(i, j, k));
+          neighbour.add(cell(i + 1, j, k));
+        }
+        if (j + 1 < ny) {
+          faces.add(Face(yFace(i, j + 1, k)));
+          owner.add(cell(i, j, k));
+          neighbour.add(cell(i, j + 1, k));
+        }
+        if (k + 1 < nz) {
+          faces.add(Face(zFace(i, j, k + 1)));
+          owner.add(cell(i, j, k));
+          neighbour.add(cell(i, j, k + 1));
+        }
+      }
+    }
+  }
+
+  final boundaries = <String, Boundary>{};
+  void patch(String name, String type, void Function() addFaces) {
+    final start = faces.length;
+    addFaces();
+    boundaries[name] = Boundary(
+      name: name,
+      type: type,
+      nFaces: faces.length - start,
+      startFace: start,
+    );
+  }
+
+  patch('inlet', 'patch', () {
+    for (int k = 0; k < nz; k++) {
+      for (int j = 0; j < ny; j++) {
+        faces.add(Face(xFace(0, j, k).reversed.toList()));
+        owner.add(cell(0, j, k));
+      }
+    }
+  });
+  patch('outlet', 'patch', () {
+    for (int k = 0; k < nz; k++) {
+      for (int j = 0; j < ny; j++) {
+        faces.add(Face(xFace(nx, j, k)));
+        owner.add(cell(nx - 1, j, k));
+      }
+    }
+  });
+  patch('walls', 'wall', () {
+    for (int k = 0; k < nz; k++) {
+      for (int i = 0; i < nx; i++) {
+        faces.add(Face(yFace(i, 0, k).reversed.toList()));
+        owner.add(cell(i, 0, k));
+        faces.add(Face(yFace(i, ny, k)));
+        owner.add(cell(i, ny - 1, k));
+      }
+    }
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        faces.add(Face(zFace(i, j, 0).reversed.toList()));
+        owner.add(cell(i, j, 0));
+        faces.add(Face(zFace(i, j, nz)));
+        owner.add(cell(i, j, nz - 1));
+      }
+    }
+  });
+
+  return PolyMesh(
+    points: points,
+    faces: faces,
+    owner: owner,
+    neighbour: neighbour,
+    boundaries: boundaries,
+  );
+}
+
+/// Total area of the triangles of [s]
+double surfaceArea(TriangleSurface s) {
+  double area = 0;
+  final p = s.positions;
+  for (int t = 0; t < s.triangleCount; t++) {
+    final a = s.triangles[t * 3] * 3;
+    final b = s.triangles[t * 3 + 1] * 3;
+    final c = s.triangles[t * 3 + 2] * 3;
+    final e1 = [p[b] - p[a], p[b + 1] - p[a + 1], p[b + 2] - p[a + 2]];
+    final e2 = [p[c] - p[a], p[c + 1] - p[a + 1], p[c + 2] - p[a + 2]];
+    final cx = e1[1] * e2[2] - e1[2] * e2[1];
+    final cy = e1[2] * e2[0] - e1[0] * e2[2];
+    final cz = e1[0] * e2[1] - e1[1] * e2[0];
+    area += 0.5 * math.sqrt(cx * cx + cy * cy + cz * cz);
+  }
+  return area;
+}
@@ -0,0 +1,66 @@
+// test/mesh_geometry_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+import 'package:d3_viewer/utils/mesh_geometry.dart';
+
+import 'matchers.dart';
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('MeshGeometry', () {
+    test('build - hex cells of a block', () {
+      final arrays = MeshArrays.of(blockMesh(3, 2, 2, spacing: 2.0));
+      final geometry = MeshGeometry.build(arrays);
+
+      for (int c = 0; c < arrays.nCells; c++) {
+        expect(geometry.cellVolumes[c], closeTo(8.0, 1e-12));
+      }
+      expect(geometry.cellCentres.sublist(0, 3), near([1.0, 1.0, 1.0], tolerance: 1e-12));
+      final last = (arrays.nCells - 1) * 3;
+      expect(geometry.cellCentres.sublist(last, last + 3), near([5.0, 3.0, 3.0], tolerance: 1e-12));
+
+      // The first internal face is between cells 0 and 1, facing +x
+      expect(geometry.faceCentres.sublist(0, 3), near([2.0, 1.0, 1.0], tolerance: 1e-12));
+      expect(geometry.faceAreas.sublist(0, 3), near([4.0, 0.0, 0.0], tolerance: 1e-12));
+      expect(geometry.faceArea(0), closeTo(4.0, 1e-12));
+    });
+
+    test('build - a tetrahedron with triangle faces', () {
+      final arrays = MeshArrays(
+        points: Float64List.fromList([0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1]),
+        faceOffsets: Int32List.fromList([0, 3, 6, 9, 12]),
+        faceVertices: Int32List.fromList([0, 2, 1, 0, 1, 3, 0, 3, 2, 1, 2, 3]),
+        owner: Int32List.fromList([0, 0, 0, 0]),
+        neighbour: Int32List(0),
+        nCells: 1,
+      );
+      final geometry = MeshGeometry.build(arrays);
+
+      expect(geometry.cellVolumes[0], closeTo(1 / 6, 1e-15));
+      for (int axis = 0; axis < 3; axis++) {
+        expect(geometry.cellCentres[axis], closeTo(0.25, 1e-15));
+      }
+      // The slanted face points out along (1, 1, 1)
+      expect(geometry.faceAreas.sublist(9, 12), equals([0.5, 0.5, 0.5]));
+      expect(geometry.faceCentres[9], closeTo(1 / 3, 1e-15));
+    });
+
+    test('faceGeometry and cellGeometry - chunks match the whole', () {
+      final arrays = MeshArrays.of(blockMesh(4, 3, 2));
+      final whole = MeshGeometry.build(arrays);
+      final (centres, areas) = MeshGeometry.faceGeometry(arrays, 5, 17);
+      expect(centres, equals(whole.faceCentres.sublist(15, 51)));
+      expect(areas, equals(whole.faceAreas.sublist(15, 51)));
+      final (_, volumes) = MeshGeometry.cellGeometry(
+        arrays,
+        whole.faceCentres,
+        whole.faceAreas,
+        3,
+        9,
+      );
+      expect(volumes, equals(whole.cellVolumes.sublist(3, 9)));
+    });
+  });
+}
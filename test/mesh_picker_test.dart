@@ -0,0 +1,69 @@
+// test/mesh_picker_test.dart
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/mesh_picker.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('MeshPicker.pick without a tree', () {
+    // Not prepared, so every pick tests each visible face in turn
+    final mesh = blockMesh(3, 2, 2);
+    final origin = Vector3(-1, 1.5, 0.5);
+    final direction = Vector3(1, 0, 0);
+
+    test('picks the nearest visible face and its owner cell', () {
+      final hit = MeshPicker.pick(mesh, origin, direction);
+
+      expect(MeshPicker.treeFor(mesh), isNull);
+      expect(hit, isNotNull);
+      expect(hit!.patchName, equals('inlet'));
+      expect(hit.cellIndex, equals(0 + 3 * (1 + 2 * 0)));
+      expect(hit.distance, closeTo(1.0, 1e-12));
+      expect(hit.point.x, closeTo(0.0, 1e-12));
+    });
+
+    test('skips hidden patches and internal faces', () {
+      final throughInternal = MeshPicker.pick(
+        mesh,
+        origin,
+        direction,
+        boundaryVisibility: {'inlet': false},
+      );
+      final boundaryOnly = MeshPicker.pick(
+        mesh,
+        origin,
+        direction,
+        showInternalMesh: false,
+        boundaryVisibility: {'inlet': false},
+      );
+
+      expect(throughInternal!.patchName, isNull);
+      expect(throughInternal.distance, closeTo(2.0, 1e-12));
+      expect(boundaryOnly!.patchName, equals('outlet'));
+      expect(boundaryOnly.cellIndex, equals(2 + 3 * (1 + 2 * 0)));
+      expect(boundaryOnly.distance, closeTo(4.0, 1e-12));
+    });
+
+    test('a ray that misses the mesh returns null', () {
+      expect(MeshPicker.pick(mesh, Vector3(-1, 5, 0.5), direction), isNull);
+    });
+  });
+
+  group('MeshPicker.prepare', () {
+    test('concurrent calls share one build, used by later picks', () async {
+      final mesh = blockMesh(3, 2, 2);
+
+      final trees = await Future.wait([
+        MeshPicker.prepare(mesh),
+        MeshPicker.prepare(mesh),
+      ]);
+      final again = await MeshPicker.prepare(mesh);
+
+      expect(identical(trees[0], trees[1]), isTrue);
+      expect(identical(again, trees[0]), isTrue);
+      expect(identical(MeshPicker.treeFor(mesh), trees[0]), isTrue);
+    });
+  });
+}
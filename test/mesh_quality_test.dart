@@ -0,0 +1,97 @@
+// test/mesh_quality_test.dart
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/field_statistics.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+import 'package:d3_viewer/utils/mesh_geometry.dart';
+import 'package:d3_viewer/utils/mesh_quality.dart';
+
+import 'mesh_fixtures.dart';
+
+MeshQuality _quality(PolyMesh mesh, [int start = 0, int? end]) {
+  final arrays = MeshArrays.of(mesh);
+  return MeshQuality.build(arrays, MeshGeometry.build(arrays), start, end);
+}
+
+void main() {
+  group('MeshQuality', () {
+    test('build - cubes are perfect', () {
+      final quality = _quality(blockMesh(3, 2, 2, spacing: 0.5));
+
+      for (int c = 0; c < quality.nCells; c++) {
+        expect(quality.nonOrthogonality[c], closeTo(0.0, 1e-6));
+        expect(quality.skewness[c], closeTo(0.0, 1e-12));
+        expect(quality.aspectRatio[c], closeTo(1.0, 1e-12));
+        expect(quality.volumeRatio[c], closeTo(1.0, 1e-12));
+        expect(quality.faceConcavity[c], 0.0);
+      }
+    });
+
+    test('build - a stretched cell', () {
+      // Move the x = 2 end of a 2 x 1 x 1 block out to x = 3
+      final mesh = blockMesh(2, 1, 1);
+      for (final p in [2, 5, 8, 11]) {
+        final point = mesh.points[p];
+        mesh.points[p] = Vector3(3.0, point.y, point.z);
+      }
+      final quality = _quality(mesh);
+
+      expect(quality.aspectRatio[0], closeTo(1.0, 1e-12));
+      expect(quality.aspectRatio[1], closeTo(2.0, 1e-12));
+      expect(quality.volumeRatio[0], closeTo(0.5, 1e-12));
+      expect(quality.volumeRatio[1], closeTo(0.5, 1e-12));
+      expect(quality.nonOrthogonality[1], closeTo(0.0, 1e-6));
+    });
+
+    test('build - a sheared face', () {
+      // Slide the top edge of the middle face of a 2 x 1 x 1 block along x
+      final mesh = blockMesh(2, 1, 1);
+      for (final p in [7, 10]) {
+        final point = mesh.points[p];
+        mesh.points[p] = Vector3(1.5, point.y, point.z);
+      }
+      final quality = _quality(mesh);
+
+      for (int c = 0; c < 2; c++) {
+        expect(quality.nonOrthogonality[c], greaterThan(1.0));
+        expect(quality.skewness[c], greaterThan(0.0));
+      }
+      expect(quality.nonOrthogonality[0], closeTo(quality.nonOrthogonality[1], 1e-9));
+    });
+
+    test('build - chunks match the whole mesh', () {
+      final mesh = blockMesh(4, 3, 2);
+      mesh.points[7] = Vector3(2.3, 1.2, 0.1);
+      final whole = _quality(mesh);
+      final head = _quality(mesh, 0, 10);
+      final tail = _quality(mesh, 10);
+
+      for (final name in MeshQuality.metrics) {
+        expect([...head.metric(name), ...tail.metric(name)], whole.metric(name));
+      }
+    });
+
+    test('fieldNames - one per metric', () {
+      expect(MeshQuality.fieldNames, hasLength(MeshQuality.metrics.length));
+      expect(MeshQuality.fieldNames, contains('quality:skewness'));
+    });
+  });
+
+  group('FieldStatistics', () {
+    test('compute - range, mean and bins', () {
+      final stats = FieldStatistics.compute([0, 1, 2, 3, double.nan], bins: 3);
+      expect(stats.count, 4);
+      expect(stats.min, 0.0);
+      expect(stats.max, 3.0);
+      expect(stats.mean, 1.5);
+      expect(stats.bins, [1, 1, 2]);
+      expect(stats.maxBin, 2);
+    });
+
+    test('compute - constant and empty fields', () {
+      expect(FieldStatistics.compute([4, 4, 4], bins: 2).bins, [3, 0]);
+      expect(FieldStatistics.compute([]).count, 0);
+    });
+  });
+}
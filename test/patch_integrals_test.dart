@@ -0,0 +1,132 @@
+// test/patch_integrals_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/patch_integrals.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+import 'package:d3_viewer/utils/mesh_geometry.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('PatchIntegrals', () {
+    // 2 x 1 x 1 block with spacing 2: inlet and outlet of area 4, walls 32
+    final arrays = MeshArrays.of(blockMesh(2, 1, 1, spacing: 2.0));
+    final areas = MeshGeometry.build(arrays).faceAreas;
+    final nBoundary = arrays.nFaces - arrays.nInternalFaces;
+
+    FieldData field(
+      String fieldClass,
+      List<double> cells, {
+      Float64List? vectors,
+      Float64List? faceValues,
+      Map<String, dynamic> patches = const {},
+    }) =>
+        FieldData(
+          name: 'f',
+          fieldClass: fieldClass,
+          internalField: cells,
+          boundaryField: patches,
+          vectors: vectors,
+          faceValues: faceValues,
+        );
+
+    List<PatchIntegral> integrate(FieldData field) {
+      final (values, vectors) = PatchIntegrals.boundaryValues(arrays, field);
+      final sums = PatchIntegrals.accumulate(
+        arrays,
+        areas,
+        values,
+        vectors,
+        onFaces: field.isFaceField,
+        start: 0,
+        end: nBoundary,
+      );
+      return PatchIntegrals.results(
+        arrays,
+        sums,
+        onFaces: field.isFaceField,
+        hasFlux: field.isFaceField || vectors != null,
+      );
+    }
+
+    test('boundaryFacePatch - one patch per boundary face', () {
+      expect(arrays.patchNames, ['inlet', 'outlet', 'walls']);
+      expect(arrays.boundaryFacePatch, [0, 1, for (int i = 0; i < 8; i++) 2]);
+    });
+
+    test('accumulate - cell scalars', () {
+      final rows = integrate(field('volScalarField', [1, 3]));
+
+      expect([for (final row in rows) row.area], [4.0, 4.0, 32.0]);
+      expect(rows[0].average, closeTo(1.0, 1e-12));
+      expect(rows[1].average, closeTo(3.0, 1e-12));
+      expect(rows[2].average, closeTo(2.0, 1e-12));
+      expect(rows[2].integral, closeTo(64.0, 1e-12));
+      expect(rows[0].flux, isNull);
+    });
+
+    test('accumulate - flux of a uniform vector field', () {
+      final rows = integrate(field(
+        'volVectorField',
+        [2, 2],
+        vectors: Float64List.fromList([2, 0, 0, 2, 0, 0]),
+      ));
+
+      expect(rows[0].flux, closeTo(-8.0, 1e-12));
+      expect(rows[1].flux, closeTo(8.0, 1e-12));
+      expect(rows[2].flux, closeTo(0.0, 1e-12));
+    });
+
+    test('accumulate - fixedValue patches use their own values', () {
+      // Inlet imposes (1 0 0) and the outlet p = 0 while the cells differ;
+      // walls have no value and fall back to the owner cell
+      final u = integrate(field(
+        'volVectorField',
+        [3, 3],
+        vectors: Float64List.fromList([3, 0, 0, 3, 0, 0]),
+        patches: {'inlet': <double>[1, 0, 0]},
+      ));
+      expect(u[0].flux, closeTo(-4.0, 1e-12));
+      expect(u[0].average, closeTo(1.0, 1e-12));
+      expect(u[1].flux, closeTo(12.0, 1e-12));
+
+      final p = integrate(field(
+        'volScalarField',
+        [1, 3],
+        patches: {'outlet': <double>[0]},
+      ));
+      expect(p[0].average, closeTo(1.0, 1e-12));
+      expect(p[1].average, 0.0);
+      expect(p[2].average, closeTo(2.0, 1e-12));
+    });
+
+    test('accumulate - face values are fluxes, with no integral', () {
+      final faces = Float64List(arrays.nFaces);
+      faces[arrays.patchStarts[1]] = 5;
+      final rows = integrate(field('surfaceScalarField', [0, 0], faceValues: faces));
+
+      expect(rows[1].flux, 5.0);
+      expect(rows[1].area, 4.0);
+      expect(rows[1].integral, isNull);
+      expect(rows[1].average, isNull);
+    });
+
+    test('accumulate - chunks add up to the whole', () {
+      final (values, _) =
+          PatchIntegrals.boundaryValues(arrays, field('volScalarField', [1.5, -2.5]));
+      final whole = PatchIntegrals.accumulate(
+          arrays, areas, values, null, onFaces: false, start: 0, end: nBoundary);
+      // Each chunk gets only its slice of the boundary values
+      final head = PatchIntegrals.accumulate(
+          arrays, areas, values.sublist(0, 3), null, onFaces: false, start: 0, end: 3);
+      final tail = PatchIntegrals.accumulate(arrays, areas, values.sublist(3), null,
+          onFaces: false, start: 3, end: nBoundary);
+
+      for (int i = 0; i < whole.length; i++) {
+        expect(head[i] + tail[i], closeTo(whole[i], 1e-12));
+      }
+    });
+  });
+}
@@ -0,0 +1,138 @@
+// test/pathline_tracer_test.dart
+
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/pathline_tracer.dart';
+import 'package:d3_viewer/filters/stream_tracer.dart';
+import 'package:d3_viewer/utils/cell_locator.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+
+import 'mesh_fixtures.dart';
+
+Float64List _uniform(int n, double ux) {
+  final vectors = Float64List(n * 3);
+  for (int i = 0; i < n; i++) {
+    vectors[i * 3] = ux;
+  }
+  return vectors;
+}
+
+String _velocityFile(int nCells, double ux) => '''
+FoamFile
+{
+    class       volVectorField;
+    object      U;
+}
+internalField   nonuniform List<vector>
+$nCells
+(
+${List.filled(nCells, '($ux 0 0)').join('\n')}
+)
+;
+''';
+
+void main() {
+  group('PathlineTracer', () {
+    final mesh = blockMesh(4, 2, 2);
+    final arrays = MeshArrays.of(mesh);
+    final sampler = FlowSampler(arrays, CellLocator.build(arrays));
+
+    test('advect - integrates velocity blended in time', () {
+      final state = PathlineTracer.advect(
+        sampler,
+        _uniform(arrays.nPoints, 1.0),
+        _uniform(arrays.nPoints, 3.0),
+        0.0,
+        1.0,
+        Float64List.fromList([0.5, 0.5, 0.5, 3.5, 0.5, 0.5]),
+        Int32List.fromList([0, 3]),
+      );
+
+      // x' = 1 + 2t over [0, 1] moves 2
+      expect(state.positions[0], closeTo(2.5, 1e-9));
+      expect(state.cells[0], equals(2));
+      expect(state.speeds[0], closeTo(3.0, 1e-12));
+      // The second particle leaves through the outlet
+      expect(state.cells[1], equals(-1));
+    });
+
+    test('trace - streams the velocity of each time step', () async {
+      final directory = await Directory.systemTemp.createTemp('pathlines');
+      addTearDown(() => directory.delete(recursive: true));
+      final times = ['0', '0.5', '1'];
+      for (final time in times) {
+        await Directory('${directory.path}/$time').create();
+        await File('${directory.path}/$time/U')
+            .writeAsString(_velocityFile(arrays.nCells, 2.0));
+      }
+
+      final lines = await PathlineTracer(
+        casePath: directory.path,
+        mesh: mesh,
+        fieldName: 'U',
+        timeDirectories: times,
+      ).trace(Float64List.fromList([0.5, 0.5, 0.5]));
+
+      expect(lines.lineCount, equals(1));
+      expect(lines.pointCount, equals(3));
+      expect(lines.positions[3], closeTo(1.5, 1e-9));
+      expect(lines.positions[6], closeTo(2.5, 1e-9));
+      expect(lines.values, everyElement(closeTo(2.0, 1e-9)));
+    });
+
+    test('trace - expands a uniform 0/U and skips steps without U', () async {
+      final directory = await Directory.systemTemp.createTemp('pathlines');
+      addTearDown(() => directory.delete(recursive: true));
+      final times = ['0', '0.5', '1'];
+      for (final time in times) {
+        await Directory('${directory.path}/$time').create();
+      }
+      await File('${directory.path}/0/U').writeAsString('''
+FoamFile
+{
+    class       volVectorField;
+    object      U;
+}
+internalField   uniform (2 0 0);
+''');
+      await File('${directory.path}/1/U')
+          .writeAsString(_velocityFile(arrays.nCells, 2.0));
+
+      final lines = await PathlineTracer(
+        casePath: directory.path,
+        mesh: mesh,
+        fieldName: 'U',
+        timeDirectories: times,
+      ).trace(Float64List.fromList([0.5, 0.5, 0.5]));
+
+      // One interval from t = 0 to t = 1
+      expect(lines.pointCount, equals(2));
+      expect(lines.positions[3], closeTo(2.5, 1e-9));
+    });
+
+    test('trace - rejects a velocity field of the wrong size', () async {
+      final directory = await Directory.systemTemp.createTemp('pathlines');
+      addTearDown(() => directory.delete(recursive: true));
+      final times = ['0', '1'];
+      for (final time in times) {
+        await Directory('${directory.path}/$time').create();
+        await File('${directory.path}/$time/U')
+            .writeAsString(_velocityFile(arrays.nCells - 1, 2.0));
+      }
+
+      final tracer = PathlineTracer(
+        casePath: directory.path,
+        mesh: mesh,
+        fieldName: 'U',
+        timeDirectories: times,
+      );
+
+      await expectLater(
+        tracer.trace(Float64List.fromList([0.5, 0.5, 0.5])),
+        throwsA(isA<RemoteError>()), // Raised on the worker
+      );
+    });
+  });
+}
@@ -0,0 +1,144 @@
+// test/sequence_exporter_test.dart
+
+import 'dart:io';
+import 'package:flutter/material.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/widgets/sequence_exporter.dart';
+
+import 'mesh_fixtures.dart';
+
+String _scalarFile(int nCells, double value) => '''
+FoamFile
+{
+    class       volScalarField;
+    object      p;
+}
+internalField   nonuniform List<scalar>
+$nCells
+(
+${List.filled(nCells, '$value').join('\n')}
+)
+;
+''';
+
+// Records the first cell value of every field it paints
+class _RecordingPainter extends CustomPainter {
+  final List<double?> painted;
+  final FieldData? fieldData;
+
+  _RecordingPainter(this.painted, this.fieldData);
+
+  @override
+  void paint(Canvas canvas, Size size) {
+    painted.add(fieldData?.internalField.first);
+    canvas.drawRect(Offset.zero & size, Paint()..color = Colors.red);
+  }
+
+  @override
+  bool shouldRepaint(covariant CustomPainter oldDelegate) => true;
+}
+
+void main() {
+  group('SequenceExporter', () {
+    final mesh = blockMesh(2, 2, 1);
+    final times = ['0', '1', '2'];
+    late Directory caseDir;
+    late Directory outDir;
+
+    setUp(() async {
+      caseDir = await Directory.systemTemp.createTemp('export_case');
+      outDir = await Directory.systemTemp.createTemp('export_out');
+      for (int t = 0; t < times.length; t++) {
+        await Directory('${caseDir.path}/${times[t]}').create();
+        await File('${caseDir.path}/${times[t]}/p')
+            .writeAsString(_scalarFile(4, t * 10.0));
+      }
+    });
+
+    tearDown(() async {
+      await caseDir.delete(recursive: true);
+      if (await outDir.exists()) await outDir.delete(recursive: true);
+    });
+
+    SequenceExporter exporter(
+      List<double?> painted, {
+      Future<FieldData?> Function(String timeStep)? loadField,
+    }) =>
+        SequenceExporter(
+          foamCase: OpenFOAMCase(
+            casePath: caseDir.path,
+            mesh: mesh,
+            fields: {},
+            timeDirectories: times,
+          ),
+          fieldName: 'p',
+          size: const Size(8, 6),
+          painterFor: (fieldData) => _RecordingPainter(painted, fieldData),
+          inFlight: 2,
+          loadField: loadField,
+        );
+
+    testWidgets('export - paints every step in order and writes numbered PNGs',
+        (tester) async {
+      final painted = <double?>[];
+      final progress = <int>[];
+      final written = await tester.runAsync(() => exporter(painted).export(
+            outDir.path,
+            onProgress: (done, total) => progress.add(done),
+          ));
+
+      expect(written, equals(3));
+      expect(painted, equals([0.0, 10.0, 20.0]));
+      expect(progress, equals([1, 2, 3]));
+      for (final name in ['frame_0000.png', 'frame_0001.png', 'frame_0002.png']) {
+        final bytes = await tester.runAsync(() => File('${outDir.path}/$name').readAsBytes());
+        expect(bytes!.sublist(1, 4), equals('PNG'.codeUnits));
+      }
+    });
+
+    testWidgets('export - computed fields come from the step loader',
+        (tester) async {
+      final painted = <double?>[];
+      final written = await tester.runAsync(() => exporter(
+            painted,
+            loadField: (time) async => FieldData(
+              name: 'p * 2',
+              fieldClass: 'volScalarField',
+              internalField: List.filled(4, double.parse(time) * 2),
+              boundaryField: {},
+            ),
+          ).export(outDir.path));
+
+      expect(written, equals(3));
+      expect(painted, equals([0.0, 2.0, 4.0]));
+    });
+
+    testWidgets('export - stops at a step whose field cannot be read',
+        (tester) async {
+      await tester.runAsync(() => File('${caseDir.path}/1/p').delete());
+      final painted = <double?>[];
+
+      final error = await tester.runAsync(() => exporter(painted)
+          .export(outDir.path)
+          .then<Object?>((_) => null, onError: (Object e) => e));
+
+      expect(error, isA<StateError>());
+      expect(painted, equals([0.0]));
+      final files = await tester.runAsync(() => outDir.list().length);
+      expect(files, equals(1));
+    });
+
+    testWidgets('export - reports a failed write after the others finish',
+        (tester) async {
+      await tester.runAsync(() => outDir.delete(recursive: true));
+      final painted = <double?>[];
+
+      final error = await tester.runAsync(() => exporter(painted)
+          .export(outDir.path)
+          .then<Object?>((_) => null, onError: (Object e) => e));
+
+      expect(error, isA<FileSystemException>());
+    });
+  });
+}
@@ -0,0 +1,51 @@
+// test/slice_filter_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/slice_filter.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('SliceFilter', () {
+    final mesh = blockMesh(3, 2, 2);
+    final arrays = MeshArrays.of(mesh);
+    final allCells = Int32List.fromList(List.generate(arrays.nCells, (c) => c));
+
+    test('cutCells - covers the cross-section of the domain', () {
+      final surface = SliceFilter.cutCells(arrays, allCells, 1, 0, 0, 1.5);
+
+      expect(surface.triangleCount, equals(8));
+      expect(surfaceArea(surface), closeTo(4.0, 1e-9));
+    });
+
+    test('cutCells - interpolates point values along cut edges', () {
+      final xValues = Float64List.fromList([for (final p in mesh.points) p.x]);
+
+      final surface = SliceFilter.cutCells(
+        arrays,
+        allCells,
+        1,
+        0,
+        0,
+        2.25,
+        pointValues: xValues,
+      );
+
+      expect(surface.values, everyElement(closeTo(2.25, 1e-9)));
+    });
+
+    test('cut - only visits cells near the plane', () async {
+      final filter = SliceFilter(mesh);
+
+      final (lo, hi) = await filter.offsetRange(Vector3(0, 0, 1));
+      final surface = await filter.cut(Vector3(0, 0, 1), 0.5);
+
+      expect(lo, equals(0.0));
+      expect(hi, equals(2.0));
+      expect(surfaceArea(surface), closeTo(6.0, 1e-9));
+    });
+  });
+}
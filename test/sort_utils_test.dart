@@ -0,0 +1,39 @@
+// test/sort_utils_test.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/utils/sort_utils.dart';
+
+void main() {
+  group('SortUtils', () {
+    test('argsort - sorts keys and keeps the permutation', () {
+      final random = math.Random(7);
+      final keys = List<double>.generate(5000, (_) => random.nextInt(100) / 7);
+
+      final (order, sorted) = SortUtils.argsort(keys);
+
+      final expected = [...keys]..sort();
+      expect(sorted, equals(expected));
+      for (int i = 0; i < keys.length; i++) {
+        expect(keys[order[i]], equals(sorted[i]));
+      }
+    });
+
+    test('argsort - puts NaN last', () {
+      final (order, sorted) = SortUtils.argsort([3.0, double.nan, 1.0]);
+
+      expect(sorted.sublist(0, 2), equals([1.0, 3.0]));
+      expect(sorted[2].isNaN, isTrue);
+      expect(order[2], equals(1));
+    });
+
+    test('lowerBound and upperBound - bracket equal keys', () {
+      final sorted = Float64List.fromList([1, 2, 2, 2, 5]);
+
+      expect(SortUtils.lowerBound(sorted, 2), equals(1));
+      expect(SortUtils.upperBound(sorted, 2), equals(4));
+      expect(SortUtils.lowerBound(sorted, 6), equals(5));
+    });
+  });
+}
@@ -0,0 +1,93 @@
+// test/stream_tracer_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/polylines.dart';
+import 'package:d3_viewer/filters/stream_tracer.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/parsers/foam_file_parser.dart';
+import 'package:d3_viewer/utils/cell_locator.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('StreamTracer', () {
+    final arrays = MeshArrays.of(blockMesh(4, 2, 2));
+    final sampler = FlowSampler(arrays, CellLocator.build(arrays));
+
+    // Uniform flow along +x
+    final pointVectors = Float64List(arrays.nPoints * 3);
+    for (int p = 0; p < arrays.nPoints; p++) {
+      pointVectors[p * 3] = 2.0;
+    }
+
+    test('walk - crosses faces to the containing cell', () {
+      expect(sampler.walk(0, 3.5, 0.5, 0.5), equals(3));
+      expect(sampler.walk(0, 2.5, 1.5, 1.5), equals(2 + 4 * (1 + 2 * 1)));
+      expect(sampler.walk(0, 4.5, 0.5, 0.5), equals(-1));
+    });
+
+    test('traceSeeds - follows uniform flow through the domain', () {
+      final lines = StreamTracer.traceSeeds(
+        sampler,
+        pointVectors,
+        Float64List.fromList([0.6, 1.0, 1.0, 9.0, 9.0, 9.0]),
+      );
+
+      // The seed outside the mesh gives no line
+      expect(lines.lineCount, equals(1));
+      final first = lines.offsets[0];
+      final last = lines.offsets[1] - 1;
+      expect(lines.positions[first * 3], lessThan(0.25));
+      expect(lines.positions[last * 3], greaterThan(3.75));
+      for (int p = first; p <= last; p++) {
+        expect(lines.positions[p * 3 + 1], closeTo(1.0, 1e-12));
+        expect(lines.positions[p * 3 + 2], closeTo(1.0, 1e-12));
+        expect(lines.values[p], closeTo(2.0, 1e-12));
+        if (p > first) {
+          expect(lines.positions[p * 3], greaterThan(lines.positions[(p - 1) * 3]));
+        }
+      }
+    });
+
+    test('Polylines.concat - offsets follow the joined points', () {
+      final a = PolylinesBuilder()
+        ..addPoint(0, 0, 0, 1)
+        ..addPoint(1, 0, 0, 1)
+        ..endLine()
+        ..addPoint(5, 5, 5, 0)
+        ..endLine();
+      final b = PolylinesBuilder()
+        ..addPoint(0, 1, 0, 2)
+        ..addPoint(0, 2, 0, 2)
+        ..addPoint(0, 3, 0, 2)
+        ..endLine();
+
+      final joined = Polylines.concat([a.build(), b.build()]);
+      expect(joined.lineCount, equals(2));
+      expect(joined.offsets, equals([0, 2, 5]));
+      expect(joined.values, equals([1, 1, 2, 2, 2]));
+    });
+  });
+
+  test('FoamFileParser.parseVectorField - keeps the components', () {
+    const content = '''
+FoamFile
+{
+    class       volVectorField;
+    object      U;
+}
+internalField   nonuniform List<vector>
+2
+(
+(1 2 2)
+(-3 0 4e0)
+)
+;
+''';
+    final vectors = FoamFileParser.parseVectorField(content);
+    expect(vectors, equals([1, 2, 2, -3, 0, 4]));
+    expect(FoamFileParser.vectorMagnitudes(vectors), equals([3.0, 5.0]));
+  });
+}
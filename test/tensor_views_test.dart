@@ -0,0 +1,63 @@
+// test/tensor_views_test.dart
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/tensor_views.dart';
+import 'package:d3_viewer/parsers/foam_file_parser.dart';
+import 'package:d3_viewer/utils/tensor_math.dart';
+
+import 'matchers.dart';
+
+void main() {
+  // Two symmetric tensors: diag(1, 2, 3) and [[2, 1, 0], [1, 2, 0], [0, 0, 5]]
+  final symm = Float64List.fromList([1, 0, 0, 2, 0, 3, 2, 1, 0, 2, 0, 5]);
+
+  group('TensorViews', () {
+    test('parse - view names', () {
+      expect(TensorViews.parse('vonMises(R)'), ('vonMises', 'R'));
+      expect(TensorViews.parse('eigMin( turbulenceProperties:R )'),
+          ('eigMin', 'turbulenceProperties:R'));
+      expect(TensorViews.parse('Q(U)'), isNull);
+    });
+  });
+
+  group('TensorMath', () {
+    test('magnitudes - symmetric and full tensors', () {
+      expect(TensorMath.magnitudes(symm, 6), near([math.sqrt(14), math.sqrt(35)]));
+      final full = Float64List.fromList([1, 2, 0, 0, 0, 0, 0, 0, 2]);
+      expect(TensorMath.magnitudes(full, 9), near([3]));
+    });
+
+    test('traces and vonMises', () {
+      expect(TensorMath.traces(symm, 6, 0, 2), near([6, 9]));
+      // Pure shear xy = 1 has von Mises sqrt(3); hydrostatic has 0
+      final shear = Float64List.fromList([0, 1, 0, 1, 0, 0, 0, 0, 0]);
+      expect(TensorMath.vonMises(shear, 9, 0, 1), near([math.sqrt(3)]));
+      expect(TensorMath.vonMises(Float64List.fromList([4, 0, 0, 4, 0, 4]), 6, 0, 1), near([0]));
+    });
+
+    test('eigenvalues - descending per tensor', () {
+      expect(TensorMath.eigenvalues(symm, 6, 0, 2), near([3, 2, 1, 5, 3, 1]));
+      expect(TensorMath.eigenvalues(symm, 6, 1, 2), near([5, 3, 1]));
+    });
+  });
+
+  group('FoamFileParser', () {
+    test('parseTensorField - symmTensor list', () {
+      const content = '''
+FoamFile { version 2.0; format ascii; class volSymmTensorField; object R; }
+dimensions [0 2 -2 0 0 0 0];
+internalField nonuniform List<symmTensor>
+2
+(
+(1 0 0 2 0 3)
+(2 1 0 2 0 5e0)
+)
+;
+boundaryField { }
+''';
+      expect(FoamFileParser.parseTensorField(content, 6), symm);
+    });
+  });
+}
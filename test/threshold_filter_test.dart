@@ -0,0 +1,79 @@
+// test/threshold_filter_test.dart
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/filters/cell_subset.dart';
+import 'package:d3_viewer/filters/threshold_filter.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/mesh_arrays.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('ThresholdFilter', () {
+    final arrays = MeshArrays.of(blockMesh(3, 2, 2));
+
+    // Values in reverse cell order, with one undefined cell
+    FieldData field() => FieldData(
+          name: 'T',
+          fieldClass: 'volScalarField',
+          internalField: [
+            for (int c = 0; c < arrays.nCells; c++)
+              c == 0 ? double.nan : (arrays.nCells - c).toDouble(),
+          ],
+          boundaryField: const {},
+        );
+
+    List<int> visible(CellSubset subset) => [
+          for (int c = 0; c < arrays.nCells; c++)
+            if (subset.isVisible(c)) c,
+        ];
+
+    test('valueRange - ignores undefined values', () async {
+      final filter = ThresholdFilter(CellSubset(arrays));
+      expect(await filter.valueRange(field()), equals((1.0, 11.0)));
+    });
+
+    test('apply - shows the cells in range and updates by difference',
+        () async {
+      final subset = CellSubset(arrays);
+      final filter = ThresholdFilter(subset);
+      final t = field();
+
+      await filter.apply(t, 2, 5);
+      expect(visible(subset), equals([7, 8, 9, 10]));
+
+      final changed = await filter.apply(t, 3.5, 7);
+      expect(changed, equals(4));
+      expect(visible(subset), equals([5, 6, 7, 8]));
+
+      await filter.apply(t, 5, 4);
+      expect(visible(subset), isEmpty);
+
+      await filter.apply(null, 0, 0);
+      expect(subset.isActive, isFalse);
+    });
+
+    test('apply - a clear issued during a pending apply wins', () async {
+      final subset = CellSubset(arrays);
+      final filter = ThresholdFilter(subset);
+
+      // The first call still has to build its index when the second arrives
+      final pending = filter.apply(field(), 2, 5);
+      final cleared = filter.apply(null, 0, 0);
+      await Future.wait([pending, cleared]);
+
+      expect(subset.isActive, isFalse);
+      expect(visible(subset).length, equals(arrays.nCells));
+    });
+
+    test('apply - switching fields restores the previous selection first',
+        () async {
+      final subset = CellSubset(arrays);
+      final filter = ThresholdFilter(subset);
+
+      await filter.apply(field(), 1, 1);
+      await filter.apply(field(), 10, 11);
+      expect(visible(subset), equals([1, 2]));
+    });
+  });
+}
@@ -0,0 +1,58 @@
+// test/view_transform_test.dart
+
+import 'dart:ui';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/models/openfoam_case.dart';
+import 'package:d3_viewer/utils/view_transform.dart';
+
+import 'mesh_fixtures.dart';
+
+void main() {
+  group('ViewTransform', () {
+    final mesh = blockMesh(4, 2, 2);
+    final view = ViewTransform.forMesh(
+      mesh,
+      rotationX: 0.4,
+      rotationY: -0.7,
+      zoom: 30,
+      size: const Size(400, 300),
+    );
+
+    test('forMesh - centres the mesh bounds on screen', () {
+      final centre = view.project(2, 1, 1);
+
+      expect(view.center.x, equals(2.0));
+      expect(centre.dx, closeTo(200, 1e-9));
+      expect(centre.dy, closeTo(150, 1e-9));
+    });
+
+    test('screenRay - passes back through the projected point', () {
+      for (final p in [Vector3(0, 0, 0), Vector3(4, 2, 2), Vector3(1.5, 0.3, 1.9)]) {
+        final screen = view.project(p.x, p.y, p.z);
+        final (origin, direction) = view.screenRay(screen, distance: 10);
+
+        // The ray starts in front of the point and reaches it going into the screen
+        final t = (origin.x - p.x) * -direction.x +
+            (origin.y - p.y) * -direction.y +
+            (origin.z - p.z) * -direction.z;
+        expect(t, greaterThan(0));
+        expect(origin.x + direction.x * t, closeTo(p.x, 1e-9));
+        expect(origin.y + direction.y * t, closeTo(p.y, 1e-9));
+        expect(origin.z + direction.z * t, closeTo(p.z, 1e-9));
+        expect(view.depth(origin.x, origin.y, origin.z),
+            greaterThan(view.depth(p.x, p.y, p.z)));
+      }
+    });
+
+    test('screenDelta - moves a point by the drag on screen', () {
+      final before = view.project(1, 1, 1);
+      final delta = view.screenDelta(const Offset(12, -5));
+      final after = view.project(1 + delta.x, 1 + delta.y, 1 + delta.z);
+
+      expect(after.dx - before.dx, closeTo(12, 1e-9));
+      expect(after.dy - before.dy, closeTo(-5, 1e-9));
+      expect(view.depth(1 + delta.x, 1 + delta.y, 1 + delta.z),
+          closeTo(view.depth(1, 1, 1), 1e-9));
+    });
+  });
+}
@@ -0,0 +1,35 @@
+// test/worker_pool_test.dart
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:d3_viewer/utils/worker_pool.dart';
+
+WorkerTask<int> _lengthTask(int key) =>
+    (store) => (store[key] as Float64List).length;
+
+void main() {
+  group('WorkerPool', () {
+    test('shareObject - drops the least recent objects over budget', () async {
+      // Two workers: each array counts twice
+      final pool = WorkerPool(2, maxResidentBytes: 1000);
+      final a = Float64List(100);
+      final b = Float64List(10);
+
+      final keyA = await pool.shareObject(a);
+      await Future<void>.delayed(Duration.zero);
+      // Shared since the last trim, so kept even over budget
+      expect(pool.isShared(keyA), isTrue);
+      expect(pool.residentBytes, equals(1600));
+
+      final keyB = await pool.shareObject(b);
+      await Future<void>.delayed(Duration.zero);
+      expect(pool.isShared(keyA), isFalse);
+      expect(pool.isShared(keyB), isTrue);
+      expect(pool.residentBytes, equals(160));
+
+      // Shared again under the same key when used later
+      expect(await pool.shareObject(a), equals(keyA));
+      expect(await pool.run(_lengthTask(keyA)), equals(100));
+    });
+  });
+}